@@ -0,0 +1,223 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Template bounded lock-free message queue for inter-thread communication
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+#include "tsSafePtr.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsGuardCondition.h"
+
+namespace ts {
+    //!
+    //! Template bounded lock-free message queue for inter-thread communication.
+    //! @ingroup thread
+    //!
+    //! The ts::RingMessageQueue template class has the same interface and the same
+    //! enqueue, dequeue and timeout semantics as ts::MessageQueue. It can be used
+    //! instead of ts::MessageQueue in performance-sensitive paths.
+    //!
+    //! The queue is implemented as a fixed ring of message slots. Enqueueing and
+    //! dequeueing a message does not allocate memory and does not take any lock.
+    //! Threads are parked on a condition variable only when the queue is full
+    //! (producers) or empty (consumer).
+    //!
+    //! @b Limitation: There can be any number of producer threads but only one consumer
+    //! thread (MPSC queue). Only one thread at a time shall call dequeue(), peek() or clear().
+    //!
+    //! Unlike ts::MessageQueue, the queue is always bounded. Messages which are inserted
+    //! using forceEnqueue() can exceed the maximum number of messages up to the ring size,
+    //! which is at least twice the maximum number of messages.
+    //!
+    //! @tparam MSG The type of the messages to exchange.
+    //! @tparam MUTEX The type of mutex for synchronization of message pointers (ts::Mutex by default).
+    //!
+    template <typename MSG, class MUTEX = Mutex>
+    class RingMessageQueue
+    {
+        TS_NOCOPY(RingMessageQueue);
+    public:
+        //!
+        //! Safe pointer to messages.
+        //!
+        typedef SafePtr<MSG, MUTEX> MessagePtr;
+
+        //!
+        //! Default maximum number of messages in the queue.
+        //!
+        static constexpr size_t DEFAULT_MAX_MESSAGES = 256;
+
+        //!
+        //! Constructor.
+        //! @param [in] maxMessages Maximum number of messages in the queue.
+        //! When a thread attempts to enqueue a message and the queue is full,
+        //! the thread waits until at least one message is dequeued.
+        //! If @a maxMessages is 0, DEFAULT_MAX_MESSAGES is used.
+        //!
+        RingMessageQueue(size_t maxMessages = 0);
+
+        //!
+        //! Destructor
+        //!
+        virtual ~RingMessageQueue();
+
+        //!
+        //! Get the maximum allowed messages in the queue.
+        //! @return The maximum allowed messages in the queue.
+        //!
+        size_t getMaxMessages() const { return _max_messages; }
+
+        //!
+        //! Change the maximum allowed messages in the queue.
+        //! When the ring size changes, the queue is reallocated. The messages in the queue are preserved.
+        //! Must not be called while other threads use the queue.
+        //! @param [in] maxMessages Maximum number of messages in the queue.
+        //! If @a maxMessages is 0, DEFAULT_MAX_MESSAGES is used.
+        //!
+        void setMaxMessages(size_t maxMessages);
+
+        //!
+        //! Insert a message in the queue.
+        //! If the queue is full, the calling thread waits until some space becomes
+        //! available in the queue or the timeout expires.
+        //! @param [in,out] msg The message to enqueue. The ownership of the pointed object
+        //! is transfered to the message queue. Upon return, the @a msg safe pointer becomes
+        //! a null pointer if the message was successfully enqueued (no timeout).
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! @return True on success, false on error (queue still full after timeout).
+        //!
+        bool enqueue(MessagePtr& msg, MilliSecond timeout = Infinite);
+
+        //!
+        //! Insert a message in the queue.
+        //! If the queue is full, the calling thread waits until some space becomes
+        //! available in the queue or the timeout expires.
+        //! @param [in] msg A pointer to the message to enqueue. This pointer shall not
+        //! be owned by a safe pointer. When the message is successfully enqueued, the
+        //! pointer becomes owned by a safe pointer and will be deallocated when no
+        //! longer used. In case of timeout, the object is not equeued and immediately
+        //! deallocated.
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! @return True on success, false on error (queue still full after timeout).
+        //!
+        bool enqueue(MSG* msg, MilliSecond timeout = Infinite);
+
+        //!
+        //! Insert a message in the queue, even if the queue is full.
+        //! The message is inserted beyond the maximum number of messages. If the
+        //! ring itself is full, the calling thread waits until one slot is free.
+        //! @param [in,out] msg The message to enqueue. The ownership of the pointed object
+        //! is transfered to the message queue. Upon return, the @a msg safe pointer becomes
+        //! a null pointer.
+        //!
+        void forceEnqueue(MessagePtr& msg);
+
+        //!
+        //! Insert a message in the queue, even if the queue is full.
+        //! The message is inserted beyond the maximum number of messages. If the
+        //! ring itself is full, the calling thread waits until one slot is free.
+        //! @param [in] msg A pointer to the message to enqueue. This pointer shall not
+        //! be owned by a safe pointer. When the message is enqueued, the pointer becomes
+        //! owned by a safe pointer and will be deallocated when no longer used.
+        //!
+        void forceEnqueue(MSG* msg);
+
+        //!
+        //! Remove a message from the queue.
+        //! Wait until a message is received or the timeout expires.
+        //! Must be called from the consumer thread only.
+        //! @param [out] msg Received message.
+        //! @param [in] timeout Maximum time to wait in milliseconds.
+        //! If @a timeout is zero and the queue is empty, return immediately.
+        //! @return True on success, false on error (queue still empty after timeout).
+        //!
+        bool dequeue(MessagePtr& msg, MilliSecond timeout = Infinite);
+
+        //!
+        //! Peek the next message from the queue, without dequeueing it.
+        //! Must be called from the consumer thread only.
+        //! @return A safe pointer to the first message in the queue or a null pointer
+        //! if the queue is empty.
+        //!
+        MessagePtr peek();
+
+        //!
+        //! Clear the content of the queue.
+        //! Must be called from the consumer thread only.
+        //!
+        void clear();
+
+    private:
+        // A slot in the ring. The sequence number is the enqueue position for which the slot
+        // is free (seq == pos) or the enqueue position + 1 when the slot contains a message.
+        // The safe pointer in a slot is never shared with anyone else, except through peek().
+        struct Slot
+        {
+            std::atomic<size_t> seq;
+            MessagePtr          msg;
+            Slot() : seq(0), msg() {}
+        };
+
+        // Private members.
+        size_t              _max_messages;        // Max number of messages in the queue.
+        size_t              _mask;                // Ring size - 1 (ring size is a power of 2).
+        std::vector<Slot>   _ring;                // Ring of message slots.
+        std::atomic<size_t> _count;               // Number of messages in the queue, including reserved slots.
+        std::atomic<size_t> _enqueue_pos;         // Next enqueue position (shared by producers).
+        size_t              _dequeue_pos;         // Next dequeue position (consumer only).
+        std::atomic<size_t> _waiting_producers;   // Number of producers waiting for free space.
+        std::atomic<size_t> _waiting_consumers;   // Number of consumers waiting for a message.
+        mutable Mutex       _mutex;               // Used only to park threads.
+        mutable Condition   _enqueued;            // Signaled when some message is inserted.
+        mutable Condition   _dequeued;            // Signaled when some message is removed.
+
+        // Allocate the ring for a given number of messages.
+        void allocate(size_t maxMessages);
+
+        // Reserve one slot in the queue, with a maximum number of messages, waiting for space if necessary.
+        bool reserve(size_t limit, MilliSecond timeout);
+        bool tryReserve(size_t limit);
+
+        // Insert a message in a previously reserved slot. The message becomes owned by the queue.
+        void push(MSG* msg);
+
+        // Extract the next message, if there is one.
+        bool pop(MessagePtr& msg);
+
+        // Check if a message is available in the next slot.
+        bool available() const;
+    };
+}
+
+#include "tsRingMessageQueueTemplate.h"
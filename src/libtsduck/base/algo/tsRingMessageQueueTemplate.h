@@ -0,0 +1,370 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsGuardMutex.h"
+#include "tsTime.h"
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+template <typename MSG, class MUTEX> constexpr size_t ts::RingMessageQueue<MSG, MUTEX>::DEFAULT_MAX_MESSAGES;
+#endif
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+ts::RingMessageQueue<MSG, MUTEX>::RingMessageQueue(size_t maxMessages) :
+    _max_messages(0),
+    _mask(0),
+    _ring(),
+    _count(0),
+    _enqueue_pos(0),
+    _dequeue_pos(0),
+    _waiting_producers(0),
+    _waiting_consumers(0),
+    _mutex(),
+    _enqueued(),
+    _dequeued()
+{
+    allocate(maxMessages);
+}
+
+TS_PUSH_WARNING()
+TS_LLVM_NOWARNING(dtor-name)
+template <typename MSG, class MUTEX>
+ts::RingMessageQueue<MSG, MUTEX>::~RingMessageQueue()
+{
+}
+TS_POP_WARNING()
+
+
+//----------------------------------------------------------------------------
+// Allocate the ring for a given number of messages.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::RingMessageQueue<MSG, MUTEX>::allocate(size_t maxMessages)
+{
+    _max_messages = maxMessages == 0 ? size_t(DEFAULT_MAX_MESSAGES) : maxMessages;
+
+    // The ring size is a power of 2, at least twice the max number of messages to leave room for forced messages.
+    size_t size = 2;
+    while (size < 2 * _max_messages) {
+        size *= 2;
+    }
+
+    // Each slot is initially free for the first enqueue position which uses it.
+    std::vector<Slot> ring(size);
+    for (size_t i = 0; i < size; ++i) {
+        ring[i].seq.store(i, std::memory_order_relaxed);
+    }
+    _ring.swap(ring);
+    _mask = size - 1;
+    _count.store(0);
+    _enqueue_pos.store(0);
+    _dequeue_pos = 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Change the maximum allowed messages in the queue.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::RingMessageQueue<MSG, MUTEX>::setMaxMessages(size_t maxMessages)
+{
+    // Save queued messages, reallocate the ring, requeue messages (as many as possible).
+    std::vector<MessagePtr> pending;
+    for (MessagePtr msg; pop(msg); msg.clear()) {
+        pending.push_back(msg);
+    }
+    allocate(maxMessages);
+    for (size_t i = 0; i < pending.size() && tryReserve(_mask + 1); ++i) {
+        push(pending[i].release());
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Reserve one slot in the queue.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::RingMessageQueue<MSG, MUTEX>::tryReserve(size_t limit)
+{
+    size_t count = _count.load(std::memory_order_relaxed);
+    while (count < limit) {
+        if (_count.compare_exchange_weak(count, count + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename MSG, class MUTEX>
+bool ts::RingMessageQueue<MSG, MUTEX>::reserve(size_t limit, MilliSecond timeout)
+{
+    // Fast path, without lock.
+    if (tryReserve(limit)) {
+        return true;
+    }
+    else if (timeout <= 0) {
+        return false;
+    }
+
+    // The queue is full, park the thread until some message is dequeued.
+    // The consumer signals the condition only when some producer is declared as waiting.
+    GuardCondition lock(_mutex, _dequeued);
+    _waiting_producers.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    bool reserved = false;
+    Time start(Time::CurrentUTC());
+    while (!(reserved = tryReserve(limit))) {
+
+        // Reduce timeout
+        if (timeout != Infinite) {
+            const Time now(Time::CurrentUTC());
+            timeout -= now - start;
+            start = now;
+            if (timeout <= 0) {
+                break; // timeout
+            }
+        }
+
+        // Wait for a message to be dequeued
+        if (!lock.waitCondition(timeout)) {
+            reserved = tryReserve(limit);
+            break; // timeout
+        }
+    }
+
+    _waiting_producers.fetch_sub(1);
+    return reserved;
+}
+
+
+//----------------------------------------------------------------------------
+// Insert a message in a previously reserved slot.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::RingMessageQueue<MSG, MUTEX>::push(MSG* msg)
+{
+    // Since the slot was reserved, the ring cannot be full and the slot at
+    // the enqueue position has already been released by the consumer.
+    const size_t pos = _enqueue_pos.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot(_ring[pos & _mask]);
+    assert(slot.seq.load(std::memory_order_acquire) == pos);
+
+    // The safe pointer in the slot is not shared, reusing it does not allocate memory.
+    slot.msg.reset(msg);
+    slot.seq.store(pos + 1, std::memory_order_release);
+
+    // Wake up the consumer if it is parked.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_waiting_consumers.load(std::memory_order_relaxed) > 0) {
+        GuardMutex lock(_mutex);
+        _enqueued.signal();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Insert a message in the queue with a timeout.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::RingMessageQueue<MSG, MUTEX>::enqueue(MessagePtr& msg, MilliSecond timeout)
+{
+    if (reserve(_max_messages, timeout)) {
+        // Transfer ownership of the pointed object.
+        push(msg.release());
+        return true;
+    }
+    else {
+        // Timeout, queue still full.
+        return false;
+    }
+}
+
+template <typename MSG, class MUTEX>
+bool ts::RingMessageQueue<MSG, MUTEX>::enqueue(MSG* msg, MilliSecond timeout)
+{
+    if (reserve(_max_messages, timeout)) {
+        push(msg);
+        return true;
+    }
+    else {
+        // Timeout, queue still full. Deallocated the message.
+        delete msg;
+        return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Insert a message in the queue, even if the queue is full.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::RingMessageQueue<MSG, MUTEX>::forceEnqueue(MessagePtr& msg)
+{
+    reserve(_mask + 1, Infinite);
+    push(msg.release());
+}
+
+template <typename MSG, class MUTEX>
+void ts::RingMessageQueue<MSG, MUTEX>::forceEnqueue(MSG* msg)
+{
+    reserve(_mask + 1, Infinite);
+    push(msg);
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a message is available in the next slot.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::RingMessageQueue<MSG, MUTEX>::available() const
+{
+    return _ring[_dequeue_pos & _mask].seq.load(std::memory_order_acquire) == _dequeue_pos + 1;
+}
+
+
+//----------------------------------------------------------------------------
+// Extract the next message, if there is one.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::RingMessageQueue<MSG, MUTEX>::pop(MessagePtr& msg)
+{
+    if (!available()) {
+        return false;
+    }
+
+    Slot& slot(_ring[_dequeue_pos & _mask]);
+    if (msg.count() == 1 && slot.msg.count() == 1) {
+        // Usual case: exchange the safe pointers, without memory allocation.
+        // The previous message of the caller was not shared and is deleted.
+        msg.swap(slot.msg);
+        slot.msg.reset();
+    }
+    else {
+        // The message was peeked or the previous message of the caller is shared.
+        msg = slot.msg;
+        slot.msg.clear();
+    }
+
+    // Release the slot for the enqueue position which will use it next time.
+    slot.seq.store(_dequeue_pos + _mask + 1, std::memory_order_release);
+    _dequeue_pos++;
+    _count.fetch_sub(1, std::memory_order_release);
+
+    // Wake up a producer if one is parked.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_waiting_producers.load(std::memory_order_relaxed) > 0) {
+        GuardMutex lock(_mutex);
+        _dequeued.signal();
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove a message from the queue.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+bool ts::RingMessageQueue<MSG, MUTEX>::dequeue(MessagePtr& msg, MilliSecond timeout)
+{
+    // Fast path, without lock.
+    if (pop(msg)) {
+        return true;
+    }
+    else if (timeout <= 0) {
+        return false;
+    }
+
+    // The queue is empty, park the thread until some message is enqueued.
+    // Producers signal the condition only when the consumer is declared as waiting.
+    bool ready = false;
+    {
+        GuardCondition lock(_mutex, _enqueued);
+        _waiting_consumers.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        Time start(Time::CurrentUTC());
+        while (!(ready = available())) {
+
+            // Reduce timeout
+            if (timeout != Infinite) {
+                const Time now(Time::CurrentUTC());
+                timeout -= now - start;
+                start = now;
+                if (timeout <= 0) {
+                    break; // timeout
+                }
+            }
+
+            // Wait for a message to be enqueued
+            if (!lock.waitCondition(timeout)) {
+                ready = available();
+                break; // timeout
+            }
+        }
+        _waiting_consumers.fetch_sub(1);
+    }
+    return ready && pop(msg);
+}
+
+
+//----------------------------------------------------------------------------
+// Peek the next message from the queue, without dequeueing it.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+typename ts::RingMessageQueue<MSG, MUTEX>::MessagePtr ts::RingMessageQueue<MSG, MUTEX>::peek()
+{
+    return available() ? _ring[_dequeue_pos & _mask].msg : MessagePtr();
+}
+
+
+//----------------------------------------------------------------------------
+// Clear the queue.
+//----------------------------------------------------------------------------
+
+template <typename MSG, class MUTEX>
+void ts::RingMessageQueue<MSG, MUTEX>::clear()
+{
+    MessagePtr msg;
+    while (pop(msg)) {
+    }
+}
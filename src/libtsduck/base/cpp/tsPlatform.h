@@ -787,6 +787,7 @@ TS_MSC_NOWARNING(5045)  // Compiler will insert Spectre mitigation for memory lo
 #include <map>
 #include <set>
 #include <bitset>
+#include <memory>
 #include <algorithm>
 #include <iterator>
 #include <limits>
@@ -0,0 +1,334 @@
+//-----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-----------------------------------------------------------------------------
+//
+//  Asynchronous I/O using io_uring. Linux-specific.
+//
+//-----------------------------------------------------------------------------
+
+#include "tsIOUring.h"
+#include "tsSysUtils.h"
+
+#include "tsBeforeStandardHeaders.h"
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "tsAfterStandardHeaders.h"
+
+#if !defined(TS_NO_IO_URING)
+
+// Older glibc headers may not define the system call numbers.
+// These numbers are identical on all architectures.
+#if !defined(__NR_io_uring_setup)
+    #define __NR_io_uring_setup    425
+    #define __NR_io_uring_enter    426
+    #define __NR_io_uring_register 427
+#endif
+
+
+//-----------------------------------------------------------------------------
+// Constructor and destructor.
+//-----------------------------------------------------------------------------
+
+ts::IOUring::IOUring() :
+    _fd(-1),
+    _registered(false),
+    _sq_entries(0),
+    _to_submit(0),
+    _sq_ring(nullptr),
+    _cq_ring(nullptr),
+    _sqes(nullptr),
+    _sq_ring_size(0),
+    _cq_ring_size(0),
+    _sqes_size(0),
+    _sq_head(nullptr),
+    _sq_tail(nullptr),
+    _sq_mask(0),
+    _sq_array(nullptr),
+    _cq_head(nullptr),
+    _cq_tail(nullptr),
+    _cq_mask(0),
+    _cqes(nullptr)
+{
+}
+
+ts::IOUring::~IOUring()
+{
+    close();
+}
+
+
+//-----------------------------------------------------------------------------
+// Create the submission and completion queues.
+//-----------------------------------------------------------------------------
+
+bool ts::IOUring::open(size_t entries, Report& report)
+{
+    close();
+
+    ::io_uring_params params;
+    TS_ZERO(params);
+    _fd = int(::syscall(__NR_io_uring_setup, unsigned(entries), &params));
+    if (_fd < 0) {
+        report.debug(u"io_uring not available: %s", {SysErrorCodeMessage()});
+        _fd = -1;
+        return false;
+    }
+
+    // Non-vectored read and write operations were introduced with this feature (kernel 5.6).
+    if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+        report.debug(u"io_uring too old, read/write operations not supported");
+        close();
+        return false;
+    }
+
+    // Map the rings in memory. Recent kernels use one single mapping for both rings.
+    _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        _sq_ring_size = _cq_ring_size = std::max(_sq_ring_size, _cq_ring_size);
+    }
+    _sqes_size = params.sq_entries * sizeof(::io_uring_sqe);
+
+    _sq_ring = ::mmap(nullptr, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+    if (_sq_ring == MAP_FAILED) {
+        _sq_ring = nullptr;
+    }
+    else if (single_mmap) {
+        _cq_ring = _sq_ring;
+    }
+    else {
+        _cq_ring = ::mmap(nullptr, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+        if (_cq_ring == MAP_FAILED) {
+            _cq_ring = nullptr;
+        }
+    }
+    if (_cq_ring != nullptr) {
+        _sqes = ::mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+        if (_sqes == MAP_FAILED) {
+            _sqes = nullptr;
+        }
+    }
+    if (_sqes == nullptr) {
+        report.debug(u"error mapping io_uring queues: %s", {SysErrorCodeMessage()});
+        close();
+        return false;
+    }
+
+    // Locate the fields of the rings.
+    uint8_t* const sq = reinterpret_cast<uint8_t*>(_sq_ring);
+    uint8_t* const cq = reinterpret_cast<uint8_t*>(_cq_ring);
+    _sq_entries = params.sq_entries;
+    _sq_head = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+    _sq_tail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+    _sq_mask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+    _sq_array = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+    _cq_head = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+    _cq_tail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+    _cq_mask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+    _cqes = cq + params.cq_off.cqes;
+    _to_submit = 0;
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Close the queues.
+//-----------------------------------------------------------------------------
+
+void ts::IOUring::close()
+{
+    if (_sqes != nullptr) {
+        ::munmap(_sqes, _sqes_size);
+    }
+    if (_cq_ring != nullptr && _cq_ring != _sq_ring) {
+        ::munmap(_cq_ring, _cq_ring_size);
+    }
+    if (_sq_ring != nullptr) {
+        ::munmap(_sq_ring, _sq_ring_size);
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+    _fd = -1;
+    _registered = false;
+    _sq_entries = _to_submit = _sq_mask = _cq_mask = 0;
+    _sq_ring = _cq_ring = _sqes = _cqes = nullptr;
+    _sq_ring_size = _cq_ring_size = _sqes_size = 0;
+    _sq_head = _sq_tail = _sq_array = _cq_head = _cq_tail = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------
+// Register fixed buffers.
+//-----------------------------------------------------------------------------
+
+bool ts::IOUring::registerBuffers(std::vector<ByteBlock>& buffers, Report& report)
+{
+    if (_fd < 0 || _registered) {
+        return false;
+    }
+    std::vector<::iovec> iov(buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        iov[i].iov_base = buffers[i].data();
+        iov[i].iov_len = buffers[i].size();
+    }
+    if (::syscall(__NR_io_uring_register, _fd, IORING_REGISTER_BUFFERS, iov.data(), unsigned(iov.size())) < 0) {
+        report.debug(u"cannot register io_uring buffers: %s", {SysErrorCodeMessage()});
+        return false;
+    }
+    _registered = true;
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Queue I/O operations.
+//-----------------------------------------------------------------------------
+
+bool ts::IOUring::queueRead(int fd, void* addr, size_t size, uint64_t offset, uint64_t user_data, size_t buffer_index, Report& report)
+{
+    return queue(_registered && buffer_index != NPOS ? uint8_t(IORING_OP_READ_FIXED) : uint8_t(IORING_OP_READ), fd, addr, size, offset, user_data, buffer_index, report);
+}
+
+bool ts::IOUring::queueWrite(int fd, const void* addr, size_t size, uint64_t offset, uint64_t user_data, size_t buffer_index, Report& report)
+{
+    return queue(_registered && buffer_index != NPOS ? uint8_t(IORING_OP_WRITE_FIXED) : uint8_t(IORING_OP_WRITE), fd, addr, size, offset, user_data, buffer_index, report);
+}
+
+bool ts::IOUring::queue(uint8_t opcode, int fd, const void* addr, size_t size, uint64_t offset, uint64_t user_data, size_t buffer_index, Report& report)
+{
+    if (_fd < 0) {
+        report.error(u"io_uring not open");
+        return false;
+    }
+
+    // If the submission queue is full, submit its content first.
+    const uint32_t tail = *_sq_tail;
+    if (tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) >= _sq_entries) {
+        if (!enter(0, report)) {
+            return false;
+        }
+        // The kernel may have refused the submission (EBUSY, EAGAIN). The next entry is still
+        // owned by the kernel until consumed and must not be overwritten.
+        if (tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) >= _sq_entries) {
+            report.error(u"io_uring submission queue full, reap completions first");
+            return false;
+        }
+    }
+
+    const uint32_t index = tail & _sq_mask;
+    ::io_uring_sqe* const sqe = reinterpret_cast<::io_uring_sqe*>(_sqes) + index;
+    TS_ZERO(*sqe);
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+
+    sqe->addr = uint64_t(reinterpret_cast<uintptr_t>(addr));
+    sqe->len = uint32_t(size);
+    if (opcode == IORING_OP_READ_FIXED || opcode == IORING_OP_WRITE_FIXED) {
+        sqe->buf_index = uint16_t(buffer_index);
+    }
+
+    _sq_array[index] = index;
+    __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+    _to_submit++;
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+// Submit queued operations and optionally wait for completions.
+//-----------------------------------------------------------------------------
+
+bool ts::IOUring::enter(uint32_t min_complete, Report& report)
+{
+    while (_to_submit > 0 || min_complete > 0) {
+        const long ret = ::syscall(__NR_io_uring_enter, _fd, _to_submit, min_complete, min_complete > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+        if (ret >= 0) {
+            _to_submit -= std::min(_to_submit, uint32_t(ret));
+            // The requested completions are available, when requested, once the call succeeded.
+            min_complete = 0;
+        }
+        else {
+            const SysErrorCode err = LastSysErrorCode();
+            if (err == EBUSY || err == EAGAIN) {
+                // Completion queue overflow or lack of resources, need to reap completions first.
+                return true;
+            }
+            else if (err != EINTR) {
+                report.error(u"io_uring error: %s", {SysErrorCodeMessage(err)});
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool ts::IOUring::submit(Report& report)
+{
+    return _fd >= 0 && enter(0, report);
+}
+
+
+//-----------------------------------------------------------------------------
+// Wait for the completion of one operation.
+//-----------------------------------------------------------------------------
+
+bool ts::IOUring::wait(uint64_t& user_data, int& result, Report& report)
+{
+    user_data = 0;
+    result = 0;
+
+    if (_fd < 0) {
+        report.error(u"io_uring not open");
+        return false;
+    }
+
+    for (;;) {
+        const uint32_t head = *_cq_head;
+        if (head != __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+            // A completion is available.
+            const ::io_uring_cqe* const cqe = reinterpret_cast<const ::io_uring_cqe*>(_cqes) + (head & _cq_mask);
+            user_data = cqe->user_data;
+            result = cqe->res;
+            __atomic_store_n(_cq_head, head + 1, __ATOMIC_RELEASE);
+            // Submit what was queued, without waiting.
+            return enter(0, report);
+        }
+        // Submit what was queued and wait for one completion.
+        if (!enter(1, report)) {
+            return false;
+        }
+    }
+}
+
+#endif
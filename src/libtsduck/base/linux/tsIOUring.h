@@ -0,0 +1,186 @@
+//-----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//-----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Asynchronous I/O using io_uring (Linux-specific).
+//!
+//-----------------------------------------------------------------------------
+
+#pragma once
+#include "tsByteBlock.h"
+#include "tsReport.h"
+
+// The io_uring system interface requires the Linux kernel headers from kernel 5.6 or higher
+// (IORING_OP_READ and IORING_OP_WRITE appeared with IORING_FEAT_RW_CUR_POS).
+// When they are not available, TS_NO_IO_URING is defined and the class IOUring is not declared.
+#if !defined(TS_NO_IO_URING) && defined(__has_include)
+    #if __has_include(<linux/io_uring.h>)
+        #include "tsBeforeStandardHeaders.h"
+        #include <linux/io_uring.h>
+        #include "tsAfterStandardHeaders.h"
+    #endif
+#endif
+#if !defined(TS_NO_IO_URING) && !defined(IORING_FEAT_RW_CUR_POS)
+    #define TS_NO_IO_URING 1
+#endif
+
+#if !defined(TS_NO_IO_URING) || defined(DOXYGEN)
+
+namespace ts {
+    //!
+    //! Asynchronous I/O using io_uring (Linux-specific).
+    //! @ingroup unix
+    //!
+    //! This is a minimal interface to the Linux io_uring facility, directly using the system calls.
+    //! It is used to keep several read or write operations in progress on a file.
+    //! An instance of this class shall be used by one single thread.
+    //!
+    //! Depending on the kernel version and the security policy, io_uring may be unavailable.
+    //! In that case, open() fails and the application shall revert to synchronous I/O.
+    //!
+    class TSDUCKDLL IOUring
+    {
+        TS_NOCOPY(IOUring);
+    public:
+        //!
+        //! Constructor.
+        //!
+        IOUring();
+
+        //!
+        //! Destructor.
+        //!
+        ~IOUring();
+
+        //!
+        //! Create the submission and completion queues.
+        //! @param [in] entries Minimum number of entries in the submission queue.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool open(size_t entries, Report& report);
+
+        //!
+        //! Check if the queues are open.
+        //! @return True if the queues are open.
+        //!
+        bool isOpen() const { return _fd >= 0; }
+
+        //!
+        //! Close the queues.
+        //! The operations in progress, if any, are not waited for and their completion are lost.
+        //! The corresponding buffers shall not be reused before the completion of these operations.
+        //!
+        void close();
+
+        //!
+        //! Register fixed buffers which are permanently mapped in the kernel.
+        //! I/O operations in these buffers avoid the per-operation page mapping overhead.
+        //! @param [in] buffers Buffers to register. The buffers shall not be resized while they are registered.
+        //! Buffer indexes in queueRead() and queueWrite() are indexes in this vector.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error (typically not enough lockable memory).
+        //! In case of error, non-registered buffers can still be used.
+        //!
+        bool registerBuffers(std::vector<ByteBlock>& buffers, Report& report);
+
+        //!
+        //! Queue a read operation.
+        //! The operation is actually started by submit() or wait().
+        //! @param [in] fd File descriptor.
+        //! @param [out] addr Address of the buffer.
+        //! @param [in] size Maximum number of bytes to read.
+        //! @param [in] offset Offset in the file.
+        //! @param [in] user_data Application data, returned by wait().
+        //! @param [in] buffer_index Index of the registered buffer containing @a addr or NPOS if not registered.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error or when the submission queue remains full.
+        //!
+        bool queueRead(int fd, void* addr, size_t size, uint64_t offset, uint64_t user_data, size_t buffer_index, Report& report);
+
+        //!
+        //! Queue a write operation.
+        //! The operation is actually started by submit() or wait().
+        //! @param [in] fd File descriptor.
+        //! @param [in] addr Address of the data to write.
+        //! @param [in] size Number of bytes to write.
+        //! @param [in] offset Offset in the file.
+        //! @param [in] user_data Application data, returned by wait().
+        //! @param [in] buffer_index Index of the registered buffer containing @a addr or NPOS if not registered.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error or when the submission queue remains full.
+        //!
+        bool queueWrite(int fd, const void* addr, size_t size, uint64_t offset, uint64_t user_data, size_t buffer_index, Report& report);
+
+        //!
+        //! Start all queued operations.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool submit(Report& report);
+
+        //!
+        //! Wait for the completion of one operation.
+        //! All queued operations are started first.
+        //! @param [out] user_data Application data of the completed operation.
+        //! @param [out] result Result of the operation: number of transferred bytes or negated error code.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool wait(uint64_t& user_data, int& result, Report& report);
+
+    private:
+        int       _fd;           // io_uring file descriptor.
+        bool      _registered;   // Fixed buffers were registered.
+        uint32_t  _sq_entries;   // Number of entries in submission queue.
+        uint32_t  _to_submit;    // Number of queued entries, not yet submitted.
+        void*     _sq_ring;      // Mapped submission queue ring.
+        void*     _cq_ring;      // Mapped completion queue ring (same as _sq_ring with single mmap).
+        void*     _sqes;         // Mapped array of submission queue entries.
+        size_t    _sq_ring_size;
+        size_t    _cq_ring_size;
+        size_t    _sqes_size;
+        uint32_t* _sq_head;
+        uint32_t* _sq_tail;
+        uint32_t  _sq_mask;
+        uint32_t* _sq_array;
+        uint32_t* _cq_head;
+        uint32_t* _cq_tail;
+        uint32_t  _cq_mask;
+        void*     _cqes;
+
+        // Queue one operation.
+        bool queue(uint8_t opcode, int fd, const void* addr, size_t size, uint64_t offset, uint64_t user_data, size_t buffer_index, Report& report);
+
+        // Enter the kernel to submit queued operations and optionally wait for completions.
+        bool enter(uint32_t min_complete, Report& report);
+    };
+}
+
+#endif
@@ -139,6 +139,7 @@ namespace ts {
                              const AbortInterface* abort = nullptr,
                              Report& report = CERR,
                              MicroSecond* timestamp = nullptr) override;
+        virtual size_t receiveMultiple(ReceiveBuffer* buffers, size_t count, const AbortInterface* abort = nullptr, Report& report = CERR) override;
 
     private:
         bool              _dest_is_parameter;  // Destination address is a command line parameter, not an option.
@@ -158,6 +159,9 @@ namespace ts {
         IPv4SocketAddress _first_source;       // Socket address of first received packet.
         IPv4SocketAddressSet _sources;         // Set of all detected packet sources.
 
+        // Check if a received message matches the filtering criteria.
+        bool accept(const IPv4SocketAddress& sender, const IPv4SocketAddress& destination, Report& report, MicroSecond timestamp);
+
         // Get the command line argument for the destination parameter.
         const UChar* destinationOptionName() const { return _dest_is_parameter ? u"" : u"ip-udp"; }
     };
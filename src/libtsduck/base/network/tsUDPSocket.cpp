@@ -33,6 +33,12 @@
 // Network timestampting feature in Linux.
 #if defined(TS_LINUX)
 #include <linux/net_tstamp.h>
+#include <netinet/udp.h>
+#endif
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+const size_t ts::UDPSocket::MAX_SEND_MULTIPLE;
+const size_t ts::UDPSocket::MAX_RECEIVE_MULTIPLE;
 #endif
 
 // Furiously idiotic Windows feature, see comment in receiveOne()
@@ -50,7 +56,8 @@ ts::UDPSocket::UDPSocket(bool auto_open, Report& report) :
     _local_address(),
     _default_destination(),
     _mcast(),
-    _ssmcast()
+    _ssmcast(),
+    _use_gso(true)
 {
     if (auto_open) {
         // Returned value ignored on purpose, the socket is marked as closed in the object on error.
@@ -423,6 +430,132 @@ bool ts::UDPSocket::send(const void* data, size_t size, const IPv4SocketAddress&
 }
 
 
+//----------------------------------------------------------------------------
+// Send several messages at once.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::sendMultiple(const void* const data[], const size_t size[], size_t count, Report& report)
+{
+    return sendMultiple(data, size, count, _default_destination, report);
+}
+
+#if !defined(TS_LINUX)
+
+// Portable version: send messages one by one.
+bool ts::UDPSocket::sendMultiple(const void* const data[], const size_t size[], size_t count, const IPv4SocketAddress& dest, Report& report)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (!send(data[i], size[i], dest, report)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#else
+
+// Linux version: use sendmmsg(), with UDP_SEGMENT when supported.
+bool ts::UDPSocket::sendMultiple(const void* const data[], const size_t size[], size_t count, const IPv4SocketAddress& dest, Report& report)
+{
+    // Maximum number of segments in one GSO message (UDP_MAX_SEGMENTS in the kernel) and UDP payload.
+    constexpr size_t max_segments = 64;
+    constexpr size_t max_payload = 65507;
+
+    ::sockaddr addr;
+    dest.copy(addr);
+
+    ::mmsghdr hdr[MAX_SEND_MULTIPLE];
+    ::iovec vec[MAX_SEND_MULTIPLE];
+#if defined(UDP_SEGMENT)
+    uint8_t ancil_data[MAX_SEND_MULTIPLE][CMSG_SPACE(sizeof(uint16_t))];
+#endif
+
+    while (count > 0) {
+
+        // Build the message headers. Without GSO, there is one message per datagram.
+        // With GSO, consecutive datagrams of identical size are grouped in one message,
+        // the last datagram in a group may be shorter.
+        const size_t vec_count = std::min(count, MAX_SEND_MULTIPLE);
+        size_t msg_count = 0;
+        TS_ZERO(hdr);
+        for (size_t first = 0; first < vec_count; ) {
+            size_t seg_count = 1;
+            size_t total = size[first];
+            vec[first].iov_base = const_cast<void*>(data[first]);
+            vec[first].iov_len = size[first];
+            if (_use_gso) {
+                while (first + seg_count < vec_count &&
+                       seg_count < max_segments &&
+                       size[first + seg_count - 1] == size[first] &&
+                       size[first + seg_count] <= size[first] &&
+                       total + size[first + seg_count] <= max_payload)
+                {
+                    const size_t i = first + seg_count++;
+                    vec[i].iov_base = const_cast<void*>(data[i]);
+                    vec[i].iov_len = size[i];
+                    total += size[i];
+                }
+            }
+            ::msghdr& msg(hdr[msg_count].msg_hdr);
+            msg.msg_name = &addr;
+            msg.msg_namelen = sizeof(addr);
+            msg.msg_iov = &vec[first];
+            msg.msg_iovlen = seg_count;
+#if defined(UDP_SEGMENT)
+            if (seg_count > 1) {
+                msg.msg_control = ancil_data[msg_count];
+                msg.msg_controllen = sizeof(ancil_data[msg_count]);
+                ::cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                const uint16_t segment_size = uint16_t(size[first]);
+                ::memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+            }
+#endif
+            msg_count++;
+            first += seg_count;
+        }
+
+        // Send all messages, loop on partial sends.
+        size_t msg_next = 0;
+        while (msg_next < msg_count) {
+            const int ret = ::sendmmsg(getSocket(), hdr + msg_next, (unsigned int)(msg_count - msg_next), 0);
+            if (ret > 0) {
+                msg_next += size_t(ret);
+                continue;
+            }
+            const SysSocketErrorCode err = LastSysSocketErrorCode();
+            if (err == EINTR) {
+                report.debug(u"signal, not user interrupt");
+            }
+            else if (_use_gso && hdr[msg_next].msg_hdr.msg_iovlen > 1 && (err == EIO || err == EINVAL || err == ENOPROTOOPT || err == EOPNOTSUPP)) {
+                // GSO not supported by the kernel or the NIC, or invalid segment size. Retry without GSO.
+                report.debug(u"UDP segmentation offload not available: %s", {SysSocketErrorCodeMessage(err)});
+                _use_gso = false;
+                break;
+            }
+            else {
+                report.error(u"error sending UDP message: " + SysSocketErrorCodeMessage(err));
+                return false;
+            }
+        }
+
+        // Skip all datagrams which were sent. If GSO was disabled, retry remaining datagrams.
+        size_t sent = 0;
+        for (size_t i = 0; i < msg_next; ++i) {
+            sent += hdr[i].msg_hdr.msg_iovlen;
+        }
+        data += sent;
+        size += sent;
+        count -= sent;
+    }
+    return true;
+}
+
+#endif
+
+
 //----------------------------------------------------------------------------
 // Receive a message.
 // If abort interface is non-zero, invoke it when I/O is interrupted
@@ -597,6 +730,27 @@ ts::SysSocketErrorCode ts::UDPSocket::receiveOne(void* data,
         return LastSysSocketErrorCode();
     }
 
+    // Browse returned ancillary data.
+    getAncillaryData(hdr, destination, timestamp);
+
+#endif // Windows vs. UNIX
+
+    // Successfully received a message
+    ret_size = size_t(insize);
+    sender = IPv4SocketAddress(sender_sock);
+
+    return SYS_SUCCESS;
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze the ancillary data of a received message (UNIX only).
+//----------------------------------------------------------------------------
+
+#if !defined(TS_WINDOWS)
+
+void ts::UDPSocket::getAncillaryData(::msghdr& hdr, IPv4SocketAddress& destination, MicroSecond* timestamp)
+{
     // Because of invalid definition of CMSG_NXTHDR in musl libc (Alpine Linux)
     TS_PUSH_WARNING()
     TS_GCC_NOWARNING(zero-as-null-pointer-constant)
@@ -625,12 +779,113 @@ ts::SysSocketErrorCode ts::UDPSocket::receiveOne(void* data,
     }
 
     TS_POP_WARNING()
+}
 
-#endif // Windows vs. UNIX
+#endif
 
-    // Successfully received a message
-    ret_size = size_t(insize);
-    sender = IPv4SocketAddress(sender_sock);
 
-    return SYS_SUCCESS;
+//----------------------------------------------------------------------------
+// Receive several messages at once.
+//----------------------------------------------------------------------------
+
+size_t ts::UDPSocket::receiveMultiple(ReceiveBuffer* buffers, size_t count, const AbortInterface* abort, Report& report)
+{
+    count = std::min(count, MAX_RECEIVE_MULTIPLE);
+    if (buffers == nullptr || count == 0) {
+        return 0;
+    }
+
+    // Clear returned values.
+    for (size_t i = 0; i < count; ++i) {
+        buffers[i].ret_size = 0;
+        buffers[i].sender.clear();
+        buffers[i].destination.clear();
+        buffers[i].timestamp = -1;
+    }
+
+#if defined(TS_LINUX)
+
+    // Build one msghdr per message for recvmmsg(), with two iovec per message.
+    // The ancillary data per message are only the destination address and timestamp.
+    ::mmsghdr hdr[MAX_RECEIVE_MULTIPLE];
+    ::iovec vec[MAX_RECEIVE_MULTIPLE][2];
+    ::sockaddr sender_sock[MAX_RECEIVE_MULTIPLE];
+    uint8_t ancil_data[MAX_RECEIVE_MULTIPLE][256];
+    for (size_t i = 0; i < count; ++i) {
+        TS_ZERO(hdr[i]);
+        TS_ZERO(sender_sock[i]);
+        vec[i][0].iov_base = buffers[i].data1;
+        vec[i][0].iov_len = buffers[i].size1;
+        vec[i][1].iov_base = buffers[i].data2;
+        vec[i][1].iov_len = buffers[i].data2 == nullptr ? 0 : buffers[i].size2;
+        hdr[i].msg_hdr.msg_name = &sender_sock[i];
+        hdr[i].msg_hdr.msg_iov = vec[i];
+        hdr[i].msg_hdr.msg_iovlen = 2;
+        hdr[i].msg_hdr.msg_control = ancil_data[i];
+    }
+
+    // Loop on unsollicited interrupts
+    for (;;) {
+
+        // The sizes of the sender address and ancillary data are overwritten by recvmmsg(), reset them before each call.
+        for (size_t i = 0; i < count; ++i) {
+            hdr[i].msg_hdr.msg_namelen = sizeof(sender_sock[i]);
+            hdr[i].msg_hdr.msg_controllen = sizeof(ancil_data[i]);
+        }
+
+        // Wait for at least one message, then get all immediately available ones.
+        const int res = ::recvmmsg(getSocket(), hdr, (unsigned int)(count), MSG_WAITFORONE, nullptr);
+        const SysSocketErrorCode err = res < 0 ? LastSysSocketErrorCode() : SYS_SUCCESS;
+
+        if (abort != nullptr && abort->aborting()) {
+            // Aborting, no error message.
+            return 0;
+        }
+        else if (res > 0) {
+            size_t valid = 0;
+            for (size_t i = 0; i < size_t(res); ++i) {
+                buffers[i].ret_size = hdr[i].msg_len;
+                buffers[i].sender = IPv4SocketAddress(sender_sock[i]);
+                getAncillaryData(hdr[i].msg_hdr, buffers[i].destination, &buffers[i].timestamp);
+                // Sometimes, we get "successful" empty message coming from nowhere. Ignore them.
+                if (buffers[i].ret_size > 0 || buffers[i].sender.hasAddress()) {
+                    valid++;
+                }
+            }
+            if (valid > 0) {
+                return size_t(res);
+            }
+        }
+        else if (res < 0 && err == EINTR) {
+            // Got a signal, not a user interrupt, will ignore it
+            report.debug(u"signal, not user interrupt");
+        }
+        else if (res < 0) {
+            // Abort on non-interrupt errors.
+            if (isOpen()) {
+                // Report the error only if the error does not result from a close in another thread.
+                report.error(u"error receiving from UDP socket: %s", {SysSocketErrorCodeMessage(err)});
+            }
+            return 0;
+        }
+    }
+
+#else
+
+    // Receive one single message. When two segments are used, receive in a contiguous buffer.
+    ReceiveBuffer& buf(buffers[0]);
+    const size_t size2 = buf.data2 == nullptr ? 0 : buf.size2;
+    ByteBlock data(size2 == 0 ? 0 : buf.size1 + size2);
+    if (!receive(size2 == 0 ? buf.data1 : data.data(), buf.size1 + size2, buf.ret_size, buf.sender, buf.destination, abort, report, &buf.timestamp)) {
+        return 0;
+    }
+    if (size2 > 0) {
+        ::memcpy(buf.data1, data.data(), std::min(buf.ret_size, buf.size1));
+        if (buf.ret_size > buf.size1) {
+            ::memcpy(buf.data2, data.data() + buf.size1, buf.ret_size - buf.size1);
+        }
+    }
+    return 1;
+
+#endif
 }
@@ -303,6 +303,42 @@ namespace ts {
         //!
         virtual bool send(const void* data, size_t size, Report& report = CERR);
 
+        //!
+        //! Maximum number of messages which are sent at once by sendMultiple().
+        //!
+        static const size_t MAX_SEND_MULTIPLE = 64;
+
+        //!
+        //! Send several messages at once to a destination address and port.
+        //!
+        //! On Linux, up to MAX_SEND_MULTIPLE messages are sent using one single system call.
+        //! When supported by the kernel, consecutive messages of identical size are grouped
+        //! using UDP generic segmentation offload (GSO) and segmented by the kernel or the NIC.
+        //! On other systems, the messages are sent one by one.
+        //!
+        //! @param [in] data Array of @a count addresses of messages to send.
+        //! @param [in] size Array of @a count sizes in bytes of the messages to send.
+        //! @param [in] count Number of messages to send.
+        //! @param [in] destination Socket address of the destination.
+        //! Both address and port are mandatory in the socket address, they cannot
+        //! be set to IPv4Address::AnyAddress or IPv4SocketAddress::AnyPort.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        virtual bool sendMultiple(const void* const data[], const size_t size[], size_t count, const IPv4SocketAddress& destination, Report& report = CERR);
+
+        //!
+        //! Send several messages at once to the default destination address and port.
+        //!
+        //! @param [in] data Array of @a count addresses of messages to send.
+        //! @param [in] size Array of @a count sizes in bytes of the messages to send.
+        //! @param [in] count Number of messages to send.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //! @see sendMultiple(const void* const[], const size_t[], size_t, const IPv4SocketAddress&, Report&)
+        //!
+        virtual bool sendMultiple(const void* const data[], const size_t size[], size_t count, Report& report = CERR);
+
         //!
         //! Receive a message.
         //!
@@ -330,6 +366,60 @@ namespace ts {
                              Report& report = CERR,
                              MicroSecond* timestamp = nullptr);
 
+        //!
+        //! Buffer for one message in receiveMultiple().
+        //!
+        //! A message is received in up to two consecutive memory segments. The second segment
+        //! receives the end of the message when it is larger than the first segment. This is
+        //! typically used to receive messages of an expected size directly in their final location,
+        //! with an overflow area for unexpected larger messages.
+        //!
+        class TSDUCKDLL ReceiveBuffer
+        {
+        public:
+            uint8_t*          data1;        //!< Address of the first segment.
+            size_t            size1;        //!< Size in bytes of the first segment.
+            uint8_t*          data2;        //!< Address of the second segment, can be null.
+            size_t            size2;        //!< Size in bytes of the second segment.
+            size_t            ret_size;     //!< Returned size of the message, in the two segments. Zero when the message is ignored.
+            IPv4SocketAddress sender;       //!< Returned socket address of the sender.
+            IPv4SocketAddress destination;  //!< Returned socket address of the packet destination.
+            MicroSecond       timestamp;    //!< Returned receive timestamp in micro-seconds, negative if not available.
+
+            //!
+            //! Constructor.
+            //!
+            ReceiveBuffer() : data1(nullptr), size1(0), data2(nullptr), size2(0), ret_size(0), sender(), destination(), timestamp(-1) {}
+            //! @cond nodoxygen
+            ReceiveBuffer(const ReceiveBuffer&) = default;
+            ReceiveBuffer& operator=(const ReceiveBuffer&) = default;
+            //! @endcond
+        };
+
+        //!
+        //! Maximum number of messages which are received at once by receiveMultiple().
+        //!
+        static const size_t MAX_RECEIVE_MULTIPLE = 64;
+
+        //!
+        //! Receive several messages at once.
+        //!
+        //! Wait for at least one message, then return all messages which are immediately
+        //! available, up to @a count messages. On Linux, this is implemented using one single
+        //! system call. On other systems, only one message is received at a time.
+        //!
+        //! @param [in,out] buffers Array of @a count message buffers. On input, the memory segments
+        //! of each buffer shall be set. On output, the returned fields are set in all used buffers.
+        //! Use setReceiveTimestamps() to enable the generation of receive timestamps.
+        //! @param [in] count Number of buffers in @a buffers. At most MAX_RECEIVE_MULTIPLE are used.
+        //! @param [in] abort If non-zero, invoked when I/O is interrupted
+        //! (in case of user-interrupt, return, otherwise retry).
+        //! @param [in,out] report Where to report error.
+        //! @return Number of used buffers, zero on error. Some used buffers may have a zero
+        //! returned size, when the corresponding message shall be ignored.
+        //!
+        virtual size_t receiveMultiple(ReceiveBuffer* buffers, size_t count, const AbortInterface* abort = nullptr, Report& report = CERR);
+
         // Implementation of Socket interface.
         virtual bool open(Report& report = CERR) override;
         virtual bool close(Report& report = CERR) override;
@@ -389,10 +479,16 @@ namespace ts {
         IPv4SocketAddress _default_destination;
         MReqSet           _mcast;    // Current set of multicast memberships
         SSMReqSet         _ssmcast;  // Current set of source-specific multicast memberships
+        bool              _use_gso;  // Try to use UDP generic segmentation offload in sendMultiple()
 
         // Perform one receive operation. Hide the system mud.
         SysSocketErrorCode receiveOne(void* data, size_t max_size, size_t& ret_size, IPv4SocketAddress& sender, IPv4SocketAddress& destination, Report& report, MicroSecond* timestamp);
 
+#if !defined(TS_WINDOWS)
+        // Analyze the ancillary data of a received message.
+        void getAncillaryData(::msghdr& hdr, IPv4SocketAddress& destination, MicroSecond* timestamp);
+#endif
+
         // Furiously idiotic Windows feature, see comment in receiveOne()
 #if defined(TS_WINDOWS)
         static volatile ::LPFN_WSARECVMSG _wsaRevcMsg;
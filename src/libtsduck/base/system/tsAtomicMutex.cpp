@@ -0,0 +1,74 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsAtomicMutex.h"
+#include "tsMonotonic.h"
+#include <thread>
+
+
+//----------------------------------------------------------------------------
+// Acquire the mutex.
+//----------------------------------------------------------------------------
+
+bool ts::AtomicMutex::acquire(MilliSecond timeout)
+{
+    // Fast path: uncontended lock.
+    if (!_locked.exchange(true, std::memory_order_acquire)) {
+        return true;
+    }
+    else if (timeout <= 0) {
+        return false;
+    }
+
+    // Contended lock: spin, yielding the CPU, until granted or timeout.
+    const bool infinite = timeout == Infinite;
+    Monotonic deadline(!infinite);
+    if (!infinite) {
+        deadline += timeout * NanoSecPerMilliSec;
+    }
+    // Test before test-and-set to avoid bouncing the cache line between CPU's.
+    while (_locked.load(std::memory_order_relaxed) || _locked.exchange(true, std::memory_order_acquire)) {
+        if (!infinite && Monotonic(true) >= deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Release the mutex.
+//----------------------------------------------------------------------------
+
+bool ts::AtomicMutex::release()
+{
+    _locked.store(false, std::memory_order_release);
+    return true;
+}
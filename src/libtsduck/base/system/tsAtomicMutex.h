@@ -0,0 +1,81 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Lightweight mutex based on an atomic boolean.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsMutexInterface.h"
+
+namespace ts {
+    //!
+    //! Lightweight mutex based on an atomic boolean (spin lock).
+    //! @ingroup thread
+    //!
+    //! The concrete class ts::AtomicMutex is a spin lock which never enters the kernel.
+    //! It is suitable for very short critical sections with low contention only.
+    //! Unlike ts::Mutex, ts::AtomicMutex is not recursive.
+    //!
+    //! This class is primarily designed as a synchronization policy for ts::SafePtr
+    //! and all classes which use it (ts::MessageQueue for instance). When a ts::SafePtr
+    //! is instantiated with ts::AtomicMutex, the reference counter and the pointer are
+    //! managed using lock-free atomic operations and the mutex itself is never used.
+    //! This is a faster alternative to ts::Mutex for safe pointers which are shared
+    //! between threads. In all other contexts, ts::AtomicMutex is a plain spin lock.
+    //!
+    class TSDUCKDLL AtomicMutex: public MutexInterface
+    {
+        TS_NOCOPY(AtomicMutex);
+    public:
+        //!
+        //! Default constructor.
+        //!
+        AtomicMutex() : _locked(false) {}
+
+        //!
+        //! Acquire the mutex with a timeout.
+        //! The calling thread spins, yielding the CPU between attempts, until the
+        //! mutex is granted or the timeout expires.
+        //! @param [in] timeout Maximum number of milliseconds to wait for the mutex.
+        //! @return True on success and false on timeout.
+        //!
+        virtual bool acquire(MilliSecond timeout = Infinite) override;
+
+        //!
+        //! Release the mutex.
+        //! @return Always true.
+        //!
+        virtual bool release() override;
+
+    private:
+        std::atomic<bool> _locked;
+    };
+}
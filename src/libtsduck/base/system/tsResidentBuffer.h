@@ -34,8 +34,24 @@
 
 #pragma once
 #include "tsSysUtils.h"
+#include "tsEnumeration.h"
 
 namespace ts {
+    //!
+    //! Type of memory pages in a memory buffer.
+    //! @ingroup system
+    //!
+    enum class PageMode {
+        STANDARD,          //!< Standard memory pages.
+        TRANSPARENT_HUGE,  //!< Transparent huge pages, the operating system is advised to use huge pages.
+        EXPLICIT_HUGE,     //!< Explicit huge pages, allocated from the pool of huge pages of the operating system.
+    };
+
+    //!
+    //! Enumeration description of ts::PageMode.
+    //!
+    TSDUCKDLL extern const Enumeration PageModeEnum;
+
     //!
     //! Implementation of memory buffer locked in physical memory.
     //! @tparam T Type of the buffer element.
@@ -50,9 +66,16 @@ namespace ts {
         //! Constructor, based on required amount of elements.
         //! Abort application if memory allocation fails.
         //! Do not abort if memory locking fails.
+        //!
+        //! Using huge pages reduces the number of TLB entries which are needed to access
+        //! large buffers. When huge pages are requested but not available, the buffer
+        //! gracefully falls back to transparent huge pages, then to standard pages.
+        //! Huge pages are currently implemented on Linux only.
+        //!
         //! @param [in] elem_count Number of @a T elements.
+        //! @param [in] mode Requested type of memory pages.
         //!
-        ResidentBuffer(size_t elem_count);
+        ResidentBuffer(size_t elem_count, PageMode mode = PageMode::STANDARD);
 
         //!
         //! Destructor.
@@ -77,6 +100,15 @@ namespace ts {
             return _error_code;
         }
 
+        //!
+        //! Get the type of memory pages which are actually used by the buffer.
+        //! @return The type of memory pages in effect.
+        //!
+        PageMode pageMode() const
+        {
+            return _page_mode;
+        }
+
         //!
         //! Return base address of the buffer.
         //! @return The address of the first @a T element in the buffer.
@@ -96,14 +128,16 @@ namespace ts {
         }
 
     private:
-        char*     _allocated_base;   // First allocated address
-        char*     _locked_base;      // First locked address (mlock, page boundary)
-        T*        _base;             // Same as _locked_base with type T*
-        size_t    _allocated_size;   // Allocated size (ts_malloc)
-        size_t    _locked_size;      // Locked size (mlock, multiple of page size)
-        size_t    _elem_count;       // Element count in locked region
-        bool      _is_locked;        // False if mlock failed.
-        SysErrorCode _error_code;       // Lock error code
+        char*        _allocated_base;  // First allocated address
+        char*        _locked_base;     // First locked address (mlock, page boundary)
+        T*           _base;            // Same as _locked_base with type T*
+        size_t       _allocated_size;  // Allocated size (new or mmap)
+        size_t       _locked_size;     // Locked size (mlock, multiple of page size)
+        size_t       _elem_count;      // Element count in locked region
+        bool         _is_locked;       // False if mlock failed.
+        bool         _is_mapped;       // Allocated using mmap() instead of new.
+        PageMode     _page_mode;       // Actual type of memory pages.
+        SysErrorCode _error_code;      // Lock error code
     };
 }
 
@@ -51,7 +51,7 @@
 //----------------------------------------------------------------------------
 
 template <typename T>
-ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
+ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count, PageMode mode) :
     _allocated_base(nullptr),
     _locked_base(nullptr),
     _base(nullptr),
@@ -59,15 +59,53 @@ ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
     _locked_size(0),
     _elem_count(elem_count),
     _is_locked(false),
+    _is_mapped(false),
+    _page_mode(PageMode::STANDARD),
     _error_code(SYS_SUCCESS)
 {
     const size_t requested_size = elem_count * sizeof(T);
-    const size_t page_size = SysInfo::Instance()->memoryPageSize();
+    size_t page_size = SysInfo::Instance()->memoryPageSize();
+
+#if defined(TS_LINUX) && defined(MAP_HUGETLB) && defined(MADV_HUGEPAGE)
+
+    // Try to use huge pages when requested and supported.
+    const size_t huge_size = SysInfo::Instance()->hugePageSize();
+    if (mode != PageMode::STANDARD && huge_size > 0 && requested_size > 0) {
+        const size_t huge_total = round_up(requested_size, huge_size);
+        void* addr = MAP_FAILED;
+        if (mode == PageMode::EXPLICIT_HUGE) {
+            // Explicit huge pages from the system pool, the mapping is aligned on a huge page.
+            // This fails when the pool is not large enough (see /proc/sys/vm/nr_hugepages).
+            _allocated_size = huge_total;
+            addr = ::mmap(nullptr, _allocated_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (addr != MAP_FAILED) {
+                _page_mode = PageMode::EXPLICIT_HUGE;
+            }
+        }
+        if (addr == MAP_FAILED) {
+            // Transparent huge pages apply to aligned huge pages only, allocate one more to align.
+            _allocated_size = huge_total + huge_size;
+            addr = ::mmap(nullptr, _allocated_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (addr != MAP_FAILED && ::madvise(char_ptr(round_up(size_t(addr), huge_size)), huge_total, MADV_HUGEPAGE) == 0) {
+                _page_mode = PageMode::TRANSPARENT_HUGE;
+            }
+        }
+        if (addr != MAP_FAILED) {
+            // Even if madvise() failed, keep the mapping, aligned on huge pages.
+            _allocated_base = char_ptr(addr);
+            _is_mapped = true;
+            page_size = huge_size;
+        }
+    }
+
+#endif
 
     // Allocate enough space to include memory pages around the requested size
 
-    _allocated_size = requested_size + 2 * page_size;
-    _allocated_base = new char[_allocated_size];
+    if (_allocated_base == nullptr) {
+        _allocated_size = requested_size + 2 * page_size;
+        _allocated_base = new char[_allocated_size];
+    }
 
     // Locked space starts at next page boundary after allocated base:
     // Its size is the next multiple of page size after requested_size:
@@ -147,7 +185,15 @@ ts::ResidentBuffer<T>::~ResidentBuffer()
 
     // Free memory
     if (_allocated_base != nullptr) {
-        delete[] _allocated_base;
+#if defined(TS_UNIX)
+        if (_is_mapped) {
+            ::munmap(_allocated_base, _allocated_size);
+        }
+        else
+#endif
+        {
+            delete[] _allocated_base;
+        }
     }
 
     // Reset state (it explicit call of destructor)
@@ -158,5 +204,7 @@ ts::ResidentBuffer<T>::~ResidentBuffer()
     _locked_size = 0;
     _elem_count = 0;
     _is_locked = false;
+    _is_mapped = false;
+    _page_mode = PageMode::STANDARD;
 }
 TS_POP_WARNING()
@@ -28,6 +28,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsSysInfo.h"
+#include "tsThreadAttributes.h"
 #include "tsSysUtils.h"
 #include "tsMemory.h"
 #if defined(TS_MAC)
@@ -35,6 +36,14 @@
 #include <sys/param.h>
 #include <sys/sysctl.h>
 #endif
+#if (defined(TS_I386) || defined(TS_X86_64)) && defined(TS_MSC)
+#include <intrin.h>
+#elif (defined(TS_I386) || defined(TS_X86_64)) && (defined(TS_GCC) || defined(TS_LLVM))
+#include <cpuid.h>
+#elif defined(TS_ARM64) && defined(TS_LINUX)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
 
 // Define singleton instance
 TS_DEFINE_SINGLETON(ts::SysInfo);
@@ -75,6 +84,8 @@ ts::SysInfo::SysInfo() :
 #else
     _isIntel64(false),
 #endif
+    _crcInstructions(false),
+    _aesInstructions(false),
     _systemVersion(),
     _systemName(),
     _hostName(),
@@ -99,7 +110,8 @@ ts::SysInfo::SysInfo() :
 #else
     _cpuName(u"unknown CPU"),
 #endif
-    _memoryPageSize(0)
+    _memoryPageSize(0),
+    _hugePageSize(0)
 {
     //
     // Get operating system name and version.
@@ -241,5 +253,95 @@ ts::SysInfo::SysInfo() :
         _memoryPageSize = size_t(pageSize);
     }
 
+#endif
+
+    //
+    // Get default huge page size, when huge pages are supported.
+    //
+#if defined(TS_LINUX)
+
+    // Line "Hugepagesize:    2048 kB" in /proc/meminfo.
+    UStringList meminfo;
+    UString::Load(meminfo, u"/proc/meminfo");
+    for (const auto& line : meminfo) {
+        size_t kb = 0;
+        if (line.startWith(u"Hugepagesize:") && line.substr(13).toTrimmed().scan(u"%d kB", {&kb})) {
+            _hugePageSize = kb * 1024;
+            break;
+        }
+    }
+
+#endif
+
+    //
+    // Get supported CPU features.
+    //
+#if (defined(TS_I386) || defined(TS_X86_64)) && defined(TS_MSC)
+
+    int regs[4]; // eax, ebx, ecx, edx
+    ::__cpuid(regs, 1);
+    _crcInstructions = (regs[2] & (1 << 1)) != 0 && (regs[2] & (1 << 9)) != 0; // PCLMULQDQ and SSSE3
+    _aesInstructions = (regs[2] & (1 << 25)) != 0; // AES-NI
+
+#elif (defined(TS_I386) || defined(TS_X86_64)) && (defined(TS_GCC) || defined(TS_LLVM))
+
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (::__get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0) {
+        _crcInstructions = (ecx & bit_PCLMUL) != 0 && (ecx & bit_SSSE3) != 0;
+        _aesInstructions = (ecx & bit_AES) != 0;
+    }
+
+#elif defined(TS_ARM64) && defined(TS_LINUX)
+
+    _crcInstructions = (::getauxval(AT_HWCAP) & HWCAP_PMULL) != 0;
+    _aesInstructions = (::getauxval(AT_HWCAP) & HWCAP_AES) != 0;
+
+#elif defined(TS_ARM64) && defined(TS_MAC)
+
+    // All Apple Silicon CPU's support the Armv8 cryptographic extension.
+    _crcInstructions = true;
+    _aesInstructions = true;
+
+#endif
+
+    // Accelerated instructions can be disabled using environment variables (for tests or in case of problem).
+    _crcInstructions = _crcInstructions && !EnvironmentExists(u"TS_NO_CRC32_INSTRUCTIONS");
+    _aesInstructions = _aesInstructions && !EnvironmentExists(u"TS_NO_AES_INSTRUCTIONS");
+}
+
+
+//----------------------------------------------------------------------------
+// Get the list of CPU's in a NUMA node.
+//----------------------------------------------------------------------------
+
+bool ts::SysInfo::getNUMANodeCPUs(size_t node, std::set<size_t>& cpus) const
+{
+    cpus.clear();
+
+#if defined(TS_LINUX)
+
+    UStringList lines;
+    return UString::Load(lines, UString::Format(u"/sys/devices/system/node/node%d/cpulist", {node})) &&
+        !lines.empty() &&
+        ThreadAttributes::DecodeCPUList(lines.front(), cpus) &&
+        !cpus.empty();
+
+#elif defined(TS_WINDOWS)
+
+    ::ULONGLONG mask = 0;
+    if (node > 0xFF || ::GetNumaNodeProcessorMask(::UCHAR(node), &mask) == 0) {
+        return false;
+    }
+    for (size_t cpu = 0; cpu < 64; ++cpu) {
+        if ((mask & (::ULONGLONG(1) << cpu)) != 0) {
+            cpus.insert(cpu);
+        }
+    }
+    return !cpus.empty();
+
+#else
+
+    return false;
+
 #endif
 }
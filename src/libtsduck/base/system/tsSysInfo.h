@@ -98,6 +98,21 @@ namespace ts {
         //!
         bool isIntel64() const { return _isIntel64; }
         //!
+        //! Check if the CPU supports accelerated instructions for CRC32 computation.
+        //! These are the carry-less multiplication instructions (PCLMULQDQ on Intel, PMULL on Arm64).
+        //! The detection can be disabled by defining the environment variable TS_NO_CRC32_INSTRUCTIONS.
+        //! @return True if the CPU supports accelerated instructions for CRC32 computation.
+        //!
+        bool crcInstructions() const { return _crcInstructions; }
+
+        //!
+        //! Check if the CPU supports accelerated instructions for AES computation.
+        //! These are the AES-NI instructions on Intel and the Armv8 cryptographic extension on Arm64.
+        //! The detection can be disabled by defining the environment variable TS_NO_AES_INSTRUCTIONS.
+        //! @return True if the CPU supports accelerated instructions for AES computation.
+        //!
+        bool aesInstructions() const { return _aesInstructions; }
+        //!
         //! Get the operating system version.
         //! @return The operating system version.
         //!
@@ -122,6 +137,21 @@ namespace ts {
         //! @return The system memory page size in bytes.
         //!
         size_t memoryPageSize() const { return _memoryPageSize; }
+        //!
+        //! Get system default huge memory page size.
+        //! @return The default size in bytes of huge memory pages or zero if huge pages are not supported
+        //! on this system (currently implemented on Linux only).
+        //!
+        size_t hugePageSize() const { return _hugePageSize; }
+        //!
+        //! Get the list of CPU's in a NUMA node.
+        //! This information is not cached, the system is queried each time.
+        //! @param [in] node NUMA node index, starting at zero.
+        //! @param [out] cpus Set of CPU indexes in the NUMA node.
+        //! @return True on success, false if the NUMA node does not exist or NUMA
+        //! information is not available on this system (implemented on Linux and Windows).
+        //!
+        bool getNUMANodeCPUs(size_t node, std::set<size_t>& cpus) const;
 
     private:
         bool    _isLinux;
@@ -134,10 +164,13 @@ namespace ts {
         bool    _isWindows;
         bool    _isIntel32;
         bool    _isIntel64;
+        bool    _crcInstructions;
+        bool    _aesInstructions;
         UString _systemVersion;
         UString _systemName;
         UString _hostName;
         UString _cpuName;
         size_t  _memoryPageSize;
+        size_t  _hugePageSize;
     };
 }
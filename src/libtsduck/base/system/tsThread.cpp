@@ -35,6 +35,12 @@
 #include "tsSysInfo.h"
 #include "tsIntegerUtils.h"
 
+#if (defined(TS_I386) || defined(TS_X86_64)) && defined(TS_MSC)
+    #include "tsBeforeStandardHeaders.h"
+    #include <intrin.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
 #if defined(TS_LINUX)
     #include "tsBeforeStandardHeaders.h"
     #include <sys/prctl.h>
@@ -128,6 +134,114 @@ void ts::Thread::Yield()
 }
 
 
+//----------------------------------------------------------------------------
+// Hint the CPU that the current thread is in a spin-wait loop.
+//----------------------------------------------------------------------------
+
+void ts::Thread::SpinPause()
+{
+#if (defined(TS_I386) || defined(TS_X86_64)) && defined(TS_MSC)
+    ::_mm_pause();
+#elif (defined(TS_I386) || defined(TS_X86_64)) && (defined(TS_GCC) || defined(TS_LLVM))
+    __builtin_ia32_pause();
+#elif defined(TS_ARM64) && (defined(TS_GCC) || defined(TS_LLVM))
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Set or get the CPU affinity of the current thread.
+//----------------------------------------------------------------------------
+
+bool ts::Thread::SetCurrentCPUAffinity(const std::set<size_t>& cpus)
+{
+#if defined(TS_LINUX)
+
+    ::cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpus.empty()) {
+        // Any CPU of the process.
+        if (::sched_getaffinity(::getpid(), sizeof(set), &set) != 0) {
+            return false;
+        }
+    }
+    for (auto cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    // On Linux, a zero pid means the calling thread, not the whole process.
+    return CPU_COUNT(&set) > 0 && ::sched_setaffinity(0, sizeof(set), &set) == 0;
+
+#elif defined(TS_WINDOWS)
+
+    ::DWORD_PTR process_mask = 0;
+    ::DWORD_PTR system_mask = 0;
+    if (::GetProcessAffinityMask(::GetCurrentProcess(), &process_mask, &system_mask) == 0) {
+        return false;
+    }
+    ::DWORD_PTR mask = cpus.empty() ? process_mask : 0;
+    for (auto cpu : cpus) {
+        if (cpu < 8 * sizeof(::DWORD_PTR)) {
+            mask |= ::DWORD_PTR(1) << cpu;
+        }
+    }
+    return mask != 0 && ::SetThreadAffinityMask(::GetCurrentThread(), mask) != 0;
+
+#else
+
+    return false;
+
+#endif
+}
+
+bool ts::Thread::GetCurrentCPUAffinity(std::set<size_t>& cpus)
+{
+    cpus.clear();
+
+#if defined(TS_LINUX)
+
+    ::cpu_set_t set;
+    CPU_ZERO(&set);
+    if (::sched_getaffinity(0, sizeof(set), &set) != 0) {
+        return false;
+    }
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+            cpus.insert(cpu);
+        }
+    }
+    return true;
+
+#elif defined(TS_WINDOWS)
+
+    // There is no GetThreadAffinityMask(). Temporarily set the process mask to get the previous one.
+    ::DWORD_PTR process_mask = 0;
+    ::DWORD_PTR system_mask = 0;
+    if (::GetProcessAffinityMask(::GetCurrentProcess(), &process_mask, &system_mask) == 0) {
+        return false;
+    }
+    const ::DWORD_PTR mask = ::SetThreadAffinityMask(::GetCurrentThread(), process_mask);
+    if (mask == 0) {
+        return false;
+    }
+    ::SetThreadAffinityMask(::GetCurrentThread(), mask);
+    for (size_t cpu = 0; cpu < 8 * sizeof(::DWORD_PTR); ++cpu) {
+        if ((mask & (::DWORD_PTR(1) << cpu)) != 0) {
+            cpus.insert(cpu);
+        }
+    }
+    return true;
+
+#else
+
+    return false;
+
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Get a copy of the attributes of the thread.
 //----------------------------------------------------------------------------
@@ -367,6 +481,11 @@ void ts::Thread::mainWrapper()
 #endif
     }
 
+    // Set CPU affinity. Errors are ignored, this is only an optimization.
+    if (!_attributes._cpus.empty()) {
+        SetCurrentCPUAffinity(_attributes._cpus);
+    }
+
     try {
         main();
     }
@@ -211,6 +211,31 @@ namespace ts {
         //!
         static void Yield();
 
+        //!
+        //! Hint the CPU that the current thread is in a spin-wait loop.
+        //! On processors which support it, this is a "pause" instruction which
+        //! reduces the power consumption and the penalty when exiting the loop.
+        //! Unlike Yield(), execution is not passed to another thread.
+        //!
+        static void SpinPause();
+
+        //!
+        //! Set the CPU affinity of the current thread.
+        //! This is the same as ThreadAttributes::setCPUAffinity() but applies to the calling thread
+        //! which can be a thread which was not created by this class, such as the main thread.
+        //! @param [in] cpus Set of CPU indexes where the current thread can run. When empty, the
+        //! current thread can run on any CPU of the process.
+        //! @return True on success, false on error or if CPU affinity is not supported on this system.
+        //!
+        static bool SetCurrentCPUAffinity(const std::set<size_t>& cpus);
+
+        //!
+        //! Get the CPU affinity of the current thread.
+        //! @param [out] cpus Set of CPU indexes where the current thread can run.
+        //! @return True on success, false on error or if CPU affinity is not supported on this system.
+        //!
+        static bool GetCurrentCPUAffinity(std::set<size_t>& cpus);
+
     protected:
         //!
         //! Set the type name.
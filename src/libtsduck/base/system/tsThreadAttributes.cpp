@@ -154,7 +154,8 @@ ts::ThreadAttributes::ThreadAttributes() :
     _stackSize(0),
     _deleteWhenTerminated(false),
     _priority(0),
-    _name()
+    _name(),
+    _cpus()
 {
     if (!_priorityInitialized) {
         InitializePriorities();
@@ -174,3 +175,57 @@ ts::ThreadAttributes& ts::ThreadAttributes::setPriority(int priority)
     _priority = std::max(_minimumPriority, std::min(_maximumPriority, priority));
     return *this;
 }
+
+
+//----------------------------------------------------------------------------
+// Decode and format a list of CPU indexes ("0-3,8,10-11").
+//----------------------------------------------------------------------------
+
+bool ts::ThreadAttributes::DecodeCPUList(const UString& list, std::set<size_t>& cpus)
+{
+    cpus.clear();
+    UStringVector fields;
+    list.split(fields, u',', true, true);
+    for (const auto& field : fields) {
+        size_t first = 0;
+        size_t last = 0;
+        const size_t dash = field.find(u'-');
+        if (dash == NPOS) {
+            if (!field.toInteger(first)) {
+                return false;
+            }
+            last = first;
+        }
+        else if (!field.substr(0, dash).toInteger(first) || !field.substr(dash + 1).toInteger(last) || last < first) {
+            return false;
+        }
+        if (last > 0xFFFF) {
+            return false; // unreasonable CPU index
+        }
+        for (size_t cpu = first; cpu <= last; ++cpu) {
+            cpus.insert(cpu);
+        }
+    }
+    return true;
+}
+
+ts::UString ts::ThreadAttributes::EncodeCPUList(const std::set<size_t>& cpus)
+{
+    UString list;
+    for (auto it = cpus.begin(); it != cpus.end(); ) {
+        // Find the end of a range of contiguous CPU indexes.
+        const size_t first = *it;
+        size_t last = first;
+        while (++it != cpus.end() && *it == last + 1) {
+            last = *it;
+        }
+        if (!list.empty()) {
+            list.append(u',');
+        }
+        list.append(UString::Decimal(first, 0, true, UString()));
+        if (last > first) {
+            list.append(UString::Format(u"-%d", {last}));
+        }
+    }
+    return list;
+}
@@ -261,11 +261,57 @@ namespace ts {
             return GetPriority(_maximumPriority);
         }
 
+        //!
+        //! Set the CPU affinity of the thread.
+        //! The thread is allowed to run on the specified CPU's only. This is typically used to
+        //! keep cooperating threads on the same processor socket and NUMA node. The CPU affinity
+        //! is implemented on Linux and Windows only (on Windows, only the first 64 CPU's can be
+        //! used). It is ignored on other systems. Errors are ignored.
+        //! @param [in] cpus Set of CPU indexes, starting at zero. When empty (the default),
+        //! the thread can run on any CPU.
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setCPUAffinity(const std::set<size_t>& cpus)
+        {
+            _cpus = cpus;
+            return *this;
+        }
+
+        //!
+        //! Get the CPU affinity of the thread.
+        //! @return A constant reference to the set of CPU indexes where the thread can run.
+        //! When empty, the thread can run on any CPU.
+        //! @see setCPUAffinity()
+        //!
+        const std::set<size_t>& getCPUAffinity() const
+        {
+            return _cpus;
+        }
+
+        //!
+        //! Decode a list of CPU indexes.
+        //! The format is the same as the "cpulist" files in the Linux /sys filesystem or
+        //! the @c taskset command: comma-separated CPU indexes or ranges of indexes,
+        //! for instance "0-3,8,10-11".
+        //! @param [in] list The string to decode.
+        //! @param [out] cpus The decoded set of CPU indexes.
+        //! @return True on success, false on invalid string.
+        //!
+        static bool DecodeCPUList(const UString& list, std::set<size_t>& cpus);
+
+        //!
+        //! Format a list of CPU indexes.
+        //! @param [in] cpus A set of CPU indexes.
+        //! @return The corresponding string, in the same format as DecodeCPUList().
+        //!
+        static UString EncodeCPUList(const std::set<size_t>& cpus);
+
     private:
-        size_t  _stackSize;
-        bool    _deleteWhenTerminated;
-        int     _priority;
-        UString _name;
+        size_t           _stackSize;
+        bool             _deleteWhenTerminated;
+        int              _priority;
+        UString          _name;
+        std::set<size_t> _cpus;
 
         //
         // These fields describe the operating system priority range.
@@ -0,0 +1,227 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsMultiPatternSearch.h"
+#include "tsMemory.h"
+
+// Select the implementation of the SIMD prefilter. We only use the SIMD instructions
+// which are always available on the target CPU (SSE2 on x86_64, Neon on Arm64).
+#if defined(TS_X86_64) || (defined(TS_I386) && defined(__SSE2__))
+    #define TS_PATTERN_SSE2 1
+    #include <emmintrin.h>
+#elif defined(TS_ARM64)
+    #define TS_PATTERN_NEON 1
+    #include <arm_neon.h>
+#endif
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::MultiPatternSearch::MAX_FIRST_BYTES;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::MultiPatternSearch::MultiPatternSearch(const ByteBlockVector& patterns) :
+    _patterns(),
+    _max_size(0),
+    _next(),
+    _match(),
+    _first_bytes()
+{
+    setPatterns(patterns);
+}
+
+
+//----------------------------------------------------------------------------
+// Compile a new set of patterns into an Aho-Corasick automaton.
+//----------------------------------------------------------------------------
+
+void ts::MultiPatternSearch::setPatterns(const ByteBlockVector& patterns)
+{
+    constexpr uint32_t NONE = 0xFFFFFFFF;
+
+    _patterns.clear();
+    _max_size = 0;
+    _next.clear();
+    _match.clear();
+    _first_bytes.clear();
+
+    // Build the trie of all patterns. Missing transitions are NONE.
+    _next.resize(256, NONE);
+    _match.push_back(false);
+    for (const auto& pat : patterns) {
+        if (pat.empty()) {
+            continue;
+        }
+        _patterns.push_back(pat);
+        _max_size = std::max(_max_size, pat.size());
+        uint32_t state = 0;
+        for (auto b : pat) {
+            if (_next[256 * state + b] == NONE) {
+                _next[256 * state + b] = uint32_t(_match.size());
+                _next.resize(_next.size() + 256, NONE);
+                _match.push_back(false);
+            }
+            state = _next[256 * state + b];
+        }
+        _match[state] = true;
+    }
+
+    // Complete the automaton in breadth-first order, using the failure links.
+    // Missing transitions from the initial state loop on the initial state.
+    std::vector<uint32_t> fail(_match.size(), 0);
+    std::vector<uint32_t> queue;
+    for (size_t b = 0; b < 256; ++b) {
+        const uint32_t child = _next[b];
+        if (child == NONE) {
+            _next[b] = 0;
+        }
+        else {
+            queue.push_back(child);
+            _first_bytes.push_back(uint8_t(b));
+        }
+    }
+    for (size_t qi = 0; qi < queue.size(); ++qi) {
+        const uint32_t state = queue[qi];
+        _match[state] = _match[state] || _match[fail[state]];
+        for (size_t b = 0; b < 256; ++b) {
+            const uint32_t child = _next[256 * state + b];
+            const uint32_t fallback = _next[256 * fail[state] + b];
+            if (child == NONE) {
+                _next[256 * state + b] = fallback;
+            }
+            else {
+                fail[child] = fallback;
+                queue.push_back(child);
+            }
+        }
+    }
+
+    // The SIMD prefilter is useful with a few distinct first bytes only.
+    if (_first_bytes.size() > MAX_FIRST_BYTES) {
+        _first_bytes.clear();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Skip bytes which cannot start a pattern.
+//----------------------------------------------------------------------------
+
+const uint8_t* ts::MultiPatternSearch::skipToFirstByte(const uint8_t* cur, const uint8_t* end) const
+{
+#if defined(TS_PATTERN_SSE2)
+
+    // Unused slots are filled with the first byte.
+    const __m128i f0 = _mm_set1_epi8(char(_first_bytes[0]));
+    const __m128i f1 = _mm_set1_epi8(char(_first_bytes[std::min<size_t>(1, _first_bytes.size() - 1)]));
+    const __m128i f2 = _mm_set1_epi8(char(_first_bytes[std::min<size_t>(2, _first_bytes.size() - 1)]));
+    const __m128i f3 = _mm_set1_epi8(char(_first_bytes[std::min<size_t>(3, _first_bytes.size() - 1)]));
+    for (; cur + 16 <= end; cur += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur));
+        const __m128i match = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, f0), _mm_cmpeq_epi8(data, f1)),
+                                           _mm_or_si128(_mm_cmpeq_epi8(data, f2), _mm_cmpeq_epi8(data, f3)));
+        const uint32_t bits = uint32_t(_mm_movemask_epi8(match));
+        if (bits != 0) {
+            size_t bit = 0;
+            while ((bits & (1u << bit)) == 0) {
+                ++bit;
+            }
+            return cur + bit;
+        }
+    }
+
+#elif defined(TS_PATTERN_NEON)
+
+    const uint8x16_t f0 = vdupq_n_u8(_first_bytes[0]);
+    const uint8x16_t f1 = vdupq_n_u8(_first_bytes[std::min<size_t>(1, _first_bytes.size() - 1)]);
+    const uint8x16_t f2 = vdupq_n_u8(_first_bytes[std::min<size_t>(2, _first_bytes.size() - 1)]);
+    const uint8x16_t f3 = vdupq_n_u8(_first_bytes[std::min<size_t>(3, _first_bytes.size() - 1)]);
+    for (; cur + 16 <= end; cur += 16) {
+        const uint8x16_t data = vld1q_u8(cur);
+        const uint8x16_t match = vorrq_u8(vorrq_u8(vceqq_u8(data, f0), vceqq_u8(data, f1)), vorrq_u8(vceqq_u8(data, f2), vceqq_u8(data, f3)));
+        if (vmaxvq_u8(match) != 0) {
+            break; // the first byte is located below
+        }
+    }
+
+#endif
+
+    // Remaining bytes, one by one.
+    while (cur < end && _next[*cur] == 0) {
+        ++cur;
+    }
+    return cur;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if any pattern is present in a memory area.
+//----------------------------------------------------------------------------
+
+bool ts::MultiPatternSearch::search(const void* area, size_t area_size) const
+{
+    if (_patterns.empty() || area == nullptr) {
+        return false;
+    }
+
+    const uint8_t* cur = reinterpret_cast<const uint8_t*>(area);
+    const uint8_t* const end = cur + area_size;
+    const bool prefilter = !_first_bytes.empty();
+    uint32_t state = 0;
+
+    while (cur < end) {
+        // In the initial state, quickly skip bytes which cannot start a pattern.
+        if (state == 0 && prefilter && (cur = skipToFirstByte(cur, end)) >= end) {
+            break;
+        }
+        state = _next[256 * state + *cur++];
+        if (_match[state]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a memory area starts with any pattern.
+//----------------------------------------------------------------------------
+
+bool ts::MultiPatternSearch::startsWith(const void* area, size_t area_size) const
+{
+    for (const auto& pat : _patterns) {
+        if (StartsWith(area, area_size, pat.data(), pat.size())) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,114 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Search several binary patterns at once in memory areas.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsByteBlock.h"
+
+namespace ts {
+    //!
+    //! Search several binary patterns at once in memory areas.
+    //! @ingroup cpp
+    //!
+    //! The set of patterns is compiled once into a deterministic automaton (Aho-Corasick).
+    //! Each byte of a searched area is then processed in constant time, whatever the
+    //! number of patterns. When the patterns start with a few distinct byte values,
+    //! the search skips the bytes which cannot start a pattern using SIMD instructions
+    //! (SSE2 on x86_64, Neon on Arm64) when available.
+    //!
+    //! The compiled automaton uses 1 kB of memory per byte in all patterns. This class
+    //! is designed for a reasonable number of short patterns, typically signatures to
+    //! search in TS packets.
+    //!
+    class TSDUCKDLL MultiPatternSearch
+    {
+    public:
+        //!
+        //! Default constructor.
+        //! @param [in] patterns The binary patterns to search. Empty patterns are ignored.
+        //!
+        MultiPatternSearch(const ByteBlockVector& patterns = ByteBlockVector());
+
+        //!
+        //! Set a new set of patterns to search.
+        //! @param [in] patterns The binary patterns to search. Empty patterns are ignored.
+        //!
+        void setPatterns(const ByteBlockVector& patterns);
+
+        //!
+        //! Check if there is no pattern to search.
+        //! @return True if there is no pattern to search.
+        //!
+        bool empty() const { return _patterns.empty(); }
+
+        //!
+        //! Get the number of patterns to search.
+        //! @return The number of non-empty patterns to search.
+        //!
+        size_t patternCount() const { return _patterns.size(); }
+
+        //!
+        //! Get the size of the largest pattern.
+        //! @return The size in bytes of the largest pattern.
+        //!
+        size_t maxPatternSize() const { return _max_size; }
+
+        //!
+        //! Check if any pattern is present in a memory area.
+        //! @param [in] area Address of a memory area to search.
+        //! @param [in] area_size Size in bytes of the memory area.
+        //! @return True if at least one pattern is found in @a area.
+        //!
+        bool search(const void* area, size_t area_size) const;
+
+        //!
+        //! Check if a memory area starts with any pattern.
+        //! @param [in] area Address of a memory area to check.
+        //! @param [in] area_size Size in bytes of the memory area.
+        //! @return True if @a area starts with at least one pattern.
+        //!
+        bool startsWith(const void* area, size_t area_size) const;
+
+    private:
+        static constexpr size_t MAX_FIRST_BYTES = 4;  // Max number of distinct first bytes for the SIMD prefilter.
+
+        ByteBlockVector       _patterns;     // Non-empty patterns.
+        size_t                _max_size;     // Size of largest pattern.
+        std::vector<uint32_t> _next;         // Automaton transitions, 256 per state, state 0 is the initial state.
+        std::vector<bool>     _match;        // Indexed by state, true when a pattern ends in this state.
+        ByteBlock             _first_bytes;  // Distinct first bytes of all patterns, if no more than MAX_FIRST_BYTES.
+
+        // Skip bytes which cannot start a pattern. Return end if there is none.
+        const uint8_t* skipToFirstByte(const uint8_t* cur, const uint8_t* end) const;
+    };
+}
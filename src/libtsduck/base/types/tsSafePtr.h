@@ -38,6 +38,7 @@
 #include "tsGuardMutex.h"
 #include "tsMutex.h"
 #include "tsNullMutex.h"
+#include "tsAtomicMutex.h"
 
 namespace ts {
     //!
@@ -82,6 +83,12 @@ namespace ts {
     //!  safe pointers in a multi-thread environment, specify an actual
     //!  mutex implementation for the target environment.
     //!
+    //!  When @a MUTEX is ts::AtomicMutex, the safe pointer is thread-safe but no
+    //!  mutex is used. The reference counter and the pointer are updated using
+    //!  lock-free atomic operations. This is the preferred choice for safe pointers
+    //!  which are frequently copied between threads (sections, messages, etc.)
+    //!  The semantics are identical to ts::Mutex.
+    //!
     //!  @tparam T The type of the pointed object. Cannot be an array type.
     //!  @tparam MUTEX A subclass of ts::MutexInterface which is used to
     //!  synchronize access to the safe pointer internal state.
@@ -340,6 +347,18 @@ namespace ts {
             _shared->reset(p);
         }
 
+        //!
+        //! Exchange the references of two safe pointers.
+        //!
+        //! No reference count is modified and no memory is allocated. All other
+        //! safe pointers which reference the same objects are not affected.
+        //! @param [in,out] sp Another safe pointer to exchange with this one.
+        //!
+        void swap(SafePtr<T,MUTEX>& sp) noexcept
+        {
+            std::swap(_shared, sp._shared);
+        }
+
         //!
         //! Clear this instance of the safe pointer.
         //!
@@ -476,10 +495,31 @@ namespace ts {
         {
             TS_NOBUILD_NOCOPY(SafePtrShared);
         private:
+            // With AtomicMutex, the pointer and reference counter are atomic and no mutex is needed.
+            static constexpr bool IS_ATOMIC = std::is_same<MUTEX, AtomicMutex>::value;
+            typedef typename std::conditional<IS_ATOMIC, std::atomic<T*>, T*>::type PointerType;
+            typedef typename std::conditional<IS_ATOMIC, std::atomic<int>, int>::type CounterType;
+            typedef typename std::conditional<IS_ATOMIC, NullMutex, MUTEX>::type MutexType;
+
             // Private members:
-            T*    _ptr;        // pointer to actual object
-            int   _ref_count;  // reference counter
-            MUTEX _mutex;      // protect the SafePtrShared
+            PointerType _ptr;        // pointer to actual object
+            CounterType _ref_count;  // reference counter
+            MutexType   _mutex;      // protect the SafePtrShared
+
+            // Primitive operations on pointer and counter, overloaded for plain and atomic types.
+            // Plain versions must be called under the protection of the mutex.
+            static T* Exchange(T*& ptr, T* p) { T* previous = ptr; ptr = p; return previous; }
+            static T* Exchange(std::atomic<T*>& ptr, T* p) { return ptr.exchange(p, std::memory_order_acq_rel); }
+            static bool CompareExchange(T*& ptr, T*& expected, T* p) { expected = ptr; ptr = p; return true; }
+            static bool CompareExchange(std::atomic<T*>& ptr, T*& expected, T* p) { return ptr.compare_exchange_weak(expected, p, std::memory_order_acq_rel); }
+            static T* Load(T* ptr) { return ptr; }
+            static T* Load(const std::atomic<T*>& ptr) { return ptr.load(std::memory_order_acquire); }
+            static void Increment(int& count) { ++count; }
+            static void Increment(std::atomic<int>& count) { count.fetch_add(1, std::memory_order_relaxed); }
+            static int Decrement(int& count) { return --count; }
+            static int Decrement(std::atomic<int>& count) { return count.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+            static int Count(const int& count) { return count; }
+            static int Count(const std::atomic<int>& count) { return count.load(std::memory_order_relaxed); }
 
         public:
             // Constructor. Initial reference count is 1.
@@ -512,10 +552,11 @@ namespace ts {
             template <typename ST> SafePtr<ST,MUTEX> downcast()
             {
                 GuardMutex lock(_mutex);
-                ST* sp = dynamic_cast<ST*>(_ptr);
-                if (sp != nullptr) {
-                    // Successful downcast, the original safe pointer must be released.
-                    _ptr = nullptr;
+                T* p = Load(_ptr);
+                ST* sp = nullptr;
+                // On successful downcast, the original safe pointer must be released.
+                // In atomic mode, retry if the pointer was concurrently modified.
+                while ((sp = dynamic_cast<ST*>(p)) != nullptr && !CompareExchange(_ptr, p, nullptr)) {
                 }
                 return SafePtr<ST,MUTEX>(sp);
             }
@@ -524,18 +565,14 @@ namespace ts {
             template <typename ST> SafePtr<ST,MUTEX> upcast()
             {
                 GuardMutex lock(_mutex);
-                ST* sp = _ptr;
-                _ptr = nullptr;
-                return SafePtr<ST,MUTEX>(sp);
+                return SafePtr<ST,MUTEX>(Exchange(_ptr, nullptr));
             }
 
             // Change mutex type.
             template <typename NEWMUTEX> SafePtr<T,NEWMUTEX> changeMutex()
             {
                 GuardMutex lock(_mutex);
-                T* sp = _ptr;
-                _ptr = nullptr;
-                return SafePtr<T,NEWMUTEX>(sp);
+                return SafePtr<T,NEWMUTEX>(Exchange(_ptr, nullptr));
             }
         };
 
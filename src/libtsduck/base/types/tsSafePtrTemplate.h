@@ -94,9 +94,9 @@ ts::SafePtr<T,MUTEX>& ts::SafePtr<T,MUTEX>::operator=(T* p)
 template <typename T, class MUTEX>
 ts::SafePtr<T,MUTEX>::SafePtrShared::~SafePtrShared()
 {
-    if (_ptr != nullptr) {
-        delete _ptr;
-        _ptr = nullptr;
+    T* previous = Exchange(_ptr, nullptr);
+    if (previous != nullptr) {
+        delete previous;
     }
 }
 
@@ -110,9 +110,7 @@ template <typename T, class MUTEX>
 T* ts::SafePtr<T,MUTEX>::SafePtrShared::release()
 {
     GuardMutex lock(_mutex);
-    T* previous = _ptr;
-    _ptr = nullptr;
-    return previous;
+    return Exchange(_ptr, nullptr);
 }
 
 
@@ -123,11 +121,14 @@ T* ts::SafePtr<T,MUTEX>::SafePtrShared::release()
 template <typename T, class MUTEX>
 void ts::SafePtr<T,MUTEX>::SafePtrShared::reset(T* p)
 {
-    GuardMutex lock(_mutex);
-    if (_ptr != nullptr) {
-        delete _ptr;
+    T* previous = nullptr;
+    {
+        GuardMutex lock(_mutex);
+        previous = Exchange(_ptr, p);
+    }
+    if (previous != nullptr) {
+        delete previous;
     }
-    _ptr = p;
 }
 
 
@@ -139,7 +140,7 @@ template <typename T, class MUTEX>
 T* ts::SafePtr<T,MUTEX>::SafePtrShared::pointer()
 {
     GuardMutex lock(_mutex);
-    return _ptr;
+    return Load(_ptr);
 }
 
 
@@ -151,7 +152,7 @@ template <typename T, class MUTEX>
 int ts::SafePtr<T,MUTEX>::SafePtrShared::count()
 {
     GuardMutex lock(_mutex);
-    return _ref_count;
+    return Count(_ref_count);
 }
 
 
@@ -163,7 +164,7 @@ template <typename T, class MUTEX>
 bool ts::SafePtr<T,MUTEX>::SafePtrShared::isNull()
 {
     GuardMutex lock(_mutex);
-    return _ptr == nullptr;
+    return Load(_ptr) == nullptr;
 }
 
 
@@ -175,7 +176,7 @@ template <typename T, class MUTEX>
 typename ts::SafePtr<T,MUTEX>::SafePtrShared* ts::SafePtr<T,MUTEX>::SafePtrShared::attach()
 {
     GuardMutex lock(_mutex);
-    _ref_count++;
+    Increment(_ref_count);
     return this;
 }
 
@@ -191,7 +192,7 @@ bool ts::SafePtr<T,MUTEX>::SafePtrShared::detach()
     int refcount;
     {
         GuardMutex lock(_mutex);
-        refcount = --_ref_count;
+        refcount = Decrement(_ref_count);
     }
     if (refcount == 0) {
         delete this;
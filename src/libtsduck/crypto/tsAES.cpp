@@ -15,9 +15,30 @@
 
 #include "tsAES.h"
 #include "tsRotate.h"
+#include "tsSysInfo.h"
 
 #define BYTE(x,n) (((x) >> (8 * (n))) & 255)
 
+// Accelerated instructions: AES-NI on Intel, Armv8 cryptographic extension on Arm64.
+// They are compiled for the specific target but used only when supported by the CPU at runtime.
+#if (defined(TS_I386) || defined(TS_X86_64)) && defined(TS_MSC)
+    #define TS_AES_INTEL 1
+    #define TS_AES_TARGET
+    #include <immintrin.h>
+#elif (defined(TS_I386) || defined(TS_X86_64)) && (defined(TS_GCC) || defined(TS_LLVM))
+    #define TS_AES_INTEL 1
+    #define TS_AES_TARGET __attribute__((target("aes,sse2")))
+    #include <immintrin.h>
+#elif defined(TS_ARM64) && defined(TS_LLVM)
+    #define TS_AES_ARM64 1
+    #define TS_AES_TARGET __attribute__((target("aes")))
+    #include <arm_neon.h>
+#elif defined(TS_ARM64) && defined(TS_GCC)
+    #define TS_AES_ARM64 1
+    #define TS_AES_TARGET __attribute__((target("+crypto")))
+    #include <arm_neon.h>
+#endif
+
 namespace {
 
     // The precomputed tables for AES:
@@ -1012,6 +1033,178 @@ namespace {
 }
 
 
+//----------------------------------------------------------------------------
+// Accelerated implementation, processing N blocks in parallel to fill the
+// pipeline of the AES instructions. The scheduled keys are the same as the
+// table-based implementation (including the "equivalent inverse cipher" for
+// decryption), in byte order.
+//----------------------------------------------------------------------------
+
+#if defined(TS_AES_INTEL)
+
+namespace {
+    template <size_t N>
+    TS_AES_TARGET void EncryptAccel(const __m128i* rk, int Nr, const uint8_t*& in, uint8_t*& out)
+    {
+        __m128i b[N];
+        for (size_t i = 0; i < N; ++i) {
+            b[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in) + i), rk[0]);
+        }
+        for (int r = 1; r < Nr; ++r) {
+            for (size_t i = 0; i < N; ++i) {
+                b[i] = _mm_aesenc_si128(b[i], rk[r]);
+            }
+        }
+        for (size_t i = 0; i < N; ++i) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + i, _mm_aesenclast_si128(b[i], rk[Nr]));
+        }
+        in += N * ts::AES::BLOCK_SIZE;
+        out += N * ts::AES::BLOCK_SIZE;
+    }
+
+    template <size_t N>
+    TS_AES_TARGET void DecryptAccel(const __m128i* rk, int Nr, const uint8_t*& in, uint8_t*& out)
+    {
+        __m128i b[N];
+        for (size_t i = 0; i < N; ++i) {
+            b[i] = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in) + i), rk[0]);
+        }
+        for (int r = 1; r < Nr; ++r) {
+            for (size_t i = 0; i < N; ++i) {
+                b[i] = _mm_aesdec_si128(b[i], rk[r]);
+            }
+        }
+        for (size_t i = 0; i < N; ++i) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + i, _mm_aesdeclast_si128(b[i], rk[Nr]));
+        }
+        in += N * ts::AES::BLOCK_SIZE;
+        out += N * ts::AES::BLOCK_SIZE;
+    }
+
+    TS_AES_TARGET void ProcessAccel(bool decrypt, const uint8_t* keys, int Nr, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        __m128i rk[ts::AES::MAX_ROUNDS + 1] = {};
+        for (int r = 0; r <= Nr; ++r) {
+            rk[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys) + r);
+        }
+        if (decrypt) {
+            for (; count >= 8; count -= 8) {
+                DecryptAccel<8>(rk, Nr, in, out);
+            }
+            if (count >= 4) {
+                DecryptAccel<4>(rk, Nr, in, out);
+                count -= 4;
+            }
+            for (; count > 0; --count) {
+                DecryptAccel<1>(rk, Nr, in, out);
+            }
+        }
+        else {
+            for (; count >= 8; count -= 8) {
+                EncryptAccel<8>(rk, Nr, in, out);
+            }
+            if (count >= 4) {
+                EncryptAccel<4>(rk, Nr, in, out);
+                count -= 4;
+            }
+            for (; count > 0; --count) {
+                EncryptAccel<1>(rk, Nr, in, out);
+            }
+        }
+    }
+}
+
+#elif defined(TS_AES_ARM64)
+
+namespace {
+    template <size_t N>
+    TS_AES_TARGET void EncryptAccel(const uint8x16_t* rk, int Nr, const uint8_t*& in, uint8_t*& out)
+    {
+        uint8x16_t b[N];
+        for (size_t i = 0; i < N; ++i) {
+            b[i] = vld1q_u8(in + i * ts::AES::BLOCK_SIZE);
+        }
+        for (int r = 0; r < Nr - 1; ++r) {
+            for (size_t i = 0; i < N; ++i) {
+                b[i] = vaesmcq_u8(vaeseq_u8(b[i], rk[r]));
+            }
+        }
+        for (size_t i = 0; i < N; ++i) {
+            vst1q_u8(out + i * ts::AES::BLOCK_SIZE, veorq_u8(vaeseq_u8(b[i], rk[Nr - 1]), rk[Nr]));
+        }
+        in += N * ts::AES::BLOCK_SIZE;
+        out += N * ts::AES::BLOCK_SIZE;
+    }
+
+    template <size_t N>
+    TS_AES_TARGET void DecryptAccel(const uint8x16_t* rk, int Nr, const uint8_t*& in, uint8_t*& out)
+    {
+        uint8x16_t b[N];
+        for (size_t i = 0; i < N; ++i) {
+            b[i] = vld1q_u8(in + i * ts::AES::BLOCK_SIZE);
+        }
+        for (int r = 0; r < Nr - 1; ++r) {
+            for (size_t i = 0; i < N; ++i) {
+                b[i] = vaesimcq_u8(vaesdq_u8(b[i], rk[r]));
+            }
+        }
+        for (size_t i = 0; i < N; ++i) {
+            vst1q_u8(out + i * ts::AES::BLOCK_SIZE, veorq_u8(vaesdq_u8(b[i], rk[Nr - 1]), rk[Nr]));
+        }
+        in += N * ts::AES::BLOCK_SIZE;
+        out += N * ts::AES::BLOCK_SIZE;
+    }
+
+    TS_AES_TARGET void ProcessAccel(bool decrypt, const uint8_t* keys, int Nr, const uint8_t* in, uint8_t* out, size_t count)
+    {
+        uint8x16_t rk[ts::AES::MAX_ROUNDS + 1] = {};
+        for (int r = 0; r <= Nr; ++r) {
+            rk[r] = vld1q_u8(keys + r * ts::AES::BLOCK_SIZE);
+        }
+        if (decrypt) {
+            for (; count >= 8; count -= 8) {
+                DecryptAccel<8>(rk, Nr, in, out);
+            }
+            if (count >= 4) {
+                DecryptAccel<4>(rk, Nr, in, out);
+                count -= 4;
+            }
+            for (; count > 0; --count) {
+                DecryptAccel<1>(rk, Nr, in, out);
+            }
+        }
+        else {
+            for (; count >= 8; count -= 8) {
+                EncryptAccel<8>(rk, Nr, in, out);
+            }
+            if (count >= 4) {
+                EncryptAccel<4>(rk, Nr, in, out);
+                count -= 4;
+            }
+            for (; count > 0; --count) {
+                EncryptAccel<1>(rk, Nr, in, out);
+            }
+        }
+    }
+}
+
+#endif
+
+
+//----------------------------------------------------------------------------
+// Check if AES is implemented using accelerated instructions.
+//----------------------------------------------------------------------------
+
+bool ts::AES::IsAccelerated()
+{
+#if defined(TS_AES_INTEL) || defined(TS_AES_ARM64)
+    return SysInfo::Instance()->aesInstructions();
+#else
+    return false;
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Schedule a new key. If rounds is zero, the default is used.
 //----------------------------------------------------------------------------
@@ -1164,6 +1357,14 @@ bool ts::AES::setKeyImpl(const void* key_, size_t key_length, size_t rounds)
     *rk++ = *rrk++;
     *rk   = *rrk;
 
+    // Byte-order copy of the scheduled keys for accelerated instructions.
+    if (_accel) {
+        for (i = 0; i < 4 * (_Nr + 1); i++) {
+            PutUInt32(_eKb + 4 * i, _eK[i]);
+            PutUInt32(_dKb + 4 * i, _dK[i]);
+        }
+    }
+
     return true;
 }
 
@@ -1181,6 +1382,16 @@ bool ts::AES::encryptImpl(const void* plain, size_t plain_length, void* cipher,
     const uint8_t* pt = reinterpret_cast<const uint8_t*> (plain);
     uint8_t* ct = reinterpret_cast<uint8_t*> (cipher);
 
+#if defined(TS_AES_INTEL) || defined(TS_AES_ARM64)
+    if (_accel) {
+        ProcessAccel(false, _eKb, _Nr, pt, ct, 1);
+        if (cipher_length != nullptr) {
+            *cipher_length = BLOCK_SIZE;
+        }
+        return true;
+    }
+#endif
+
     uint32_t s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
@@ -1306,6 +1517,16 @@ bool ts::AES::decryptImpl(const void* cipher, size_t cipher_length, void* plain,
     const uint8_t* ct = reinterpret_cast<const uint8_t*> (cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*> (plain);
 
+#if defined(TS_AES_INTEL) || defined(TS_AES_ARM64)
+    if (_accel) {
+        ProcessAccel(true, _dKb, _Nr, ct, pt, 1);
+        if (plain_length != nullptr) {
+            *plain_length = BLOCK_SIZE;
+        }
+        return true;
+    }
+#endif
+
     uint32_t s0, s1, s2, s3, t0, t1, t2, t3, *rk;
     int Nr, r;
 
@@ -1419,6 +1640,49 @@ bool ts::AES::decryptImpl(const void* cipher, size_t cipher_length, void* plain,
 }
 
 
+//----------------------------------------------------------------------------
+// Encryption and decryption of several blocks in ECB mode.
+//----------------------------------------------------------------------------
+
+bool ts::AES::encryptBlocksImpl(const void* plain, void* cipher, size_t count)
+{
+    const uint8_t* pt = reinterpret_cast<const uint8_t*>(plain);
+    uint8_t* ct = reinterpret_cast<uint8_t*>(cipher);
+
+#if defined(TS_AES_INTEL) || defined(TS_AES_ARM64)
+    if (_accel) {
+        ProcessAccel(false, _eKb, _Nr, pt, ct, count);
+        return true;
+    }
+#endif
+
+    // The table-based implementation reads the input block before writing the output one.
+    for (; count > 0; --count, pt += BLOCK_SIZE, ct += BLOCK_SIZE) {
+        encryptImpl(pt, BLOCK_SIZE, ct, BLOCK_SIZE, nullptr);
+    }
+    return true;
+}
+
+bool ts::AES::decryptBlocksImpl(const void* cipher, void* plain, size_t count)
+{
+    const uint8_t* ct = reinterpret_cast<const uint8_t*>(cipher);
+    uint8_t* pt = reinterpret_cast<uint8_t*>(plain);
+
+#if defined(TS_AES_INTEL) || defined(TS_AES_ARM64)
+    if (_accel) {
+        ProcessAccel(true, _dKb, _Nr, ct, pt, count);
+        return true;
+    }
+#endif
+
+    // The table-based implementation reads the input block before writing the output one.
+    for (; count > 0; --count, ct += BLOCK_SIZE, pt += BLOCK_SIZE) {
+        decryptImpl(ct, BLOCK_SIZE, pt, BLOCK_SIZE, nullptr);
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Constructor
 //----------------------------------------------------------------------------
@@ -1426,7 +1690,10 @@ bool ts::AES::decryptImpl(const void* cipher, size_t cipher_length, void* plain,
 ts::AES::AES() :
     _Nr(0),
     _eK(),
-    _dK()
+    _dK(),
+    _accel(IsAccelerated()),
+    _eKb(),
+    _dKb()
 {
 }
 
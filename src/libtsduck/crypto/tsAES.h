@@ -52,6 +52,14 @@ namespace ts {
         static constexpr size_t MAX_ROUNDS = 14;      //!< AES maximum number of rounds.
         static constexpr size_t DEFAULT_ROUNDS = 10;  //!< AES default number of rounds, actually depends on key size.
 
+        //!
+        //! Check if AES is implemented using accelerated instructions on this system.
+        //! These are the AES-NI instructions on Intel and the Armv8 cryptographic extension on Arm64.
+        //! @return True if AES is implemented using accelerated instructions.
+        //! @see SysInfo::aesInstructions()
+        //!
+        static bool IsAccelerated();
+
         // Implementation of BlockCipher interface:
         virtual UString name() const override;
         virtual size_t blockSize() const override;
@@ -67,10 +75,15 @@ namespace ts {
         virtual bool setKeyImpl(const void* key, size_t key_length, size_t rounds) override;
         virtual bool encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length) override;
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+        virtual bool encryptBlocksImpl(const void* plain, void* cipher, size_t count) override;
+        virtual bool decryptBlocksImpl(const void* cipher, void* plain, size_t count) override;
 
     private:
-        int      _Nr;     //!< Number of rounds
-        uint32_t _eK[60]; //!< Scheduled encryption keys
-        uint32_t _dK[60]; //!< Scheduled decryption keys
+        int      _Nr;       //!< Number of rounds
+        uint32_t _eK[60];   //!< Scheduled encryption keys
+        uint32_t _dK[60];   //!< Scheduled decryption keys
+        bool     _accel;    //!< Use accelerated instructions
+        uint8_t  _eKb[240]; //!< Scheduled encryption keys in byte order, for accelerated instructions
+        uint8_t  _dKb[240]; //!< Scheduled decryption keys in byte order, for accelerated instructions
     };
 }
@@ -80,7 +80,7 @@ bool ts::BlockCipher::setKey(const void* key, size_t key_length, size_t rounds)
 // Check if encryption or decryption is allowed. Increment counters.
 //----------------------------------------------------------------------------
 
-bool ts::BlockCipher::allowEncrypt()
+bool ts::BlockCipher::allowEncrypt(size_t blocks)
 {
     // Check that a key was successfully set.
     if (!_key_set) {
@@ -88,7 +88,7 @@ bool ts::BlockCipher::allowEncrypt()
     }
 
     // Check encryption limitations.
-    if (_key_encrypt_count >= _key_encrypt_max &&
+    if ((_key_encrypt_count >= _key_encrypt_max || blocks > _key_encrypt_max - _key_encrypt_count) &&
         (_alert == nullptr || _alert->handleBlockCipherAlert(*this, BlockCipherAlertInterface::ENCRYPTION_EXCEEDED)))
     {
         // Disallow encryption if no handler present or handler did not cancel the alert.
@@ -102,11 +102,11 @@ bool ts::BlockCipher::allowEncrypt()
     }
 
     // Encryption allowed.
-    _key_encrypt_count++;
+    _key_encrypt_count += blocks;
     return true;
 }
 
-bool ts::BlockCipher::allowDecrypt()
+bool ts::BlockCipher::allowDecrypt(size_t blocks)
 {
     // Check that a key was successfully set.
     if (!_key_set) {
@@ -114,7 +114,7 @@ bool ts::BlockCipher::allowDecrypt()
     }
 
     // Check decryption limitations.
-    if (_key_decrypt_count >= _key_decrypt_max &&
+    if ((_key_decrypt_count >= _key_decrypt_max || blocks > _key_decrypt_max - _key_decrypt_count) &&
         (_alert == nullptr || _alert->handleBlockCipherAlert(*this, BlockCipherAlertInterface::DECRYPTION_EXCEEDED)))
     {
         // Disallow decryption if no handler present or handler did not cancel the alert.
@@ -128,7 +128,7 @@ bool ts::BlockCipher::allowDecrypt()
     }
 
     // Decryption allowed.
-    _key_decrypt_count++;
+    _key_decrypt_count += blocks;
     return true;
 }
 
@@ -185,3 +185,61 @@ bool ts::BlockCipher::decryptInPlaceImpl(void* data, size_t data_length, size_t*
     const size_t plain_max_size = max_actual_length != nullptr ? *max_actual_length : data_length;
     return decryptImpl(cipher.data(), cipher.size(), data, plain_max_size, max_actual_length);
 }
+
+
+//----------------------------------------------------------------------------
+// Encrypt a sequence of independent blocks of data.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::encryptBlocks(const void* plain, void* cipher, size_t count)
+{
+    return allowEncrypt(count) && encryptBlocksImpl(plain, cipher, count);
+}
+
+bool ts::BlockCipher::encryptBlocksImpl(const void* plain, void* cipher, size_t count)
+{
+    const size_t bsize = blockSize();
+    const uint8_t* pt = reinterpret_cast<const uint8_t*>(plain);
+    uint8_t* ct = reinterpret_cast<uint8_t*>(cipher);
+
+    // Encrypt through an intermediate block when input and output are identical.
+    ByteBlock work(pt == ct ? bsize : 0);
+    for (; count > 0; --count, pt += bsize, ct += bsize) {
+        if (pt == ct) {
+            work.copy(pt, bsize);
+        }
+        if (!encryptImpl(pt == ct ? work.data() : pt, bsize, ct, bsize, nullptr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Decrypt a sequence of independent blocks of data.
+//----------------------------------------------------------------------------
+
+bool ts::BlockCipher::decryptBlocks(const void* cipher, void* plain, size_t count)
+{
+    return allowDecrypt(count) && decryptBlocksImpl(cipher, plain, count);
+}
+
+bool ts::BlockCipher::decryptBlocksImpl(const void* cipher, void* plain, size_t count)
+{
+    const size_t bsize = blockSize();
+    const uint8_t* ct = reinterpret_cast<const uint8_t*>(cipher);
+    uint8_t* pt = reinterpret_cast<uint8_t*>(plain);
+
+    // Decrypt through an intermediate block when input and output are identical.
+    ByteBlock work(ct == pt ? bsize : 0);
+    for (; count > 0; --count, ct += bsize, pt += bsize) {
+        if (ct == pt) {
+            work.copy(ct, bsize);
+        }
+        if (!decryptImpl(ct == pt ? work.data() : ct, bsize, pt, bsize, nullptr)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -189,6 +189,38 @@ namespace ts {
         //!
         bool decryptInPlace(void* data, size_t data_length, size_t* max_actual_length = nullptr);
 
+        //!
+        //! Encrypt a sequence of independent blocks of data (ECB mode).
+        //!
+        //! This is equivalent to calling encrypt() on each block but a subclass may
+        //! process several blocks in parallel. Each block counts as one use of the key
+        //! in encryptionCount(). When the sequence would exceed the maximum number of encryptions,
+        //! no block is encrypted.
+        //!
+        //! @param [in] plain Address of plain text. The size is @a count times blockSize().
+        //! @param [out] cipher Address of buffer for cipher text. The size is @a count times blockSize().
+        //! The cipher text buffer may be identical to the plain text buffer but shall not partially overlap.
+        //! @param [in] count Number of blocks to encrypt.
+        //! @return True on success, false on error.
+        //!
+        bool encryptBlocks(const void* plain, void* cipher, size_t count);
+
+        //!
+        //! Decrypt a sequence of independent blocks of data (ECB mode).
+        //!
+        //! This is equivalent to calling decrypt() on each block but a subclass may
+        //! process several blocks in parallel. Each block counts as one use of the key
+        //! in decryptionCount(). When the sequence would exceed the maximum number of decryptions,
+        //! no block is decrypted.
+        //!
+        //! @param [in] cipher Address of cipher text. The size is @a count times blockSize().
+        //! @param [out] plain Address of buffer for plain text. The size is @a count times blockSize().
+        //! The plain text buffer may be identical to the cipher text buffer but shall not partially overlap.
+        //! @param [in] count Number of blocks to decrypt.
+        //! @return True on success, false on error.
+        //!
+        bool decryptBlocks(const void* cipher, void* plain, size_t count);
+
         //!
         //! Get the number of times the current key was used for encryption.
         //! @return The number of times the current key was used for encryption.
@@ -314,6 +346,46 @@ namespace ts {
         //!
         virtual bool decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length);
 
+        //!
+        //! Encrypt a sequence of independent blocks of data (implementation of algorithm-specific part).
+        //! The default implementation is to call encryptImpl() on each block.
+        //! A subclass may provide a more efficient implementation.
+        //! @param [in] plain Address of plain text.
+        //! @param [out] cipher Address of buffer for cipher text, possibly identical to @a plain.
+        //! @param [in] count Number of blocks to encrypt.
+        //! @return True on success, false on error.
+        //!
+        virtual bool encryptBlocksImpl(const void* plain, void* cipher, size_t count);
+
+        //!
+        //! Decrypt a sequence of independent blocks of data (implementation of algorithm-specific part).
+        //! The default implementation is to call decryptImpl() on each block.
+        //! A subclass may provide a more efficient implementation.
+        //! @param [in] cipher Address of cipher text.
+        //! @param [out] plain Address of buffer for plain text, possibly identical to @a cipher.
+        //! @param [in] count Number of blocks to decrypt.
+        //! @return True on success, false on error.
+        //!
+        virtual bool decryptBlocksImpl(const void* cipher, void* plain, size_t count);
+
+        //!
+        //! Check if encryption is allowed with the current key and increment the usage counter.
+        //! This is automatically done by encrypt() and encryptInPlace(). A subclass which
+        //! provides additional encryption methods shall call it once per encrypted data block.
+        //! @param [in] blocks Number of data blocks to encrypt at once.
+        //! @return True if encryption is allowed, false otherwise.
+        //!
+        bool allowEncrypt(size_t blocks = 1);
+
+        //!
+        //! Check if decryption is allowed with the current key and increment the usage counter.
+        //! This is automatically done by decrypt() and decryptInPlace(). A subclass which
+        //! provides additional decryption methods shall call it once per decrypted data block.
+        //! @param [in] blocks Number of data blocks to decrypt at once.
+        //! @return True if decryption is allowed, false otherwise.
+        //!
+        bool allowDecrypt(size_t blocks = 1);
+
     private:
         bool      _key_set;                // Current key successfully set.
         int       _cipher_id;              // Cipher identity (from application).
@@ -323,9 +395,5 @@ namespace ts {
         size_t    _key_decrypt_max;        // Maximum number of times a key should be used for decryption.
         ByteBlock _current_key;            // Current unscheduled key.
         BlockCipherAlertInterface* _alert; // Alert handler.
-
-        // Check if encryption or decryption is allowed. Increment counters.
-        bool allowEncrypt();
-        bool allowDecrypt();
     };
 }
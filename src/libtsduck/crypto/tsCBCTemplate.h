@@ -33,6 +33,7 @@
 //----------------------------------------------------------------------------
 
 #pragma once
+#include "tsMemory.h"
 
 
 //----------------------------------------------------------------------------
@@ -88,7 +89,7 @@ bool ts::CBC<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
 {
     if (this->algo == nullptr ||
         this->iv.size() != this->block_size ||
-        this->work.size() < this->block_size ||
+        this->work.size() < 2 * this->block_size ||
         cipher_length % this->block_size != 0 ||
         plain_maxsize < cipher_length)
     {
@@ -98,28 +99,9 @@ bool ts::CBC<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
         *plain_length = cipher_length;
     }
 
-    const uint8_t* previous = this->iv.data();
-    const uint8_t* ct = reinterpret_cast<const uint8_t*> (cipher);
-    uint8_t* pt = reinterpret_cast<uint8_t*> (plain);
-
-    while (cipher_length > 0) {
-        // work = decrypt (cipher-text)
-        if (!this->algo->decrypt(ct, this->block_size, this->work.data(), this->block_size)) {
-            return false;
-        }
-        // plain-text = previous-cipher XOR work
-        for (size_t i = 0; i < this->block_size; ++i) {
-            pt[i] = previous[i] ^ this->work[i];
-        }
-        // previous-cipher = cipher-text
-        previous = ct;
-        // advance one block
-        ct += this->block_size;
-        pt += this->block_size;
-        cipher_length -= this->block_size;
-    }
-
-    return true;
+    // Unlike encryption, all blocks can be decrypted in parallel, by batches.
+    ::memcpy(this->work.data(), this->iv.data(), this->block_size);
+    return this->decryptBlocksCBC(reinterpret_cast<const uint8_t*>(cipher), reinterpret_cast<uint8_t*>(plain), cipher_length / this->block_size);
 }
 
 
@@ -144,3 +126,21 @@ ts::UString ts::CBC<CIPHER>::name() const
 {
     return this->algo == nullptr ? UString() : this->algo->name() + u"-CBC";
 }
+
+
+//----------------------------------------------------------------------------
+// Encryption and decryption in place: the CBC mode already supports
+// identical plain and cipher text buffers, no need for an intermediate copy.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::CBC<CIPHER>::encryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length)
+{
+    return encryptImpl(data, data_length, data, max_actual_length != nullptr ? *max_actual_length : data_length, max_actual_length);
+}
+
+template<class CIPHER>
+bool ts::CBC<CIPHER>::decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length)
+{
+    return decryptImpl(data, data_length, data, max_actual_length != nullptr ? *max_actual_length : data_length, max_actual_length);
+}
@@ -83,13 +83,15 @@ namespace ts {
         // Implementation of BlockCipher interface.
         virtual bool encryptImpl(const void* plain, size_t plain_length, void* cipher, size_t cipher_maxsize, size_t* cipher_length) override;
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize, size_t* plain_length) override;
+        virtual bool encryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length) override;
+        virtual bool decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length) override;
 
     private:
         size_t _counter_bits; // size in bits of the counter part.
 
-        // We need two work blocks.
+        // We need 1 + N work blocks.
         // The first one contains the "input block" or counter.
-        // The second one contains the "output block", the encrypted counter.
+        // The next N ones contain the successive counter values, encrypted in one batch.
         // This private method increments the counter block.
         bool incrementCounter();
     };
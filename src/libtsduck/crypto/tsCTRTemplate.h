@@ -37,7 +37,7 @@
 
 template<class CIPHER>
 ts::CTR<CIPHER>::CTR(size_t counter_bits) :
-    CipherChainingTemplate<CIPHER>(1, 1, 2),
+    CipherChainingTemplate<CIPHER>(1, 1, 1 + CipherChaining::BATCH_BLOCKS),
     _counter_bits(0)
 {
     setCounterBits(counter_bits);
@@ -133,27 +133,38 @@ bool ts::CTR<CIPHER>::encryptImpl(const void* plain, size_t plain_length, void*
     // work[0] = iv
     ::memcpy(this->work.data(), this->iv.data(), this->block_size);
 
-    // Loop on all blocks, including last truncated one.
+    // Number of blocks which are encrypted in one batch.
+    uint8_t* const batch = this->work.data() + this->block_size;
+    const size_t batch_max = this->work.size() / this->block_size - 1;
 
+    // Loop on all batches of blocks, including last truncated one.
     const uint8_t* pt = reinterpret_cast<const uint8_t*>(plain);
     uint8_t* ct = reinterpret_cast<uint8_t*>(cipher);
-
     while (plain_length > 0) {
-        // work[1] = encrypt(work[0])
-        if (!this->algo->encrypt(this->work.data(), this->block_size, this->work.data() + this->block_size, this->block_size)) {
+
+        // work[1..count] = successive values of work[0]
+        const size_t count = std::min(batch_max, (plain_length + this->block_size - 1) / this->block_size);
+        for (size_t blk = 0; blk < count; ++blk) {
+            ::memcpy(batch + blk * this->block_size, this->work.data(), this->block_size);
+            if (!incrementCounter()) {
+                return false;
+            }
+        }
+
+        // work[1..count] = encrypt(work[1..count])
+        if (!this->algo->encryptBlocks(batch, batch, count)) {
             return false;
         }
-        // This block size:
-        const size_t size = std::min(plain_length, this->block_size);
-        // cipher-text = plain-text XOR work[1]
+
+        // This batch size:
+        const size_t size = std::min(plain_length, count * this->block_size);
+
+        // cipher-text = plain-text XOR work[1..count]
         for (size_t i = 0; i < size; ++i) {
-            ct[i] = this->work[this->block_size + i] ^ pt[i];
+            ct[i] = batch[i] ^ pt[i];
         }
-        // work[0] += 1
-        if (!incrementCounter()) {
-            return false;
-        }
-        // advance one block
+
+        // advance the batch of blocks
         ct += size;
         pt += size;
         plain_length -= size;
@@ -172,3 +183,21 @@ bool ts::CTR<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, void
     // With CTR, the encryption and decryption are identical operations.
     return this->encryptImpl(cipher, cipher_length, plain, plain_maxsize, plain_length);
 }
+
+
+//----------------------------------------------------------------------------
+// Encryption and decryption in place: the CTR mode already supports
+// identical plain and cipher text buffers, no need for an intermediate copy.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::CTR<CIPHER>::encryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length)
+{
+    return encryptImpl(data, data_length, data, max_actual_length != nullptr ? *max_actual_length : data_length, max_actual_length);
+}
+
+template<class CIPHER>
+bool ts::CTR<CIPHER>::decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length)
+{
+    return decryptImpl(data, data_length, data, max_actual_length != nullptr ? *max_actual_length : data_length, max_actual_length);
+}
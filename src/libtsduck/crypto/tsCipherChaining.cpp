@@ -28,6 +28,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsCipherChaining.h"
+#include "tsMemory.h"
 
 
 //----------------------------------------------------------------------------
@@ -124,3 +125,49 @@ bool ts::CipherChaining::setIV(const void* iv_data, size_t iv_length)
         return true;
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Decrypt a sequence of complete blocks in CBC mode, by batches of blocks.
+//----------------------------------------------------------------------------
+
+bool ts::CipherChaining::decryptBlocksCBC(const uint8_t* cipher, uint8_t* plain, size_t count)
+{
+    if (algo == nullptr || work.size() < 2 * block_size) {
+        return false;
+    }
+
+    // work[0] = previous cipher block, work[1..batch_max] = decrypted blocks.
+    uint8_t* const previous = work.data();
+    uint8_t* const batch = work.data() + block_size;
+    const size_t batch_max = work.size() / block_size - 1;
+
+    while (count > 0) {
+        const size_t blocks = std::min(batch_max, count);
+        const size_t size = blocks * block_size;
+
+        // work[1..blocks] = decrypt(cipher-text)
+        if (!algo->decryptBlocks(cipher, batch, blocks)) {
+            return false;
+        }
+
+        // First block: work[1] ^= previous-cipher
+        for (size_t i = 0; i < block_size; ++i) {
+            batch[i] ^= previous[i];
+        }
+
+        // Save last cipher block of the batch for the next one.
+        ::memcpy(previous, cipher + size - block_size, block_size);
+
+        // Other blocks, backward, so that the cipher text can be overwritten by the plain text.
+        for (size_t i = size; i-- > block_size; ) {
+            plain[i] = cipher[i - block_size] ^ batch[i];
+        }
+        ::memcpy(plain, batch, block_size);
+
+        cipher += size;
+        plain += size;
+        count -= blocks;
+    }
+    return true;
+}
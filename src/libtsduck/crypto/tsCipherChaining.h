@@ -100,6 +100,12 @@ namespace ts {
         ByteBlock    iv;          //!< Current initialization vector.
         ByteBlock    work;        //!< Temporary working buffer.
 
+        //!
+        //! Number of blocks which are encrypted or decrypted in one batch by the chaining
+        //! modes which can process independent blocks in parallel.
+        //!
+        static constexpr size_t BATCH_BLOCKS = 16;
+
         //!
         //! Constructor for subclasses.
         //! @param [in,out] cipher An instance of block cipher.
@@ -112,6 +118,17 @@ namespace ts {
                        size_t iv_max_blocks = 1,
                        size_t work_blocks = 1);
 
+        //!
+        //! Decrypt a sequence of complete blocks in CBC mode, by batches of blocks.
+        //! The work buffer must contain at least 2 blocks. On input, the first block of the
+        //! work buffer contains the IV. On output, it contains the last cipher block.
+        //! @param [in] cipher Address of cipher text.
+        //! @param [out] plain Address of buffer for plain text, possibly identical to @a cipher.
+        //! @param [in] count Number of blocks to decrypt.
+        //! @return True on success, false on error.
+        //!
+        bool decryptBlocksCBC(const uint8_t* cipher, uint8_t* plain, size_t count);
+
         // Implementation of BlockCipher interface:
         virtual bool setKeyImpl(const void* key, size_t key_length, size_t rounds) override;
     };
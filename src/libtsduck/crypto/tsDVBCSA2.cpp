@@ -28,6 +28,11 @@ TS_LLVM_NOWARNING(cast-align) // Because of casts to uint64_ptr
 
 #define MAX_NBLOCKS (184 / 8)
 
+// Minimum number of data blocks to use the bitsliced stream cipher.
+// Smaller batches are faster to decrypt one by one.
+
+#define MIN_BATCH_SIZE 20
+
 
 //----------------------------------------------------------------------------
 // Manually perform entropy reduction on a control word.
@@ -86,49 +91,49 @@ namespace {
     // reg q,           1 bit
     // reg r,           1 bit
 
-    const int sbox1[32] = {
+    constexpr int sbox1[32] = {
         2,0,1,1,2,3,3,0,
         3,2,2,0,1,1,0,3,
         0,3,3,0,2,2,1,1,
         2,2,0,3,1,1,3,0
     };
 
-    const int sbox2[32] = {
+    constexpr int sbox2[32] = {
         3,1,0,2,2,3,3,0,
         1,3,2,1,0,0,1,2,
         3,1,0,3,3,2,0,2,
         0,0,1,2,2,1,3,1
     };
 
-    const int sbox3[32] = {
+    constexpr int sbox3[32] = {
         2,0,1,2,2,3,3,1,
         1,1,0,3,3,0,2,0,
         1,3,0,1,3,0,2,2,
         2,0,1,2,0,3,3,1
     };
 
-    const int sbox4[32] = {
+    constexpr int sbox4[32] = {
         3,1,2,3,0,2,1,2,
         1,2,0,1,3,0,0,3,
         1,0,3,1,2,3,0,3,
         0,3,2,0,1,2,2,1
     };
 
-    const int sbox5[32] = {
+    constexpr int sbox5[32] = {
         2,0,0,1,3,2,3,2,
         0,1,3,3,1,0,2,1,
         2,3,2,0,0,3,1,1,
         1,0,3,2,3,1,0,2
     };
 
-    const int sbox6[32] = {
+    constexpr int sbox6[32] = {
         0,1,2,3,1,2,2,0,
         0,1,3,0,2,3,1,3,
         2,3,0,2,3,0,1,1,
         2,1,1,2,0,3,3,0
     };
 
-    const int sbox7[32] = {
+    constexpr int sbox7[32] = {
         0,3,2,2,3,0,0,1,
         3,0,1,3,1,2,2,1,
         1,0,3,3,0,1,1,2,
@@ -332,6 +337,281 @@ void ts::DVBCSA2::StreamCipher::cipher(const uint8_t* sb, uint8_t *cb)
 }
 
 
+//----------------------------------------------------------------------------
+// Bitsliced stream cipher, used in batch decryption.
+//
+// In a bitsliced implementation, each bit of each register of the stream
+// cipher is stored in a separate "bitslice word". Bit n of this word is the
+// value of the register bit for the data block n in the batch. All data
+// blocks are processed in parallel, using logical operations only. The
+// s-boxes are evaluated as boolean functions, from their truth tables.
+//----------------------------------------------------------------------------
+
+namespace {
+
+#if (defined(TS_GCC) || defined(TS_LLVM)) && (defined(TS_X86_64) || defined(TS_ARM64))
+    // Use 128-bit SIMD registers (SSE2 or Neon) through compiler vector extensions.
+    typedef uint64_t BsWord __attribute__((vector_size(16)));
+    inline BsWord BsFill(uint64_t v) { return BsWord{v, v}; }
+    inline uint64_t BsGetLane(const BsWord& w, size_t lane) { return w[lane]; }
+    inline void BsSetLane(BsWord& w, size_t lane, uint64_t v) { w[lane] = v; }
+#else
+    // Portable version, 64 data blocks in parallel.
+    typedef uint64_t BsWord;
+    inline BsWord BsFill(uint64_t v) { return v; }
+    inline uint64_t BsGetLane(const BsWord& w, size_t) { return w; }
+    inline void BsSetLane(BsWord& w, size_t, uint64_t v) { w = v; }
+#endif
+
+    // Number of 64-bit lanes in a bitslice word and number of data blocks in a batch.
+    constexpr size_t BS_LANES = sizeof(BsWord) / sizeof(uint64_t);
+    constexpr size_t BS_WIDTH = 64 * BS_LANES;
+
+    // Bitslice word with the same bit value for all data blocks.
+    inline BsWord BsBit(int value, size_t bit)
+    {
+        return BsFill(((value >> bit) & 1) != 0 ? ~uint64_t(0) : 0);
+    }
+
+    // Select a when sel is set, b otherwise.
+    inline BsWord BsSelect(const BsWord& sel, const BsWord& a, const BsWord& b)
+    {
+        return b ^ (sel & (a ^ b));
+    }
+
+    // Truth table of one output bit of an s-box: bit i of the result is bit 'bit' of sbox[i].
+    constexpr uint32_t TruthTable(const int* sbox, int bit, int i = 0)
+    {
+        return i >= 32 ? 0 : (uint32_t((sbox[i] >> bit) & 1) << i) | TruthTable(sbox, bit, i + 1);
+    }
+
+    // Boolean function of N inputs with truth table TT, evaluated as a tree of multiplexers.
+    // x[N-1] is the most significant bit of the index in the truth table. Inputs without
+    // influence on the result are eliminated at compile time.
+    template <uint32_t TT, int N, bool SAME_HALVES> struct BsFunctionSplit;
+
+    template <uint32_t TT, int N>
+    struct BsFunction
+    {
+        static constexpr uint32_t HALF = uint32_t(1) << (N - 1);
+        static constexpr uint32_t LOW = TT & ((uint32_t(1) << HALF) - 1);
+        static constexpr uint32_t HIGH = (TT >> HALF) & ((uint32_t(1) << HALF) - 1);
+        static BsWord eval(const BsWord* x) { return BsFunctionSplit<TT, N, LOW == HIGH>::eval(x); }
+    };
+
+    template <uint32_t TT>
+    struct BsFunction<TT, 0>
+    {
+        static BsWord eval(const BsWord*) { return BsBit(int(TT), 0); }
+    };
+
+    template <uint32_t TT, int N>
+    struct BsFunctionSplit<TT, N, true>
+    {
+        static BsWord eval(const BsWord* x) { return BsFunction<BsFunction<TT, N>::LOW, N - 1>::eval(x); }
+    };
+
+    template <uint32_t TT, int N>
+    struct BsFunctionSplit<TT, N, false>
+    {
+        static BsWord eval(const BsWord* x)
+        {
+            return BsSelect(x[N - 1], BsFunction<BsFunction<TT, N>::HIGH, N - 1>::eval(x), BsFunction<BsFunction<TT, N>::LOW, N - 1>::eval(x));
+        }
+    };
+
+    // Evaluate the two output bits of an s-box.
+    template <const int* SBOX>
+    inline void BsSbox(const BsWord* x, BsWord& out1, BsWord& out0)
+    {
+        out1 = BsFunction<TruthTable(SBOX, 1), 5>::eval(x);
+        out0 = BsFunction<TruthTable(SBOX, 0), 5>::eval(x);
+    }
+
+    // Bitsliced stream cipher. Same algorithm as DVBCSA2::StreamCipher.
+    // Registers are arrays of bits, least significant bit first.
+    class BsStreamCipher
+    {
+    public:
+        void init(const uint8_t* key);
+        // Bit b of byte i of the 8-byte block is in word 8*i+b of sb and cb.
+        void cipher(const BsWord* sb, BsWord* cb);
+    private:
+        BsWord A[11][4];
+        BsWord B[11][4];
+        BsWord X[4];
+        BsWord Y[4];
+        BsWord Z[4];
+        BsWord D[4];
+        BsWord E[4];
+        BsWord F[4];
+        BsWord p;
+        BsWord q;
+        BsWord r;
+    };
+
+    void BsStreamCipher::init(const uint8_t* key)
+    {
+        // Same control word for all data blocks.
+        for (size_t i = 0; i < 4; ++i) {
+            for (size_t b = 0; b < 4; ++b) {
+                A[2*i+1][b] = BsBit(key[i], b + 4);
+                A[2*i+2][b] = BsBit(key[i], b);
+                B[2*i+1][b] = BsBit(key[i+4], b + 4);
+                B[2*i+2][b] = BsBit(key[i+4], b);
+            }
+        }
+        const BsWord zero = BsFill(0);
+        for (size_t b = 0; b < 4; ++b) {
+            A[0][b] = A[9][b] = A[10][b] = zero;
+            B[0][b] = B[9][b] = B[10][b] = zero;
+            X[b] = Y[b] = Z[b] = D[b] = E[b] = F[b] = zero;
+        }
+        p = q = r = zero;
+    }
+
+    void BsStreamCipher::cipher(const BsWord* sb, BsWord* cb)
+    {
+        const bool init = sb != nullptr;
+
+        // 8 bytes per operation
+        for (size_t i = 0; i < 8; i++) {
+            // Most and least significant nibbles of input byte.
+            const BsWord* const in1 = init ? sb + 8*i + 4 : nullptr;
+            const BsWord* const in2 = init ? sb + 8*i : nullptr;
+
+            // 2 bits per iteration
+            for (size_t j = 0; j < 4; j++) {
+                // S-boxes inputs, least significant bit first.
+                const BsWord x1[5] = {A[9][0], A[7][3], A[6][1], A[1][2], A[4][0]};
+                const BsWord x2[5] = {A[9][1], A[7][0], A[6][3], A[3][2], A[2][1]};
+                const BsWord x3[5] = {A[6][2], A[5][3], A[5][1], A[2][0], A[1][3]};
+                const BsWord x4[5] = {A[8][0], A[4][2], A[2][3], A[1][1], A[3][3]};
+                const BsWord x5[5] = {A[9][2], A[8][1], A[6][0], A[4][3], A[5][2]};
+                const BsWord x6[5] = {A[9][3], A[7][2], A[5][0], A[4][1], A[3][1]};
+                const BsWord x7[5] = {A[8][3], A[8][2], A[7][1], A[3][0], A[2][2]};
+                BsWord s1[2], s2[2], s3[2], s4[2], s5[2], s6[2], s7[2];
+                BsSbox<sbox1>(x1, s1[1], s1[0]);
+                BsSbox<sbox2>(x2, s2[1], s2[0]);
+                BsSbox<sbox3>(x3, s3[1], s3[0]);
+                BsSbox<sbox4>(x4, s4[1], s4[0]);
+                BsSbox<sbox5>(x5, s5[1], s5[0]);
+                BsSbox<sbox6>(x6, s6[1], s6[0]);
+                BsSbox<sbox7>(x7, s7[1], s7[0]);
+
+                // Extra nibble for T3.
+                const BsWord extra_B[4] = {
+                    B[9][2] ^ B[6][3] ^ B[3][1] ^ B[8][0],
+                    B[5][3] ^ B[8][2] ^ B[4][0] ^ B[5][1],
+                    B[6][0] ^ B[8][1] ^ B[3][3] ^ B[4][2],
+                    B[3][0] ^ B[6][1] ^ B[7][2] ^ B[9][3]
+                };
+
+                // T1 and T2, in1, in2 and D are used during initialisation only.
+                BsWord next_A1[4];
+                BsWord next_B1[4];
+                for (size_t b = 0; b < 4; ++b) {
+                    next_A1[b] = A[10][b] ^ X[b];
+                    next_B1[b] = B[7][b] ^ B[10][b] ^ Y[b];
+                    if (init) {
+                        next_A1[b] ^= D[b] ^ ((j % 2) ? in2[b] : in1[b]);
+                        next_B1[b] ^= (j % 2) ? in1[b] : in2[b];
+                    }
+                }
+
+                // If p=1, rotate next_B1 left.
+                const BsWord rot_B1[4] = {next_B1[3], next_B1[0], next_B1[1], next_B1[2]};
+                for (size_t b = 0; b < 4; ++b) {
+                    next_B1[b] = BsSelect(p, rot_B1[b], next_B1[b]);
+                }
+
+                // T3 = xor all inputs
+                for (size_t b = 0; b < 4; ++b) {
+                    D[b] = E[b] ^ Z[b] ^ extra_B[b];
+                }
+
+                // T4 = if q=1, sum and carry of Z + E + r, otherwise E (and r unchanged).
+                BsWord carry = r;
+                for (size_t b = 0; b < 4; ++b) {
+                    const BsWord sum = Z[b] ^ E[b] ^ carry;
+                    carry = (Z[b] & E[b]) | (carry & (Z[b] ^ E[b]));
+                    const BsWord next_E = F[b];
+                    F[b] = BsSelect(q, sum, E[b]);
+                    E[b] = next_E;
+                }
+                r = BsSelect(q, carry, r);
+
+                // Shift registers.
+                for (size_t k = 10; k > 1; --k) {
+                    for (size_t b = 0; b < 4; ++b) {
+                        A[k][b] = A[k-1][b];
+                        B[k][b] = B[k-1][b];
+                    }
+                }
+                for (size_t b = 0; b < 4; ++b) {
+                    A[1][b] = next_A1[b];
+                    B[1][b] = next_B1[b];
+                }
+
+                X[0] = s1[1]; X[1] = s2[1]; X[2] = s3[0]; X[3] = s4[0];
+                Y[0] = s3[1]; Y[1] = s4[1]; Y[2] = s5[0]; Y[3] = s6[0];
+                Z[0] = s5[1]; Z[1] = s6[1]; Z[2] = s1[0]; Z[3] = s2[0];
+                p = s7[1];
+                q = s7[0];
+
+                // 2 output bits are a function of the 4 bits of D, most significant bits first.
+                if (!init) {
+                    cb[8*i + 7 - 2*j] = D[2] ^ D[3];
+                    cb[8*i + 6 - 2*j] = D[0] ^ D[1];
+                }
+            }
+        }
+    }
+
+    // Transpose a 64x64 bit matrix in place: bit j of a[i] is swapped with bit i of a[j].
+    void Transpose64(uint64_t a[64])
+    {
+        uint64_t m = 0x00000000FFFFFFFF;
+        for (size_t j = 32; j != 0; j >>= 1, m ^= (m << j)) {
+            for (size_t k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+                const uint64_t t = ((a[k] >> j) ^ a[k | j]) & m;
+                a[k] ^= t << j;
+                a[k | j] ^= t;
+            }
+        }
+    }
+
+    // Load the 8-byte blocks at the same offset in all data blocks into bitslice words.
+    // Null addresses are loaded as zero.
+    void BsLoad(BsWord bs[64], uint8_t* const data[], size_t count, size_t offset)
+    {
+        uint64_t mat[64];
+        for (size_t lane = 0; lane < BS_LANES; ++lane) {
+            for (size_t n = 0; n < 64; ++n) {
+                const size_t index = 64 * lane + n;
+                mat[n] = index < count && data[index] != nullptr ? ts::GetUInt64LE(data[index] + offset) : 0;
+            }
+            Transpose64(mat);
+            for (size_t w = 0; w < 64; ++w) {
+                BsSetLane(bs[w], lane, mat[w]);
+            }
+        }
+    }
+
+    // Extract the 8-byte blocks from bitslice words, one 64-bit value per data block, bytes in little endian order.
+    void BsStore(const BsWord bs[64], uint64_t out[BS_WIDTH])
+    {
+        for (size_t lane = 0; lane < BS_LANES; ++lane) {
+            uint64_t* const mat = out + 64 * lane;
+            for (size_t w = 0; w < 64; ++w) {
+                mat[w] = BsGetLane(bs[w], lane);
+            }
+            Transpose64(mat);
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Block cipher
 //----------------------------------------------------------------------------
@@ -520,6 +800,42 @@ void ts::DVBCSA2::BlockCipher::decipher(const uint8_t *ib, uint8_t *bd)
 }
 
 
+void ts::DVBCSA2::BlockCipher::decipher(const uint8_t* const ib[INTERLEAVE], uint8_t bd[INTERLEAVE][8])
+{
+    // Same as decipher() on independent blocks. Interleaving the blocks removes
+    // the dependency between consecutive table lookups in the round loop.
+    int R[INTERLEAVE][9];
+    for (size_t n = 0; n < INTERLEAVE; n++) {
+        for (size_t k = 0; k < 8; k++) {
+            R[n][k+1] = ib[n][k];
+        }
+    }
+
+    // loop over kk[56]..kk[1]
+    for (int i = 56; i > 0; i--) {
+        for (size_t n = 0; n < INTERLEAVE; n++) {
+            const int sbox_out = block_sbox[_kk[i] ^ R[n][7]];
+            const int perm_out = block_perm[sbox_out];
+            const int next_R8 = R[n][7];
+            R[n][7] = R[n][6] ^ perm_out;
+            R[n][6] = R[n][5];
+            R[n][5] = R[n][4] ^ R[n][8] ^ sbox_out;
+            R[n][4] = R[n][3] ^ R[n][8] ^ sbox_out;
+            R[n][3] = R[n][2] ^ R[n][8] ^ sbox_out;
+            R[n][2] = R[n][1];
+            R[n][1] = R[n][8] ^ sbox_out;
+            R[n][8] = next_R8;
+        }
+    }
+
+    for (size_t n = 0; n < INTERLEAVE; n++) {
+        for (size_t k = 0; k < 8; k++) {
+            bd[n][k] = uint8_t(R[n][k+1]);
+        }
+    }
+}
+
+
 void ts::DVBCSA2::BlockCipher::encipher (const uint8_t *bd, uint8_t *ib)
 {
     int i;
@@ -718,6 +1034,137 @@ bool ts::DVBCSA2::decryptInPlaceImpl(void* addr, size_t size, size_t* max_actual
 }
 
 
+//----------------------------------------------------------------------------
+// Decrypt a batch of data blocks.
+//----------------------------------------------------------------------------
+
+size_t ts::DVBCSA2::BatchSize()
+{
+    return BS_WIDTH;
+}
+
+bool ts::DVBCSA2::decryptInPlaceBatch(size_t count, void* const data[], const size_t data_length[], size_t* decrypted)
+{
+    if (decrypted != nullptr) {
+        *decrypted = 0;
+    }
+
+    // Filter invalid parameters.
+    if (count > 0 && (data == nullptr || data_length == nullptr || !_init)) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (data[i] == nullptr || data_length[i] / 8 > MAX_NBLOCKS) {
+            return false;
+        }
+    }
+
+    // Check the usage limits of the control word, once per data block.
+    size_t allowed = 0;
+    while (allowed < count && allowDecrypt()) {
+        allowed++;
+    }
+
+    // Process slices of the batch in parallel. Small remaining slices are decrypted one by one.
+    for (size_t first = 0; first < allowed; first += BS_WIDTH) {
+        const size_t slice = std::min(BS_WIDTH, allowed - first);
+        if (slice >= MIN_BATCH_SIZE) {
+            decryptBatchImpl(slice, data + first, data_length + first);
+        }
+        else {
+            for (size_t i = first; i < first + slice; ++i) {
+                decryptInPlaceImpl(data[i], data_length[i], nullptr);
+            }
+        }
+    }
+    if (decrypted != nullptr) {
+        *decrypted = allowed;
+    }
+    return allowed == count;
+}
+
+void ts::DVBCSA2::decryptBatchImpl(size_t count, void* const data[], const size_t data_length[])
+{
+    assert(count <= BS_WIDTH);
+
+    // Data blocks to decrypt. Packets smaller than 8 bytes are left unscrambled.
+    uint8_t* pkt[BS_WIDTH];
+    size_t max_size = 0;
+    for (size_t i = 0; i < count; ++i) {
+        pkt[i] = data_length[i] < 8 ? nullptr : reinterpret_cast<uint8_t*>(data[i]);
+        max_size = std::max(max_size, data_length[i]);
+    }
+
+    // Initialize all stream ciphers with the first 8 bytes of each scrambled packet.
+    BsWord bs[64];
+    BsStreamCipher stream_ctx;
+    stream_ctx.init(_key);
+    BsLoad(bs, pkt, count, 0);
+    stream_ctx.cipher(bs, nullptr);
+
+    // Apply the stream cipher on all subsequent blocks, including residues.
+    // After this, all blocks contain the intermediate blocks of the block cipher.
+    uint64_t ostream[BS_WIDTH];
+    for (size_t offset = 8; offset < max_size; offset += 8) {
+        stream_ctx.cipher(nullptr, bs);
+        BsStore(bs, ostream);
+        for (size_t i = 0; i < count; ++i) {
+            if (pkt[i] != nullptr && offset + 8 <= data_length[i]) {
+                PutUInt64LE(pkt[i] + offset, GetUInt64LE(pkt[i] + offset) ^ ostream[i]);
+            }
+            else if (pkt[i] != nullptr && offset < data_length[i]) {
+                for (size_t k = 0; offset + k < data_length[i]; ++k) {
+                    pkt[i][offset + k] ^= uint8_t(ostream[i] >> (8 * k));
+                }
+            }
+        }
+    }
+
+    // Decipher all intermediate blocks, several independent blocks at a time.
+    // Each plain block is the deciphered block, xor'ed with the next intermediate
+    // block, if any. Blocks are processed in increasing order in each packet:
+    // the next block is still an intermediate block when the plain block is stored.
+    static const uint8_t zero_block[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    const uint8_t* ib[BlockCipher::INTERLEAVE];
+    uint8_t* next[BlockCipher::INTERLEAVE];
+    uint8_t oblock[BlockCipher::INTERLEAVE][8];
+    size_t pending = 0;
+
+    const auto flush = [&]() {
+        for (size_t n = pending; n < BlockCipher::INTERLEAVE; ++n) {
+            ib[n] = zero_block;
+        }
+        _block.decipher(ib, oblock);
+        for (size_t n = 0; n < pending; ++n) {
+            uint8_t* plain = const_cast<uint8_t*>(ib[n]);
+            if (next[n] == nullptr) {
+                memcpy_8(plain, oblock[n]);
+            }
+            else {
+                xor_8(plain, oblock[n], next[n]);
+            }
+        }
+        pending = 0;
+    };
+
+    for (size_t i = 0; i < count; ++i) {
+        if (pkt[i] != nullptr) {
+            const size_t nblocks = data_length[i] / 8;
+            for (size_t b = 0; b < nblocks; ++b) {
+                ib[pending] = pkt[i] + 8 * b;
+                next[pending] = b + 1 < nblocks ? pkt[i] + 8 * (b + 1) : nullptr;
+                if (++pending == BlockCipher::INTERLEAVE) {
+                    flush();
+                }
+            }
+        }
+    }
+    if (pending > 0) {
+        flush();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Wrappers for encrypt and decrypt.
 //----------------------------------------------------------------------------
@@ -88,6 +88,29 @@ namespace ts {
         //!
         static bool IsReducedCW(const uint8_t *cw);
 
+        //!
+        //! Decrypt a batch of data blocks in place, typically the payloads of TS packets.
+        //! All data blocks are decrypted using the current control word. The result is the same
+        //! as calling decryptInPlace() on each data block. However, the stream cipher is computed
+        //! on many data blocks in parallel using a bitsliced implementation, which is much faster
+        //! than the packet-per-packet decryption when there are many data blocks to decrypt.
+        //! @param [in] count Number of data blocks to decrypt.
+        //! @param [in,out] data Array of @a count addresses of data blocks to decrypt.
+        //! @param [in] data_length Array of @a count data block sizes in bytes.
+        //! @param [out] decrypted Optional address of a variable which receives the number of
+        //! decrypted data blocks, from the beginning of the batch.
+        //! @return True on success, false on error. When the maximum number of decryptions
+        //! for the current key is reached, the data blocks before that limit are decrypted.
+        //!
+        bool decryptInPlaceBatch(size_t count, void* const data[], const size_t data_length[], size_t* decrypted = nullptr);
+
+        //!
+        //! Number of data blocks which are processed in parallel in decryptInPlaceBatch().
+        //! Applications should preferably submit batches of at least this number of data blocks.
+        //! @return The bitsliced batch size.
+        //!
+        static size_t BatchSize();
+
         // Implementation of CipherChaining interface. Cannot set IV with DVB CSA.
         virtual bool setIV(const void*, size_t) override;
         virtual size_t minIVSize() const override;
@@ -123,6 +146,9 @@ namespace ts {
             void init(const uint8_t *cw);
             void encipher(const uint8_t *bd, uint8_t *ib);
             void decipher(const uint8_t *ib, uint8_t *bd);
+            // Interleaved decipher of several independent blocks.
+            static const size_t INTERLEAVE = 4;
+            void decipher(const uint8_t* const ib[INTERLEAVE], uint8_t bd[INTERLEAVE][8]);
         };
 
         // Stream cipher data
@@ -151,5 +177,8 @@ namespace ts {
         uint8_t      _key[KEY_SIZE];
         BlockCipher  _block;
         StreamCipher _stream;
+
+        // Decrypt up to BatchSize() data blocks using the bitsliced stream cipher.
+        void decryptBatchImpl(size_t count, void* const data[], const size_t data_length[]);
     };
 }
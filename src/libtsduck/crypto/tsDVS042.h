@@ -102,6 +102,12 @@ namespace ts {
         //! @copydoc ts::BlockCipher::decryptImpl()
         virtual bool decryptImpl(const void* cipher, size_t cipher_length, void* plain, size_t plain_maxsize,                              size_t* plain_length) override;
 
+        //! @copydoc ts::BlockCipher::encryptInPlaceImpl()
+        virtual bool encryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length) override;
+
+        //! @copydoc ts::BlockCipher::decryptInPlaceImpl()
+        virtual bool decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length) override;
+
     protected:
         ByteBlock shortIV;  //!< Current initialization vector for short blocks.
     };
@@ -45,7 +45,7 @@ TS_MSC_NOWARNING(4505) // warning C4505: 'ts::DVS042<ts::AES>::encrypt': unrefer
 
 template<class CIPHER>
 ts::DVS042<CIPHER>::DVS042() :
-    CipherChainingTemplate<CIPHER>(1, 1, 1),
+    CipherChainingTemplate<CIPHER>(1, 1, 1 + CipherChaining::BATCH_BLOCKS),
     shortIV(this->block_size)
 {
 }
@@ -174,7 +174,7 @@ bool ts::DVS042<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, v
     if (this->algo == nullptr ||
         this->iv.size() != this->block_size ||
         this->shortIV.size() != this->block_size ||
-        this->work.size() < this->block_size ||
+        this->work.size() < 2 * this->block_size ||
         plain_maxsize < cipher_length)
     {
         return false;
@@ -185,42 +185,52 @@ bool ts::DVS042<CIPHER>::decryptImpl(const void* cipher, size_t cipher_length, v
         *plain_length = cipher_length;
     }
 
-    // Select IV depending on block size.
-    const uint8_t* previous = cipher_length < this->block_size ? this->shortIV.data() : this->iv.data();
+    // Select IV depending on block size: work[0] = IV.
+    ::memcpy(this->work.data(), cipher_length < this->block_size ? this->shortIV.data() : this->iv.data(), this->block_size);
 
-    // Decrypt all blocks in CBC mode, except the last one if partial
+    // Decrypt all blocks in CBC mode, except the last one if partial.
+    // On return, work[0] = Cn-1, the last complete cipher block, or the IV.
+    const size_t count = cipher_length / this->block_size;
     const uint8_t* ct = reinterpret_cast<const uint8_t*>(cipher);
     uint8_t* pt = reinterpret_cast<uint8_t*>(plain);
-
-    while (cipher_length >= this->block_size) {
-        // work = decrypt (cipher-text)
-        if (!this->algo->decrypt(ct, this->block_size, this->work.data(), this->block_size)) {
-            return false;
-        }
-        // plain-text = previous-cipher XOR work
-        for (size_t i = 0; i < this->block_size; ++i) {
-            pt[i] = previous[i] ^ this->work[i];
-        }
-        // previous-cipher = cipher-text
-        previous = ct;
-        // advance one block
-        ct += this->block_size;
-        pt += this->block_size;
-        cipher_length -= this->block_size;
+    if (!this->decryptBlocksCBC(ct, pt, count)) {
+        return false;
     }
+    ct += count * this->block_size;
+    pt += count * this->block_size;
+    cipher_length -= count * this->block_size;
 
     // Process final block if incomplete
     if (cipher_length > 0) {
-        // work = encrypt (Cn-1), which is encrypt (shortIV) for short packets
-        if (!this->algo->encrypt(previous, this->block_size, this->work.data(), this->block_size)) {
+        // work[1] = encrypt (Cn-1), which is encrypt (shortIV) for short packets
+        uint8_t* const last = this->work.data() + this->block_size;
+        if (!this->algo->encrypt(this->work.data(), this->block_size, last, this->block_size)) {
             return false;
         }
-        // Pn = work XOR Cn, truncated
+        // Pn = work[1] XOR Cn, truncated
         for (size_t i = 0; i < cipher_length; ++i) {
-            pt[i] = this->work[i] ^ ct[i];
+            pt[i] = last[i] ^ ct[i];
         }
     }
     return true;
 }
 
+
+//----------------------------------------------------------------------------
+// Encryption and decryption in place: the DVS042 mode already supports
+// identical plain and cipher text buffers, no need for an intermediate copy.
+//----------------------------------------------------------------------------
+
+template<class CIPHER>
+bool ts::DVS042<CIPHER>::encryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length)
+{
+    return encryptImpl(data, data_length, data, max_actual_length != nullptr ? *max_actual_length : data_length, max_actual_length);
+}
+
+template<class CIPHER>
+bool ts::DVS042<CIPHER>::decryptInPlaceImpl(void* data, size_t data_length, size_t* max_actual_length)
+{
+    return decryptImpl(data, data_length, data, max_actual_length != nullptr ? *max_actual_length : data_length, max_actual_length);
+}
+
 TS_POP_WARNING()
@@ -31,6 +31,11 @@
 #include "tsNullReport.h"
 
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr uint16_t ts::ContinuityAnalyzer::NO_PACKET;
+#endif
+
+
 //----------------------------------------------------------------------------
 // Constructors and destructors
 //----------------------------------------------------------------------------
@@ -48,15 +53,17 @@ ts::ContinuityAnalyzer::ContinuityAnalyzer(const PIDSet& pid_filter, Report* rep
     _fix_count(0),
     _error_count(0),
     _pid_filter(pid_filter),
-    _pid_states()
+    _pid_states(),
+    _last_pkts()
 {
 }
 
 ts::ContinuityAnalyzer::PIDState::PIDState() :
-    first_cc(INVALID_CC),
-    last_cc_out(INVALID_CC),
     dup_count(0),
-    last_pkt_in()
+    pkt_index(NO_PACKET),
+    first_cc(INVALID_CC),
+    last_cc_in(INVALID_CC),
+    last_cc_out(INVALID_CC)
 {
 }
 
@@ -82,6 +89,7 @@ void ts::ContinuityAnalyzer::reset()
     _fix_count = 0;
     _error_count = 0;
     _pid_states.clear();
+    _last_pkts.clear();
 }
 
 
@@ -97,11 +105,14 @@ void ts::ContinuityAnalyzer::setPIDFilter(const PIDSet& pids)
     // Set the new filter
     _pid_filter = pids;
 
-    // Reset context of all removed PID's
-    if (removed_pids.any()) {
+    // Reset context of all removed PID's.
+    // Keep the packet slot of the PID, it will be reused if the PID comes back.
+    if (removed_pids.any() && !_pid_states.empty()) {
         for (PID pid = 0; pid < PID_MAX; ++pid) {
             if (removed_pids[pid]) {
-                _pid_states.erase(pid);
+                const uint16_t index = _pid_states[pid].pkt_index;
+                _pid_states[pid] = PIDState();
+                _pid_states[pid].pkt_index = index;
             }
         }
     }
@@ -123,7 +134,11 @@ void ts::ContinuityAnalyzer::removePID(PID pid)
 {
     if (pid < _pid_filter.size() && _pid_filter[pid]) {
         _pid_filter.reset(pid);
-        _pid_states.erase(pid);
+        if (!_pid_states.empty()) {
+            const uint16_t index = _pid_states[pid].pkt_index;
+            _pid_states[pid] = PIDState();
+            _pid_states[pid].pkt_index = index;
+        }
     }
 }
 
@@ -137,28 +152,33 @@ bool ts::ContinuityAnalyzer::hasPID(PID pid) const
 // PIDState access
 //----------------------------------------------------------------------------
 
+const ts::ContinuityAnalyzer::PIDState* ts::ContinuityAnalyzer::getState(PID pid) const
+{
+    return pid < _pid_states.size() && _pid_states[pid].first_cc != INVALID_CC ? &_pid_states[pid] : nullptr;
+}
+
 uint8_t ts::ContinuityAnalyzer::firstCC(PID pid) const
 {
-    auto it = _pid_states.find(pid);
-    return it == _pid_states.end() ? INVALID_CC : it->second.first_cc;
+    const PIDState* state = getState(pid);
+    return state == nullptr ? INVALID_CC : state->first_cc;
 }
 
 uint8_t ts::ContinuityAnalyzer::lastCC(PID pid) const
 {
-    auto it = _pid_states.find(pid);
-    return it == _pid_states.end() ? INVALID_CC : it->second.last_cc_out;
+    const PIDState* state = getState(pid);
+    return state == nullptr ? INVALID_CC : state->last_cc_out;
 }
 
 size_t ts::ContinuityAnalyzer::dupCount(PID pid) const
 {
-    auto it = _pid_states.find(pid);
-    return it == _pid_states.end() ? NPOS : it->second.dup_count;
+    const PIDState* state = getState(pid);
+    return state == nullptr ? NPOS : state->dup_count;
 }
 
 void ts::ContinuityAnalyzer::getLastPacket(PID pid, TSPacket& packet) const
 {
-    auto it = _pid_states.find(pid);
-    packet = it == _pid_states.end() ? NullPacket : it->second.last_pkt_in;
+    const PIDState* state = getState(pid);
+    packet = state == nullptr ? NullPacket : _last_pkts[state->pkt_index];
 }
 
 ts::TSPacket ts::ContinuityAnalyzer::lastPacket(PID pid) const
@@ -202,19 +222,31 @@ bool ts::ContinuityAnalyzer::feedPacketInternal(TSPacket* pkt, bool update)
     // The null PID is never eligible for CC processing.
     if (pid != PID_NULL && _pid_filter.test(pid)) {
 
-        // Get or create PID context.
+        // Get or create PID context. The PID states are allocated all at once.
+        if (_pid_states.empty()) {
+            _pid_states.resize(PID_MAX);
+        }
         PIDState& state(_pid_states[pid]);
         const bool new_pid = state.first_cc == INVALID_CC;
 
+        // Allocate a slot for the last input packet on first use of the PID.
+        if (state.pkt_index == NO_PACKET) {
+            state.pkt_index = uint16_t(_last_pkts.size());
+            _last_pkts.push_back(NullPacket);
+        }
+        TSPacket& last_pkt_in(_last_pkts[state.pkt_index]);
+
         // Remember initial characteristics of the input packet.
-        const uint8_t last_cc_in = new_pid ? INVALID_CC : state.last_pkt_in.getCC();
+        // Duplicate packets have the same CC, check the full content only in that case.
+        const uint8_t last_cc_in = new_pid ? INVALID_CC : state.last_cc_in;
         const uint8_t cc = pkt->getCC();
         const bool has_payload = pkt->hasPayload();
         const bool has_discontinuity = pkt->getDiscontinuityIndicator();
-        const bool duplicated = !new_pid && !has_discontinuity && pkt->isDuplicate(state.last_pkt_in);
+        const bool duplicated = !new_pid && !has_discontinuity && cc == last_cc_in && pkt->isDuplicate(last_pkt_in);
 
         // Save input packet as originally received.
-        state.last_pkt_in = *pkt;
+        last_pkt_in = *pkt;
+        state.last_cc_in = cc;
 
         if (new_pid) {
             // First packet on this PID
@@ -252,34 +252,45 @@ namespace ts {
         static int MissingPackets(int cc1, int cc2);
 
     private:
-        // PID analysis state
+        // PID analysis state, one instance per PID in a flat array, indexed by PID.
+        // Only the small fields which are used on each packet are stored here.
+        // The last input packet of each PID is stored in a separate array, see below.
         class PIDState
         {
         public:
             PIDState();            // Constructor
-            uint8_t  first_cc;     // First CC value in a PID.
+            uint32_t dup_count;    // Consecutive duplicate count.
+            uint16_t pkt_index;    // Index of last input packet in _last_pkts, NO_PACKET if none.
+            uint8_t  first_cc;     // First CC value in a PID, INVALID_CC if the PID was not yet seen.
+            uint8_t  last_cc_in;   // Last input CC value in a PID.
             uint8_t  last_cc_out;  // Last output CC value in a PID.
-            size_t   dup_count;    // Consecutive duplicate count.
-            TSPacket last_pkt_in;  // Last input packet (before modification, if any).
         };
 
-        // A map of PID state, indexed by PID.
-        typedef std::map<PID,PIDState> PIDStateMap;
+        // Value of PIDState::pkt_index when no packet slot was allocated for the PID.
+        static constexpr uint16_t NO_PACKET = 0xFFFF;
+
+        // A flat vector of PID state, indexed by PID.
+        // It is empty until the first processed packet, then contains PID_MAX elements.
+        typedef std::vector<PIDState> PIDStateVector;
 
         // Private members.
-        Report*       _report;            // Where to report errors, never null.
-        int           _severity;          // Severity level for error messages.
-        bool          _display_errors;    // Display discontinuity errors.
-        bool          _fix_errors;        // Fix discontinuity errors.
-        bool          _replicate_dup;     // With _fix_errors, replicate duplicate packets.
-        bool          _generator;         // Use generator mode.
-        UString       _prefix;            // Message prefix.
-        PacketCounter _total_packets;     // Total number of packets.
-        PacketCounter _processed_packets; // Number of processed packets.
-        PacketCounter _fix_count;         // Number of fixed (modified) packets.
-        PacketCounter _error_count;       // Number of discontinuity errors.
-        PIDSet        _pid_filter;        // Current set of filtered PID's.
-        PIDStateMap   _pid_states;        // State of all PID's.
+        Report*        _report;            // Where to report errors, never null.
+        int            _severity;          // Severity level for error messages.
+        bool           _display_errors;    // Display discontinuity errors.
+        bool           _fix_errors;        // Fix discontinuity errors.
+        bool           _replicate_dup;     // With _fix_errors, replicate duplicate packets.
+        bool           _generator;         // Use generator mode.
+        UString        _prefix;            // Message prefix.
+        PacketCounter  _total_packets;     // Total number of packets.
+        PacketCounter  _processed_packets; // Number of processed packets.
+        PacketCounter  _fix_count;         // Number of fixed (modified) packets.
+        PacketCounter  _error_count;       // Number of discontinuity errors.
+        PIDSet         _pid_filter;        // Current set of filtered PID's.
+        PIDStateVector _pid_states;        // State of all PID's.
+        TSPacketVector _last_pkts;         // Last input packet (before modification, if any), one slot per PID in use.
+
+        // Get the state of a PID if it was already seen, null otherwise.
+        const PIDState* getState(PID pid) const;
 
         // Internal version of feedPacket.
         // The packet is modified only if update is true.
@@ -93,14 +93,19 @@ ts::TSAnalyzer::TSAnalyzer(DuckContext& duck, const BitRate& bitrate_hint, BitRa
     _modified(false),
     _ts_bitrate_sum(0),
     _ts_bitrate_cnt(0),
+    _pid_contexts(),
+    _pid_counters(),
     _preceding_errors(0),
     _preceding_suspects(0),
     _min_error_before_suspect(1),
     _max_consecutive_suspects(1),
+    _resync_packets(0),
     _demux(_duck, this, this),
     _pes_demux(_duck, this),
     _t2mi_demux(_duck, this)
 {
+    // Only the audio/video attributes are used, PES packets don't need to be reassembled.
+    _pes_demux.setStreamingMode(true);
     resetSectionDemux();
 }
 
@@ -166,8 +171,11 @@ void ts::TSAnalyzer::reset()
     _services.clear();
     _ts_bitrate_sum = 0;
     _ts_bitrate_cnt = 0;
+    _pid_contexts.reset();
+    _pid_counters.clear();
     _preceding_errors = 0;
     _preceding_suspects = 0;
+    _resync_packets = 0;
     _pes_demux.reset();
 
     resetSectionDemux();
@@ -233,10 +241,41 @@ const ts::TSAnalyzer::PIDContext::KnownPIDMap ts::TSAnalyzer::PIDContext::KNOWN_
 
 
 //----------------------------------------------------------------------------
-// Constructor for the PID context
+// Constructors for the PID counters and context
 //----------------------------------------------------------------------------
 
+ts::TSAnalyzer::PIDCounters::PIDCounters() :
+    scrambled(false),
+    same_stream_id(false),
+    pes_stream_id(0),
+    cur_continuity(0),
+    cur_ts_sc(0),
+    first_cc(0),
+    first_discont(false),
+    first_payload(false),
+    ts_pkt_cnt(0),
+    ts_af_cnt(0),
+    unit_start_cnt(0),
+    pl_start_cnt(0),
+    unexp_discont(0),
+    exp_discont(0),
+    duplicated(0),
+    ts_sc_cnt(0),
+    inv_ts_sc_cnt(0),
+    inv_pes_start(0),
+    pcr_cnt(0),
+    cur_ts_sc_pkt(0),
+    cryptop_cnt(0),
+    cryptop_ts_cnt(0),
+    last_pcr(0),
+    last_pcr_pkt(0),
+    ts_bitrate_sum(0),
+    ts_bitrate_cnt(0)
+{
+}
+
 ts::TSAnalyzer::PIDContext::PIDContext(PID pid_, const UString& description_) :
+    PIDCounters(),
     pid(pid_),
     description(description_),
     comment(),
@@ -254,24 +293,10 @@ ts::TSAnalyzer::PIDContext::PIDContext(PID pid_, const UString& description_) :
     carry_audio(false),
     carry_video(false),
     carry_t2mi(false),
-    scrambled(false),
-    same_stream_id(false),
-    pes_stream_id(0),
     stream_type(0),
-    ts_pkt_cnt(0),
-    ts_af_cnt(0),
-    unit_start_cnt(0),
-    pl_start_cnt(0),
     pmt_cnt(0),
     crypto_period(0),
-    unexp_discont(0),
-    exp_discont(0),
-    duplicated(0),
-    ts_sc_cnt(0),
-    inv_ts_sc_cnt(0),
-    inv_pes_start(0),
     t2mi_cnt(0),
-    pcr_cnt(0),
     ts_pcr_bitrate(0),
     bitrate(0),
     cas_id(0),
@@ -279,16 +304,7 @@ ts::TSAnalyzer::PIDContext::PIDContext(PID pid_, const UString& description_) :
     sections(),
     ssu_oui(),
     t2mi_plp_ts(),
-    cur_continuity(0),
-    audio2(),
-    cur_ts_sc(0),
-    cur_ts_sc_pkt(0),
-    cryptop_cnt(0),
-    cryptop_ts_cnt(0),
-    last_pcr(0),
-    last_pcr_pkt(0),
-    ts_bitrate_sum(0),
-    ts_bitrate_cnt(0)
+    audio2()
 {
     // Guess the initial description, based on the PID
     // Global PID's (PAT, CAT, etc) are marked as "referenced" since they
@@ -408,7 +424,7 @@ ts::TSAnalyzer::ETIDContextPtr ts::TSAnalyzer::getETID(const Section& section)
 
 bool ts::TSAnalyzer::pidExists(PID pid) const
 {
-    return Contains(_pids, pid);
+    return pid < PID_MAX && _pid_contexts.test(pid);
 }
 
 
@@ -421,6 +437,9 @@ ts::TSAnalyzer::PIDContextPtr ts::TSAnalyzer::getPID(PID pid, const UString& des
     const PIDContextPtr p(_pids[pid]);
     if (p.isNull()) {
         // The PID was not yet used, map entry just created.
+        if (pid < PID_MAX) {
+            _pid_contexts.set(pid);
+        }
         return _pids[pid] = new PIDContext(pid, description);
     }
     else {
@@ -475,6 +494,11 @@ void ts::TSAnalyzer::PIDContext::addService(uint16_t service_id)
 
 void ts::TSAnalyzer::handleSection(SectionDemux&, const Section& section)
 {
+    // Sections which end in the resynchronization window are not counted.
+    if (_resync_packets > 0) {
+        return;
+    }
+
     ETIDContextPtr etc(getETID(section));
     const uint8_t version = section.version();
 
@@ -660,7 +684,9 @@ void ts::TSAnalyzer::analyzePMT(PID pid, const PMT& pmt)
 {
     // Count the number of PMT's on this PID
     PIDContextPtr ps(getPID(pid));
-    ps->pmt_cnt++;
+    if (_resync_packets == 0) {
+        ps->pmt_cnt++;
+    }
 
     // Get service description
     ServiceContextPtr svp(getService(pmt.service_id));
@@ -1369,8 +1395,10 @@ void ts::TSAnalyzer::handleT2MIPacket(T2MIDemux& demux, const T2MIPacket& pkt)
 {
     PIDContextPtr pc(getPID(pkt.sourcePID(), u"T2-MI"));
 
-    // Count T2-MI packets.
-    pc->t2mi_cnt++;
+    // Count T2-MI packets (not in the resynchronization window).
+    if (_resync_packets == 0) {
+        pc->t2mi_cnt++;
+    }
 
     // Process PLP (only in baseband frame).
     if (pkt.plpValid()) {
@@ -1392,8 +1420,10 @@ void ts::TSAnalyzer::handleTSPacket(T2MIDemux& demux, const T2MIPacket& t2mi, co
 {
     PIDContextPtr pc(getPID(t2mi.sourcePID(), u"T2-MI"));
 
-    // Count demux'ed TS packets from this PLP.
-    pc->t2mi_plp_ts[t2mi.plp()]++;
+    // Count demux'ed TS packets from this PLP (not in the resynchronization window).
+    if (_resync_packets == 0) {
+        pc->t2mi_plp_ts[t2mi.plp()]++;
+    }
 }
 
 
@@ -1414,6 +1444,18 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
     // Each new packet leads to various modifications
     _modified = true;
 
+    // Packets in the resynchronization window are only used to resynchronize the demux.
+    // They are not counted, the window is decremented after the demux handlers were invoked.
+    if (_resync_packets > 0) {
+        if (pkt.hasValidSync() && !pkt.getTEI()) {
+            _demux.feedPacket(pkt);
+            _pes_demux.feedPacket(pkt);
+            _t2mi_demux.feedPacket(pkt);
+        }
+        _resync_packets--;
+        return;
+    }
+
     // Count TS packets
     _ts_pkt_cnt++;
     uint64_t packet_index(_ts_pkt_cnt);
@@ -1454,8 +1496,16 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
     _pes_demux.feedPacket(pkt);
     _t2mi_demux.feedPacket(pkt);
 
-    // Get PID context
-    PIDContextPtr ps(getPID(pkt.getPID()));
+    // Create the PID context on the first packet of the PID. On the packet path, only the
+    // per-packet data of the PID are updated, in the flat array of PID counters.
+    const PID pid = pkt.getPID();
+    if (!_pid_contexts.test(pid)) {
+        getPID(pid);
+    }
+    if (_pid_counters.empty()) {
+        _pid_counters.resize(PID_MAX);
+    }
+    PIDCounters* const ps = &_pid_counters[pid];
     ps->ts_pkt_cnt++;
 
     // Accumulate stat from packet
@@ -1499,10 +1549,13 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
 
     // Process discontinuities.
     // The continuity counter of null packets is undefined.
-    if (ps->pid != PID_NULL) {
+    if (pid != PID_NULL) {
         if (ps->ts_pkt_cnt == 1) {
-            // First packet, initialize continuity
-            ps->cur_continuity = pkt.getCC();
+            // First packet, initialize continuity. Remember characteristics of
+            // the first packet to check continuity when merging analyses.
+            ps->cur_continuity = ps->first_cc = pkt.getCC();
+            ps->first_discont = pkt.getDiscontinuityIndicator();
+            ps->first_payload = pkt.hasPayload();
         }
         else if (pkt.getDiscontinuityIndicator()) {
             // Expected discontinuity
@@ -1578,7 +1631,7 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
             // that the PID does not carry PES packets).
             ps->inv_pes_start++;
         }
-        else if (header_size <= PKT_SIZE - 4 && ps->pid != 0) {
+        else if (header_size <= PKT_SIZE - 4 && pid != 0) {
             // Here, the start of the packet payload is 00 00 01.
             // The only case where this can happen on a section is a PAT
             // (first 00 = "pointer field", second 00 = table_id = PAT).
@@ -1661,6 +1714,9 @@ void ts::TSAnalyzer::recomputeStatistics()
     for (auto& pci : _pids) {
         PIDContext& pc(*pci.second);
 
+        // Get the latest per-packet data of the PID.
+        static_cast<PIDCounters&>(pc) = pc.pid < _pid_counters.size() ? _pid_counters[pc.pid] : PIDCounters();
+
         // Compute TS bitrate from the PCR's of this PID
         if (pc.ts_bitrate_cnt != 0) {
             pc.ts_pcr_bitrate = pc.ts_bitrate_sum / pc.ts_bitrate_cnt;
@@ -1852,3 +1908,249 @@ void ts::TSAnalyzer::getPIDsWithPES(std::vector<PID>& list)
         }
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Merge the analysis of the next part of the same transport stream.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::merge(const TSAnalyzer& next)
+{
+    // Packet indexes in the next analysis are relative to its first packet.
+    const uint64_t base = _ts_pkt_cnt;
+
+    // Global counters and state.
+    _modified = true;
+    _ts_pkt_cnt += next._ts_pkt_cnt;
+    _invalid_sync += next._invalid_sync;
+    _transport_errors += next._transport_errors;
+    _suspect_ignored += next._suspect_ignored;
+    _ts_bitrate_sum += next._ts_bitrate_sum;
+    _ts_bitrate_cnt += next._ts_bitrate_cnt;
+    _tid_present |= next._tid_present;
+    _duck.addStandards(next._duck.standards());
+    if (next._ts_id_valid) {
+        _ts_id = next._ts_id;
+        _ts_id_valid = true;
+    }
+
+    // System times: keep the earliest start time.
+    if (_first_utc == Time::Epoch || (next._first_utc != Time::Epoch && next._first_utc < _first_utc)) {
+        _first_utc = next._first_utc;
+        _first_local = next._first_local;
+    }
+
+    // Time stamps from the stream: first ones from this part, last ones from the next part.
+    if (_first_tdt == Time::Epoch) {
+        _first_tdt = next._first_tdt;
+    }
+    if (next._last_tdt != Time::Epoch) {
+        _last_tdt = next._last_tdt;
+    }
+    if (_first_tot == Time::Epoch && next._first_tot != Time::Epoch) {
+        _first_tot = next._first_tot;
+        _country_code = next._country_code;
+    }
+    if (next._last_tot != Time::Epoch) {
+        _last_tot = next._last_tot;
+    }
+    if (_first_stt == Time::Epoch) {
+        _first_stt = next._first_stt;
+    }
+    if (next._last_stt != Time::Epoch) {
+        _last_stt = next._last_stt;
+    }
+
+    // Merge service descriptions, the most recent non-empty values take precedence.
+    for (const auto& it : next._services) {
+        const ServiceContext& ns(*it.second);
+        const ServiceContextPtr svp(getService(ns.service_id));
+        if (ns.orig_netw_id != 0) {
+            svp->orig_netw_id = ns.orig_netw_id;
+        }
+        if (ns.service_type != 0) {
+            svp->service_type = ns.service_type;
+        }
+        if (!ns.name.empty()) {
+            svp->name = ns.name;
+        }
+        if (!ns.provider.empty()) {
+            svp->provider = ns.provider;
+        }
+        if (ns.pmt_pid != 0) {
+            svp->pmt_pid = ns.pmt_pid;
+        }
+        if (ns.pcr_pid != 0) {
+            svp->pcr_pid = ns.pcr_pid;
+        }
+        svp->carry_ssu = svp->carry_ssu || ns.carry_ssu;
+        svp->carry_t2mi = svp->carry_t2mi || ns.carry_t2mi;
+    }
+
+    // Merge PID's. The per-packet data are merged in the flat arrays of PID counters.
+    static const PIDCounters no_counters;
+    if (_pid_counters.empty()) {
+        _pid_counters.resize(PID_MAX);
+    }
+    for (const auto& it : next._pids) {
+        const PIDContext& np(*it.second);
+        const PIDContextPtr pc(getPID(np.pid));
+        const PIDCounters& ncnt(np.pid < next._pid_counters.size() ? next._pid_counters[np.pid] : no_counters);
+        PIDCounters& cnt(_pid_counters[np.pid]);
+
+        // Check continuity between the last packet of this part and the first packet of the next part.
+        // This is the same logic as in feedPacket().
+        if (np.pid != PID_NULL && cnt.ts_pkt_cnt > 0 && ncnt.ts_pkt_cnt > 0) {
+            if (ncnt.first_discont) {
+                cnt.exp_discont++;
+            }
+            else if (ncnt.first_payload) {
+                if (ncnt.first_cc == cnt.cur_continuity) {
+                    cnt.duplicated++;
+                }
+                else if (ncnt.first_cc != (cnt.cur_continuity + 1) % CC_MAX) {
+                    cnt.unexp_discont++;
+                }
+            }
+            else if (ncnt.first_cc != cnt.cur_continuity) {
+                cnt.unexp_discont++;
+            }
+        }
+        if (cnt.ts_pkt_cnt == 0 && ncnt.ts_pkt_cnt > 0) {
+            cnt.first_cc = ncnt.first_cc;
+            cnt.first_discont = ncnt.first_discont;
+            cnt.first_payload = ncnt.first_payload;
+        }
+
+        // Global counts of scrambled PID's and PID's with PCR.
+        if (ncnt.scrambled && !cnt.scrambled) {
+            cnt.scrambled = true;
+            _scrambled_pid_cnt++;
+        }
+        if (ncnt.pcr_cnt > 0 && cnt.pcr_cnt == 0) {
+            _pcr_pid_cnt++;
+        }
+
+        // Accumulate counters. The first crypto-period of each part is truncated and
+        // ignored in its count of packets, only one of them shall be counted.
+        cnt.cryptop_cnt += cnt.cryptop_cnt == 0 || ncnt.cryptop_cnt == 0 ? ncnt.cryptop_cnt : ncnt.cryptop_cnt - 1;
+        cnt.cryptop_ts_cnt += ncnt.cryptop_ts_cnt;
+        cnt.ts_pkt_cnt += ncnt.ts_pkt_cnt;
+        cnt.ts_af_cnt += ncnt.ts_af_cnt;
+        cnt.unit_start_cnt += ncnt.unit_start_cnt;
+        cnt.pl_start_cnt += ncnt.pl_start_cnt;
+        cnt.unexp_discont += ncnt.unexp_discont;
+        cnt.exp_discont += ncnt.exp_discont;
+        cnt.duplicated += ncnt.duplicated;
+        cnt.ts_sc_cnt += ncnt.ts_sc_cnt;
+        cnt.inv_ts_sc_cnt += ncnt.inv_ts_sc_cnt;
+        cnt.inv_pes_start += ncnt.inv_pes_start;
+        cnt.pcr_cnt += ncnt.pcr_cnt;
+        cnt.ts_bitrate_sum += ncnt.ts_bitrate_sum;
+        cnt.ts_bitrate_cnt += ncnt.ts_bitrate_cnt;
+        pc->pmt_cnt += np.pmt_cnt;
+        pc->t2mi_cnt += np.t2mi_cnt;
+        for (const auto& plp : np.t2mi_plp_ts) {
+            pc->t2mi_plp_ts[plp.first] += plp.second;
+        }
+
+        // The analysis state is the one at the end of the next part.
+        if (ncnt.ts_pkt_cnt > 0) {
+            cnt.cur_continuity = ncnt.cur_continuity;
+            cnt.cur_ts_sc = ncnt.cur_ts_sc;
+            cnt.cur_ts_sc_pkt = base + ncnt.cur_ts_sc_pkt;
+        }
+        if (ncnt.pcr_cnt > 0) {
+            cnt.last_pcr = ncnt.last_pcr;
+            cnt.last_pcr_pkt = base + ncnt.last_pcr_pkt;
+        }
+        if (np.audio2.isValid()) {
+            pc->audio2 = np.audio2;
+        }
+
+        // PES stream id.
+        if (cnt.pes_stream_id == 0) {
+            cnt.pes_stream_id = ncnt.pes_stream_id;
+            cnt.same_stream_id = ncnt.same_stream_id;
+        }
+        else if (ncnt.pes_stream_id != 0) {
+            cnt.same_stream_id = cnt.same_stream_id && ncnt.same_stream_id && cnt.pes_stream_id == ncnt.pes_stream_id;
+        }
+
+        // Descriptive data.
+        if (np.description != UNREFERENCED) {
+            pc->description = np.description;
+        }
+        if (!np.comment.empty()) {
+            pc->comment = np.comment;
+        }
+        for (const auto& lang : np.languages) {
+            AppendUnique(pc->languages, lang);
+        }
+        for (const auto& attr : np.attributes) {
+            AppendUnique(pc->attributes, attr);
+        }
+        pc->services.insert(np.services.begin(), np.services.end());
+        pc->cas_operators.insert(np.cas_operators.begin(), np.cas_operators.end());
+        pc->ssu_oui.insert(np.ssu_oui.begin(), np.ssu_oui.end());
+        pc->is_pmt_pid = pc->is_pmt_pid || np.is_pmt_pid;
+        pc->is_pcr_pid = pc->is_pcr_pid || np.is_pcr_pid;
+        pc->referenced = pc->referenced || np.referenced;
+        pc->carry_pes = pc->carry_pes || np.carry_pes;
+        pc->carry_section = pc->carry_section || np.carry_section;
+        pc->carry_ecm = pc->carry_ecm || np.carry_ecm;
+        pc->carry_emm = pc->carry_emm || np.carry_emm;
+        pc->carry_audio = pc->carry_audio || np.carry_audio;
+        pc->carry_video = pc->carry_video || np.carry_video;
+        pc->carry_t2mi = pc->carry_t2mi || np.carry_t2mi;
+        if (np.stream_type != 0) {
+            pc->stream_type = np.stream_type;
+        }
+        if (np.cas_id != 0) {
+            pc->cas_id = np.cas_id;
+        }
+
+        // Merge tables and sections.
+        for (const auto& eit : np.sections) {
+            const ETIDContext& ne(*eit.second);
+            ETIDContextPtr& ec(pc->sections[ne.etid]);
+            if (ec.isNull()) {
+                ec = new ETIDContext(ne.etid);
+                ec->first_version = ne.first_version;
+            }
+            if (ne.table_count > 0) {
+                if (ec->table_count == 0) {
+                    ec->first_pkt = base + ne.first_pkt;
+                    ec->first_version = ne.first_version;
+                    ec->min_repetition_ts = ne.min_repetition_ts;
+                    ec->max_repetition_ts = ne.max_repetition_ts;
+                }
+                else {
+                    // Repetition interval across the boundary between the two parts.
+                    const uint64_t rep = base + ne.first_pkt - ec->last_pkt;
+                    if (ec->table_count == 1) {
+                        ec->min_repetition_ts = ec->max_repetition_ts = rep;
+                    }
+                    else {
+                        ec->min_repetition_ts = std::min(ec->min_repetition_ts, rep);
+                        ec->max_repetition_ts = std::max(ec->max_repetition_ts, rep);
+                    }
+                    if (ne.table_count > 1) {
+                        ec->min_repetition_ts = std::min(ec->min_repetition_ts, ne.min_repetition_ts);
+                        ec->max_repetition_ts = std::max(ec->max_repetition_ts, ne.max_repetition_ts);
+                    }
+                }
+                ec->table_count += ne.table_count;
+                ec->last_pkt = base + ne.last_pkt;
+                if (ec->table_count > 1) {
+                    ec->repetition_ts = (ec->last_pkt - ec->first_pkt + (ec->table_count - 1) / 2) / (ec->table_count - 1);
+                }
+            }
+            if (ne.versions.any()) {
+                ec->last_version = ne.last_version;
+            }
+            ec->versions |= ne.versions;
+            ec->section_count += ne.section_count;
+        }
+    }
+}
@@ -123,6 +123,21 @@ namespace ts {
             _max_consecutive_suspects = count;
         }
 
+        //!
+        //! Set a resynchronization window at the beginning of the analysis.
+        //! This is used when the analyzed packets are a part of a larger stream which
+        //! starts after the beginning of the stream. The first @a count packets are only
+        //! used to resynchronize the demux of sections and PES packets. They are not counted,
+        //! they are supposed to be the last packets of the previous part of the stream.
+        //! Tables which start in the window and end after it are analyzed and counted.
+        //! @param [in] count Number of packets in the resynchronization window.
+        //! Initially set to zero (no resynchronization window).
+        //!
+        void setResyncWindow(uint64_t count)
+        {
+            _resync_packets = count;
+        }
+
         //!
         //! Get the list of service ids.
         //! @param [out] list The returned list of service ids.
@@ -161,6 +176,23 @@ namespace ts {
         //!
         void getPIDsWithPES(std::vector<PID>& list);
 
+        //!
+        //! Merge the analysis of the next part of the same transport stream.
+        //! This is used to analyze distinct parts of a large stream in parallel.
+        //! All counters are accumulated. The continuity counters and the repetition
+        //! of tables are checked across the boundary between the two parts.
+        //! The parts may overlap: when @a next was analyzed with a resynchronization
+        //! window, the packets in that window are duplicates of the last packets of
+        //! this part and were not counted by @a next, they are dropped from the merge.
+        //! @see setResyncWindow()
+        //! The descriptive data (services, PID types, etc.) are merged, the most
+        //! recent ones from @a next taking precedence.
+        //! @param [in] next Analyzer of the packets which immediately follow the
+        //! packets which were analyzed by this object. After merging, this object
+        //! is used for reporting only, it shall not be fed with additional packets.
+        //!
+        void merge(const TSAnalyzer& next);
+
     protected:
 
         // -------------------
@@ -295,72 +327,85 @@ namespace ts {
         // PID description
         // -------------------
 
+        //!
+        //! This protected inner class contains the counters and state of one PID which are updated on each packet.
+        //! During the analysis, these data are stored in a flat array of values, indexed by PID, separated
+        //! from the descriptive data in PIDContext. They are copied in PIDContext by recomputeStatistics().
+        //!
+        class TSDUCKDLL PIDCounters
+        {
+        public:
+            bool          scrambled;      //!< Contains some scrambled packets.
+            bool          same_stream_id; //!< All PES packets have same stream_id.
+            uint8_t       pes_stream_id;  //!< Stream_id in PES packets on this PID.
+            uint8_t       cur_continuity; //!< Current continuity count.
+            uint8_t       cur_ts_sc;      //!< Current scrambling control in TS header.
+            uint8_t       first_cc;       //!< Continuity counter of the first packet.
+            bool          first_discont;  //!< First packet has the discontinuity indicator.
+            bool          first_payload;  //!< First packet has a payload.
+            uint64_t      ts_pkt_cnt;     //!< Number of TS packets.
+            uint64_t      ts_af_cnt;      //!< Number of TS packets with adaptation field.
+            uint64_t      unit_start_cnt; //!< Number of unit_start in packets.
+            uint64_t      pl_start_cnt;   //!< Number of unit_start & has_payload in packets.
+            uint64_t      unexp_discont;  //!< Number of unexpected discontinuities.
+            uint64_t      exp_discont;    //!< Number of expected discontinuities.
+            uint64_t      duplicated;     //!< Number of duplicated packets.
+            uint64_t      ts_sc_cnt;      //!< Number of scrambled packets.
+            uint64_t      inv_ts_sc_cnt;  //!< Number of invalid scrambling control in TS headers.
+            uint64_t      inv_pes_start;  //!< Number of invalid PES start code.
+            uint64_t      pcr_cnt;        //!< Number of PCR's.
+            uint64_t      cur_ts_sc_pkt;  //!< First packet index of current crypto-period.
+            uint64_t      cryptop_cnt;    //!< Number of crypto-periods.
+            uint64_t      cryptop_ts_cnt; //!< Number of TS packets in all crypto-periods.
+            uint64_t      last_pcr;       //!< Last PCR value.
+            uint64_t      last_pcr_pkt;   //!< Index of packet with last PCR.
+            BitRate       ts_bitrate_sum; //!< Sum of all computed TS bitrates.
+            uint64_t      ts_bitrate_cnt; //!< Number of computed TS bitrates.
+
+            //!
+            //! Default constructor.
+            //!
+            PIDCounters();
+        };
+
         //!
         //! This protected inner class contains the analysis context for one PID.
+        //! The inherited counters are valid after calling recomputeStatistics().
         //!
-        class TSDUCKDLL PIDContext
+        class TSDUCKDLL PIDContext : public PIDCounters
         {
             TS_NOBUILD_NOCOPY(PIDContext);
         public:
             // Public members - Synthetic data (do not modify outside PIDContext methods)
-            const PID     pid;             //!< PID value.
-            UString       description;     //!< Readable description string (ie "MPEG-2 Audio").
-            UString       comment;         //!< Additional description (ie "MPE", "HbbTV").
-            UStringVector languages;       //!< For audio or subtitles (3 chars per language).
-            UStringVector attributes;      //!< Audio or video attributes (several lines if attributes changed).
-            ServiceIdSet  services;        //!< List of service ids the PID belongs to.
-            bool          is_pmt_pid;      //!< Is the PMT PID for this service.
-            bool          is_pcr_pid;      //!< Is the PCR PID for this service.
-            bool          referenced;      //!< Is referenced (by service or global).
-            bool          optional;        //!< Optional PID, don't display report if no packet.
-            bool          carry_pes;       //!< This PID carries PES packets.
-            bool          carry_section;   //!< This PID carries sections.
-            bool          carry_ecm;       //!< This PID carries ECM's.
-            bool          carry_emm;       //!< This PID carries EMM's.
-            bool          carry_audio;     //!< This PID carries audio data.
-            bool          carry_video;     //!< This PID carries video data.
-            bool          carry_t2mi;      //!< Carry T2-MI encasulated data.
-            bool          scrambled;       //!< Contains some scrambled packets.
-            bool          same_stream_id;  //!< All PES packets have same stream_id.
-            uint8_t       pes_stream_id;   //!< Stream_id in PES packets on this PID.
-            uint8_t       stream_type;     //!< Stream type in PMT.
-            uint64_t      ts_pkt_cnt;      //!< Number of TS packets.
-            uint64_t      ts_af_cnt;       //!< Number of TS packets with adaptation field.
-            uint64_t      unit_start_cnt;  //!< Number of unit_start in packets.
-            uint64_t      pl_start_cnt;    //!< Number of unit_start & has_payload in packets.
-            uint64_t      pmt_cnt;         //!< Number of PMT (for PMT PID's).
-            uint64_t      crypto_period;   //!< Average number of TS packets per crypto-period.
-            uint64_t      unexp_discont;   //!< Number of unexpected discontinuities.
-            uint64_t      exp_discont;     //!< Number of expected discontinuities.
-            uint64_t      duplicated;      //!< Number of duplicated packets.
-            uint64_t      ts_sc_cnt;       //!< Number of scrambled packets.
-            uint64_t      inv_ts_sc_cnt;   //!< Number of invalid scrambling control in TS headers.
-            uint64_t      inv_pes_start;   //!< Number of invalid PES start code.
-            uint64_t      t2mi_cnt;        //!< Number of T2-MI packets.
-            uint64_t      pcr_cnt;         //!< Number of PCR's.
-            BitRate       ts_pcr_bitrate;  //!< Average TS bitrate in b/s (eval from PCR).
-            BitRate       bitrate;         //!< Average PID bitrate in b/s.
-            uint16_t      cas_id;          //!< For EMM and ECM streams.
-            std::set<uint32_t>         cas_operators; //!< Operators for EMM and ECM streams, when applicable.
-            ETIDContextMap             sections;      //!< List of sections in this PID.
-            std::set<uint32_t>         ssu_oui;       //!< Set of applicable OUI's for SSU.
+            const PID            pid;            //!< PID value.
+            UString              description;    //!< Readable description string (ie "MPEG-2 Audio").
+            UString              comment;        //!< Additional description (ie "MPE", "HbbTV").
+            UStringVector        languages;      //!< For audio or subtitles (3 chars per language).
+            UStringVector        attributes;     //!< Audio or video attributes (several lines if attributes changed).
+            ServiceIdSet         services;       //!< List of service ids the PID belongs to.
+            bool                 is_pmt_pid;     //!< Is the PMT PID for this service.
+            bool                 is_pcr_pid;     //!< Is the PCR PID for this service.
+            bool                 referenced;     //!< Is referenced (by service or global).
+            bool                 optional;       //!< Optional PID, don't display report if no packet.
+            bool                 carry_pes;      //!< This PID carries PES packets.
+            bool                 carry_section;  //!< This PID carries sections.
+            bool                 carry_ecm;      //!< This PID carries ECM's.
+            bool                 carry_emm;      //!< This PID carries EMM's.
+            bool                 carry_audio;    //!< This PID carries audio data.
+            bool                 carry_video;    //!< This PID carries video data.
+            bool                 carry_t2mi;     //!< Carry T2-MI encasulated data.
+            uint8_t              stream_type;    //!< Stream type in PMT.
+            uint64_t             pmt_cnt;        //!< Number of PMT (for PMT PID's).
+            uint64_t             crypto_period;  //!< Average number of TS packets per crypto-period.
+            uint64_t             t2mi_cnt;       //!< Number of T2-MI packets.
+            BitRate              ts_pcr_bitrate; //!< Average TS bitrate in b/s (eval from PCR).
+            BitRate              bitrate;        //!< Average PID bitrate in b/s.
+            uint16_t             cas_id;         //!< For EMM and ECM streams.
+            std::set<uint32_t>   cas_operators;  //!< Operators for EMM and ECM streams, when applicable.
+            ETIDContextMap       sections;       //!< List of sections in this PID.
+            std::set<uint32_t>   ssu_oui;        //!< Set of applicable OUI's for SSU.
             std::map<uint8_t,uint64_t> t2mi_plp_ts;   //!< For T2-MI streams, map key = PLP (Physical Layer Pipe) to value = number of embedded TS packets.
-
-            // Public members - Analysis data:
-            uint8_t        cur_continuity;  //!< Current continuity count.
-            MPEG2AudioAttributes audio2;    //!< Last MPEG-2 audio attributes.
-
-            // Public members - Analysis data: Crypto-period evaluation:
-            uint8_t        cur_ts_sc;       //!< Current scrambling control in TS header.
-            uint64_t       cur_ts_sc_pkt;   //!< First packet index of current crypto-period.
-            uint64_t       cryptop_cnt;     //!< Number of crypto-periods.
-            uint64_t       cryptop_ts_cnt;  //!< Number of TS packets in all crypto-periods.
-
-            // Public members - Analysis data: Bitrate evaluation
-            uint64_t       last_pcr;        //!< Last PCR value.
-            uint64_t       last_pcr_pkt;    //!< Index of packet with last PCR.
-            BitRate        ts_bitrate_sum;  //!< Sum of all computed TS bitrates.
-            uint64_t       ts_bitrate_cnt;  //!< Number of computed TS bitrates.
+            MPEG2AudioAttributes audio2;         //!< Last MPEG-2 audio attributes.
 
             //!
             //! Default constructor.
@@ -530,10 +575,13 @@ namespace ts {
         bool         _modified;                  // Internal data modified, need recomputeStatistics
         BitRate      _ts_bitrate_sum;            // Sum of all computed TS bitrates
         uint64_t     _ts_bitrate_cnt;            // Number of computed TS bitrates
+        PIDSet       _pid_contexts;              // PID's with a context in _pids
+        std::vector<PIDCounters> _pid_counters;  // Per-packet data, indexed by PID, empty until the first packet, then PID_MAX elements
         uint64_t     _preceding_errors;          // Number of contiguous invalid packets before current packet
         uint64_t     _preceding_suspects;        // Number of contiguous suspects packets before current packet
         uint64_t     _min_error_before_suspect;  // Required number of invalid packets before starting suspect
         uint64_t     _max_consecutive_suspects;  // Max number of consecutive suspect packets before clearing suspect
+        uint64_t     _resync_packets;            // Remaining packets in the resynchronization window, not counted
         SectionDemux _demux;                     // PSI tables analysis
         PESDemux     _pes_demux;                 // Audio/video analysis
         T2MIDemux    _t2mi_demux;                // T2-MI analysis
@@ -577,3 +577,87 @@ bool ts::TSScrambling::decrypt(TSPacket& pkt)
     }
     return ok;
 }
+
+
+//----------------------------------------------------------------------------
+// Decrypt a batch of TS packets.
+//----------------------------------------------------------------------------
+
+bool ts::TSScrambling::decrypt(TSPacket* const pkts[], size_t count, size_t* processed)
+{
+    std::vector<void*> payloads;
+    std::vector<size_t> sizes;
+    payloads.reserve(count);
+    sizes.reserve(count);
+
+    size_t next = 0;
+    while (next < count) {
+
+        // Clear or invalid packets are silently accepted.
+        const uint8_t scv = pkts[next]->getScrambling();
+        if (scv != SC_EVEN_KEY && scv != SC_ODD_KEY) {
+            next++;
+            continue;
+        }
+
+        // Only DVB-CSA2 has a batch implementation, decrypt other packets one by one.
+        if (_scrambler[scv & 1] != &_dvbcsa[scv & 1]) {
+            if (!decrypt(*pkts[next])) {
+                break;
+            }
+            next++;
+            continue;
+        }
+
+        // Update current parity. In case of fixed control word, use next key when the scrambling control changes.
+        const uint8_t previous_scv = _decrypt_scv;
+        _decrypt_scv = scv;
+        if (hasFixedCW() && previous_scv != _decrypt_scv && !setNextFixedCW(_decrypt_scv)) {
+            break;
+        }
+
+        // Collect all subsequent packets with the same parity, skipping clear packets.
+        const size_t first = next;
+        payloads.clear();
+        sizes.clear();
+        for (; next < count; ++next) {
+            const uint8_t pkt_scv = pkts[next]->getScrambling();
+            if (pkt_scv == scv) {
+                const size_t psize = pkts[next]->getPayloadSize();
+                if (psize > 0) {
+                    payloads.push_back(pkts[next]->getPayload());
+                    sizes.push_back(psize);
+                }
+            }
+            else if (pkt_scv == SC_EVEN_KEY || pkt_scv == SC_ODD_KEY) {
+                break;
+            }
+        }
+
+        // Decrypt all packets with the same control word.
+        size_t decrypted = 0;
+        const bool success = _dvbcsa[scv & 1].decryptInPlaceBatch(payloads.size(), payloads.data(), sizes.data(), &decrypted);
+
+        // Mark the decrypted packets as clear. On error, some leading packets may have been decrypted
+        // anyway (usage limit of the control word). Stop on the first packet which was not decrypted.
+        for (size_t i = first, index = 0; i < next; ++i) {
+            if (pkts[i]->getScrambling() == scv) {
+                if (pkts[i]->getPayloadSize() > 0 && index++ >= decrypted) {
+                    next = i;
+                    break;
+                }
+                pkts[i]->setScrambling(SC_CLEAR);
+            }
+        }
+        if (!success) {
+            _report.error(u"packet decryption error using %s", {_dvbcsa[scv & 1].name()});
+            break;
+        }
+    }
+
+    // On error, the loop was interrupted on the failing packet.
+    if (processed != nullptr) {
+        *processed = next;
+    }
+    return next >= count;
+}
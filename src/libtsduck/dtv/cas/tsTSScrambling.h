@@ -206,6 +206,20 @@ namespace ts {
         //!
         bool decrypt(TSPacket& pkt);
 
+        //!
+        //! Decrypt a batch of TS packets with the CW corresponding to the parity in each packet.
+        //! The result is the same as calling decrypt() on each packet, in sequence. With DVB-CSA2,
+        //! consecutive packets with the same parity are decrypted in parallel, which is faster.
+        //! @param [in,out] pkts Array of @a count addresses of packets to decrypt.
+        //! @param [in] count Number of packets to decrypt.
+        //! @param [out] processed Optional address of a variable which receives the number of
+        //! processed packets. On error, this is the index of the first failing packet.
+        //! @return True on success, false on error. A clear packet is not an error.
+        //! On error, the packets before the failing one are decrypted and marked as clear,
+        //! the failing packet and the packets after it are left unmodified.
+        //!
+        bool decrypt(TSPacket* const pkts[], size_t count, size_t* processed = nullptr);
+
     private:
         // List of control words
         typedef std::list<ByteBlock> CWList;
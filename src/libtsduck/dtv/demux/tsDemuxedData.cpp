@@ -118,7 +118,17 @@ void ts::DemuxedData::reload(const void* content, size_t content_size, PID sourc
 {
     _source_pid = source_pid;
     _first_pkt = _last_pkt = 0;
-    _data = new ByteBlock(content, content_size);
+
+    // Recycle the previous buffer when it is not shared with another object.
+    // This avoids a heap allocation when the same object is reloaded many times.
+    // The new content must not be inside the previous buffer, which may be reallocated.
+    const uint8_t* const addr = reinterpret_cast<const uint8_t*>(content);
+    if (!_data.isNull() && _data.count() == 1 && (addr + content_size <= _data->data() || addr >= _data->data() + _data->capacity())) {
+        _data->copy(content, content_size);
+    }
+    else {
+        _data = new ByteBlock(content, content_size);
+    }
 }
 
 void ts::DemuxedData::reload(const ByteBlock& content, PID source_pid)
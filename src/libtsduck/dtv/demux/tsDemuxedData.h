@@ -95,6 +95,7 @@ namespace ts {
 
         //!
         //! Reload from full binary content.
+        //! If the previous content buffer is not shared with another object, it is recycled.
         //! @param [in] content Address of the binary packet data.
         //! @param [in] content_size Size in bytes of the packet.
         //! @param [in] source_pid PID from which the data were read.
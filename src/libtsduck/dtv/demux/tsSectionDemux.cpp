@@ -190,6 +190,91 @@ void ts::SectionDemux::ETIDContext::notify(SectionDemux& demux, bool pack, bool
 }
 
 
+//----------------------------------------------------------------------------
+// Hash table of TID/TIDext contexts in one PID.
+//----------------------------------------------------------------------------
+
+ts::SectionDemux::ETIDTable::ETIDTable() :
+    _slots(),
+    _count(0)
+{
+}
+
+ts::SectionDemux::ETIDTable::~ETIDTable()
+{
+    clear();
+}
+
+// Delete all contexts.
+void ts::SectionDemux::ETIDTable::clear()
+{
+    for (auto& slot : _slots) {
+        delete slot.context;
+    }
+    _slots.clear();
+    _count = 0;
+}
+
+// Index of the slot for an ETID. The table must not be full.
+size_t ts::SectionDemux::ETIDTable::lookup(const ETID& etid) const
+{
+    const size_t mask = _slots.size() - 1;
+    uint32_t hash = ((uint32_t(etid.tid()) << 16) | etid.tidExt()) * 0x9E3779B1;
+    size_t index = (hash ^ (hash >> 15)) & mask;
+    while (_slots[index].context != nullptr && !(_slots[index].etid == etid)) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+// Get the context for an ETID, create it if it does not exist.
+ts::SectionDemux::ETIDContext& ts::SectionDemux::ETIDTable::get(const ETID& etid)
+{
+    // Fast path: existing context.
+    if (!_slots.empty()) {
+        const size_t index = lookup(etid);
+        if (_slots[index].context != nullptr) {
+            return *_slots[index].context;
+        }
+    }
+
+    // Keep the load factor below 1/2, grow the table when necessary.
+    if (2 * (_count + 1) > _slots.size()) {
+        std::vector<Slot> old(std::max<size_t>(8, 2 * _slots.size()), Slot{ETID(), nullptr});
+        old.swap(_slots);
+        for (const auto& slot : old) {
+            if (slot.context != nullptr) {
+                _slots[lookup(slot.etid)] = slot;
+            }
+        }
+    }
+
+    // Create a new context.
+    Slot& slot(_slots[lookup(etid)]);
+    slot.etid = etid;
+    slot.context = new ETIDContext;
+    _count++;
+    return *slot.context;
+}
+
+// Get all contexts, sorted by ETID.
+void ts::SectionDemux::ETIDTable::getSorted(std::vector<ETIDContext*>& contexts) const
+{
+    std::vector<Slot> used;
+    used.reserve(_count);
+    for (const auto& slot : _slots) {
+        if (slot.context != nullptr) {
+            used.push_back(slot);
+        }
+    }
+    std::sort(used.begin(), used.end(), [](const Slot& a, const Slot& b) { return a.etid < b.etid; });
+    contexts.clear();
+    for (const auto& slot : used) {
+        contexts.push_back(slot.context);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Analysis context for one PID.
 //----------------------------------------------------------------------------
@@ -220,7 +305,8 @@ ts::SectionDemux::SectionDemux(DuckContext& duck, TableHandlerInterface* table_h
     _table_handler(table_handler),
     _section_handler(section_handler),
     _invalid_handler(nullptr),
-    _pids(),
+    _pids(PID_MAX),
+    _recycled_section(),
     _status(),
     _get_current(true),
     _get_next(false),
@@ -229,6 +315,10 @@ ts::SectionDemux::SectionDemux(DuckContext& duck, TableHandlerInterface* table_h
 {
 }
 
+ts::SectionDemux::~SectionDemux()
+{
+}
+
 
 //----------------------------------------------------------------------------
 // Reset the analysis context (partially built sections and tables).
@@ -237,13 +327,17 @@ ts::SectionDemux::SectionDemux(DuckContext& duck, TableHandlerInterface* table_h
 void ts::SectionDemux::immediateReset()
 {
     SuperClass::immediateReset();
-    _pids.clear();
+    for (auto& pc : _pids) {
+        pc.reset();
+    }
 }
 
 void ts::SectionDemux::immediateResetPID(PID pid)
 {
     SuperClass::immediateResetPID(pid);
-    _pids.erase(pid);
+    if (pid < _pids.size()) {
+        _pids[pid].reset();
+    }
 }
 
 
@@ -270,7 +364,10 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
     // Get PID and reference to the PID context.
     // The PID context is created if did not exist.
     const PID pid = pkt.getPID();
-    PIDContext& pc(_pids[pid]);
+    if (_pids[pid] == nullptr) {
+        _pids[pid].reset(new PIDContext);
+    }
+    PIDContext& pc(*_pids[pid]);
 
     // If TS packet is scrambled, we cannot decode it and we loose synchronization
     // on this PID (usually, PID's carrying sections are not scrambled).
@@ -489,7 +586,7 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
             // Get reference to the ETID context for this PID.
             // The ETID context is created if did not exist.
             // Avoid accumulating partial sections when there is no table handler.
-            ETIDContext* tc = _table_handler == nullptr ? nullptr : &pc.tids[etid];
+            ETIDContext* tc = _table_handler == nullptr ? nullptr : &pc.tids.get(etid);
 
             // If this is a new version of the table, reset the TID context.
             // Note that short sections do not have versions, so the version
@@ -534,8 +631,20 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
             // hendler is registered or if this is a new section).
             SectionPtr sect_ptr;
 
-            if (section_ok && (_section_handler != nullptr || (tc != nullptr && tc->sects[section_number].isNull()))) {
+            if (section_ok && tc != nullptr && tc->sects[section_number].isNull()) {
+                // New section in a table, will be kept in the table.
                 sect_ptr = new Section(ts_start, section_length, pid, CRC32::CHECK);
+            }
+            else if (section_ok && _section_handler != nullptr) {
+                // Section only passed to the section handler: recycle the same section object and buffer.
+                // If the handler kept a shared copy of the previous section, a new buffer is allocated.
+                if (_recycled_section.isNull()) {
+                    _recycled_section = new Section;
+                }
+                _recycled_section->reload(ts_start, section_length, pid, CRC32::CHECK);
+                sect_ptr = _recycled_section;
+            }
+            if (!sect_ptr.isNull()) {
                 sect_ptr->setFirstTSPacketIndex(pusi_pkt_index);
                 sect_ptr->setLastTSPacketIndex(_packet_count);
                 if (!sect_ptr->isValid()) {
@@ -621,20 +730,25 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
 
 void ts::SectionDemux::fixAndFlush(bool pack, bool fill_eit)
 {
+    std::vector<ETIDContext*> contexts;
+
     // Loop on all PID's.
-    for (auto it1 = _pids.begin(); it1 != _pids.end(); ++it1) {
-        const PID pid = it1->first;
-        PIDContext& pc(it1->second);
+    for (PID pid = 0; pid < _pids.size(); ++pid) {
+        if (_pids[pid] == nullptr) {
+            continue;
+        }
+
+        // Loop on all TID's currently found in the PID, in increasing order.
+        _pids[pid]->tids.getSorted(contexts);
 
         // Mark that we are in the context of a table or section handler.
         // This is used to prevent the destruction of PID contexts during
         // the execution of a handler.
         beforeCallingHandler(pid);
         try {
-            // Loop on all TID's currently found in the PID.
-            for (auto it2 = pc.tids.begin(); it2 != pc.tids.end(); ++it2) {
+            for (auto tc : contexts) {
                 // Force a notification of the partial table, if any.
-                it2->second.notify(*this, pack, fill_eit);
+                tc->notify(*this, pack, fill_eit);
             }
         }
         catch (...) {
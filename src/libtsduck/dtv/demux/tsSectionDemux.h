@@ -70,6 +70,11 @@ namespace ts {
                               SectionHandlerInterface* section_handler = nullptr,
                               const PIDSet& pid_filter = NoPID);
 
+        //!
+        //! Destructor.
+        //!
+        virtual ~SectionDemux() override;
+
         // Inherited methods
         virtual void feedPacket(const TSPacket& pkt) override;
 
@@ -278,14 +283,48 @@ namespace ts {
             void notify(SectionDemux& demux, bool pack, bool fill_eit);
         };
 
+        // Small open-addressed hash table of TID/TIDext contexts in one PID, with linear probing.
+        // Most PID's carry one or a few table ids. EIT, ECM or DSM-CC PID's may carry hundreds of them.
+        // The contexts are individually allocated and never move, even when the table grows.
+        class ETIDTable
+        {
+            TS_NOCOPY(ETIDTable);
+        public:
+            // Constructor and destructor.
+            ETIDTable();
+            ~ETIDTable();
+
+            // Get the context for an ETID, create it if it does not exist.
+            ETIDContext& get(const ETID& etid);
+
+            // Get all contexts, sorted by ETID.
+            void getSorted(std::vector<ETIDContext*>& contexts) const;
+
+            // Delete all contexts.
+            void clear();
+
+        private:
+            struct Slot {
+                ETID         etid;
+                ETIDContext* context;  // nullptr for unused slot
+            };
+            std::vector<Slot> _slots;  // Size is zero or a power of 2.
+            size_t            _count;  // Number of used slots.
+
+            // Index of the slot for an ETID (the slot is either unused or the one of the ETID).
+            size_t lookup(const ETID& etid) const;
+        };
+
         // This internal structure contains the analysis context for one PID.
         struct PIDContext
         {
+            TS_NOCOPY(PIDContext);
+        public:
             PacketCounter pusi_pkt_index;     // Index of last packet with PUSI in this PID
             uint8_t       continuity;         // Last continuity counter
             bool          sync;               // We are synchronous in this PID
             ByteBlock     ts;                 // TS payload buffer
-            std::map<ETID,ETIDContext> tids;  // TID analysis contexts
+            ETIDTable     tids;               // TID analysis contexts
 
             // Default constructor.
             PIDContext();
@@ -304,7 +343,8 @@ namespace ts {
         TableHandlerInterface*          _table_handler;
         SectionHandlerInterface*        _section_handler;
         InvalidSectionHandlerInterface* _invalid_handler;
-        std::map<PID,PIDContext>        _pids;
+        std::vector<std::unique_ptr<PIDContext>> _pids;  // Indexed by PID, allocated on first use.
+        SectionPtr                      _recycled_section;  // Reused for sections which are not kept in a table.
         Status _status;
         bool   _get_current;
         bool   _get_next;
@@ -51,6 +51,13 @@ namespace ts {
     public:
         //!
         //! This hook is invoked when a complete section is available.
+        //!
+        //! The section object belongs to the demux and is valid during the execution of the hook only.
+        //! To limit heap allocations, the demux may reuse the same section object and buffer for
+        //! subsequent sections. An application which needs to keep the section must create its
+        //! own copy. With ShareMode::SHARE, the copy shares the binary content of the section,
+        //! without data copy, and the demux no longer reuses the buffer.
+        //!
         //! @param [in,out] demux The demux which sends the section.
         //! @param [in] section The new section from the demux.
         //!
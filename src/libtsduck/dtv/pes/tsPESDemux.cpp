@@ -35,6 +35,7 @@
 #include "tsPMT.h"
 #include "tsPSI.h"
 #include "tsPES.h"
+#include "tsMPEG2.h"
 #include "tsAVC.h"
 #include "tsHEVC.h"
 #include "tsVVC.h"
@@ -43,6 +44,14 @@
 #include "tsHEVCAccessUnitDelimiter.h"
 #include "tsVVCAccessUnitDelimiter.h"
 
+// Sizes of data which are collected in streaming mode.
+namespace {
+    constexpr size_t MAX_PES_HEADER_SIZE = 9 + 255;  // Maximum size of a PES header.
+    constexpr size_t CONTENT_CHECK_SIZE = 64;        // Size of payload to check before identifying the content.
+    constexpr size_t AUDIO_HEADER_SIZE = 128;        // Size of audio payload to analyze for attributes.
+    constexpr size_t MAX_UNIT_SIZE = 64 * 1024;      // Max size of collected video units, larger ones are ignored.
+}
+
 
 //----------------------------------------------------------------------------
 // Constructors and destructors.
@@ -52,6 +61,7 @@ ts::PESDemux::PESDemux(DuckContext& duck, PESHandlerInterface* pes_handler, cons
     SuperClass(duck, pid_filter),
     _pes_handler(pes_handler),
     _default_codec(CodecType::UNDEFINED),
+    _streaming(false),
     _pids(),
     _pid_types(),
     _section_demux(_duck, this)
@@ -77,7 +87,18 @@ ts::PESDemux::PIDContext::PIDContext() :
     avc(),
     hevc(),
     ac3(),
-    ac3_count(0)
+    ac3_count(0),
+    parser(Parser::DONE),
+    ac3_pes(false),
+    after_seq(false),
+    need_type(false),
+    collect(false),
+    zeros(0),
+    pl_size(0),
+    pl_offset(0),
+    head(),
+    unit(),
+    pes()
 {
 }
 
@@ -127,6 +148,22 @@ ts::CodecType ts::PESDemux::getDefaultCodec(PID pid) const
 }
 
 
+//----------------------------------------------------------------------------
+// Set the streaming mode of the demux.
+//----------------------------------------------------------------------------
+
+void ts::PESDemux::setStreamingMode(bool on)
+{
+    if (on != _streaming) {
+        _streaming = on;
+        // Partially demultiplexed PES packets were collected in the other mode, drop them.
+        for (auto& it : _pids) {
+            it.second.syncLost();
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Get current audio/video attributes on the specified PID.
 // Check isValid() on returned object.
@@ -232,7 +269,12 @@ void ts::PESDemux::processPacket(const TSPacket& pkt)
     // If at a unit start and the context exists, process previous PES packet in context
     if (pc_exists && pkt.getPUSI() && pci->second.sync) {
         // Process packet, invoke all handlers
-        processPESPacket(pid, pci->second);
+        if (_streaming) {
+            processStreamingData(pid, pci->second, nullptr, 0, true);
+        }
+        else {
+            processPESPacket(pid, pci->second);
+        }
         // Recheck PID context in case it was reset by a handler
         pci = _pids.find(pid);
         pc_exists = pci != _pids.end();
@@ -261,10 +303,18 @@ void ts::PESDemux::processPacket(const TSPacket& pkt)
             PIDContext& pc(_pids[pid]);
             pc.continuity = pkt.getCC();
             pc.sync = true;
-            pc.ts->copy(pl, pl_size);
             pc.first_pkt = _packet_count;
             pc.last_pkt = _packet_count;
             pc.pcr = pkt.getPCR(); // can be invalid
+            if (_streaming) {
+                // Start collecting the PES header, the payload is never accumulated.
+                pc.parser = Parser::HEADER;
+                pc.head.clear();
+                processStreamingData(pid, pc, pl, pl_size, false);
+            }
+            else {
+                pc.ts->copy(pl, pl_size);
+            }
         }
         else if (pc_exists) {
             // This PID does not contain PES packet, reset context
@@ -293,6 +343,20 @@ void ts::PESDemux::processPacket(const TSPacket& pkt)
     }
     pc.continuity = pkt.getCC();
 
+    // Last TS packet containing actual data for this PES packet
+    pc.last_pkt = _packet_count;
+
+    // Keep track of first PCR in the PES packet.
+    if (pc.pcr == INVALID_PCR && pkt.hasPCR()) {
+        pc.pcr = pkt.getPCR();
+    }
+
+    // In streaming mode, directly process the TS payload.
+    if (_streaming) {
+        processStreamingData(pid, pc, pl, pl_size, false);
+        return;
+    }
+
     // Append the TS payload in PID context.
     size_t capacity = pc.ts->capacity();
     if (pc.ts->size() + pl_size > capacity) {
@@ -313,14 +377,6 @@ void ts::PESDemux::processPacket(const TSPacket& pkt)
     }
     pc.ts->append(pl, pl_size);
 
-    // Last TS packet containing actual data for this PES packet
-    pc.last_pkt = _packet_count;
-
-    // Keep track of first PCR in the PES packet.
-    if (pc.pcr == INVALID_PCR && pkt.hasPCR()) {
-        pc.pcr = pkt.getPCR();
-    }
-
     // Check if the complete PES packet is now present (without waiting for the next PUSI).
     if (pc.ts->size() >= 6 && pc.sync) {
         // There is enought to get the PES packet length.
@@ -557,3 +613,377 @@ void ts::PESDemux::handlePESContent(PIDContext& pc, const PESPacket& pes)
         }
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Streaming mode: process a fragment of PES packet.
+//----------------------------------------------------------------------------
+
+void ts::PESDemux::processStreamingData(PID pid, PIDContext& pc, const uint8_t* data, size_t size, bool pes_end)
+{
+    // Nothing to do after the end of the PES packet or on invalid PES packets.
+    if (pc.parser == Parser::DONE) {
+        return;
+    }
+
+    // Mark that we are in the context of handlers (see processPESPacket()).
+    // The PID context cannot be deleted until afterCallingHandler().
+    beforeCallingHandler(pid);
+    try {
+        // Location of the PES packet inside the demultiplexed stream.
+        pc.pes.setLastTSPacketIndex(pc.last_pkt);
+        pc.pes.setPCR(pc.pcr);
+
+        if (pc.parser == Parser::HEADER) {
+            // Accumulate the PES header and the start of the payload until the content can be identified.
+            pc.head.append(data, size);
+            const size_t hsize = PESPacket::HeaderSize(pc.head.data(), pc.head.size());
+            const size_t psize = pc.head.size() < 6 ? 0 : 6 + size_t(GetUInt16(pc.head.data() + 4));
+            if (hsize == 0) {
+                // Incomplete header, unless there are enough data for the largest header.
+                if (pes_end || pc.head.size() >= MAX_PES_HEADER_SIZE) {
+                    pc.parser = Parser::DONE;
+                }
+            }
+            else if (psize != 6 && psize < hsize) {
+                // Invalid PES packet size.
+                pc.parser = Parser::DONE;
+            }
+            else if (pes_end || pc.head.size() >= hsize + CONTENT_CHECK_SIZE || (psize != 6 && pc.head.size() >= psize)) {
+                // Enough data to identify the content, process the collected payload.
+                startStreamingPES(pid, pc, hsize, psize);
+                processStreamingPayload(pc, pc.head.data() + hsize, pc.head.size() - hsize);
+            }
+        }
+        else {
+            processStreamingPayload(pc, data, size);
+        }
+
+        // End of PES packet, either at next unit start or when the declared size is reached.
+        if (pc.parser != Parser::HEADER && pc.parser != Parser::DONE && (pes_end || pc.pl_offset >= pc.pl_size)) {
+            endStreamingPES(pc);
+        }
+    }
+    catch (...) {
+        afterCallingHandler(false);
+        throw;
+    }
+    afterCallingHandler(true);
+}
+
+
+//----------------------------------------------------------------------------
+// Streaming mode: identify the content of the PES packet.
+//----------------------------------------------------------------------------
+
+void ts::PESDemux::startStreamingPES(PID pid, PIDContext& pc, size_t header_size, size_t pes_size)
+{
+    // PES data to check, same as the complete PES packet in processPESPacket().
+    const uint8_t* const data = pc.head.data();
+    const size_t size = pes_size == 6 ? pc.head.size() : std::min(pc.head.size(), pes_size);
+    const uint8_t* const pl_data = data + header_size;
+    const size_t pl_size = size - header_size;
+
+    // Stream type and codec, if known.
+    uint8_t stream_type = ST_NULL;
+    CodecType codec = CodecType::UNDEFINED;
+    const auto it_type = _pid_types.find(pid);
+    if (it_type != _pid_types.end()) {
+        stream_type = it_type->second.stream_type;
+        codec = it_type->second.default_codec;
+    }
+
+    // Use a default codec if none was set from the PMT and the data look compatible.
+    const CodecType default_codec = getDefaultCodec(pid);
+    if (codec == CodecType::UNDEFINED && default_codec != CodecType::UNDEFINED && PESPacket::IsCompatibleCodec(default_codec, data, size, stream_type)) {
+        codec = default_codec;
+    }
+
+    // Format of AVC/HEVC/VVC access units, same rules as AccessUnitIterator.
+    CodecType au_format = CodecType::UNDEFINED;
+    if (PESPacket::HasCommonVideoHeader(pl_data, pl_size)) {
+        if (StreamTypeIsAVC(stream_type)) {
+            au_format = CodecType::AVC;
+        }
+        else if (StreamTypeIsHEVC(stream_type)) {
+            au_format = CodecType::HEVC;
+        }
+        else if (StreamTypeIsVVC(stream_type)) {
+            au_format = CodecType::VVC;
+        }
+        else if (stream_type == ST_NULL && (codec == CodecType::AVC || codec == CodecType::HEVC || codec == CodecType::VVC)) {
+            au_format = codec;
+        }
+    }
+
+    // Select the content analysis, same as handlePESContent() on complete PES packets.
+    pc.parser = Parser::NONE;
+    pc.ac3_pes = false;
+    if (_pes_handler == nullptr) {
+        // No analysis without a handler.
+    }
+    else if (au_format == CodecType::AVC) {
+        pc.parser = Parser::AVC;
+    }
+    else if (au_format == CodecType::HEVC) {
+        pc.parser = Parser::HEVC;
+    }
+    else if (au_format != CodecType::UNDEFINED) {
+        // VVC, no attribute to analyze.
+    }
+    else if (codec == CodecType::MPEG1_VIDEO || codec == CodecType::MPEG2_VIDEO || PESPacket::IsMPEG2Video(data, size, stream_type)) {
+        pc.parser = Parser::MPEG2_VIDEO;
+    }
+    else if (codec == CodecType::AC3 || codec == CodecType::EAC3 || PESPacket::IsAC3(data, size, stream_type)) {
+        pc.parser = Parser::AC3;
+        pc.ac3_pes = true;
+    }
+    else if (IsAudioSID(data[3])) {
+        pc.parser = Parser::AUDIO;
+    }
+
+    // Reset the analysis of the payload. The state of MPEG-1/2 video units (after_seq)
+    // is preserved since a sequence header may be at the end of the previous PES packet.
+    pc.need_type = false;
+    pc.collect = false;
+    pc.zeros = 0;
+    pc.unit.clear();
+    pc.pl_size = pes_size == 6 ? NPOS : pes_size - header_size;
+    pc.pl_offset = 0;
+
+    // Build the header-only PES packet which is passed to the handlers.
+    // The PES_packet_length is cleared to make it a valid PES packet.
+    PutUInt16(pc.head.data() + 4, 0);
+    pc.pes.reload(pc.head.data(), header_size, pid);
+    pc.pes.setFirstTSPacketIndex(pc.first_pkt);
+    pc.pes.setLastTSPacketIndex(pc.last_pkt);
+    pc.pes.setPCR(pc.pcr);
+    pc.pes.setStreamType(stream_type);
+    pc.pes.setCodec(codec);
+}
+
+
+//----------------------------------------------------------------------------
+// Streaming mode: process a fragment of PES payload.
+//----------------------------------------------------------------------------
+
+void ts::PESDemux::processStreamingPayload(PIDContext& pc, const uint8_t* data, size_t size)
+{
+    // Ignore data after the declared end of PES packet.
+    size = std::min(size, pc.pl_size - pc.pl_offset);
+    if (size == 0) {
+        return;
+    }
+
+    // Pass the fragment to the handler.
+    if (_pes_handler != nullptr) {
+        _pes_handler->handlePESPayload(*this, pc.pes, data, size, pc.pl_offset);
+    }
+    pc.pl_offset += size;
+
+    switch (pc.parser) {
+        case Parser::MPEG2_VIDEO:
+        case Parser::AVC:
+        case Parser::HEVC: {
+            analyzeVideoData(pc, data, size);
+            break;
+        }
+        case Parser::AC3:
+        case Parser::AUDIO: {
+            // Only the beginning of the audio payload is analyzed. Avoid a copy when the
+            // first fragment is large enough, which is the most common case.
+            if (pc.unit.empty() && size >= AUDIO_HEADER_SIZE) {
+                pc.unit.copy(data, AUDIO_HEADER_SIZE);
+            }
+            else {
+                pc.unit.append(data, std::min(size, AUDIO_HEADER_SIZE - pc.unit.size()));
+            }
+            if (pc.unit.size() >= AUDIO_HEADER_SIZE) {
+                analyzeStreamingUnit(pc);
+            }
+            break;
+        }
+        case Parser::HEADER:
+        case Parser::NONE:
+        case Parser::DONE:
+        default: {
+            break;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Streaming mode: complete the analysis at the end of the PES packet.
+//----------------------------------------------------------------------------
+
+void ts::PESDemux::endStreamingPES(PIDContext& pc)
+{
+    // A PES packet which is shorter than its declared size is invalid.
+    if (pc.pl_size != NPOS && pc.pl_offset < pc.pl_size) {
+        pc.parser = Parser::DONE;
+        return;
+    }
+
+    // The last video unit extends up to the end of the PES payload.
+    // Audio payloads which are shorter than the expected header are analyzed as is.
+    if (pc.collect || pc.parser == Parser::AC3 || pc.parser == Parser::AUDIO) {
+        pc.collect = false;
+        analyzeStreamingUnit(pc);
+    }
+
+    // Count valid PES packets.
+    pc.pes_count++;
+    if (pc.ac3_pes) {
+        pc.ac3_count++;
+    }
+    pc.parser = Parser::DONE;
+}
+
+
+//----------------------------------------------------------------------------
+// Streaming mode: look for interesting video units in a fragment of payload.
+//----------------------------------------------------------------------------
+
+void ts::PESDemux::analyzeVideoData(PIDContext& pc, const uint8_t* data, size_t size)
+{
+    // MPEG-1/2 video units end at the next start code prefix 00 00 01.
+    // AVC/HEVC NALunits end at 00 00 00 or 00 00 01 (see AccessUnitIterator).
+    // The start code prefix is part of the MPEG-1/2 video units, not of the NALunits.
+    static const uint8_t StartCodePrefix[] = {0x00, 0x00, 0x01};
+    const bool nalunits = pc.parser != Parser::MPEG2_VIDEO;
+    const uint8_t* const end = data + size;
+
+    while (data < end) {
+        if (pc.collect) {
+            // Collect the current unit, up to its end.
+            for (; data < end; ++data) {
+                const uint8_t b = *data;
+                if (pc.zeros >= 2 && (b == 0x01 || (nalunits && b == 0x00))) {
+                    // End of unit, remove the two zeroes which were already collected.
+                    pc.unit.resize(pc.unit.size() - 2);
+                    pc.collect = false;
+                    analyzeStreamingUnit(pc);
+                    if (b == 0x01) {
+                        // Start code prefix, the next byte is the unit type.
+                        pc.need_type = true;
+                        pc.zeros = 0;
+                        ++data;
+                    }
+                    break;
+                }
+                pc.unit.push_back(b);
+                pc.zeros = b == 0x00 ? std::min<size_t>(pc.zeros + 1, 2) : 0;
+                if (pc.unit.size() >= MAX_UNIT_SIZE) {
+                    // Abnormally large unit, certainly not a sequence header or parameter set, ignore it.
+                    pc.collect = false;
+                    pc.unit.clear();
+                    ++data;
+                    break;
+                }
+            }
+        }
+        else if (pc.need_type) {
+            // First byte after a start code prefix: check if the unit is interesting.
+            // This byte remains in the data to analyze since it is part of the unit.
+            const uint8_t type = *data;
+            pc.need_type = false;
+            pc.unit.clear();
+            if (pc.parser == Parser::MPEG2_VIDEO) {
+                // Keep sequence headers and the unit which follows (normally a sequence extension).
+                pc.collect = type == PST_SEQUENCE_HEADER || pc.after_seq;
+                pc.after_seq = type == PST_SEQUENCE_HEADER;
+                pc.unit.copy(StartCodePrefix, sizeof(StartCodePrefix));
+            }
+            else if (pc.parser == Parser::AVC) {
+                pc.collect = (type & 0x1F) == AVC_AUT_SEQPARAMS;
+            }
+            else {
+                pc.collect = ((type >> 1) & 0x3F) == HEVC_AUT_SPS_NUT;
+            }
+        }
+        else {
+            // Look for the next start code prefix. Locate the next 01 and check the preceding zeroes,
+            // possibly at the end of the previous fragment.
+            const uint8_t* const one = reinterpret_cast<const uint8_t*>(std::memchr(data, 0x01, end - data));
+            const uint8_t* const limit = one == nullptr ? end : one;
+            size_t count = 0;
+            while (count < 2 && limit - count > data && *(limit - count - 1) == 0x00) {
+                count++;
+            }
+            if (limit - count == data) {
+                count = std::min<size_t>(count + pc.zeros, 2);
+            }
+            if (one == nullptr) {
+                pc.zeros = count;
+                data = end;
+            }
+            else {
+                pc.need_type = count >= 2;
+                pc.zeros = 0;
+                data = one + 1;
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Streaming mode: analyze the collected video unit or audio frame header.
+//----------------------------------------------------------------------------
+
+void ts::PESDemux::analyzeStreamingUnit(PIDContext& pc)
+{
+    // The handler can be removed by a previous handler.
+    if (_pes_handler == nullptr) {
+        return;
+    }
+
+    // Accumulate info from video units or audio frames to extract attributes.
+    // If new attributes were found, invoke handler.
+    const uint8_t* const data = pc.unit.data();
+    const size_t size = pc.unit.size();
+
+    switch (pc.parser) {
+        case Parser::MPEG2_VIDEO: {
+            if (pc.video.moreBinaryData(data, size)) {
+                _pes_handler->handleNewMPEG2VideoAttributes(*this, pc.pes, pc.video);
+            }
+            break;
+        }
+        case Parser::AVC: {
+            if (pc.avc.moreBinaryData(data, size)) {
+                _pes_handler->handleNewAVCAttributes(*this, pc.pes, pc.avc);
+            }
+            break;
+        }
+        case Parser::HEVC: {
+            if (pc.hevc.moreBinaryData(data, size)) {
+                _pes_handler->handleNewHEVCAttributes(*this, pc.pes, pc.hevc);
+            }
+            break;
+        }
+        case Parser::AC3: {
+            // Audio frame header analyzed once per PES packet.
+            pc.parser = Parser::NONE;
+            if (pc.ac3.moreBinaryData(data, size)) {
+                _pes_handler->handleNewAC3Attributes(*this, pc.pes, pc.ac3);
+            }
+            break;
+        }
+        case Parser::AUDIO: {
+            // Audio frame header analyzed once per PES packet.
+            pc.parser = Parser::NONE;
+            if (pc.audio.moreBinaryData(data, size)) {
+                _pes_handler->handleNewMPEG2AudioAttributes(*this, pc.pes, pc.audio);
+            }
+            break;
+        }
+        case Parser::HEADER:
+        case Parser::NONE:
+        case Parser::DONE:
+        default: {
+            break;
+        }
+    }
+}
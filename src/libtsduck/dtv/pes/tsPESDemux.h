@@ -160,6 +160,32 @@ namespace ts {
         //!
         bool allAC3(PID pid) const;
 
+        //!
+        //! Set the streaming mode of the demux.
+        //! By default, complete PES packets are reassembled before being analyzed and passed to the handler.
+        //! In streaming mode, PES packets are never reassembled. The payload is passed to the handler
+        //! using PESHandlerInterface::handlePESPayload(), fragment by fragment, as views inside the TS packets.
+        //! The audio and video attributes are extracted on the fly from these fragments. Only the few data
+        //! which are needed to compute the attributes (PES header, video sequence header, audio frame header)
+        //! are copied. This is much faster when the complete PES packets are not needed.
+        //!
+        //! In streaming mode, the handlers handlePESPacket(), handleVideoStartCode(), handleAccessUnit(),
+        //! handleSEI() and handleIntraImage() are never invoked. The PES packet which is passed to the other
+        //! handlers contains the PES header only. Since a PES packet is analyzed while it is received,
+        //! its attributes may be reported before the packet is known to be complete.
+        //!
+        //! Changing the mode drops the PES packets which are currently being demultiplexed.
+        //! @param [in] on True to use the streaming mode, false to reassemble complete PES packets.
+        //!
+        void setStreamingMode(bool on);
+
+        //!
+        //! Check if the demux is in streaming mode.
+        //! @return True if the demux is in streaming mode.
+        //! @see setStreamingMode()
+        //!
+        bool streamingMode() const { return _streaming; }
+
     protected:
         //!
         //! This hook is invoked when a complete PES packet is available.
@@ -173,6 +199,18 @@ namespace ts {
         virtual void immediateResetPID(PID pid) override;
 
     private:
+        // Analysis of the current PES packet in streaming mode.
+        enum class Parser : uint8_t {
+            HEADER,       // Collecting the PES header and start of payload to identify the content.
+            NONE,         // No content analysis, payload is only passed to the handler.
+            MPEG2_VIDEO,  // Look for MPEG-1/2 sequence header and extension.
+            AVC,          // Look for AVC sequence parameter set.
+            HEVC,         // Look for HEVC sequence parameter set.
+            AC3,          // Collect AC-3 frame header.
+            AUDIO,        // Collect MPEG audio frame header.
+            DONE          // End of current PES packet or invalid PES packet.
+        };
+
         // This internal structure contains the analysis context for one PID.
         struct PIDContext
         {
@@ -189,12 +227,23 @@ namespace ts {
             HEVCAttributes       hevc;        // Current HEVC attributes
             AC3Attributes        ac3;         // Current AC-3 attributes
             PacketCounter        ac3_count;   // Number of PES packets with contents which looks like AC-3
+            Parser               parser;      // Streaming mode: analysis of current PES packet
+            bool                 ac3_pes;     // Streaming mode: current PES packet contains AC-3
+            bool                 after_seq;   // Streaming mode: next MPEG-1/2 video unit follows a sequence header
+            bool                 need_type;   // Streaming mode: start code prefix found, next byte is the unit type
+            bool                 collect;     // Streaming mode: collecting the current video unit
+            size_t               zeros;       // Streaming mode: number of zeroes before the current position (max 2)
+            size_t               pl_size;     // Streaming mode: declared PES payload size, NPOS if unbounded
+            size_t               pl_offset;   // Streaming mode: size of PES payload already processed
+            ByteBlock            head;        // Streaming mode: PES header and start of payload to identify the content
+            ByteBlock            unit;        // Streaming mode: video unit or audio frame header being collected
+            PESPacket            pes;         // Streaming mode: PES header only, as passed to handlers
 
             // Default constructor:
             PIDContext();
 
             // Called when packet synchronization is lost on the pid
-            void syncLost() {sync = false; ts->clear();}
+            void syncLost() {sync = false; ts->clear(); parser = Parser::DONE;}
         };
 
         // Map of PID contexts, indexed by PID.
@@ -224,12 +273,31 @@ namespace ts {
         // Process all video/audio analysis on the PES packet.
         void handlePESContent(PIDContext&, const PESPacket&);
 
+        // Streaming mode: process a fragment of PES packet, optionally at end of PES packet.
+        void processStreamingData(PID, PIDContext&, const uint8_t* data, size_t size, bool pes_end);
+
+        // Streaming mode: identify the content of the PES packet from the collected header.
+        void startStreamingPES(PID, PIDContext&, size_t header_size, size_t pes_size);
+
+        // Streaming mode: pass a fragment of PES payload to the handler and analyze it.
+        void processStreamingPayload(PIDContext&, const uint8_t* data, size_t size);
+
+        // Streaming mode: complete the analysis at the end of the PES packet.
+        void endStreamingPES(PIDContext&);
+
+        // Streaming mode: look for interesting video units in a fragment of PES payload.
+        void analyzeVideoData(PIDContext&, const uint8_t* data, size_t size);
+
+        // Streaming mode: analyze the collected video unit or audio frame header.
+        void analyzeStreamingUnit(PIDContext&);
+
         // Implementation of TableHandlerInterface.
         virtual void handleTable(SectionDemux& demux, const BinaryTable& table) override;
 
         // Private members:
         PESHandlerInterface* _pes_handler;
         CodecType            _default_codec;
+        bool                 _streaming;
         PIDContextMap        _pids;
         PIDTypeMap           _pid_types;
         SectionDemux         _section_demux;
@@ -34,6 +34,7 @@
 #define IMPL(profile) void ts::PESHandlerInterface::profile {}
 
 IMPL(handlePESPacket(PESDemux&, const PESPacket&))
+IMPL(handlePESPayload(PESDemux&, const PESPacket&, const uint8_t*, size_t, size_t))
 IMPL(handleVideoStartCode(PESDemux&, const PESPacket&, uint8_t, size_t, size_t))
 IMPL(handleNewMPEG2VideoAttributes(PESDemux&, const PESPacket&, const MPEG2VideoAttributes&))
 IMPL(handleAccessUnit(PESDemux&, const PESPacket&, uint8_t, size_t, size_t))
@@ -59,6 +59,23 @@ namespace ts {
         //!
         virtual void handlePESPacket(PESDemux& demux, const PESPacket& packet);
 
+        //!
+        //! This hook is invoked in streaming mode for each fragment of a PES packet payload.
+        //! In streaming mode, the PES packets are not reassembled and the payload is passed
+        //! to the handler, piece by piece, as it is found in the TS packets.
+        //! @param [in,out] demux A reference to the PES demux.
+        //! @param [in] packet The PES packet which is being demultiplexed. In streaming mode,
+        //! it contains the PES header only, with a zero PES_packet_length.
+        //! @param [in] data Address of the payload fragment. This is a view inside the TS packet
+        //! or the demux internal buffers which is valid during the execution of the handler only.
+        //! The handler must copy the data when they need to be kept.
+        //! @param [in] size Size in bytes of the payload fragment.
+        //! @param [in] offset Offset of the fragment in the PES packet payload. A zero offset
+        //! indicates the start of a new PES packet.
+        //! @see PESDemux::setStreamingMode()
+        //!
+        virtual void handlePESPayload(PESDemux& demux, const PESPacket& packet, const uint8_t* data, size_t size, size_t offset);
+
         //!
         //! This hook is invoked when a video start code is encountered.
         //! @param [in,out] demux A reference to the PES demux.
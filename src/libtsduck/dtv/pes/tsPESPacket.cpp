@@ -353,14 +353,19 @@ void ts::PESPacket::setDefaultCodec(CodecType default_codec)
 {
     // If the codec if already set or the new one is undefined, nothing to do.
     if (_is_valid && _codec == CodecType::UNDEFINED && default_codec != CodecType::UNDEFINED) {
-        // Check if the specified default codec has a PES content checking function.
-        const auto it = StaticCodecCheckMap::Instance().find(default_codec);
-        if (it == StaticCodecCheckMap::Instance().end() || it->second(content(), size(), _stream_type)) {
+        if (IsCompatibleCodec(default_codec, content(), size(), _stream_type)) {
             _codec = default_codec;
         }
     }
 }
 
+bool ts::PESPacket::IsCompatibleCodec(CodecType codec, const uint8_t* data, size_t size, uint8_t stream_type)
+{
+    // Check if the specified codec has a PES content checking function.
+    const auto it = StaticCodecCheckMap::Instance().find(codec);
+    return it == StaticCodecCheckMap::Instance().end() || it->second(data, size, stream_type);
+}
+
 
 //----------------------------------------------------------------------------
 // Check if the PES packet contains MPEG-2 video (also applies to MPEG-1 video)
@@ -364,6 +364,18 @@ namespace ts {
         //!
         static bool IsAC3(const uint8_t* data, size_t size, uint8_t stream_type = ST_NULL);
 
+        //!
+        //! Check if a truncated PES packet may contain data which are encoded using a given codec.
+        //! This is the check which is applied by setDefaultCodec().
+        //! @param [in] codec The codec to check.
+        //! @param [in] data Address of data to check, typically the start of a PES packet.
+        //! @param [in] size Data size in bytes.
+        //! @param [in] stream_type Optional stream type, as found in the PMT. Used as a hint.
+        //! @return True if the PES data may contain data encoded with @a codec. Codecs without
+        //! specific content check are always considered as compatible.
+        //!
+        static bool IsCompatibleCodec(CodecType codec, const uint8_t* data, size_t size, uint8_t stream_type = ST_NULL);
+
         //!
         //! Check if a truncated PES packet starts with 00 00 00 [00...] 01, common header for AVC, HEVC and VVC.
         //! @param [in] data Address of data to check, typically the start of a PES packet.
@@ -387,6 +399,14 @@ namespace ts {
         //!
         static size_t FindIntraImage(const uint8_t* data, size_t size, uint8_t stream_type = ST_NULL, CodecType default_format = CodecType::UNDEFINED);
 
+        //!
+        //! Get the header size of the start of a PES packet.
+        //! @param [in] data Address of data to check, typically the start of a PES packet.
+        //! @param [in] size Data size in bytes.
+        //! @return The PES header size in bytes or zero if @a data does not contain a complete valid PES header.
+        //!
+        static size_t HeaderSize(const uint8_t* data, size_t size);
+
     private:
         // Private fields
         bool      _is_valid;     // Content of *_data is a valid packet
@@ -398,9 +418,6 @@ namespace ts {
         // Validate binary content.
         void validate();
 
-        // Get the header size of the start of a PES packet. Return 0 on error.
-        static size_t HeaderSize(const uint8_t* data, size_t size);
-
         //! Check if a truncated PES packet may contain AVC, HEVC or VVC.
         static bool IsXVC(bool (*StreamTypeCheck)(uint8_t), const uint8_t* data, size_t size, uint8_t stream_type);
 
@@ -28,6 +28,29 @@
 //----------------------------------------------------------------------------
 
 #include "tsCRC32.h"
+#include "tsSysInfo.h"
+#include "tsMemory.h"
+
+// Select the implementation of CRC32 folding using carry-less multiplication, if any.
+// On GCC and LLVM, the specific instructions are enabled on a function basis only,
+// the rest of the code remains portable. Use of these functions depends on the CPU.
+#if (defined(TS_I386) || defined(TS_X86_64)) && defined(TS_MSC)
+    #define TS_CRC32_FOLDING_INTEL 1
+    #define TS_CRC32_FOLDING_TARGET
+    #include <immintrin.h>
+#elif (defined(TS_I386) || defined(TS_X86_64)) && (defined(TS_GCC) || defined(TS_LLVM))
+    #define TS_CRC32_FOLDING_INTEL 1
+    #define TS_CRC32_FOLDING_TARGET __attribute__((target("pclmul,ssse3")))
+    #include <immintrin.h>
+#elif defined(TS_ARM64) && defined(TS_LLVM)
+    #define TS_CRC32_FOLDING_ARM64 1
+    #define TS_CRC32_FOLDING_TARGET __attribute__((target("aes")))
+    #include <arm_neon.h>
+#elif defined(TS_ARM64) && defined(TS_GCC)
+    #define TS_CRC32_FOLDING_ARM64 1
+    #define TS_CRC32_FOLDING_TARGET __attribute__((target("+crypto")))
+    #include <arm_neon.h>
+#endif
 
 
 // The FCS-32 generator polynomial:
@@ -104,13 +127,293 @@ namespace {
     };
 }
 
-// Continue the computation of a data area, following a previous CRC32
 
-void ts::CRC32::add (const void* data, size_t size)
+
+//----------------------------------------------------------------------------
+// Portable implementations.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Original implementation, one byte at a time.
+    uint32_t AddBytewise(uint32_t fcs, const uint8_t* cp, size_t size)
+    {
+        while (size-- > 0) {
+            fcs = (fcs << 8) ^ fcstab_32 [((fcs >> 24) ^ (*cp++)) & 0xFF];
+        }
+        return fcs;
+    }
+
+    // Tables for slicing-by-8: table[k][i] is the CRC contribution of byte i, followed by k zero bytes.
+    // The first table is fcstab_32. Built once, on first use.
+    class SlicingTables
+    {
+    public:
+        uint32_t table[8][256];
+
+        SlicingTables()
+        {
+            for (size_t i = 0; i < 256; ++i) {
+                table[0][i] = fcstab_32[i];
+            }
+            for (size_t k = 1; k < 8; ++k) {
+                for (size_t i = 0; i < 256; ++i) {
+                    const uint32_t prev = table[k-1][i];
+                    table[k][i] = (prev << 8) ^ fcstab_32[prev >> 24];
+                }
+            }
+        }
+    };
+
+    // Slicing-by-8 implementation, 8 bytes at a time.
+    uint32_t AddSlicing(uint32_t fcs, const uint8_t* cp, size_t size)
+    {
+        static const SlicingTables tables;
+        const uint32_t (&t)[8][256](tables.table);
+
+        while (size >= 8) {
+            const uint32_t w1 = fcs ^ ts::GetUInt32(cp);
+            const uint32_t w2 = ts::GetUInt32(cp + 4);
+            fcs = t[7][w1 >> 24] ^ t[6][(w1 >> 16) & 0xFF] ^ t[5][(w1 >> 8) & 0xFF] ^ t[4][w1 & 0xFF] ^
+                  t[3][w2 >> 24] ^ t[2][(w2 >> 16) & 0xFF] ^ t[1][(w2 >> 8) & 0xFF] ^ t[0][w2 & 0xFF];
+            cp += 8;
+            size -= 8;
+        }
+        return AddBytewise(fcs, cp, size);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Folding implementation using carry-less multiplication.
+//
+// The data are processed in 128-bit blocks, as polynomials with the first byte
+// in the most significant position (the MPEG CRC32 is not bit-reflected). An
+// accumulator X = H.x^64 + L, followed by a block D, is folded into X.x^128 + D,
+// which is congruent to H.(x^192 mod P) + L.(x^128 mod P) + D. Four accumulators
+// are used in parallel on 64-byte blocks, with the x^576 and x^512 constants.
+// The final 128-bit accumulator R is reduced to R.x^32 mod P, which is exactly
+// the CRC32 of the 16 bytes of R with a zero initial value.
+//----------------------------------------------------------------------------
+
+#if defined(TS_CRC32_FOLDING_INTEL) || defined(TS_CRC32_FOLDING_ARM64)
+
+namespace {
+
+    // Folding constants, x^n mod P, built once, on first use.
+    class FoldingConstants
+    {
+    public:
+        uint64_t x128;
+        uint64_t x192;
+        uint64_t x512;
+        uint64_t x576;
+
+        FoldingConstants() :
+            x128(XPowerModP(128)),
+            x192(XPowerModP(192)),
+            x512(XPowerModP(512)),
+            x576(XPowerModP(576))
+        {
+        }
+
+    private:
+        // Compute x^n mod P (P being the MPEG CRC32 polynomial).
+        static uint64_t XPowerModP(size_t n)
+        {
+            uint32_t value = 1;
+            while (n-- > 0) {
+                // fcstab_32[1] is the polynomial itself.
+                value = (value & 0x80000000) != 0 ? (value << 1) ^ fcstab_32[1] : (value << 1);
+            }
+            return value;
+        }
+    };
+
+    const FoldingConstants& GetFoldingConstants()
+    {
+        static const FoldingConstants constants;
+        return constants;
+    }
+}
+
+#endif
+
+#if defined(TS_CRC32_FOLDING_INTEL)
+
+namespace {
+
+    // Load a 128-bit block with the first byte in the most significant position.
+    TS_CRC32_FOLDING_TARGET inline __m128i Load(const uint8_t* cp, const __m128i& bswap)
+    {
+        return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(cp)), bswap);
+    }
+
+    // Fold accumulator x using the constants k (high: high part multiplier, low: low part multiplier) and add d.
+    TS_CRC32_FOLDING_TARGET inline __m128i Fold(const __m128i& x, const __m128i& k, const __m128i& d)
+    {
+        return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x11), _mm_clmulepi64_si128(x, k, 0x00)), d);
+    }
+
+    // Folding implementation, at least 64 bytes.
+    TS_CRC32_FOLDING_TARGET uint32_t AddFolding(uint32_t fcs, const uint8_t* cp, size_t size)
+    {
+        if (size < 64) {
+            return AddSlicing(fcs, cp, size);
+        }
+
+        const FoldingConstants& fc(GetFoldingConstants());
+        const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m128i k128 = _mm_set_epi64x(int64_t(fc.x192), int64_t(fc.x128));
+        const __m128i k512 = _mm_set_epi64x(int64_t(fc.x576), int64_t(fc.x512));
+
+        // Initial accumulators. The previous CRC is added to the first 32 bits of data.
+        __m128i x0 = _mm_xor_si128(Load(cp, bswap), _mm_set_epi32(int32_t(fcs), 0, 0, 0));
+        __m128i x1 = Load(cp + 16, bswap);
+        __m128i x2 = Load(cp + 32, bswap);
+        __m128i x3 = Load(cp + 48, bswap);
+        cp += 64;
+        size -= 64;
+
+        // Fold 64-byte blocks.
+        while (size >= 64) {
+            x0 = Fold(x0, k512, Load(cp, bswap));
+            x1 = Fold(x1, k512, Load(cp + 16, bswap));
+            x2 = Fold(x2, k512, Load(cp + 32, bswap));
+            x3 = Fold(x3, k512, Load(cp + 48, bswap));
+            cp += 64;
+            size -= 64;
+        }
+
+        // Fold the four accumulators into one, then the remaining 16-byte blocks.
+        x3 = Fold(Fold(Fold(x0, k128, x1), k128, x2), k128, x3);
+        while (size >= 16) {
+            x3 = Fold(x3, k128, Load(cp, bswap));
+            cp += 16;
+            size -= 16;
+        }
+
+        // Final reduction, then process the remaining bytes.
+        uint8_t last[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(last), _mm_shuffle_epi8(x3, bswap));
+        return AddSlicing(AddSlicing(0, last, sizeof(last)), cp, size);
+    }
+}
+
+#elif defined(TS_CRC32_FOLDING_ARM64)
+
+namespace {
+
+    // Load a 128-bit block with the first byte in the most significant position.
+    TS_CRC32_FOLDING_TARGET inline uint64x2_t Load(const uint8_t* cp)
+    {
+        const uint8x16_t b = vrev64q_u8(vld1q_u8(cp));
+        return vreinterpretq_u64_u8(vextq_u8(b, b, 8));
+    }
+
+    // Fold accumulator x using the constants khi and klo and add d.
+    TS_CRC32_FOLDING_TARGET inline uint64x2_t Fold(const uint64x2_t& x, uint64_t khi, uint64_t klo, const uint64x2_t& d)
+    {
+        const uint64x2_t h = vreinterpretq_u64_p128(vmull_p64(poly64_t(vgetq_lane_u64(x, 1)), poly64_t(khi)));
+        const uint64x2_t l = vreinterpretq_u64_p128(vmull_p64(poly64_t(vgetq_lane_u64(x, 0)), poly64_t(klo)));
+        return veorq_u64(veorq_u64(h, l), d);
+    }
+
+    // Folding implementation, at least 64 bytes.
+    TS_CRC32_FOLDING_TARGET uint32_t AddFolding(uint32_t fcs, const uint8_t* cp, size_t size)
+    {
+        if (size < 64) {
+            return AddSlicing(fcs, cp, size);
+        }
+
+        const FoldingConstants& fc(GetFoldingConstants());
+
+        // Initial accumulators. The previous CRC is added to the first 32 bits of data.
+        uint64x2_t x0 = veorq_u64(Load(cp), vsetq_lane_u64(uint64_t(fcs) << 32, vdupq_n_u64(0), 1));
+        uint64x2_t x1 = Load(cp + 16);
+        uint64x2_t x2 = Load(cp + 32);
+        uint64x2_t x3 = Load(cp + 48);
+        cp += 64;
+        size -= 64;
+
+        // Fold 64-byte blocks.
+        while (size >= 64) {
+            x0 = Fold(x0, fc.x576, fc.x512, Load(cp));
+            x1 = Fold(x1, fc.x576, fc.x512, Load(cp + 16));
+            x2 = Fold(x2, fc.x576, fc.x512, Load(cp + 32));
+            x3 = Fold(x3, fc.x576, fc.x512, Load(cp + 48));
+            cp += 64;
+            size -= 64;
+        }
+
+        // Fold the four accumulators into one, then the remaining 16-byte blocks.
+        x3 = Fold(Fold(Fold(x0, fc.x192, fc.x128, x1), fc.x192, fc.x128, x2), fc.x192, fc.x128, x3);
+        while (size >= 16) {
+            x3 = Fold(x3, fc.x192, fc.x128, Load(cp));
+            cp += 16;
+            size -= 16;
+        }
+
+        // Final reduction, then process the remaining bytes.
+        uint8_t last[16];
+        const uint8x16_t b = vrev64q_u8(vreinterpretq_u8_u64(x3));
+        vst1q_u8(last, vextq_u8(b, b, 8));
+        return AddSlicing(AddSlicing(0, last, sizeof(last)), cp, size);
+    }
+}
+
+#endif
+
+
+//----------------------------------------------------------------------------
+// Implementation selection.
+//----------------------------------------------------------------------------
+
+namespace {
+    typedef uint32_t (*AddFunction)(uint32_t, const uint8_t*, size_t);
+
+    // Get the function which implements an engine, nullptr if unsupported.
+    AddFunction GetAddFunction(ts::CRC32::Engine engine)
+    {
+        switch (engine) {
+            case ts::CRC32::Engine::BYTEWISE:
+                return AddBytewise;
+            case ts::CRC32::Engine::SLICING:
+                return AddSlicing;
+            case ts::CRC32::Engine::FOLDING:
+#if defined(TS_CRC32_FOLDING_INTEL) || defined(TS_CRC32_FOLDING_ARM64)
+                return ts::SysInfo::Instance()->crcInstructions() ? AddFolding : nullptr;
+#else
+                return nullptr;
+#endif
+            case ts::CRC32::Engine::DEFAULT:
+            default: {
+                static const AddFunction def = GetAddFunction(ts::CRC32::Engine::FOLDING) != nullptr ? GetAddFunction(ts::CRC32::Engine::FOLDING) : AddSlicing;
+                return def;
+            }
+        }
+    }
+}
+
+// Check if a CRC32 implementation is supported on this system.
+bool ts::CRC32::IsSupported(Engine engine)
 {
-    const uint8_t* cp = static_cast <const uint8_t*> (data);
+    return GetAddFunction(engine) != nullptr;
+}
 
-    while (size-- > 0) {
-        _fcs = (_fcs << 8) ^ fcstab_32 [((_fcs >> 24) ^ (*cp++)) & 0xFF];
+// Continue the computation of a data area, following a previous CRC32.
+void ts::CRC32::add(const void* data, size_t size)
+{
+    static const AddFunction func = GetAddFunction(Engine::DEFAULT);
+    _fcs = func(_fcs, static_cast<const uint8_t*>(data), size);
+}
+
+// Continue the computation using a specific implementation.
+void ts::CRC32::add(const void* data, size_t size, Engine engine)
+{
+    AddFunction func = GetAddFunction(engine);
+    if (func == nullptr) {
+        func = GetAddFunction(Engine::DEFAULT);
     }
+    _fcs = func(_fcs, static_cast<const uint8_t*>(data), size);
 }
@@ -45,6 +45,26 @@ namespace ts {
     class TSDUCKDLL CRC32
     {
     public:
+        //!
+        //! Available implementations of the CRC32 computation.
+        //! All implementations produce identical results. By default, the fastest
+        //! implementation which is supported by the CPU is used. The other ones
+        //! are mainly used for tests and benchmarks.
+        //!
+        enum class Engine {
+            DEFAULT,   //!< Fastest implementation which is supported by the CPU.
+            BYTEWISE,  //!< Portable computation, one byte at a time, using one 256-entry table.
+            SLICING,   //!< Portable computation, 8 bytes at a time, using eight 256-entry tables ("slicing-by-8").
+            FOLDING,   //!< Folding of 64-byte blocks using carry-less multiplication (PCLMULQDQ on Intel, PMULL on Arm64).
+        };
+
+        //!
+        //! Check if a CRC32 implementation is supported on this system.
+        //! @param [in] engine The implementation to check.
+        //! @return True if @a engine is supported by the CPU and the compiler.
+        //!
+        static bool IsSupported(Engine engine);
+
         //!
         //! Default constructor.
         //!
@@ -68,6 +88,15 @@ namespace ts {
         //!
         void add(const void* data, size_t size);
 
+        //!
+        //! Continue the computation of a data area using a specific implementation.
+        //! @param [in] data Address of area to analyze.
+        //! @param [in] size Size in bytes of area to analyze.
+        //! @param [in] engine The implementation to use. If @a engine is not supported
+        //! on this system, the default implementation is used instead.
+        //!
+        void add(const void* data, size_t size, Engine engine);
+
         //!
         //! Get the value of the CRC32 as computed so far.
         //! @return The value of the CRC32 as computed so far.
@@ -31,6 +31,7 @@
 #include "tsTSPacketMetadata.h"
 #include "tsNullReport.h"
 #include "tsSysUtils.h"
+#include "tsSysInfo.h"
 
 #if defined(TS_WINDOWS)
     #include "tsBeforeStandardHeaders.h"
@@ -40,10 +41,30 @@
     #include "tsBeforeStandardHeaders.h"
     #include <sys/types.h>
     #include <sys/stat.h>
+    #include <sys/mman.h>
+    #include <fcntl.h>
     #include <unistd.h>
     #include "tsAfterStandardHeaders.h"
 #endif
 
+#if defined(TS_LINUX)
+    #include "tsIOUring.h"
+#elif !defined(TS_NO_IO_URING)
+    #define TS_NO_IO_URING 1
+#endif
+
+namespace {
+    // Alignment of buffers, sizes and file offsets with direct I/O.
+    constexpr size_t DIRECT_ALIGN = 4096;
+    // Size of the output buffer with direct I/O (multiple of DIRECT_ALIGN).
+    constexpr size_t DIRECT_BUFFER_SIZE = 1024 * 1024;
+    // Memory-mapped input files: already read data are released by chunks of this size.
+    constexpr uint64_t MAP_RELEASE_SIZE = 64 * 1024 * 1024;
+    // Asynchronous I/O: number and size of buffers, as many I/O in progress.
+    constexpr size_t ASYNC_BUFFER_COUNT = 8;
+    constexpr size_t ASYNC_BUFFER_SIZE = 512 * 1024;
+}
+
 
 //----------------------------------------------------------------------------
 // Default constructor.
@@ -67,6 +88,19 @@ ts::TSFile::TSFile() :
     _rewindable(false),
     _regular(false),
     _std_inout(false),
+    _io_flags(NONE),
+    _map_base(nullptr),
+    _map_size(0),
+    _map_pos(0),
+    _map_released(0),
+    _direct_buffer(),
+    _direct_start(0),
+    _direct_count(0),
+    _uring(nullptr),
+    _async_buffers(),
+    _async_io(),
+    _async_next(0),
+    _async_offset(0),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE)
 #else
@@ -98,6 +132,19 @@ ts::TSFile::TSFile(const TSFile& other) :
     _rewindable(false),
     _regular(false),
     _std_inout(other._std_inout),
+    _io_flags(other._io_flags),
+    _map_base(nullptr),
+    _map_size(0),
+    _map_pos(0),
+    _map_released(0),
+    _direct_buffer(),
+    _direct_start(0),
+    _direct_count(0),
+    _uring(nullptr),
+    _async_buffers(),
+    _async_io(),
+    _async_next(0),
+    _async_offset(0),
 #if defined(TS_WINDOWS)
     _handle(INVALID_HANDLE_VALUE)
 #else
@@ -129,6 +176,19 @@ ts::TSFile::TSFile(TSFile&& other) noexcept :
     _rewindable(other._rewindable),
     _regular(other._regular),
     _std_inout(other._std_inout),
+    _io_flags(other._io_flags),
+    _map_base(other._map_base),
+    _map_size(other._map_size),
+    _map_pos(other._map_pos),
+    _map_released(other._map_released),
+    _direct_buffer(std::move(other._direct_buffer)),
+    _direct_start(other._direct_start),
+    _direct_count(other._direct_count),
+    _uring(other._uring),
+    _async_buffers(std::move(other._async_buffers)),
+    _async_io(std::move(other._async_io)),
+    _async_next(other._async_next),
+    _async_offset(other._async_offset),
 #if defined(TS_WINDOWS)
     _handle(other._handle)
 #else
@@ -137,6 +197,9 @@ ts::TSFile::TSFile(TSFile&& other) noexcept :
 {
     // Mark other object as closed, just in case.
     other._is_open = false;
+    other._map_base = nullptr;
+    other._direct_buffer.clear();
+    other._uring = nullptr;
 #if defined(TS_WINDOWS)
     other._handle = INVALID_HANDLE_VALUE;
 #else
@@ -189,6 +252,16 @@ void ts::TSFile::setStuffing(size_t initial, size_t final)
 }
 
 
+//----------------------------------------------------------------------------
+// Set I/O acceleration flags.
+//----------------------------------------------------------------------------
+
+void ts::TSFile::setIOFlags(OpenFlags flags)
+{
+    _io_flags = flags & (MMAP | DIRECT | ASYNC);
+}
+
+
 //----------------------------------------------------------------------------
 // Open file for read in a rewindable mode.
 //----------------------------------------------------------------------------
@@ -205,7 +278,7 @@ bool ts::TSFile::openRead(const UString& filename, uint64_t start_offset, Report
     _counter = 0;
     _start_offset = start_offset;
     _rewindable = true;
-    _flags = READ;
+    _flags = READ | _io_flags;
 
     resetPacketStream(format, this, this);
     return openInternal(false, report);
@@ -228,7 +301,7 @@ bool ts::TSFile::openRead(const UString& filename, size_t repeat_count, uint64_t
     _counter = 0;
     _start_offset = start_offset;
     _rewindable = false;
-    _flags = READ | REOPEN_SPEC;
+    _flags = READ | REOPEN_SPEC | _io_flags;
 
     resetPacketStream(format, this, this);
     return openInternal(false, report);
@@ -264,7 +337,7 @@ bool ts::TSFile::open(const UString& filename, OpenFlags flags, Report& report,
     _counter = 0;
     _start_offset = 0;
     _rewindable = true;
-    _flags = flags;
+    _flags = flags | _io_flags;
 
     resetPacketStream(format, this, this);
     return openInternal(false, report);
@@ -306,7 +379,8 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
 
 #if defined(TS_WINDOWS)
 
-    // Windows implementation
+    // Windows implementation. Memory-mapped input, direct and asynchronous I/O are not supported.
+    _flags &= ~(MMAP | DIRECT | ASYNC);
     const ::DWORD access = (read_access ? GENERIC_READ : 0) | (write_access ? GENERIC_WRITE : 0);
     const ::DWORD attrib = temporary ? (FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE) : FILE_ATTRIBUTE_NORMAL;
     const ::DWORD shared = read_only || (_flags & SHARED) != 0 ? FILE_SHARE_READ : 0;
@@ -391,10 +465,23 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
 
     // Close first if this is a reopen.
     if (reopen) {
+        unmapFile();
+#if !defined(TS_NO_IO_URING)
+        asyncClose(false, report);
+#endif
         ::close(_fd);
         _fd = -1;
     }
 
+    // Direct I/O is used on new named files in write-only mode.
+    bool direct = false;
+#if defined(O_DIRECT)
+    direct = (_flags & DIRECT) != 0 && !read_access && !append_access && !_std_inout;
+#endif
+    if (!direct) {
+        _flags &= ~DIRECT;
+    }
+
     if (read_only) {
         uflags |= O_RDONLY;
     }
@@ -417,7 +504,15 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
     }
     else {
         // Open a named file.
-        if ((_fd = ::open(_filename.toUTF8().c_str(), uflags, mode)) < 0) {
+#if defined(O_DIRECT)
+        if (direct && (_fd = ::open(_filename.toUTF8().c_str(), uflags | O_DIRECT, mode)) < 0) {
+            // Direct I/O not supported on this file system, revert to standard I/O.
+            report.debug(u"direct I/O not supported on %s, using standard I/O", {getDisplayFileName()});
+            direct = false;
+            _flags &= ~DIRECT;
+        }
+#endif
+        if (!direct && (_fd = ::open(_filename.toUTF8().c_str(), uflags, mode)) < 0) {
             const SysErrorCode err = LastSysErrorCode();
             report.log(_severity, u"cannot open file %s: %s", {getDisplayFileName(), SysErrorCodeMessage(err)});
             return false;
@@ -466,6 +561,46 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
         return false;
     }
 
+    // With direct I/O, all writes go through an aligned buffer.
+#if defined(O_DIRECT)
+    if (direct && !_regular) {
+        // Not a regular file, direct I/O is useless.
+        ::fcntl(_fd, F_SETFL, ::fcntl(_fd, F_GETFL) & ~O_DIRECT);
+        direct = false;
+        _flags &= ~DIRECT;
+    }
+#endif
+    if (direct) {
+        _direct_buffer.resize(DIRECT_BUFFER_SIZE + DIRECT_ALIGN);
+        const size_t misalign = size_t(reinterpret_cast<uintptr_t>(_direct_buffer.data()) % DIRECT_ALIGN);
+        _direct_start = misalign == 0 ? 0 : DIRECT_ALIGN - misalign;
+        _direct_count = 0;
+    }
+
+    // Map read-only regular files in memory when requested.
+    if ((_flags & MMAP) != 0) {
+        if (read_only && _regular && !_std_inout) {
+            mapFile(uint64_t(st.st_size), report);
+            _map_pos = std::min(_start_offset, _map_size);
+        }
+        else {
+            _flags &= ~MMAP;
+        }
+    }
+
+    // Asynchronous I/O on read-only or write-only regular files, when not already memory-mapped or direct.
+    // Not in append mode: writes with explicit offsets would not follow data concurrently appended to the file.
+#if !defined(TS_NO_IO_URING)
+    if ((_flags & ASYNC) != 0 && _regular && !_std_inout && !append_access && (read_only || !read_access) && (_flags & (MMAP | DIRECT)) == 0) {
+        asyncOpen(read_only, report);
+    }
+    else {
+        _flags &= ~ASYNC;
+    }
+#else
+    _flags &= ~ASYNC;
+#endif
+
 #endif
 
     // Reset counters only if not a reopen.
@@ -526,6 +661,33 @@ bool ts::TSFile::seekInternal(uint64_t index, Report& report)
 
     report.debug(u"seeking %s at offset %'d", {_filename, _start_offset + index});
 
+    // Memory-mapped file: simply move the read position.
+    if (_map_base != nullptr) {
+        _map_pos = std::min(_start_offset + index, _map_size);
+        _map_released = std::min(_map_released, _map_pos - _map_pos % SysInfo::Instance()->memoryPageSize());
+        _at_eof = false;
+        return true;
+    }
+
+    // Asynchronous I/O: restart read operations or continue writing at the new position.
+#if !defined(TS_NO_IO_URING)
+    if (_uring != nullptr) {
+        _at_eof = false;
+        if ((_flags & WRITE) == 0) {
+            return asyncStartRead(_start_offset + index, report);
+        }
+        const bool ok = asyncFlush(true, report);
+        _async_offset = _start_offset + index;
+        return ok;
+    }
+#endif
+
+    // Direct I/O: write pending data at the current position before moving. The new position
+    // is not necessarily aligned, direct I/O is no longer used after seeking.
+    if (!_direct_buffer.empty() && !flushDirect(true, report)) {
+        return false;
+    }
+
 #if defined(TS_WINDOWS)
     // In Win32, LARGE_INTEGER is a 64-bit structure, not an integer type
     uint64_t where = _start_offset + index;
@@ -576,11 +738,24 @@ bool ts::TSFile::close(Report& report)
         return false;
     }
 
+    bool success = true;
+
     // In write mode, write final null packets.
     if ((_flags & WRITE) != 0 && _close_null > 0) {
         writeStuffing(_close_null, report);
     }
 
+    // Write the rest of the direct I/O buffer and release the memory-mapped input file.
+    if (!_direct_buffer.empty() && !_aborted) {
+        success = flushDirect(true, report);
+    }
+    _direct_buffer.clear();
+    _direct_count = 0;
+    unmapFile();
+#if !defined(TS_NO_IO_URING)
+    success = asyncClose(!_aborted, _aborted ? NULLREP : report) && success;
+#endif
+
     if (!_std_inout) {
 #if defined(TS_WINDOWS)
         ::CloseHandle(_handle);
@@ -596,7 +771,7 @@ bool ts::TSFile::close(Report& report)
     _filename.clear();
     _std_inout = false;
 
-    return true;
+    return success;
 }
 
 
@@ -626,6 +801,26 @@ bool ts::TSFile::readStreamPartial(void* buffer, size_t request_size, size_t& re
         return true;
     }
 
+    // Memory-mapped file: copy from the mapped area.
+    if (_map_base != nullptr) {
+        if (_map_pos >= _map_size) {
+            _at_eof = true;
+            return false;
+        }
+        releaseMapped();
+        read_size = size_t(std::min<uint64_t>(request_size, _map_size - _map_pos));
+        ::memcpy(buffer, _map_base + _map_pos, read_size);
+        _map_pos += read_size;
+        return true;
+    }
+
+#if !defined(TS_NO_IO_URING)
+    // Asynchronous I/O: copy from the I/O buffers.
+    if (_uring != nullptr) {
+        return asyncRead(buffer, request_size, read_size, report);
+    }
+#endif
+
 #if defined(TS_WINDOWS)
 
     // Windows implementation
@@ -748,6 +943,26 @@ bool ts::TSFile::writeStream(const void* buffer, size_t data_size, size_t& writt
     written_size = 0;
     SysErrorCode error_code = SYS_SUCCESS;
 
+    // With direct I/O, accumulate data in the aligned buffer.
+    if (!_direct_buffer.empty()) {
+        if (!writeDirect(buffer, data_size, report)) {
+            return false;
+        }
+        written_size = data_size;
+        return true;
+    }
+
+#if !defined(TS_NO_IO_URING)
+    // With asynchronous I/O, accumulate data in the I/O buffers.
+    if (_uring != nullptr) {
+        if (!asyncWrite(buffer, data_size, report)) {
+            return false;
+        }
+        written_size = data_size;
+        return true;
+    }
+#endif
+
 #if defined(TS_WINDOWS)
 
     // Windows implementation
@@ -859,3 +1074,414 @@ void ts::TSFile::abort()
 #endif
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Memory-mapped input file.
+//----------------------------------------------------------------------------
+
+void ts::TSFile::mapFile(uint64_t size, Report& report)
+{
+    unmapFile();
+
+#if !defined(TS_WINDOWS)
+    // Empty files cannot be mapped, they are read using standard I/O.
+    if (size > 0 && size <= uint64_t(std::numeric_limits<size_t>::max())) {
+        void* const base = ::mmap(nullptr, size_t(size), PROT_READ, MAP_SHARED, _fd, 0);
+        if (base == MAP_FAILED) {
+            const SysErrorCode err = LastSysErrorCode();
+            report.debug(u"cannot map %s in memory, using standard I/O: %s", {getDisplayFileName(), SysErrorCodeMessage(err)});
+        }
+        else {
+            // The file is read sequentially, let the system read ahead aggressively.
+            ::madvise(base, size_t(size), MADV_SEQUENTIAL);
+            _map_base = reinterpret_cast<const uint8_t*>(base);
+            _map_size = size;
+            _map_pos = 0;
+            _map_released = 0;
+            report.debug(u"%s mapped in memory, %'d bytes", {getDisplayFileName(), size});
+        }
+    }
+#endif
+
+    if (_map_base == nullptr) {
+        _flags &= ~MMAP;
+    }
+}
+
+void ts::TSFile::unmapFile()
+{
+#if !defined(TS_WINDOWS)
+    if (_map_base != nullptr) {
+        ::munmap(const_cast<uint8_t*>(_map_base), size_t(_map_size));
+    }
+#endif
+    _map_base = nullptr;
+    _map_size = _map_pos = _map_released = 0;
+}
+
+// Release the pages of the memory-mapped file which were already read.
+// This prevents huge files from filling the process memory and the system cache.
+void ts::TSFile::releaseMapped()
+{
+#if !defined(TS_WINDOWS)
+    const uint64_t end = _map_pos - _map_pos % SysInfo::Instance()->memoryPageSize();
+    if (_map_base != nullptr && end >= _map_released + MAP_RELEASE_SIZE) {
+        ::madvise(const_cast<uint8_t*>(_map_base + _map_released), size_t(end - _map_released), MADV_DONTNEED);
+#if defined(TS_LINUX)
+        ::posix_fadvise(_fd, off_t(_map_released), off_t(end - _map_released), POSIX_FADV_DONTNEED);
+#endif
+        _map_released = end;
+    }
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Directly access TS packets in a memory-mapped file.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::mapPackets(const TSPacket*& packets, size_t& count, Report& report)
+{
+    const size_t max_packets = count;
+    packets = nullptr;
+    count = 0;
+
+    // Direct access is not possible without mapping or with artificial stuffing.
+    if (_map_base == nullptr || _open_null > 0 || _close_null > 0) {
+        return false;
+    }
+
+    // Direct access is possible on plain 188-byte packets only.
+    if (packetFormat() == TSPacketFormat::AUTODETECT) {
+        const uint8_t* const data = _map_base + _map_pos;
+        const uint64_t remain = _map_size - _map_pos;
+        if (remain >= PKT_SIZE && (data[0] != SYNC_BYTE || (remain > PKT_SIZE && data[PKT_SIZE] != SYNC_BYTE))) {
+            // Not a plain TS file, use readPackets() for format detection.
+            return false;
+        }
+        const PacketCounter total_read = _total_read;
+        resetPacketStream(TSPacketFormat::TS, this, this);
+        _total_read = total_read;
+        report.debug(u"detected TS file format %s", {packetFormatString()});
+    }
+    else if (packetFormat() != TSPacketFormat::TS) {
+        return false;
+    }
+
+    // Loop on file repetitions.
+    bool rewound = false;
+    while (max_packets > 0 && !_aborted) {
+        const uint64_t remain = (_map_size - _map_pos) / PKT_SIZE;
+        if (remain > 0) {
+            releaseMapped();
+            count = size_t(std::min<uint64_t>(max_packets, remain));
+            packets = reinterpret_cast<const TSPacket*>(_map_base + _map_pos);
+            _map_pos += count * PKT_SIZE;
+            _total_read += count;
+            break;
+        }
+        // End of file. Rewind if the file must be repeated, unless it contains no packet at all.
+        _at_eof = true;
+        if (rewound || (_repeat != 0 && ++_counter >= _repeat) || !seekInternal(0, report)) {
+            break;
+        }
+        rewound = true;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Output with direct I/O.
+//----------------------------------------------------------------------------
+
+bool ts::TSFile::writeDirect(const void* addr, size_t size, Report& report)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(addr);
+    while (size > 0) {
+        const size_t chunk = std::min(size, DIRECT_BUFFER_SIZE - _direct_count);
+        ::memcpy(_direct_buffer.data() + _direct_start + _direct_count, data, chunk);
+        data += chunk;
+        size -= chunk;
+        _direct_count += chunk;
+        if (_direct_count == DIRECT_BUFFER_SIZE && !flushDirect(false, report)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ts::TSFile::flushDirect(bool final, Report& report)
+{
+#if !defined(TS_WINDOWS)
+    // Write all complete aligned blocks.
+    uint8_t* const data = _direct_buffer.data() + _direct_start;
+    const size_t size = _direct_count - _direct_count % DIRECT_ALIGN;
+    size_t done = 0;
+    while (done < size) {
+        const ssize_t outsize = ::write(_fd, data + done, size - done);
+        if (outsize > 0) {
+            done += size_t(outsize);
+        }
+        else {
+            const SysErrorCode error_code = LastSysErrorCode();
+            if (error_code != EINTR) {
+                report.log(_severity, u"error writing %s: %s (%d)", {getDisplayFileName(), SysErrorCodeMessage(error_code), error_code});
+                return false;
+            }
+        }
+    }
+
+    // Keep the unaligned rest for next time.
+    _direct_count -= size;
+    if (_direct_count > 0) {
+        ::memmove(data, data + size, _direct_count);
+    }
+
+    // On final flush, write the unaligned end of file without direct I/O.
+    if (final) {
+        const ByteBlock tail(data, _direct_count);
+        _direct_buffer.clear();
+        _direct_count = 0;
+#if defined(O_DIRECT)
+        ::fcntl(_fd, F_SETFL, ::fcntl(_fd, F_GETFL) & ~O_DIRECT);
+#endif
+        size_t written_size = 0;
+        return tail.empty() || writeStream(tail.data(), tail.size(), written_size, report);
+    }
+#endif
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Asynchronous I/O using io_uring (Linux only, when supported by the kernel headers).
+//----------------------------------------------------------------------------
+
+#if !defined(TS_NO_IO_URING)
+
+// Start asynchronous I/O on a newly open file.
+void ts::TSFile::asyncOpen(bool read_only, Report& report)
+{
+    asyncClose(false, report);
+
+    _uring = new IOUring;
+    if (!_uring->open(ASYNC_BUFFER_COUNT, report)) {
+        report.debug(u"asynchronous I/O not supported on %s, using standard I/O", {getDisplayFileName()});
+        delete _uring;
+        _uring = nullptr;
+        _flags &= ~ASYNC;
+        return;
+    }
+
+    // Allocate and register the I/O buffers. If the registration fails (not enough lockable memory),
+    // the buffers are still usable, with slightly less efficient I/O.
+    _async_buffers.resize(ASYNC_BUFFER_COUNT);
+    for (auto& buf : _async_buffers) {
+        buf.resize(ASYNC_BUFFER_SIZE);
+    }
+    _async_io.assign(ASYNC_BUFFER_COUNT, AsyncIO());
+    _uring->registerBuffers(_async_buffers, report);
+    _async_next = 0;
+
+    // I/O operations use explicit offsets, starting at the current position (start offset or end of file).
+    const off_t pos = ::lseek(_fd, 0, SEEK_CUR);
+    _async_offset = pos < 0 ? 0 : uint64_t(pos);
+    report.debug(u"using asynchronous I/O on %s", {getDisplayFileName()});
+    if (read_only) {
+        asyncStartRead(_async_offset, report);
+    }
+}
+
+// Terminate asynchronous I/O, wait for all I/O in progress.
+bool ts::TSFile::asyncClose(bool flush, Report& report)
+{
+    bool ok = true;
+    if (_uring != nullptr) {
+        // The buffers cannot be released before all I/O are complete.
+        ok = asyncFlush(flush, report);
+        delete _uring;
+        _uring = nullptr;
+    }
+    _async_buffers.clear();
+    _async_io.clear();
+    _async_next = 0;
+    _async_offset = 0;
+    return ok;
+}
+
+// Wait for all I/O in progress, optionally after starting to write the last partial buffer.
+bool ts::TSFile::asyncFlush(bool write_last, Report& report)
+{
+    bool ok = true;
+    if (write_last && (_flags & WRITE) != 0 && !_async_io[_async_next].pending && _async_io[_async_next].size > 0) {
+        ok = asyncSubmitWrite(report);
+    }
+    for (size_t i = 0; i < _async_io.size(); ++i) {
+        ok = asyncWait(i, report) && ok;
+    }
+    return ok;
+}
+
+// Wait for the completion of the I/O in one buffer.
+bool ts::TSFile::asyncWait(size_t index, Report& report)
+{
+    AsyncIO& io(_async_io[index]);
+    if (!io.pending) {
+        return true;
+    }
+
+    // Collect completions, in any order, until this one is complete.
+    while (!io.complete) {
+        uint64_t user_data = 0;
+        int result = 0;
+        if (!_uring->wait(user_data, result, report)) {
+            // Unrecoverable io_uring error, consider all I/O as lost.
+            for (auto& it : _async_io) {
+                it.complete = true;
+                it.result = -EIO;
+            }
+        }
+        else if (user_data < _async_io.size()) {
+            _async_io[user_data].complete = true;
+            _async_io[user_data].result = result;
+        }
+    }
+    io.pending = false;
+
+    // On output, check that everything was written.
+    if ((_flags & WRITE) != 0) {
+        if (io.result < 0) {
+            report.log(_severity, u"error writing %s: %s", {getDisplayFileName(), SysErrorCodeMessage(-io.result)});
+            return false;
+        }
+        // Complete partial writes synchronously.
+        size_t done = size_t(io.result);
+        while (done < io.size) {
+            const ssize_t outsize = ::pwrite(_fd, _async_buffers[index].data() + done, io.size - done, off_t(io.offset + done));
+            if (outsize > 0) {
+                done += size_t(outsize);
+            }
+            else if (LastSysErrorCode() != EINTR) {
+                report.log(_severity, u"error writing %s: %s", {getDisplayFileName(), SysErrorCodeMessage()});
+                return false;
+            }
+        }
+        io.size = 0;
+    }
+    return true;
+}
+
+// Discard all read buffers and restart reading at the specified offset.
+bool ts::TSFile::asyncStartRead(uint64_t offset, Report& report)
+{
+    // Read operations in progress must complete before reusing their buffers.
+    asyncFlush(false, report);
+
+    // Start one read in each buffer.
+    _async_next = 0;
+    _async_offset = offset;
+    for (size_t i = 0; i < _async_io.size(); ++i) {
+        AsyncIO& io(_async_io[i]);
+        io.offset = _async_offset;
+        io.size = io.pos = 0;
+        io.pending = true;
+        io.complete = false;
+        io.result = 0;
+        if (!_uring->queueRead(_fd, _async_buffers[i].data(), ASYNC_BUFFER_SIZE, io.offset, i, i, report)) {
+            io.pending = false;
+            io.complete = true;
+            io.result = -EIO;
+        }
+        _async_offset += ASYNC_BUFFER_SIZE;
+    }
+    return _uring->submit(report);
+}
+
+// Read data from the asynchronous buffers.
+bool ts::TSFile::asyncRead(void* addr, size_t max_size, size_t& ret_size, Report& report)
+{
+    AsyncIO& io(_async_io[_async_next]);
+    if (!asyncWait(_async_next, report)) {
+        return false;
+    }
+    if (io.result < 0) {
+        report.error(u"error reading from %s: %s", {getDisplayFileName(), SysErrorCodeMessage(-io.result)});
+        return false;
+    }
+    if (io.result == 0) {
+        // End of file.
+        _at_eof = true;
+        return false;
+    }
+
+    // Copy data from the current buffer.
+    const size_t size = size_t(io.result);
+    ret_size = std::min(max_size, size - io.pos);
+    ::memcpy(addr, _async_buffers[_async_next].data() + io.pos, ret_size);
+    io.pos += ret_size;
+
+    // When the buffer is exhausted, reuse it for a new read.
+    if (io.pos >= size) {
+        if (size < ASYNC_BUFFER_SIZE) {
+            // Short read, typically at end of file. The next buffers were read at wrong offsets.
+            // Restart reading after this one. At end of file, the next read will return zero.
+            asyncStartRead(io.offset + size, report);
+            return true;
+        }
+        io.offset = _async_offset;
+        io.pos = 0;
+        io.pending = true;
+        io.complete = false;
+        if (!_uring->queueRead(_fd, _async_buffers[_async_next].data(), ASYNC_BUFFER_SIZE, io.offset, _async_next, _async_next, report) || !_uring->submit(report)) {
+            io.pending = false;
+            io.complete = true;
+            io.result = -EIO;
+        }
+        _async_offset += ASYNC_BUFFER_SIZE;
+        _async_next = (_async_next + 1) % _async_io.size();
+    }
+    return true;
+}
+
+// Accumulate data to write in the asynchronous buffers.
+bool ts::TSFile::asyncWrite(const void* addr, size_t size, Report& report)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(addr);
+    while (size > 0) {
+        // Wait for the previous write in the current buffer, if any.
+        AsyncIO& io(_async_io[_async_next]);
+        if (!asyncWait(_async_next, report)) {
+            return false;
+        }
+        const size_t chunk = std::min(size, ASYNC_BUFFER_SIZE - io.size);
+        ::memcpy(_async_buffers[_async_next].data() + io.size, data, chunk);
+        data += chunk;
+        size -= chunk;
+        io.size += chunk;
+        if (io.size >= ASYNC_BUFFER_SIZE && !asyncSubmitWrite(report)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Start writing the current buffer and move to next one.
+bool ts::TSFile::asyncSubmitWrite(Report& report)
+{
+    AsyncIO& io(_async_io[_async_next]);
+    io.offset = _async_offset;
+    io.pending = true;
+    io.complete = false;
+    io.result = 0;
+    if (!_uring->queueWrite(_fd, _async_buffers[_async_next].data(), io.size, io.offset, _async_next, _async_next, report) || !_uring->submit(report)) {
+        io.pending = false;
+        return false;
+    }
+    _async_offset += io.size;
+    _async_next = (_async_next + 1) % _async_io.size();
+    return true;
+}
+
+#endif
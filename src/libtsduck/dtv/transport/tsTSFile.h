@@ -37,10 +37,12 @@
 #include "tsAbstractReadStreamInterface.h"
 #include "tsAbstractWriteStreamInterface.h"
 #include "tsEnumUtils.h"
+#include "tsByteBlock.h"
 
 namespace ts {
 
     class TSPacketMetadata;
+    class IOUring;
 
     //!
     //! Transport stream file, input and/or output.
@@ -120,6 +122,9 @@ namespace ts {
             TEMPORARY   = 0x0020,   //!< Temporary file, deleted on close, not always visible in the file system.
             REOPEN      = 0x0040,   //!< Close and reopen the file instead of rewind to start of file when looping on input file.
             REOPEN_SPEC = 0x0080,   //!< Force REOPEN when the file is not a regular file.
+            MMAP        = 0x0100,   //!< Read-only regular file: map the file in memory, see mapPackets(). UNIX only, ignored otherwise.
+            DIRECT      = 0x0200,   //!< Write-only regular file: bypass the system cache using aligned direct I/O. UNIX only, ignored otherwise.
+            ASYNC       = 0x0400,   //!< Read-only or write-only regular file: keep several I/O in progress using io_uring. Linux only, ignored otherwise or when io_uring is not supported by the kernel headers.
         };
 
         //!
@@ -178,6 +183,43 @@ namespace ts {
         //!
         void setStuffing(size_t initial, size_t final);
 
+        //!
+        //! Set I/O acceleration flags.
+        //! This method shall be called before opening the file.
+        //! The specified flags are added to the flags of all subsequent open operations,
+        //! including openRead(). They are silently ignored when they do not apply to the file
+        //! (wrong access mode, not a regular file, not supported by the operating system).
+        //! @param [in] flags Bit mask of MMAP, DIRECT and ASYNC. Other flags are ignored.
+        //!
+        void setIOFlags(OpenFlags flags);
+
+        //!
+        //! Check if the input file is currently memory-mapped.
+        //! @return True if the file was successfully open in MMAP mode.
+        //!
+        bool isMemoryMapped() const { return _map_base != nullptr; }
+
+        //!
+        //! Check if the file currently uses asynchronous I/O.
+        //! @return True if the file was successfully open in ASYNC mode.
+        //!
+        bool isAsynchronous() const { return _uring != nullptr; }
+
+        //!
+        //! Directly access the next TS packets in a memory-mapped file, without copy.
+        //! This is possible when the file is open in MMAP mode, contains plain 188-byte TS packets
+        //! and no artificial stuffing is specified. Repetition and start offset are applied as in
+        //! readPackets(). Do not mix calls to mapPackets() and readPackets() on the same file.
+        //! @param [out] packets Address of the next TS packets in memory. Read-only.
+        //! The packets remain accessible until the next read, seek or close operation.
+        //! @param [in,out] count On input, the maximum number of packets to return.
+        //! On output, the number of packets at @a packets, zero at end of file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, including end of file. False if direct access is not possible
+        //! on this file, in which case readPackets() shall be used.
+        //!
+        bool mapPackets(const TSPacket*& packets, size_t& count, Report& report);
+
         //!
         //! Abort any currenly read/write operation in progress.
         //! The file is left in a broken state and can be only closed.
@@ -208,6 +250,16 @@ namespace ts {
         virtual size_t readPackets(TSPacket* buffer, TSPacketMetadata* metadata, size_t max_packets, Report& report) override;
 
     private:
+        // State of an I/O buffer in ASYNC mode.
+        struct AsyncIO {
+            uint64_t offset;   // Offset in file.
+            size_t   size;     // Size of data in buffer: read data or data to write.
+            size_t   pos;      // Next byte to read in buffer.
+            bool     pending;  // An I/O operation was submitted and its result was not yet processed.
+            bool     complete; // The I/O operation is complete, the result is available.
+            int      result;   // Result of I/O operation: transferred size or negated error code.
+        };
+
         UString       _filename;         //!< Input file name.
         size_t        _repeat;           //!< Repeat count (0 means infinite)
         size_t        _counter;          //!< Current repeat count
@@ -224,6 +276,19 @@ namespace ts {
         bool          _rewindable;       //!< Opened in rewindable mode
         bool          _regular;          //!< Is a regular file (ie. not a pipe or special device)
         bool          _std_inout;        //!< File is standard input or output.
+        OpenFlags     _io_flags;         //!< Additional I/O flags for all open operations.
+        const uint8_t* _map_base;        //!< Base address of memory-mapped input file (MMAP mode).
+        uint64_t      _map_size;         //!< Size in bytes of memory-mapped input file.
+        uint64_t      _map_pos;          //!< Current read position in memory-mapped input file.
+        uint64_t      _map_released;     //!< Size of the initial part of the mapping which was released.
+        ByteBlock     _direct_buffer;    //!< Buffer for aligned writes in DIRECT mode.
+        size_t        _direct_start;     //!< Index of first aligned byte in _direct_buffer.
+        size_t        _direct_count;     //!< Number of pending bytes to write in _direct_buffer.
+        IOUring*      _uring;            //!< Asynchronous I/O engine in ASYNC mode (Linux only).
+        std::vector<ByteBlock> _async_buffers; //!< I/O buffers in ASYNC mode, registered in _uring.
+        std::vector<AsyncIO>   _async_io;      //!< State of I/O in each buffer in ASYNC mode.
+        size_t        _async_next;       //!< Index of current buffer in ASYNC mode.
+        uint64_t      _async_offset;     //!< File offset of the next I/O to submit in ASYNC mode.
 #if defined(TS_WINDOWS)
         ::HANDLE      _handle;           //!< File handle
 #else
@@ -241,6 +306,23 @@ namespace ts {
         void readStuffing(TSPacket*& buffer, TSPacketMetadata*& metadata, size_t count, Report& report);
         bool writeStuffing(size_t count, Report& report);
 
+        // Memory-mapped input and direct output (UNIX only).
+        void mapFile(uint64_t size, Report& report);
+        void unmapFile();
+        void releaseMapped();
+        bool writeDirect(const void* addr, size_t size, Report& report);
+        bool flushDirect(bool final, Report& report);
+
+        // Asynchronous I/O (Linux only).
+        void asyncOpen(bool read_only, Report& report);
+        bool asyncClose(bool flush, Report& report);
+        bool asyncWait(size_t index, Report& report);
+        bool asyncFlush(bool write_last, Report& report);
+        bool asyncStartRead(uint64_t offset, Report& report);
+        bool asyncRead(void* addr, size_t max_size, size_t& ret_size, Report& report);
+        bool asyncWrite(const void* addr, size_t size, Report& report);
+        bool asyncSubmitWrite(Report& report);
+
         // Internal methods
         bool openInternal(bool reopen, Report& report);
         bool seekCheck(Report& report);
@@ -32,6 +32,16 @@
 #include "tsNames.h"
 #include "tsByteBlock.h"
 
+// Select the implementation of the sync byte search and packet comparison. We only use the SIMD instructions
+// which are always available on the target CPU (SSE2 on x86_64, Neon on Arm64).
+#if defined(TS_X86_64) || (defined(TS_I386) && defined(__SSE2__))
+    #define TS_PKT_SSE2 1
+    #include <emmintrin.h>
+#elif defined(TS_ARM64)
+    #define TS_PKT_NEON 1
+    #include <arm_neon.h>
+#endif
+
 
 //----------------------------------------------------------------------------
 // This constant is a null (or stuffing) packet.
@@ -923,6 +933,7 @@ bool ts::TSPacket::Locate(const uint8_t* buffer, size_t buffer_size, size_t& sta
     }
 
     // Look backward from the end of the message, looking for a 0x47 sync byte every 188 bytes, going backward.
+    // This is the general case, there is usually nothing to search.
     const uint8_t* buffer_end = buffer + buffer_size;
     const uint8_t* p;
     for (p = buffer_end; p >= buffer + PKT_SIZE && *(p - PKT_SIZE) == SYNC_BYTE; p -= PKT_SIZE) {}
@@ -935,24 +946,21 @@ bool ts::TSPacket::Locate(const uint8_t* buffer, size_t buffer_size, size_t& sta
     }
 
     // No TS packet found using the first method. Restart from the beginning of the message.
-    const uint8_t* const max = buffer_end - PKT_SIZE; // max address for a TS packet
-    for (p = buffer; p <= max; p++) {
-        if (*p == SYNC_BYTE) {
-            // Found something that could be the start of a TS packet.
-            // Verify that we get a 0x47 sync byte every 188 bytes up
-            // to the end of message (not leaving more than one truncated
-            // TS packet at the end of the message).
-            const uint8_t* end;
-            for (end = p; end <= max && *end == SYNC_BYTE; end += PKT_SIZE) {}
-            if (end > max) {
-                // End is after the start of the last possible packet.
-                // So, there are less than 188 bytes left in buffer after last packet.
-                // Consider that we have found a valid suite of packets.
-                start_index = p - buffer;
-                packet_count = (end - p) / PKT_SIZE;
-                return true;
-            }
+    // We need a 0x47 sync byte every 188 bytes up to the end of message, not leaving more
+    // than one truncated TS packet at the end of the message. The number of packets depends
+    // on the start index. Search the ranges of start index for a given number of packets,
+    // from the beginning of the buffer.
+    size_t first = 0;
+    for (size_t count = buffer_size / PKT_SIZE; count > 0; --count) {
+        // Range of start index for 'count' packets: first..last.
+        const size_t last = buffer_size - count * PKT_SIZE;
+        const size_t index = FindSync(buffer + first, last - first + count * PKT_SIZE, count);
+        if (index != NPOS) {
+            start_index = first + index;
+            packet_count = count;
+            return true;
         }
+        first = last + 1;
     }
 
     // Could not find a valid suite of TS packets.
@@ -960,6 +968,190 @@ bool ts::TSPacket::Locate(const uint8_t* buffer, size_t buffer_size, size_t& sta
 }
 
 
+//----------------------------------------------------------------------------
+// Check the sync byte of contiguous TS packets.
+//----------------------------------------------------------------------------
+
+size_t ts::TSPacket::FindInvalidSync(const TSPacket* packets, size_t count)
+{
+    // The sync bytes are 188 bytes apart, there is no useful SIMD load. Check blocks
+    // of packets without branch, then locate the invalid packet in the failing block.
+    constexpr size_t BLOCK = 8;
+    size_t index = 0;
+    for (; index + BLOCK <= count; index += BLOCK) {
+        uint8_t diff = 0;
+        for (size_t i = 0; i < BLOCK; ++i) {
+            diff |= packets[index + i].b[0] ^ SYNC_BYTE;
+        }
+        if (diff != 0) {
+            break;
+        }
+    }
+    while (index < count && packets[index].b[0] == SYNC_BYTE) {
+        ++index;
+    }
+    return index;
+}
+
+
+//----------------------------------------------------------------------------
+// Find a sequence of TS packets with valid sync bytes in a buffer.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Check sync bytes at a given stride, starting at a given packet.
+    inline bool CheckStride(const uint8_t* sync, size_t count, size_t pkt_size, size_t first)
+    {
+        for (size_t i = first; i < count; ++i) {
+            if (sync[i * pkt_size] != ts::SYNC_BYTE) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+size_t ts::TSPacket::FindSync(const uint8_t* buffer, size_t buffer_size, size_t count, size_t pkt_size, size_t header_size)
+{
+    if (buffer == nullptr || count == 0 || pkt_size <= header_size || count > buffer_size / pkt_size) {
+        return NPOS;
+    }
+
+    // Last possible start index for the sequence of packets.
+    const size_t last = buffer_size - count * pkt_size;
+    size_t index = 0;
+
+#if defined(TS_PKT_SSE2) || defined(TS_PKT_NEON)
+
+    // Check 16 candidate positions at a time on the first 'strides' packets. All loads
+    // remain in the buffer when the 16 bytes after each sync byte are in the same packet.
+    // Candidates which pass the filter are then fully checked.
+    const size_t strides = std::min<size_t>(count, 4);
+    if (pkt_size >= header_size + 16) {
+        const uint8_t* const base = buffer + header_size;
+#if defined(TS_PKT_SSE2)
+        const __m128i sync = _mm_set1_epi8(char(SYNC_BYTE));
+        for (; index + 15 <= last; index += 16) {
+            __m128i match = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base + index)), sync);
+            for (size_t i = 1; i < strides; ++i) {
+                match = _mm_and_si128(match, _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base + index + i * pkt_size)), sync));
+            }
+            for (uint32_t bits = uint32_t(_mm_movemask_epi8(match)); bits != 0; bits &= bits - 1) {
+                size_t bit = 0;
+                while ((bits & (1u << bit)) == 0) {
+                    ++bit;
+                }
+                if (CheckStride(base + index + bit, count, pkt_size, strides)) {
+                    return index + bit;
+                }
+            }
+        }
+#else
+        const uint8x16_t sync = vdupq_n_u8(SYNC_BYTE);
+        uint8_t lanes[16];
+        for (; index + 15 <= last; index += 16) {
+            uint8x16_t match = vceqq_u8(vld1q_u8(base + index), sync);
+            for (size_t i = 1; i < strides; ++i) {
+                match = vandq_u8(match, vceqq_u8(vld1q_u8(base + index + i * pkt_size), sync));
+            }
+            if (vmaxvq_u8(match) != 0) {
+                vst1q_u8(lanes, match);
+                for (size_t bit = 0; bit < 16; ++bit) {
+                    if (lanes[bit] != 0 && CheckStride(base + index + bit, count, pkt_size, strides)) {
+                        return index + bit;
+                    }
+                }
+            }
+        }
+#endif
+    }
+
+#endif
+
+    // Remaining positions, or all positions without SIMD instructions.
+    for (; index <= last; ++index) {
+        if (CheckStride(buffer + index + header_size, count, pkt_size, 0)) {
+            return index;
+        }
+    }
+    return NPOS;
+}
+
+
+//----------------------------------------------------------------------------
+// Find the first differing packet in two arrays of contiguous TS packets.
+//----------------------------------------------------------------------------
+
+size_t ts::TSPacket::FindDifferentPacket(const TSPacket* packets1, const TSPacket* packets2, size_t count)
+{
+    // Identical packets are the general case. Compare large blocks of packets
+    // using the system memcmp() (which is vectorized), then locate the packet.
+    constexpr size_t BLOCK = 64;
+    size_t index = 0;
+    while (index < count) {
+        const size_t size = std::min(BLOCK, count - index);
+        if (::memcmp(packets1[index].b, packets2[index].b, size * PKT_SIZE) != 0) {
+            break;
+        }
+        index += size;
+    }
+    while (index < count && ::memcmp(packets1[index].b, packets2[index].b, PKT_SIZE) == 0) {
+        ++index;
+    }
+    return index;
+}
+
+
+//----------------------------------------------------------------------------
+// Compare two memory areas byte by byte and locate the differences.
+//----------------------------------------------------------------------------
+
+size_t ts::TSPacket::CompareBytes(const uint8_t* mem1, const uint8_t* mem2, size_t size, size_t& first_diff, size_t& end_diff)
+{
+    first_diff = end_diff = size;
+    size_t diff_count = 0;
+    size_t index = 0;
+
+    // Byte-by-byte analysis of a range which is known to contain differences.
+    const auto scan = [&](size_t end) {
+        for (; index < end; ++index) {
+            if (mem1[index] != mem2[index]) {
+                ++diff_count;
+                end_diff = index + 1;
+                if (first_diff == size) {
+                    first_diff = index;
+                }
+            }
+        }
+    };
+
+#if defined(TS_PKT_SSE2) || defined(TS_PKT_NEON)
+
+    // Skip identical blocks of 16 bytes, only scan the differing ones.
+    while (index + 16 <= size) {
+#if defined(TS_PKT_SSE2)
+        const __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mem1 + index)),
+                                          _mm_loadu_si128(reinterpret_cast<const __m128i*>(mem2 + index)));
+        const bool same = _mm_movemask_epi8(eq) == 0xFFFF;
+#else
+        const bool same = vmaxvq_u8(veorq_u8(vld1q_u8(mem1 + index), vld1q_u8(mem2 + index))) == 0;
+#endif
+        if (same) {
+            index += 16;
+        }
+        else {
+            scan(index + 16);
+        }
+    }
+
+#endif
+
+    // Remaining bytes, or all bytes without SIMD instructions.
+    scan(size);
+    return diff_count;
+}
+
+
 //----------------------------------------------------------------------------
 // Error message fragment indicating the number of packets previously
 // read in a binary file
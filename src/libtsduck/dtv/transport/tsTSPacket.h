@@ -877,6 +877,55 @@ namespace ts {
         //!
         static bool Locate(const uint8_t* buffer, size_t buffer_size, size_t& start_index, size_t& packet_count);
 
+        //!
+        //! Check the sync byte of contiguous TS packets.
+        //! @param [in] packets Address of the first TS packet.
+        //! @param [in] count Number of contiguous TS packets to check.
+        //! @return The index of the first packet with an invalid sync byte or @a count if all packets are valid.
+        //!
+        static size_t FindInvalidSync(const TSPacket* packets, size_t count);
+
+        //!
+        //! Find a sequence of TS packets with valid sync bytes in a buffer.
+        //!
+        //! This static method is typically used to resynchronize on corrupted data.
+        //! All candidate positions are checked in one pass. When available, SIMD instructions
+        //! are used to check 16 candidate positions at a time, on several packets in parallel.
+        //!
+        //! @param [in] buffer Address of a buffer.
+        //! @param [in] buffer_size Size in bytes of the buffer.
+        //! @param [in] count Number of contiguous packets with a valid sync byte to find. Must be at least 1.
+        //! @param [in] pkt_size Size in bytes of each packet. This can be larger than a TS packet
+        //! when packets are encapsulated with a header or a trailer (M2TS, Reed-Solomon).
+        //! @param [in] header_size Size in bytes of the header before the sync byte in each packet.
+        //! @return The index in bytes in @a buffer of the first sequence of @a count packets or NPOS if not found.
+        //! The sequence of packets must entirely fit in the buffer.
+        //!
+        static size_t FindSync(const uint8_t* buffer, size_t buffer_size, size_t count, size_t pkt_size = PKT_SIZE, size_t header_size = 0);
+
+        //!
+        //! Find the first differing packet in two arrays of contiguous TS packets.
+        //! The packets are compared as raw binary data, without interpretation.
+        //! @param [in] packets1 Address of the first array of TS packets.
+        //! @param [in] packets2 Address of the second array of TS packets.
+        //! @param [in] count Number of TS packets in each array.
+        //! @return The index of the first packet which differs between the two arrays
+        //! or @a count if all packets are identical.
+        //!
+        static size_t FindDifferentPacket(const TSPacket* packets1, const TSPacket* packets2, size_t count);
+
+        //!
+        //! Compare two memory areas byte by byte and locate the differences.
+        //! This is typically used to compare the content of TS packets.
+        //! @param [in] mem1 Address of the first memory area.
+        //! @param [in] mem2 Address of the second memory area.
+        //! @param [in] size Size in bytes of each memory area.
+        //! @param [out] first_diff Offset of the first differing byte, @a size if the areas are identical.
+        //! @param [out] end_diff Offset after the last differing byte, @a size if the areas are identical.
+        //! @return The number of differing bytes, which can be lower than @a end_diff - @a first_diff.
+        //!
+        static size_t CompareBytes(const uint8_t* mem1, const uint8_t* mem2, size_t size, size_t& first_diff, size_t& end_diff);
+
         //!
         //! Sanity check routine.
         //! Ensure that the TSPacket structure can
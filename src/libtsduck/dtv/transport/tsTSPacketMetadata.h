@@ -204,6 +204,12 @@ namespace ts {
         //!
         void clearAllLabels() { _labels.reset(); }
 
+        //!
+        //! Get the set of labels of the TS packet.
+        //! @return A constant reference to the set of labels.
+        //!
+        const LabelSet& getLabels() const { return _labels; }
+
         //!
         //! Get the list of labels as a string, typically for debug messages.
         //! @param [in] separator Separator between labale values.
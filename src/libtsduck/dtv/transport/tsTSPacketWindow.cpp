@@ -29,17 +29,23 @@
 
 #include "tsTSPacketWindow.h"
 
+// The label index uses one 32-bit mask per packet.
+static_assert(ts::TSPacketMetadata::LABEL_COUNT <= 32, "label index too small for all labels");
+
 
 //----------------------------------------------------------------------------
 // Constructors.
 //----------------------------------------------------------------------------
 
 ts::TSPacketWindow::TSPacketWindow() :
+    _indexed(false),
     _size(0),
     _nullify_count(0),
     _drop_count(0),
     _last_range_index(0),
-    _ranges()
+    _ranges(),
+    _pids(),
+    _labels()
 {
 }
 
@@ -55,6 +61,19 @@ void ts::TSPacketWindow::clear()
     _drop_count = 0;
     _last_range_index = 0;
     _ranges.clear();
+    _pids.clear();
+    _labels.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Enable or disable the PID and label index.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketWindow::setIndexed(bool on)
+{
+    assert(_size == 0);
+    _indexed = on;
 }
 
 
@@ -67,6 +86,14 @@ void ts::TSPacketWindow::addPacketsReference(TSPacket* pkt, TSPacketMetadata* md
     assert(pkt != nullptr);
     assert(mdata != nullptr);
 
+    // Build the PID and label index of the new packets, only when requested.
+    if (_indexed) {
+        for (size_t i = 0; i < count; ++i) {
+            _pids.push_back(pkt[i].b[0] == SYNC_BYTE ? pkt[i].getPID() : PID_MAX);
+            _labels.push_back(uint32_t(mdata[i].getLabels().to_ulong()));
+        }
+    }
+
     // Enlarge the last range if the next packets are contiguous.
     if (!_ranges.empty()) {
         PacketRange& last(_ranges.back());
@@ -122,6 +149,74 @@ bool ts::TSPacketWindow::get(size_t index, TSPacket*& pkt, TSPacketMetadata*& md
 }
 
 
+//----------------------------------------------------------------------------
+// Search packets using the PID and label index.
+// The loops are kept simple so that the compiler can vectorize them.
+// Without index, the packets and their metadata are accessed one by one.
+//----------------------------------------------------------------------------
+
+size_t ts::TSPacketWindow::findPID(PID pid, size_t start) const
+{
+    if (_indexed) {
+        const PID* const pids = _pids.data();
+        for (size_t i = start; i < _size; ++i) {
+            if (pids[i] == pid) {
+                return i;
+            }
+        }
+    }
+    else {
+        for (size_t i = start; i < _size; ++i) {
+            const TSPacket* const pkt = packet(i);
+            if (pkt != nullptr && pkt->getPID() == pid) {
+                return i;
+            }
+        }
+    }
+    return NPOS;
+}
+
+size_t ts::TSPacketWindow::countPID(PID pid) const
+{
+    size_t count = 0;
+    if (_indexed) {
+        const PID* const pids = _pids.data();
+        for (size_t i = 0; i < _size; ++i) {
+            count += pids[i] == pid;
+        }
+    }
+    else {
+        for (size_t i = 0; i < _size; ++i) {
+            const TSPacket* const pkt = packet(i);
+            count += pkt != nullptr && pkt->getPID() == pid;
+        }
+    }
+    return count;
+}
+
+size_t ts::TSPacketWindow::findAnyLabel(const TSPacketMetadata::LabelSet& mask, size_t start) const
+{
+    if (_indexed) {
+        const uint32_t bits = uint32_t(mask.to_ulong());
+        const uint32_t* const labels = _labels.data();
+        for (size_t i = start; i < _size; ++i) {
+            if ((labels[i] & bits) != 0) {
+                return i;
+            }
+        }
+    }
+    else {
+        for (size_t i = start; i < _size; ++i) {
+            const TSPacketMetadata* const mdata = metadata(i);
+            if (mdata != nullptr && mdata->hasAnyLabel(mask)) {
+                return i;
+            }
+        }
+    }
+    return NPOS;
+}
+
+
 //----------------------------------------------------------------------------
 // Get the physical index of a packet inside a buffer.
 //----------------------------------------------------------------------------
@@ -197,6 +292,9 @@ void ts::TSPacketWindow::nullify(size_t index)
         // Count nullified packets once only.
         _nullify_count++;
         *pkt = NullPacket;
+        if (_indexed) {
+            _pids[index] = PID_NULL;
+        }
     }
 }
 
@@ -211,5 +309,8 @@ void ts::TSPacketWindow::drop(size_t index)
     if (pkt != nullptr) {
         _drop_count++;
         pkt->b[0] = 0;
+        if (_indexed) {
+            _pids[index] = PID_MAX;
+        }
     }
 }
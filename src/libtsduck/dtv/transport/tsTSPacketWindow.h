@@ -49,6 +49,15 @@ namespace ts {
     //! a circular buffer and/or a buffer with unused entries. This is the case of the
     //! TSProcessor global buffer.
     //!
+    //! Optionally, when packets are added in the window, their PID and labels are collected
+    //! in two contiguous arrays (a "structure of arrays" index). Plugins which only need to
+    //! select packets by PID or label can scan these arrays without accessing the packets
+    //! and their metadata. The corresponding loops are easily vectorized by the compiler.
+    //! Building the index has a cost and it is disabled by default, see setIndexed().
+    //! The index reflects the state of the packets when they were added in the window.
+    //! It is updated by nullify() and drop() but not when a packet or its metadata is
+    //! directly modified.
+    //!
     class TSDUCKDLL TSPacketWindow
     {
         TS_NOCOPY(TSPacketWindow);
@@ -60,9 +69,24 @@ namespace ts {
 
         //!
         //! Clear the content of the packet window.
+        //! The indexing mode is unchanged.
         //!
         void clear();
 
+        //!
+        //! Enable or disable the PID and label index of the packets in the window.
+        //! The indexing mode shall be set while the window is empty, before adding packets.
+        //! @param [in] on When true, the PID and label of the packets are collected when
+        //! they are added in the window.
+        //!
+        void setIndexed(bool on);
+
+        //!
+        //! Check if the PID and label index of the packets in the window is enabled.
+        //! @return True if the PID and label index is enabled.
+        //!
+        bool isIndexed() const { return _indexed; }
+
         //!
         //! Add the address of a range of packets and their metadata inside the window.
         //! @param [in] packet The address of the first packet.
@@ -77,6 +101,45 @@ namespace ts {
         //!
         size_t size() const { return _size; }
 
+        //!
+        //! Get the PID index of the packets in the window.
+        //! @return The address of a contiguous array of size() PID values, one per packet in the window.
+        //! Dropped packets have the invalid value PID_MAX. The array is invalidated when packets are added.
+        //! Return a null pointer if the index is not enabled.
+        //!
+        const PID* pids() const { return _indexed ? _pids.data() : nullptr; }
+
+        //!
+        //! Get the label index of the packets in the window.
+        //! @return The address of a contiguous array of size() label masks, one per packet in the window.
+        //! In each mask, bit N is set when the packet has label N. The array is invalidated when packets are added.
+        //! Return a null pointer if the index is not enabled.
+        //!
+        const uint32_t* labels() const { return _indexed ? _labels.data() : nullptr; }
+
+        //!
+        //! Find the next packet with a given PID in the window, using the PID index if enabled.
+        //! @param [in] pid The PID to search.
+        //! @param [in] start Index in the window where to start the search.
+        //! @return The index of the first packet with PID @a pid, starting at @a start, or NPOS if not found.
+        //!
+        size_t findPID(PID pid, size_t start = 0) const;
+
+        //!
+        //! Count the packets with a given PID in the window, using the PID index if enabled.
+        //! @param [in] pid The PID to search.
+        //! @return The number of packets with PID @a pid in the window.
+        //!
+        size_t countPID(PID pid) const;
+
+        //!
+        //! Find the next packet with any label from a set of labels, using the label index if enabled.
+        //! @param [in] mask The mask of labels to search.
+        //! @param [in] start Index in the window where to start the search.
+        //! @return The index of the first packet with any label from @a mask, starting at @a start, or NPOS if not found.
+        //!
+        size_t findAnyLabel(const TSPacketMetadata::LabelSet& mask, size_t start = 0) const;
+
         //!
         //! Get the address of a packet inside the window.
         //! @param [in] index Index of the packet inside the window, from 0 to size()-1.
@@ -166,10 +229,13 @@ namespace ts {
         // Same as public get() but returns non-null addresses for dropped packets.
         bool getInternal(size_t index, TSPacket*& packet, TSPacketMetadata*& metadata) const;
 
+        bool                     _indexed;           // Build the PID and label index.
         size_t                   _size;              // Number of packets in the window.
         size_t                   _nullify_count;     // Number of nullified packets.
         size_t                   _drop_count;        // Number of dropped packets.
         mutable volatile size_t  _last_range_index;  // Last accessed range (to optimiza sequential access).
         std::vector<PacketRange> _ranges;            // Ranges of contiguous packets.
+        std::vector<PID>         _pids;              // PID index, one per packet in the window.
+        std::vector<uint32_t>    _labels;            // Label index, one per packet in the window.
     };
 }
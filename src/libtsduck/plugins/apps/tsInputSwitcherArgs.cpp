@@ -118,6 +118,10 @@ void ts::InputSwitcherArgs::defineArgs(Args& args)
               u"By default, all input plugins are executed in sequence only once (--cycle 1). "
               u"The options --cycle, --infinite and --terminate are mutually exclusive.");
 
+    PluginOptions::DefineCPUPlacementArgs(args,
+        u"The input plugins have indexes 0 to N-1, in the order of the command line, "
+        u"and the output plugin has index N.");
+
     args.option(u"delayed-switch", 'd');
     args.help(u"delayed-switch",
               u"Perform delayed input switching. When switching from one input plugin to another one, "
@@ -295,6 +299,14 @@ bool ts::InputSwitcherArgs::loadArgs(DuckContext& duck, Args& args)
         inputs.push_back(PluginOptions(u"file"));
     }
 
+    // CPU placement of all plugin threads, in order of plugin index.
+    std::vector<PluginOptions*> chain;
+    for (auto& it : inputs) {
+        chain.push_back(&it);
+    }
+    chain.push_back(&output);
+    PluginOptions::LoadCPUPlacementArgs(args, chain);
+
     // Check validity of input indexes.
     if (firstInput >= inputs.size()) {
         args.error(u"invalid input index for --first-input %d", {firstInput});
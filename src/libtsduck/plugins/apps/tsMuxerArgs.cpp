@@ -131,6 +131,10 @@ void ts::MuxerArgs::defineArgs(Args& args)
               u"Specify the internal polling cadence in microseconds. "
               u"The default is " + UString::Decimal(DEFAULT_CADENCE) + u" microseconds.");
 
+    PluginOptions::DefineCPUPlacementArgs(args,
+        u"The input plugins have indexes 0 to N-1, in the order of the command line, "
+        u"and the output plugin has index N.");
+
     args.option<BitRate>(u"cat-bitrate", 0, 0, 0, MIN_PSI_BITRATE);
     args.help(u"cat-bitrate",
               u"CAT bitrate in output stream. The default is " + UString::Decimal(DEFAULT_PSI_BITRATE) + u" b/s.");
@@ -258,6 +262,15 @@ bool ts::MuxerArgs::loadArgs(DuckContext& duck, Args& args)
         // If no input plugin is used, used only standard input.
         inputs.push_back(PluginOptions(u"file"));
     }
+
+    // CPU placement of all plugin threads, in order of plugin index.
+    std::vector<PluginOptions*> chain;
+    for (auto& it : inputs) {
+        chain.push_back(&it);
+    }
+    chain.push_back(&output);
+    PluginOptions::LoadCPUPlacementArgs(args, chain);
+
     if (timeInputIndex != NPOS && timeInputIndex >= inputs.size()) {
         args.error(u"%d is not a valid input plugin index in --time-reference-input", {timeInputIndex});
     }
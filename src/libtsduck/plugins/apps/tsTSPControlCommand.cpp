@@ -56,6 +56,16 @@ ts::TSPControlCommand::TSPControlCommand(Report& report) :
 
     arg = command(u"list", u"List all running plugins", u"[options]", flags);
 
+    arg = command(u"stats", u"Display execution statistics of plugins", u"[options] [plugin-index]", flags | Args::NO_VERBOSE);
+    arg->setIntro(u"Display execution statistics of all plugins in JSON format: time spent processing packets, "
+                  u"time waiting for packets, number of packets in the buffer area of the plugin, "
+                  u"latency of packets from input to output. Durations are in microseconds. "
+                  u"Use the command 'list' to list all running plugins. ");
+    arg->option(u"", 0, Args::UNSIGNED, 0, 1);
+    arg->help(u"", u"Index of the plugin to display. By default, display all plugins.");
+    arg->option(u"json-line");
+    arg->help(u"json-line", u"Display the JSON description on one single line.");
+
     arg = command(u"suspend", u"Suspend a plugin", u"[options] plugin-index", flags);
     arg->setIntro(u"Suspend a plugin. When a packet processing plugin is suspended, "
                   u"the TS packets are directly passed from the previous to the next plugin, "
@@ -32,6 +32,7 @@
 #include "tstspOutputExecutor.h"
 #include "tstspProcessorExecutor.h"
 #include "tstspControlServer.h"
+#include "tstspStatisticsLogger.h"
 #include "tsMonotonic.h"
 #include "tsGuardMutex.h"
 
@@ -49,6 +50,7 @@ ts::TSProcessor::TSProcessor(Report& report) :
     _input(nullptr),
     _output(nullptr),
     _control(nullptr),
+    _stats_logger(nullptr),
     _packet_buffer(nullptr),
     _metadata_buffer(nullptr)
 {
@@ -74,6 +76,10 @@ void ts::TSProcessor::cleanupInternal()
         delete _control;
         _control = nullptr;
     }
+    if (_stats_logger != nullptr) {
+        delete _stats_logger;
+        _stats_logger = nullptr;
+    }
 
     // Abort and wait for threads to terminate
     tsp::PluginExecutor* proc = _input;
@@ -187,20 +193,37 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
             }
         } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != _input);
 
+        // Allocate the global buffers while running on the CPU's of the input plugin, if specified.
+        // With the default "first touch" memory policy of the operating system, the physical memory
+        // is then allocated on the NUMA node of the input plugin, which writes the packets first.
+        std::set<size_t> saved_cpus;
+        const bool input_placement = !_args.input.cpus.empty() && Thread::GetCurrentCPUAffinity(saved_cpus) && Thread::SetCurrentCPUAffinity(_args.input.cpus);
+        if (input_placement) {
+            _report.debug(u"tsp: allocating buffers on CPU's %s", {ThreadAttributes::EncodeCPUList(_args.input.cpus)});
+        }
+
         // Allocate a memory-resident buffer of TS packets
-        _packet_buffer = new PacketBuffer(_args.ts_buffer_size / ts::PKT_SIZE);
+        _packet_buffer = new PacketBuffer(_args.ts_buffer_size / ts::PKT_SIZE, _args.buffer_pages);
         CheckNonNull(_packet_buffer);
         if (!_packet_buffer->isLocked()) {
             _report.debug(u"tsp: buffer failed to lock into physical memory (%d: %s), risk of real-time issue",
                           {_packet_buffer->lockErrorCode(), ts::SysErrorCodeMessage(_packet_buffer->lockErrorCode())});
         }
         _report.debug(u"tsp: buffer size: %'d TS packets, %'d bytes", {_packet_buffer->count(), _packet_buffer->count() * ts::PKT_SIZE});
+        if (_args.buffer_pages != PageMode::STANDARD) {
+            _report.verbose(u"tsp: buffer memory pages: %s", {PageModeEnum.name(int(_packet_buffer->pageMode()))});
+        }
 
         // Buffer for the packet metadata.
         // A packet and its metadata have the same index in their respective buffer.
-        _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count());
+        _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count(), _args.buffer_pages);
         CheckNonNull(_metadata_buffer);
 
+        // Restore the CPU affinity of the current thread.
+        if (input_placement) {
+            Thread::SetCurrentCPUAffinity(saved_cpus);
+        }
+
         // End of locked section.
     }
 
@@ -241,6 +264,11 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
     CheckNonNull(_control);
     _control->open();
 
+    // Create a thread to periodically log plugin statistics, if requested.
+    _stats_logger = new tsp::StatisticsLogger(_args, _report, _input);
+    CheckNonNull(_stats_logger);
+    _stats_logger->open();
+
     return true;
 }
 
@@ -293,6 +321,7 @@ void ts::TSProcessor::waitForTermination()
 
         // Make sure the control server thread is terminated before deleting plugins.
         _control->close();
+        _stats_logger->close();
 
         // Deallocate all plugins and plugin executor
         cleanupInternal();
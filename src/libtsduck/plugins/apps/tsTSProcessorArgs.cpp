@@ -53,10 +53,13 @@ ts::TSProcessorArgs::TSProcessorArgs() :
     app_name(),
     ignore_jt(false),
     log_plugin_index(false),
+    lockfree_handoff(false),
     ts_buffer_size(DEFAULT_BUFFER_SIZE),
+    buffer_pages(PageMode::STANDARD),
     max_flush_pkt(0),
     max_input_pkt(0),
     max_output_pkt(NPOS), // unlimited
+    parallel_workers(0),
     init_input_pkt(0),
     instuff_nullpkt(0),
     instuff_inpkt(0),
@@ -73,6 +76,7 @@ ts::TSProcessorArgs::TSProcessorArgs() :
     control_reuse(false),
     control_sources(),
     control_timeout(DEF_CONTROL_TIMEOUT),
+    stats_interval(0),
     duck_args(),
     input(),
     plugins(),
@@ -155,11 +159,27 @@ void ts::TSProcessorArgs::defineArgs(Args& args)
               u"Specify the reception timeout in milliseconds for control commands. "
               u"The default timeout is " TS_STRINGIFY(DEF_CONTROL_TIMEOUT) u" ms.");
 
+    PluginOptions::DefineCPUPlacementArgs(args,
+        u"The input plugin has index 0, the packet processing plugins have indexes 1 to N and "
+        u"the output plugin has index N+1, as displayed with --log-plugin-index. "
+        u"The global packet buffer is allocated on the NUMA node of the CPU's of the input plugin.");
+
     args.option(u"final-wait", 0, Args::INT64);
     args.help(u"final-wait", u"milliseconds",
               u"Wait the specified number of milliseconds after the last input packet. "
               u"Zero means wait forever.");
 
+    args.option(u"huge-pages", 0, PageModeEnum, 0, 1, true);
+    args.help(u"huge-pages", u"mode",
+              u"Allocate the global packet buffer using huge memory pages (typically 2 MB instead of 4 kB). "
+              u"Huge pages reduce the number of TLB misses when the plugins access large buffers at high bitrates. "
+              u"With \"explicit\" (the default when the option is used without value), the huge pages are "
+              u"allocated from the pool of huge pages of the system which must be previously reserved "
+              u"(see /proc/sys/vm/nr_hugepages on Linux). If the pool is not large enough, or with \"transparent\", "
+              u"the system is only advised to use transparent huge pages. "
+              u"If huge pages are not supported, standard memory pages are used. "
+              u"Huge pages are currently supported on Linux only.");
+
     args.option(u"ignore-joint-termination", 'i');
     args.help(u"ignore-joint-termination",
               u"Ignore all --joint-termination options in plugins. "
@@ -180,12 +200,30 @@ void ts::TSProcessorArgs::defineArgs(Args& args)
               u"a valid bitrate value from the beginning. "
               u"The default initial load is half the size of the global buffer.");
 
+    args.option(u"lock-free-handoff");
+    args.help(u"lock-free-handoff",
+              u"Pass packets from one plugin thread to the next one using atomic counters instead of "
+              u"a global mutex which is shared by all plugins. A waiting plugin thread first polls "
+              u"for packets during an adaptive period of time and then sleeps until it is awaken. "
+              u"This option may reduce the synchronization overhead with long chains of plugins "
+              u"at high bitrates, at the expense of some additional CPU load when the threads poll. "
+              u"The behavior of the plugins is unchanged.");
+
     args.option(u"log-plugin-index");
     args.help(u"log-plugin-index",
               u"In log messages, add the plugin index to the plugin name. "
               u"This can be useful if the same plugin is used several times "
               u"and all instances log many messages.");
 
+    args.option(u"log-plugin-statistics", 0, Args::POSITIVE);
+    args.help(u"log-plugin-statistics", u"seconds",
+              u"Periodically log the execution statistics of all plugins. "
+              u"For each plugin, one line is logged in JSON format with the time spent processing packets, "
+              u"the time waiting for packets, the number of packets in the buffer area of the plugin and, "
+              u"for the output plugin, the latency of packets from input to output. "
+              u"The same statistics are available on demand using the tspcontrol command 'stats'. "
+              u"By default, the statistics are not logged.");
+
     args.option(u"receive-timeout", 0, Args::POSITIVE);
     args.help(u"receive-timeout", u"milliseconds",
               u"Specify a timeout in milliseconds for all input operations. "
@@ -214,6 +252,16 @@ void ts::TSProcessorArgs::defineArgs(Args& args)
               u"This option is useful only when an output plugin or device has problems with large output requests. "
               u"This option forces multiple smaller send operations.");
 
+    args.option(u"parallel-workers", 0, Args::INTEGER, 0, 1, 1, 256);
+    args.help(u"parallel-workers", u"count",
+              u"Specify the number of parallel threads which are used to process packets in each "
+              u"stateless packet processor plugin. A stateless plugin is a pure packet transformation, "
+              u"without dependency between packets, such as \"filter\" without time or packet count criteria. "
+              u"Each worker thread uses its own instance of the plugin and processes a distinct part "
+              u"of the buffer. The order of packets is preserved. "
+              u"This option is ignored for plugins which are not stateless with their current options. "
+              u"By default, each plugin is executed in one single thread.");
+
     args.option(u"realtime", 'r', Args::TRISTATE, 0, 1, -255, 256, true);
     args.help(u"realtime",
               u"Specifies if tsp and all plugins should use default values for real-time "
@@ -234,12 +282,15 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
 {
     app_name = args.appName();
     log_plugin_index = args.present(u"log-plugin-index");
+    lockfree_handoff = args.present(u"lock-free-handoff");
     ts_buffer_size = args.intValue<size_t>(u"buffer-size-mb", DEFAULT_BUFFER_SIZE);
+    buffer_pages = args.present(u"huge-pages") ? args.intValue<PageMode>(u"huge-pages", PageMode::EXPLICIT_HUGE) : PageMode::STANDARD;
     args.getValue(fixed_bitrate, u"bitrate", 0);
     bitrate_adj = MilliSecPerSec * args.intValue(u"bitrate-adjust-interval", DEF_BITRATE_INTERVAL);
     args.getIntValue(max_flush_pkt, u"max-flushed-packets", 0);
     args.getIntValue(max_input_pkt, u"max-input-packets", 0);
     args.getIntValue(max_output_pkt, u"max-output-packets", NPOS); // unlimited by default
+    args.getIntValue(parallel_workers, u"parallel-workers", 0);
     args.getIntValue(init_input_pkt, u"initial-input-packets", 0);
     args.getIntValue(instuff_start, u"add-start-stuffing", 0);
     args.getIntValue(instuff_stop, u"add-stop-stuffing", 0);
@@ -250,6 +301,7 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
     args.getIntValue(control_port, u"control-port", 0);
     args.getIntValue(control_timeout, u"control-timeout", DEF_CONTROL_TIMEOUT);
     control_reuse = args.present(u"control-reuse-port");
+    stats_interval = MilliSecPerSec * args.intValue<MilliSecond>(u"log-plugin-statistics", 0);
 
     // Convert MB in MiB for buffer size for compatibility with original versions.
     ts_buffer_size = size_t((uint64_t(ts_buffer_size) * 1024 * 1024) / 1000000);
@@ -297,6 +349,15 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
         plugins.clear();
     }
 
+    // CPU placement of all plugin threads, in order of plugin index.
+    std::vector<PluginOptions*> chain;
+    chain.push_back(&input);
+    for (auto& it : plugins) {
+        chain.push_back(&it);
+    }
+    chain.push_back(&output);
+    PluginOptions::LoadCPUPlacementArgs(args, chain);
+
     // Get default options for TSDuck contexts in each plugin.
     duck.saveArgs(duck_args);
 
@@ -35,6 +35,7 @@
 #pragma once
 #include "tsPluginOptions.h"
 #include "tsIPv4Address.h"
+#include "tsResidentBuffer.h"
 
 namespace ts {
 
@@ -51,10 +52,13 @@ namespace ts {
         UString           app_name;         //!< Application name, for help messages.
         bool              ignore_jt;        //!< Ignore "joint termination" options in plugins.
         bool              log_plugin_index; //!< Log plugin index with plugin name.
+        bool              lockfree_handoff; //!< Pass packets between plugin threads using atomic counters instead of the global mutex.
         size_t            ts_buffer_size;   //!< Size in bytes of the global TS packet buffer.
+        PageMode          buffer_pages;     //!< Type of memory pages for the global TS packet buffer.
         size_t            max_flush_pkt;    //!< Max processed packets before flush.
         size_t            max_input_pkt;    //!< Max packets per input operation.
         size_t            max_output_pkt;   //!< Max packets per outsput operation.
+        size_t            parallel_workers; //!< Number of parallel workers for stateless packet processors (0 or 1 means no parallelism).
         size_t            init_input_pkt;   //!< Initial number of input packets to read before starting the processing (zero means default).
         size_t            instuff_nullpkt;  //!< Add input stuffing: add @a instuff_nullpkt null packets every @a instuff_inpkt input packets.
         size_t            instuff_inpkt;    //!< Add input stuffing: add @a instuff_nullpkt null packets every @a instuff_inpkt input packets.
@@ -71,6 +75,7 @@ namespace ts {
         bool              control_reuse;    //!< Set the 'reuse port' socket option on the control TCP server port.
         IPv4AddressVector control_sources;  //!< Remote IP addresses which are allowed to send control commands.
         MilliSecond       control_timeout;  //!< Reception timeout in milliseconds for control commands.
+        MilliSecond       stats_interval;   //!< Interval between logs of plugin execution statistics. Zero means none.
         DuckContext::SavedArgs duck_args;   //!< Default TSDuck context options for all plugins. Each plugin can override them in its context.
         PluginOptions          input;       //!< Input plugin description.
         PluginOptionsVector    plugins;     //!< Packet processor plugins descriptions.
@@ -28,10 +28,13 @@
 //----------------------------------------------------------------------------
 
 #include "tsPluginOptions.h"
+#include "tsThreadAttributes.h"
+#include "tsSysInfo.h"
 
 ts::PluginOptions::PluginOptions(const ts::UString& name_, const UStringVector& args_) :
     name(name_),
-    args(args_)
+    args(args_),
+    cpus()
 {
 }
 
@@ -45,6 +48,7 @@ void ts::PluginOptions::clear()
 {
     name.clear();
     args.clear();
+    cpus.clear();
 }
 
 ts::UString ts::PluginOptions::toString(PluginType type) const
@@ -73,3 +77,105 @@ ts::UString ts::PluginOptions::toString(PluginType type) const
     }
     return str;
 }
+
+
+//----------------------------------------------------------------------------
+// Command line options for the CPU placement of plugin threads.
+//----------------------------------------------------------------------------
+
+void ts::PluginOptions::DefineCPUPlacementArgs(Args& args, const UString& indexes)
+{
+    args.option(u"cpu-affinity", 0, Args::STRING, 0, Args::UNLIMITED_COUNT);
+    args.help(u"cpu-affinity", u"[index:]cpu-list",
+              u"Restrict the execution of plugin threads on the specified CPU's. "
+              u"The CPU list is a comma-separated list of CPU indexes or ranges of indexes, "
+              u"as in the Linux command taskset, for instance \"0-3,8\". "
+              u"When the value starts with a plugin index and a colon, the CPU affinity applies to this plugin only. " +
+              indexes + u" "
+              u"Otherwise, it applies to all plugins without specific CPU affinity. "
+              u"Several --cpu-affinity options may be specified. "
+              u"This option is implemented on Linux and Windows only. "
+              u"By default, all threads can run on any CPU.");
+
+    args.option(u"numa-node", 0, Args::STRING, 0, Args::UNLIMITED_COUNT);
+    args.help(u"numa-node", u"[index:]node",
+              u"Restrict the execution of plugin threads on the CPU's of the specified NUMA node, "
+              u"typically a processor socket on multi-socket systems. "
+              u"Keeping all plugin threads on the same node as the memory they use avoids cross-socket traffic. "
+              u"The optional plugin index has the same meaning as in option --cpu-affinity. "
+              u"When --cpu-affinity and --numa-node apply to the same plugin, its thread is restricted "
+              u"to the CPU's which belong to both lists. "
+              u"This option is implemented on Linux and Windows only.");
+}
+
+bool ts::PluginOptions::LoadCPUPlacementArgs(Args& args, const std::vector<PluginOptions*>& plugins)
+{
+    // CPU sets per plugin index, the last entry is for all plugins (no index).
+    const size_t all = plugins.size();
+    std::vector<std::set<size_t>> affinity(all + 1);
+    std::vector<std::set<size_t>> numa(all + 1);
+    std::vector<bool> has_affinity(all + 1, false);
+    std::vector<bool> has_numa(all + 1, false);
+    bool success = true;
+
+    // Decode all options.
+    for (bool is_numa : {false, true}) {
+        const UChar* const opt = is_numa ? u"numa-node" : u"cpu-affinity";
+        for (size_t n = 0; n < args.count(opt); ++n) {
+            const UString value(args.value(opt, u"", n));
+            const size_t colon = value.find(u':');
+            size_t index = all;
+            if (colon != NPOS && (!value.substr(0, colon).toInteger(index) || index >= all)) {
+                args.error(u"invalid plugin index in --%s %s", {opt, value});
+                success = false;
+                continue;
+            }
+            const UString spec(colon == NPOS ? value : value.substr(colon + 1));
+            std::set<size_t> cpus;
+            size_t node = 0;
+            if (is_numa) {
+                if (!spec.toInteger(node) || !SysInfo::Instance()->getNUMANodeCPUs(node, cpus)) {
+                    args.error(u"invalid or unsupported NUMA node in --%s %s", {opt, value});
+                    success = false;
+                    continue;
+                }
+                numa[index] = cpus;
+                has_numa[index] = true;
+            }
+            else {
+                if (!ThreadAttributes::DecodeCPUList(spec, cpus) || cpus.empty()) {
+                    args.error(u"invalid CPU list in --%s %s", {opt, value});
+                    success = false;
+                    continue;
+                }
+                affinity[index] = cpus;
+                has_affinity[index] = true;
+            }
+        }
+    }
+
+    // Compute the final CPU set of each plugin.
+    for (size_t index = 0; success && index < all; ++index) {
+        const size_t ai = has_affinity[index] ? index : all;
+        const size_t ni = has_numa[index] ? index : all;
+        PluginOptions* plugin = plugins[index];
+        if (plugin == nullptr) {
+            continue;
+        }
+        plugin->cpus.clear();
+        if (has_affinity[ai] && has_numa[ni]) {
+            std::set_intersection(affinity[ai].begin(), affinity[ai].end(), numa[ni].begin(), numa[ni].end(), std::inserter(plugin->cpus, plugin->cpus.end()));
+            if (plugin->cpus.empty()) {
+                args.error(u"no CPU in both --cpu-affinity and --numa-node for plugin %d (%s)", {index, plugin->name});
+                success = false;
+            }
+        }
+        else if (has_affinity[ai]) {
+            plugin->cpus = affinity[ai];
+        }
+        else if (has_numa[ni]) {
+            plugin->cpus = numa[ni];
+        }
+    }
+    return success;
+}
@@ -69,8 +69,27 @@ namespace ts {
         //!
         UString toString(PluginType type) const;
 
-        UString       name;  //!< Plugin name.
-        UStringVector args;  //!< Plugin options.
+        //!
+        //! Add command line option definitions for the CPU placement of the plugin threads of an application.
+        //! The options are -\-cpu-affinity and -\-numa-node.
+        //! @param [in,out] args Command line arguments to update.
+        //! @param [in] indexes Description of the plugin indexes in the application, for the help text.
+        //!
+        static void DefineCPUPlacementArgs(Args& args, const UString& indexes);
+
+        //!
+        //! Load the CPU placement of the plugin threads of an application from command line arguments.
+        //! The options must have been defined using DefineCPUPlacementArgs().
+        //! @param [in,out] args Command line arguments. Errors are reported there.
+        //! @param [in,out] plugins Options of all plugins of the application, in order of plugin index.
+        //! The field @a cpus is updated in each of them.
+        //! @return True on success, false on error.
+        //!
+        static bool LoadCPUPlacementArgs(Args& args, const std::vector<PluginOptions*>& plugins);
+
+        UString          name;  //!< Plugin name.
+        UStringVector    args;  //!< Plugin options.
+        std::set<size_t> cpus;  //!< CPU affinity of the plugin thread. When empty, the thread can run on any CPU.
     };
 
     //!
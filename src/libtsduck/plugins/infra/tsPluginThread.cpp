@@ -98,10 +98,13 @@ ts::PluginThread::PluginThread(Report* report, const UString& appName, PluginTyp
         stackSize = STACK_SIZE_OVERHEAD + _shlib->stackUsage();
     }
 
-    // Define thread name and stack size.
+    // Define thread name, stack size and CPU affinity.
     ThreadAttributes attr(attributes);
     attr.setName(_name);
     attr.setStackSize(stackSize);
+    if (!options.cpus.empty()) {
+        attr.setCPUAffinity(options.cpus);
+    }
     Thread::setAttributes(attr);
 }
 
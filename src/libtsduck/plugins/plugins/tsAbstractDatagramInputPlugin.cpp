@@ -50,6 +50,7 @@ ts::AbstractDatagramInputPlugin::AbstractDatagramInputPlugin(TSP* tsp_,
     _time_priority_enum(),
     _time_priority(RTP_TSP),
     _default_time_priority(RTP_TSP),
+    _buffer_size(std::max(buffer_size, 7 * PKT_SIZE)),
     _next_display(Time::Epoch),
     _start(Time::Epoch),
     _packets(0),
@@ -60,8 +61,15 @@ ts::AbstractDatagramInputPlugin::AbstractDatagramInputPlugin(TSP* tsp_,
     _inbuf_count(0),
     _inbuf_next(0),
     _mdata_next(0),
-    _inbuf(std::max(buffer_size, 7 * PKT_SIZE)),
-    _mdata(_inbuf.size() / PKT_SIZE)
+    _inbuf(_buffer_size),
+    _mdata(_inbuf.size() / PKT_SIZE),
+    _batch_size(0),
+    _slot_size(0),
+    _queue_count(0),
+    _queue_next(0),
+    _queue(),
+    _queue_mdata(),
+    _rbuf()
 {
     if (_real_time) {
         option(u"display-interval", 'd', POSITIVE);
@@ -112,6 +120,19 @@ bool ts::AbstractDatagramInputPlugin::isRealTime()
     return _real_time;
 }
 
+size_t ts::AbstractDatagramInputPlugin::getDatagramBatchSize()
+{
+    // No batched reception by default.
+    return 0;
+}
+
+bool ts::AbstractDatagramInputPlugin::receiveDatagrams(UDPSocket::ReceiveBuffer*, size_t& count)
+{
+    // Should not be called when getDatagramBatchSize() returns zero.
+    count = 0;
+    return false;
+}
+
 
 //----------------------------------------------------------------------------
 // Input command line options method
@@ -136,8 +157,20 @@ bool ts::AbstractDatagramInputPlugin::start()
 {
     // Initialize working data.
     _inbuf_count = _inbuf_next = _mdata_next = 0;
+    _queue_count = _queue_next = 0;
     _start = _start_0 = _start_1 = _next_display = Time::Epoch;
     _packets = _packets_0 = _packets_1 = 0;
+
+    // With batched reception, each datagram has a slot in the input buffer. The first 7 TS packets of
+    // the datagram are normally received in the tsp buffer. The first part of the slot is used when the
+    // datagram is not received in the tsp buffer or must be reassembled. The rest of the slot receives
+    // the rest of the datagram, when it is larger than 7 TS packets.
+    _batch_size = getDatagramBatchSize();
+    if (_batch_size > 0) {
+        _slot_size = 7 * PKT_SIZE + _buffer_size;
+        _inbuf.resize(_batch_size * _slot_size);
+        _rbuf.resize(_batch_size);
+    }
     return true;
 }
 
@@ -173,6 +206,11 @@ ts::BitRateConfidence ts::AbstractDatagramInputPlugin::getBitrateConfidence()
 
 size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
 {
+    // Use batched reception when supported by the subclass.
+    if (_batch_size > 0) {
+        return receiveBatch(buffer, pkt_data, max_packets);
+    }
+
     MicroSecond timestamp = -1;
 
     // Check if we receive new packets or process remain of previous buffer.
@@ -192,64 +230,216 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
         new_packets = TSPacket::Locate(_inbuf.data(), insize, _inbuf_next, _inbuf_count);
 
         if (new_packets) {
+            // Build time stamps in packet metadata.
+            _mdata_next = 0;
+            setTimeStamps(_inbuf.data(), _inbuf_next, timestamp, _mdata.data(), _inbuf_count);
+            break; // found packets.
+        }
+
+        // No TS packet found in UDP message, wait for another one.
+        tsp->debug(u"no TS packet in message, %s bytes", {insize});
+    }
 
-            // Look for an RTP header before the first packet. There is no clear proof of the presence of the RTP header.
-            // We check if the header size is large enough for an RTP header and if the "RTP payload type" is MPEG-2 TS.
-            const bool rtp = _inbuf_next >= RTP_HEADER_SIZE && (_inbuf[1] & 0x7F) == RTP_PT_MP2T;
-            const uint32_t rtp_timestamp = rtp ? GetUInt32(_inbuf.data() + 4) : 0;
-
-            // Use RTP time stamp if there is one and RTP is the preferred choice.
-            bool use_rtp = false;
-            bool use_kernel = false;
-            switch (_time_priority) {
-                case RTP_SYSTEM_TSP:
-                    use_rtp = rtp;
-                    use_kernel = !rtp && timestamp >= 0;
-                    break;
-                case SYSTEM_RTP_TSP:
-                    use_kernel = timestamp >= 0;
-                    use_rtp = !use_kernel && rtp;
-                    break;
-                case RTP_TSP:
-                    use_rtp = rtp;
-                    use_kernel = false;
-                    break;
-                case SYSTEM_TSP:
-                    use_kernel = timestamp >= 0;
-                    use_rtp = false;
-                    break;
-                case TSP_ONLY:
-                default:
-                    use_rtp = false;
-                    use_kernel = false;
-                    break;
+    // If new packets were received, we may need to re-evaluate the real-time input bitrate.
+    if (new_packets) {
+        evaluateBitrate(_inbuf_count);
+    }
+
+    // Return packets from the input buffer
+    size_t pkt_cnt = std::min(_inbuf_count, max_packets);
+    TSPacket::Copy(buffer, _inbuf.data() + _inbuf_next, pkt_cnt);
+    TSPacketMetadata::Copy(pkt_data, &_mdata[_mdata_next], pkt_cnt);
+    _inbuf_count -= pkt_cnt;
+    _inbuf_next += pkt_cnt * PKT_SIZE;
+    _mdata_next += pkt_cnt;
+
+    return pkt_cnt;
+}
+
+
+//----------------------------------------------------------------------------
+// Batched input method
+//----------------------------------------------------------------------------
+
+size_t ts::AbstractDatagramInputPlugin::receiveBatch(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+{
+    // First, return packets from previous batch which did not fit in the tsp buffer.
+    if (_queue_count > 0) {
+        const size_t pkt_cnt = std::min(_queue_count, max_packets);
+        TSPacket::Copy(buffer, &_queue[_queue_next], pkt_cnt);
+        TSPacketMetadata::Copy(pkt_data, &_queue_mdata[_queue_next], pkt_cnt);
+        _queue_count -= pkt_cnt;
+        _queue_next += pkt_cnt;
+        return pkt_cnt;
+    }
+    _queue_next = 0;
+
+    // Datagrams are directly received in the tsp buffer, by slices of 7 TS packets, when there is enough space.
+    constexpr size_t direct_size = 7 * PKT_SIZE;
+    const bool direct = max_packets >= 7;
+    size_t pkt_cnt = 0;
+
+    // Loop until we get some TS packets.
+    while (pkt_cnt == 0) {
+
+        // Describe the reception buffers.
+        size_t msg_count = direct ? std::min(_batch_size, max_packets / 7) : 1;
+        for (size_t i = 0; i < msg_count; ++i) {
+            UDPSocket::ReceiveBuffer& rb(_rbuf[i]);
+            uint8_t* const slot = _inbuf.data() + i * _slot_size;
+            if (direct) {
+                rb.data1 = buffer[7 * i].b;
+                rb.size1 = direct_size;
+                rb.data2 = slot + direct_size;
+                rb.size2 = _slot_size - direct_size;
+            }
+            else {
+                rb.data1 = slot;
+                rb.size1 = _slot_size;
+                rb.data2 = nullptr;
+                rb.size2 = 0;
             }
+        }
 
-            // Build time stamps in packet metadata.
-            _mdata_next = 0;
-            for (size_t i = 0; i < _inbuf_count; ++i) {
-                if (use_rtp) {
-                    // RTP time stamp unit is 90 kHz (RTP_RATE_MP2T)
-                    _mdata[i].setInputTimeStamp(rtp_timestamp, RTP_RATE_MP2T, TimeSource::RTP);
+        // Wait for at least one datagram message.
+        if (!receiveDatagrams(_rbuf.data(), msg_count)) {
+            return 0;
+        }
+
+        // Process all received messages, in order. The TS packets are compacted at the beginning of the tsp buffer.
+        // As long as each datagram contains at most 7 TS packets, the compacted packets never overwrite the
+        // next datagrams. Otherwise, the next datagrams are first moved out of the tsp buffer.
+        bool moved = !direct;
+        for (size_t i = 0; i < msg_count; ++i) {
+            UDPSocket::ReceiveBuffer& rb(_rbuf[i]);
+            if (rb.ret_size == 0) {
+                continue; // ignored message
+            }
+
+            // Reassemble datagrams which are larger than 7 TS packets.
+            uint8_t* dgram = rb.data1;
+            if (rb.ret_size > rb.size1) {
+                dgram = _inbuf.data() + i * _slot_size;
+                ::memcpy(dgram, rb.data1, rb.size1);
+            }
+
+            // Look for TS packets in the datagram.
+            size_t start = 0;
+            size_t count = 0;
+            if (!TSPacket::Locate(dgram, rb.ret_size, start, count)) {
+                tsp->debug(u"no TS packet in message, %s bytes", {rb.ret_size});
+                continue;
+            }
+
+            // Move the next datagrams out of the tsp buffer if they may be overwritten.
+            if (!moved && pkt_cnt + count > 7 * (i + 1)) {
+                for (size_t j = i + 1; j < msg_count; ++j) {
+                    UDPSocket::ReceiveBuffer& next(_rbuf[j]);
+                    uint8_t* const slot = _inbuf.data() + j * _slot_size;
+                    ::memcpy(slot, next.data1, std::min(next.ret_size, next.size1));
+                    next.data1 = slot;
+                    next.size1 = _slot_size;
                 }
-                else if (use_kernel) {
-                    // IP time stamp unit is microseconds.
-                    _mdata[i].setInputTimeStamp(uint64_t(timestamp), MicroSecPerSec, TimeSource::KERNEL);
+                moved = true;
+            }
+
+            // Return as many packets as possible in the tsp buffer.
+            const uint8_t* const first = dgram + start;
+            const size_t out = std::min(count, max_packets - pkt_cnt);
+            if (first != buffer[pkt_cnt].b) {
+                ::memmove(buffer[pkt_cnt].b, first, out * PKT_SIZE);
+            }
+            for (size_t k = 0; k < out; ++k) {
+                pkt_data[pkt_cnt + k].reset();
+            }
+            setTimeStamps(dgram, start, rb.timestamp, pkt_data + pkt_cnt, out);
+            pkt_cnt += out;
+
+            // Queue remaining packets for the next invocation.
+            if (out < count) {
+                const size_t rest = count - out;
+                if (_queue.size() < _queue_count + rest) {
+                    _queue.resize(_queue_count + rest);
+                    _queue_mdata.resize(_queue_count + rest);
                 }
-                else {
-                    _mdata[i].clearInputTimeStamp();
+                TSPacket::Copy(&_queue[_queue_count], first + out * PKT_SIZE, rest);
+                for (size_t k = 0; k < rest; ++k) {
+                    _queue_mdata[_queue_count + k].reset();
                 }
+                setTimeStamps(dgram, start, rb.timestamp, &_queue_mdata[_queue_count], rest);
+                _queue_count += rest;
             }
-
-            break; // found packets.
         }
+    }
 
-        // No TS packet found in UDP message, wait for another one.
-        tsp->debug(u"no TS packet in message, %s bytes", {insize});
+    // We may need to re-evaluate the real-time input bitrate.
+    evaluateBitrate(pkt_cnt + _queue_count);
+    return pkt_cnt;
+}
+
+
+//----------------------------------------------------------------------------
+// Build input time stamps of the TS packets of a datagram.
+//----------------------------------------------------------------------------
+
+void ts::AbstractDatagramInputPlugin::setTimeStamps(const uint8_t* datagram, size_t header_size, MicroSecond timestamp, TSPacketMetadata* mdata, size_t count)
+{
+    // Look for an RTP header before the first packet. There is no clear proof of the presence of the RTP header.
+    // We check if the header size is large enough for an RTP header and if the "RTP payload type" is MPEG-2 TS.
+    const bool rtp = header_size >= RTP_HEADER_SIZE && (datagram[1] & 0x7F) == RTP_PT_MP2T;
+    const uint32_t rtp_timestamp = rtp ? GetUInt32(datagram + 4) : 0;
+
+    // Use RTP time stamp if there is one and RTP is the preferred choice.
+    bool use_rtp = false;
+    bool use_kernel = false;
+    switch (_time_priority) {
+        case RTP_SYSTEM_TSP:
+            use_rtp = rtp;
+            use_kernel = !rtp && timestamp >= 0;
+            break;
+        case SYSTEM_RTP_TSP:
+            use_kernel = timestamp >= 0;
+            use_rtp = !use_kernel && rtp;
+            break;
+        case RTP_TSP:
+            use_rtp = rtp;
+            use_kernel = false;
+            break;
+        case SYSTEM_TSP:
+            use_kernel = timestamp >= 0;
+            use_rtp = false;
+            break;
+        case TSP_ONLY:
+        default:
+            use_rtp = false;
+            use_kernel = false;
+            break;
     }
 
-    // If new packets were received, we may need to re-evaluate the real-time input bitrate.
-    if (new_packets && _real_time && _eval_time > 0) {
+    // Build time stamps in packet metadata.
+    for (size_t i = 0; i < count; ++i) {
+        if (use_rtp) {
+            // RTP time stamp unit is 90 kHz (RTP_RATE_MP2T)
+            mdata[i].setInputTimeStamp(rtp_timestamp, RTP_RATE_MP2T, TimeSource::RTP);
+        }
+        else if (use_kernel) {
+            // IP time stamp unit is microseconds.
+            mdata[i].setInputTimeStamp(uint64_t(timestamp), MicroSecPerSec, TimeSource::KERNEL);
+        }
+        else {
+            mdata[i].clearInputTimeStamp();
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Count newly received packets and re-evaluate the real-time input bitrate.
+//----------------------------------------------------------------------------
+
+void ts::AbstractDatagramInputPlugin::evaluateBitrate(size_t new_packets)
+{
+    if (_real_time && _eval_time > 0) {
 
         const Time now(Time::CurrentUTC());
 
@@ -262,9 +452,9 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
         }
 
         // Count packets
-        _packets += _inbuf_count;
-        _packets_0 += _inbuf_count;
-        _packets_1 += _inbuf_count;
+        _packets += new_packets;
+        _packets_0 += new_packets;
+        _packets_1 += new_packets;
 
         // Detect new evaluation period
         if (now >= _start_1 + _eval_time) {
@@ -287,14 +477,4 @@ size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetada
                 br_average == 0 ? u"undefined" : br_average.toString() + u" b/s"});
         }
     }
-
-    // Return packets from the input buffer
-    size_t pkt_cnt = std::min(_inbuf_count, max_packets);
-    TSPacket::Copy(buffer, _inbuf.data() + _inbuf_next, pkt_cnt);
-    TSPacketMetadata::Copy(pkt_data, &_mdata[_mdata_next], pkt_cnt);
-    _inbuf_count -= pkt_cnt;
-    _inbuf_next += pkt_cnt * PKT_SIZE;
-    _mdata_next += pkt_cnt;
-
-    return pkt_cnt;
 }
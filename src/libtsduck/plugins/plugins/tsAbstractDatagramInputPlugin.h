@@ -36,6 +36,7 @@
 #include "tsInputPlugin.h"
 #include "tsTSPacketMetadata.h"
 #include "tsByteBlock.h"
+#include "tsUDPSocket.h"
 #include "tsEnumeration.h"
 #include "tsTime.h"
 
@@ -91,6 +92,28 @@ namespace ts {
         //!
         virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp) = 0;
 
+        //!
+        //! Get the maximum number of datagrams to receive in one batch.
+        //! Subclasses which can receive several datagrams in one system call shall override this method.
+        //! In that case, receiveDatagrams() is used instead of receiveDatagram() and datagrams
+        //! containing exactly 7 TS packets are directly received into the tsp buffer.
+        //! Called once in start().
+        //! @return The maximum number of datagrams in one batch. The default implementation returns zero,
+        //! meaning that datagrams are received one by one using receiveDatagram().
+        //!
+        virtual size_t getDatagramBatchSize();
+
+        //!
+        //! Receive a batch of datagram messages.
+        //! Must be implemented by subclasses which return a non-zero value in getDatagramBatchSize().
+        //! @param [in,out] buffers Array of reception buffers. On output, the @a ret_size and @a timestamp
+        //! fields of the buffers are updated. Buffers with a zero @a ret_size shall be ignored.
+        //! @param [in,out] count On input, the number of buffers in @a buffers. On output, the number
+        //! of used buffers. Wait for at least one message, never wait for all messages.
+        //! @return True on success, false on error.
+        //!
+        virtual bool receiveDatagrams(UDPSocket::ReceiveBuffer* buffers, size_t& count);
+
     private:
         // Order of priority for input timestamps. SYSTEM means lower layer from subclass (UDP, SRT, etc).
         enum TimePriority {RTP_SYSTEM_TSP, SYSTEM_RTP_TSP, RTP_TSP, SYSTEM_TSP, TSP_ONLY};
@@ -102,6 +125,7 @@ namespace ts {
         Enumeration   _time_priority_enum;    // Enumeration values for _time_priority
         TimePriority  _time_priority;         // Priority of time stamps sources.
         TimePriority  _default_time_priority; // Priority of time stamps sources.
+        size_t        _buffer_size;           // Max datagram size.
 
         // Working data.
         Time          _next_display;          // Next bitrate display time
@@ -116,5 +140,23 @@ namespace ts {
         size_t        _mdata_next;            // Index in _mdata of next TS packet metadata to return
         ByteBlock     _inbuf;                 // Input buffer
         TSPacketMetadataVector _mdata;        // Metadata for packets in _inbuf
+
+        // Working data for batched reception.
+        size_t        _batch_size;            // Max number of datagrams per batch, zero when not supported.
+        size_t        _slot_size;             // Size of a datagram slot in _inbuf.
+        size_t        _queue_count;           // Number of remaining TS packets in _queue.
+        size_t        _queue_next;            // Index in _queue of next TS packet to return.
+        TSPacketVector _queue;                // Received packets which did not fit in the tsp buffer.
+        TSPacketMetadataVector _queue_mdata;  // Metadata for packets in _queue.
+        std::vector<UDPSocket::ReceiveBuffer> _rbuf; // Reception buffers descriptions.
+
+        // Batched version of receive().
+        size_t receiveBatch(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets);
+
+        // Build input time stamps of the TS packets of a datagram.
+        void setTimeStamps(const uint8_t* datagram, size_t header_size, MicroSecond timestamp, TSPacketMetadata* mdata, size_t count);
+
+        // Count newly received packets and re-evaluate the real-time input bitrate.
+        void evaluateBitrate(size_t new_packets);
     };
 }
@@ -63,7 +63,12 @@ ts::AbstractDatagramOutputPlugin::AbstractDatagramOutputPlugin(TSP* tsp_, const
     _rtp_pcr_offset(0),
     _pkt_count(0),
     _out_count(0),
-    _out_buffer()
+    _out_buffer(),
+    _dgram_max(1),
+    _dgram_count(0),
+    _dgram_address(),
+    _dgram_size(),
+    _dgram_buffer()
 {
     option(u"enforce-burst", 'e');
     help(u"enforce-burst",
@@ -105,6 +110,26 @@ ts::AbstractDatagramOutputPlugin::AbstractDatagramOutputPlugin(TSP* tsp_, const
 }
 
 
+//----------------------------------------------------------------------------
+// Default implementation of batched datagram transmission.
+//----------------------------------------------------------------------------
+
+size_t ts::AbstractDatagramOutputPlugin::getDatagramBatchSize()
+{
+    // No batched transmission by default.
+    return 1;
+}
+
+bool ts::AbstractDatagramOutputPlugin::sendDatagrams(const void* const address[], const size_t size[], size_t count)
+{
+    bool status = true;
+    for (size_t i = 0; status && i < count; ++i) {
+        status = sendDatagram(address[i], size[i]);
+    }
+    return status;
+}
+
+
 //----------------------------------------------------------------------------
 // Get command line options.
 //----------------------------------------------------------------------------
@@ -140,6 +165,13 @@ bool ts::AbstractDatagramOutputPlugin::start()
         _out_count = 0;
     }
 
+    // Datagrams are sent by batches. With RTP or RS204, each datagram is built in its own buffer.
+    _dgram_max = std::max<size_t>(1, getDatagramBatchSize());
+    _dgram_count = 0;
+    _dgram_address.resize(_dgram_max);
+    _dgram_size.resize(_dgram_max);
+    _dgram_buffer.resize(_use_rtp || _rs204_format ? _dgram_max : 0);
+
     // Initialize RTP parameters.
     if (_use_rtp) {
         // Use a system PRNG. This type of RNG does not need to be seeded.
@@ -181,7 +213,7 @@ bool ts::AbstractDatagramOutputPlugin::stop()
     // Flush incomplete datagram, if any.
     bool success = true;
     if (_out_count > 0) {
-        success = sendPackets(_out_buffer.data(), _out_count);
+        success = sendPackets(_out_buffer.data(), _out_count) && flushDatagrams();
         _out_count = 0;
     }
     return success;
@@ -230,6 +262,11 @@ bool ts::AbstractDatagramOutputPlugin::send(const TSPacket* pkt, const TSPacketM
         packet_count -= count;
     }
 
+    // Send all pending datagrams before reusing the output buffer.
+    if (!flushDatagrams()) {
+        return false;
+    }
+
     // If remaining packets are present, save them in output buffer.
     if (packet_count > 0) {
         assert(_enforce_burst);
@@ -243,12 +280,15 @@ bool ts::AbstractDatagramOutputPlugin::send(const TSPacket* pkt, const TSPacketM
 
 
 //----------------------------------------------------------------------------
-// Send contiguous packets in one single datagram.
+// Build one datagram with contiguous packets.
 //----------------------------------------------------------------------------
 
 bool ts::AbstractDatagramOutputPlugin::sendPackets(const TSPacket* pkt, size_t packet_count)
 {
-    bool status = true;
+    // Make room in the current batch.
+    if (_dgram_count >= _dgram_max && !flushDatagrams()) {
+        return false;
+    }
 
     if (_use_rtp) {
         // RTP datagram are relatively trivial to build, except the time stamp.
@@ -261,7 +301,8 @@ bool ts::AbstractDatagramOutputPlugin::sendPackets(const TSPacket* pkt, size_t p
         // But never jump back in RTP timestamps, only increase "more slowly" when adjusting.
 
         // Build an RTP datagram. Use a simple RTP header without options nor extensions.
-        ByteBlock buffer(RTP_HEADER_SIZE + packet_count * PKT_RS_SIZE);
+        ByteBlock& buffer(_dgram_buffer[_dgram_count]);
+        buffer.resize(RTP_HEADER_SIZE + packet_count * PKT_RS_SIZE);
 
         // Build the RTP header, except the timestamp.
         buffer[0] = 0x80;             // Version = 2, P = 0, X = 0, CC = 0
@@ -339,10 +380,11 @@ bool ts::AbstractDatagramOutputPlugin::sendPackets(const TSPacket* pkt, size_t p
         // Copy the TS packets after the RTP header and send the packets.
         uint8_t* buf = buffer.data() + RTP_HEADER_SIZE;
         if (_rs204_format) {
-            // Copy TS packets one by one with RS204 zero trailer. Since the default initial value
-            // of the buffer vector is zero, there is no need to explicitly set the trailers.
+            // Copy TS packets one by one with RS204 zero trailer.
+            // The buffer is reused, the trailers must be explicitly cleared.
             for (size_t i = 0; i < packet_count; ++i) {
                 ::memcpy(buf, pkt++, PKT_SIZE);
+                ::memset(buf + PKT_SIZE, 0, RS_SIZE);
                 buf += PKT_SIZE + RS_SIZE;
             }
         }
@@ -351,26 +393,46 @@ bool ts::AbstractDatagramOutputPlugin::sendPackets(const TSPacket* pkt, size_t p
             ::memcpy(buf, pkt, packet_count * PKT_SIZE);
             buffer.resize(RTP_HEADER_SIZE + packet_count * PKT_SIZE);
         }
-        status = sendDatagram(buffer.data(), buffer.size());
+        _dgram_address[_dgram_count] = buffer.data();
+        _dgram_size[_dgram_count] = buffer.size();
     }
     else if (_rs204_format) {
-        // No RTP header, add TS trailer after each packet. Since the default initial value
-        // of the buffer vector is zero, there is no need to explicitly set the trailers.
-        ByteBlock buffer(packet_count * PKT_RS_SIZE);
+        // No RTP header, add TS trailer after each packet.
+        // The buffer is reused, the trailers must be explicitly cleared.
+        ByteBlock& buffer(_dgram_buffer[_dgram_count]);
+        buffer.resize(packet_count * PKT_RS_SIZE);
         uint8_t* buf = buffer.data();
         for (size_t i = 0; i < packet_count; ++i) {
             ::memcpy(buf, pkt++, PKT_SIZE);
+            ::memset(buf + PKT_SIZE, 0, RS_SIZE);
             buf += PKT_SIZE + RS_SIZE;
         }
-        status = sendDatagram(buffer.data(), buffer.size());
+        _dgram_address[_dgram_count] = buffer.data();
+        _dgram_size[_dgram_count] = buffer.size();
     }
     else {
         // No RTP, send TS packets directly as datagram.
-        status = sendDatagram(pkt, packet_count * PKT_SIZE);
+        // The packets remain in the caller's buffer until the batch is flushed.
+        _dgram_address[_dgram_count] = pkt;
+        _dgram_size[_dgram_count] = packet_count * PKT_SIZE;
     }
+    _dgram_count++;
 
     // Count packets datagram per datagram.
     _pkt_count += packet_count;
 
-    return status;
+    // Without batched transmission, send the datagram immediately.
+    return _dgram_count < _dgram_max || flushDatagrams();
+}
+
+
+//----------------------------------------------------------------------------
+// Send all datagrams in the current batch.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDatagramOutputPlugin::flushDatagrams()
+{
+    const size_t count = _dgram_count;
+    _dgram_count = 0;
+    return count == 0 || sendDatagrams(_dgram_address.data(), _dgram_size.data(), count);
 }
@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tsOutputPlugin.h"
+#include "tsByteBlock.h"
 
 namespace ts {
     //!
@@ -98,6 +99,26 @@ namespace ts {
         //!
         virtual bool sendDatagram(const void* address, size_t size) = 0;
 
+        //!
+        //! Get the maximum number of datagrams to send in one batch.
+        //! Subclasses which can send several datagrams in one system call shall override this method.
+        //! In that case, all datagrams from one call to send() are passed to sendDatagrams(),
+        //! by batches of this size. Called once in start().
+        //! @return The maximum number of datagrams in one batch. The default implementation
+        //! returns 1, meaning that datagrams are sent one by one.
+        //!
+        virtual size_t getDatagramBatchSize();
+
+        //!
+        //! Send several datagram messages.
+        //! The default implementation calls sendDatagram() for each datagram.
+        //! @param [in] address Array of @a count addresses of datagrams.
+        //! @param [in] size Array of @a count sizes in bytes of datagrams.
+        //! @param [in] count Number of datagrams to send.
+        //! @return True on success, false on error.
+        //!
+        virtual bool sendDatagrams(const void* const address[], const size_t size[], size_t count);
+
     private:
         // Configuration and command line options.
         const Options  _flags;              // Configuration flags.
@@ -123,8 +144,16 @@ namespace ts {
         PacketCounter  _pkt_count;          // Total packet counter for output packets
         size_t         _out_count;          // Number of packets in _out_buffer
         TSPacketVector _out_buffer;         // Buffered packets for output with --enforce-burst
+        size_t         _dgram_max;          // Max number of datagrams in a batch
+        size_t         _dgram_count;        // Number of datagrams in the current batch
+        std::vector<const void*> _dgram_address; // Addresses of datagrams in the current batch
+        std::vector<size_t>      _dgram_size;    // Sizes of datagrams in the current batch
+        std::vector<ByteBlock>   _dgram_buffer;  // Datagram buffers (RTP and RS204 only)
 
-        // Send a buffer of TS packets.
+        // Build a datagram with a buffer of TS packets, send it or add it to the current batch.
         bool sendPackets(const TSPacket* packet, size_t count);
+
+        // Send all datagrams in the current batch.
+        bool flushDatagrams();
     };
 }
@@ -50,6 +50,10 @@ ts::AbstractDescrambler::AbstractDescrambler(TSP* tsp_, const UString& descripti
     _pids(),
     _service(duck, this),
     _stack_usage(stack_usage),
+    _packet_window(0),
+    _pending(),
+    _batch(),
+    _batch_index(),
     _demux(duck, nullptr, this),
     _ecm_streams(),
     _scrambled_streams(),
@@ -75,6 +79,14 @@ ts::AbstractDescrambler::AbstractDescrambler(TSP* tsp_, const UString& descripti
          u"If the argument is omitted, --pid options shall be specified to list explicit "
          u"PID's to descramble and fixed control words shall be specified as well.");
 
+    option(u"packet-window", 0, POSITIVE);
+    help(u"packet-window", u"count",
+         u"Descramble packets by groups of up to the specified number of packets. "
+         u"With DVB-CSA2, consecutive packets using the same control word are descrambled "
+         u"in parallel, which is much faster than descrambling packets one by one. "
+         u"The recommended value is a few times " + UString::Decimal(DVBCSA2::BatchSize()) + u" packets. "
+         u"By default, packets are descrambled one by one.");
+
     option(u"pid", 'p', PIDVAL, 0, UNLIMITED_COUNT);
     help(u"pid", u"pid1[-pid2]",
          u"Descramble packets with this PID value or range of PID values. "
@@ -105,6 +117,7 @@ bool ts::AbstractDescrambler::getOptions()
     _service.set(value(u""));
     _synchronous = present(u"synchronous") || !tsp->realtime();
     _swap_cw = present(u"swap-cw");
+    getIntValue(_packet_window, u"packet-window", 0);
     getIntValues(_pids, u"pid");
     if (!duck.loadArgs(*this) || !_scrambling.loadArgs(duck, *this)) {
         return false;
@@ -508,18 +521,19 @@ void ts::AbstractDescrambler::ECMThread::main()
 
 
 //----------------------------------------------------------------------------
-// Packet processing method
+// Get the descrambling context for a packet.
 //----------------------------------------------------------------------------
 
-ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
+ts::TSScrambling* ts::AbstractDescrambler::getScrambling(TSPacket& pkt, size_t pkt_index, size_t& error_index)
 {
     const PID pid = pkt.getPID();
+    error_index = NPOS;
 
     // Descramble packets from fixed PID's using fixed control words.
     // If there is a user-specified list of PID's, we don't manage a service
     // and there is nothing else to do.
     if (_pids.any()) {
-        return !_pids.test(pid) || _scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+        return _pids.test(pid) ? &_scrambling : nullptr;
     }
 
     // Filter sections to locate the service and grab ECM's.
@@ -528,7 +542,8 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
 
     // If the service is definitely unknown or a fatal error occured during table analysis, give up.
     if (_abort || _service.nonExistentService()) {
-        return TSP_END;
+        error_index = pkt_index;
+        return nullptr;
     }
 
     // Get scrambling_control_value in packet.
@@ -536,19 +551,19 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
 
     // If the packet has no payload or is clear, there is nothing to descramble.
     if (!pkt.hasPayload() || (scv != SC_EVEN_KEY && scv != SC_ODD_KEY)) {
-        return TSP_OK;
+        return nullptr;
     }
 
     // Without ECM's, we descramble using fixed control words.
     if (!_need_ecm) {
-        return _scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+        return &_scrambling;
     }
 
     // Get PID context. If the PID is not known as a scrambled PID,
     // with a corresponding ECM stream, we cannot descramble it.
     auto ssit = _scrambled_streams.find(pid);
     if (ssit == _scrambled_streams.end()) {
-        return TSP_OK;
+        return nullptr;
     }
     ScrambledStream& ss(ssit->second);
 
@@ -563,13 +578,18 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
     }
     if (pecm.isNull()) {
         // No ECM stream has valid Control Word now, cannot descramble
-        return TSP_OK;
+        return nullptr;
     }
 
     // We found a valid CW, check if new CW were deciphered and store them in the descrambler.
     // Flags new_cw_even/odd are "write-protected, read-volatile", no mutex needed.
     if ((scv == SC_EVEN_KEY && pecm->new_cw_even) || (scv == SC_ODD_KEY && pecm->new_cw_odd)) {
 
+        // Packets from the current window which use the previous CW must be descrambled first.
+        if (!flushPending(error_index)) {
+            return nullptr;
+        }
+
         // A new CW was deciphered.
         // In asynchronous mode, the CW are accessed under mutex protection.
         if (!_synchronous) {
@@ -593,6 +613,102 @@ ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt
         }
     }
 
-    // Descramble the packet payload.
-    return pecm->scrambling.decrypt(pkt) ? TSP_OK : TSP_END;
+    return &pecm->scrambling;
+}
+
+
+//----------------------------------------------------------------------------
+// Packet processing method
+//----------------------------------------------------------------------------
+
+ts::ProcessorPlugin::Status ts::AbstractDescrambler::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
+{
+    size_t error_index = NPOS;
+    TSScrambling* scrambling = getScrambling(pkt, 0, error_index);
+    return error_index == NPOS && (scrambling == nullptr || scrambling->decrypt(pkt)) ? TSP_OK : TSP_END;
+}
+
+
+//----------------------------------------------------------------------------
+// Packet window processing method, when --packet-window is specified.
+//----------------------------------------------------------------------------
+
+size_t ts::AbstractDescrambler::getPacketWindowSize()
+{
+    return _packet_window;
+}
+
+bool ts::AbstractDescrambler::usePacketWindowIndex() const
+{
+    return true;
+}
+
+size_t ts::AbstractDescrambler::processPacketWindow(TSPacketWindow& win)
+{
+    // Collect all packets to descramble, in order, with their descrambling context.
+    // Null and dropped packets are skipped using the PID index, when available, without accessing them.
+    _pending.clear();
+    const PID* const pids = win.pids();
+    for (size_t i = 0; i < win.size(); ++i) {
+        TSPacket* pkt = pids != nullptr && (pids[i] == PID_NULL || pids[i] == PID_MAX) ? nullptr : win.packet(i);
+        if (pkt != nullptr) {
+            // Pending packets may be descrambled here, on control word change.
+            size_t error_index = NPOS;
+            TSScrambling* scrambling = getScrambling(*pkt, i, error_index);
+            if (error_index != NPOS) {
+                // Descramble previous packets and terminate at the first failing one.
+                size_t index = error_index;
+                return flushPending(index) ? error_index : index;
+            }
+            if (scrambling != nullptr) {
+                _pending.push_back({scrambling, pkt, i});
+            }
+        }
+    }
+
+    // Descramble remaining packets.
+    size_t index = 0;
+    return flushPending(index) ? win.size() : index;
+}
+
+
+//----------------------------------------------------------------------------
+// Descramble all pending packets from the current packet window.
+//----------------------------------------------------------------------------
+
+bool ts::AbstractDescrambler::flushPending(size_t& index)
+{
+    // Packets are grouped by descrambling context, there are usually very few of them.
+    // Each group is descrambled as one batch and removed from the pending list.
+    // After an error, the packets after the failing one are no longer descrambled.
+    size_t failed = NPOS;
+    while (!_pending.empty()) {
+        TSScrambling* const scrambling = _pending.front().scrambling;
+        _batch.clear();
+        _batch_index.clear();
+        size_t remain = 0;
+        for (size_t i = 0; i < _pending.size(); ++i) {
+            if (_pending[i].index >= failed) {
+                // Drop packets after the failing one.
+            }
+            else if (_pending[i].scrambling == scrambling) {
+                _batch.push_back(_pending[i].packet);
+                _batch_index.push_back(_pending[i].index);
+            }
+            else {
+                _pending[remain++] = _pending[i];
+            }
+        }
+        _pending.resize(remain);
+        size_t done = 0;
+        if (!_batch.empty() && !scrambling->decrypt(_batch.data(), _batch.size(), &done)) {
+            // The failing packet is necessarily before the previous failing one, if any.
+            failed = _batch_index[done];
+        }
+    }
+    if (failed != NPOS) {
+        index = failed;
+        return false;
+    }
+    return true;
 }
@@ -62,6 +62,9 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual size_t getPacketWindowSize() override;
+        virtual bool usePacketWindowIndex() const override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
 
     protected:
         //!
@@ -259,6 +262,30 @@ namespace ts {
         // Analyze a list of descriptors from the PMT, looking for ECM PID's
         void analyzeDescriptors(const DescriptorList& dlist, std::set<PID>& ecm_pids, uint8_t& scrambling);
 
+        // A scrambled packet in a packet window, waiting to be descrambled.
+        class PendingPacket
+        {
+        public:
+            TSScrambling* scrambling;  // Descrambling context to use.
+            TSPacket*     packet;      // Packet to descramble.
+            size_t        index;       // Index of packet in window.
+        };
+        typedef std::vector<PendingPacket> PendingVector;
+        typedef std::vector<TSPacket*> PacketPtrVector;
+        typedef std::vector<size_t> IndexVector;
+
+        // Get the descrambling context for a packet, after processing its signalization and ECM.
+        // Return zero if the packet shall not be descrambled. On fatal error, set error_index
+        // to the index of the first packet which cannot be processed: either the current one
+        // (at pkt_index in the packet window) or a previous pending one. Otherwise, set NPOS.
+        // Pending packets are descrambled before storing a new control word.
+        TSScrambling* getScrambling(TSPacket& pkt, size_t pkt_index, size_t& error_index);
+
+        // Descramble all pending packets, grouped by descrambling context.
+        // On error, return false and set index to the index of the first failing packet.
+        // All pending packets before the failing one are descrambled.
+        bool flushPending(size_t& index);
+
         // Abstract descrambler private data.
         bool               _use_service;       // Descramble a service (ie. not a specific list of PID's).
         bool               _need_ecm;          // We need to get control words from ECM's.
@@ -269,6 +296,10 @@ namespace ts {
         PIDSet             _pids;              // Explicit PID's to descramble.
         ServiceDiscovery   _service;           // Service to descramble (by name, id or none).
         size_t             _stack_usage;       // Stack usage for ECM deciphering.
+        size_t             _packet_window;     // Number of packets to descramble at once, zero means one by one.
+        PendingVector      _pending;           // Scrambled packets in current packet window.
+        PacketPtrVector    _batch;             // Pending packets to descramble with the same context.
+        IndexVector        _batch_index;       // Index in packet window of each packet in _batch.
         SectionDemux       _demux;             // Section demux to extract ECM's.
         ECMStreamMap       _ecm_streams;       // ECM streams, indexed by PID.
         ScrambledStreamMap _scrambled_streams; // Scrambled streams, indexed by PID.
@@ -51,11 +51,13 @@ ts::FileInputPlugin::FileInputPlugin(TSP* tsp_) :
     _start_offset(0),
     _base_label(0),
     _file_format(TSPacketFormat::AUTODETECT),
+    _io_flags(TSFile::NONE),
     _filenames(),
     _start_stuffing(),
     _stop_stuffing(),
     _eof(),
-    _files()
+    _files(),
+    _mapped()
 {
     DefineTSPacketFormatInputOption(*this);
 
@@ -103,6 +105,14 @@ ts::FileInputPlugin::FileInputPlugin(TSP* tsp_) :
          u"N packets are read from the first file, then N from the second file, etc. "
          u"and then loop back to N packets again from the first file, etc.");
 
+    option(u"io-uring");
+    help(u"io-uring",
+         u"Read regular input files using asynchronous I/O with io_uring. "
+         u"Several read operations are kept in progress on each file, in advance, "
+         u"so that a slow disk does not stall the processing chain. "
+         u"This option is ignored on systems other than Linux, on non-regular files such as pipes "
+         u"and when io_uring is not available (old kernel, restricted container).");
+
     option(u"label-base", 'l', INTEGER, 0, 1, 0, TSPacketMetadata::LABEL_MAX);
     help(u"label-base",
          u"Set a label on each input packet. "
@@ -111,6 +121,13 @@ ts::FileInputPlugin::FileInputPlugin(TSP* tsp_) :
          u"For a given file, if the computed label is above the maximum (" +
          UString::Decimal(TSPacketMetadata::LABEL_MAX) + u"), its packets are not labelled.");
 
+    option(u"mmap");
+    help(u"mmap",
+         u"Map regular input files in memory instead of reading them. "
+         u"This reduces the number of system calls and data copies with very large files. "
+         u"The already read parts of the files are released from the system cache. "
+         u"This option is ignored on Windows and on non-regular files such as pipes.");
+
     option(u"packet-offset", 'p', UNSIGNED);
     help(u"packet-offset",
          u"Start reading each file at the specified TS packet (default: 0). "
@@ -135,6 +152,13 @@ bool ts::FileInputPlugin::getOptions()
     _start_offset = intValue<uint64_t>(u"byte-offset", intValue<uint64_t>(u"packet-offset", 0) * PKT_SIZE);
     _interleave = present(u"interleave");
     _first_terminate = present(u"first-terminate");
+    _io_flags = TSFile::NONE;
+    if (present(u"mmap")) {
+        _io_flags |= TSFile::MMAP;
+    }
+    if (present(u"io-uring")) {
+        _io_flags |= TSFile::ASYNC;
+    }
     getIntValue(_interleave_chunk, u"interleave", 1);
     getIntValue(_base_label, u"label-base", TSPacketMetadata::LABEL_MAX + 1);
     getIntValues(_start_stuffing, u"add-start-stuffing");
@@ -184,11 +208,39 @@ bool ts::FileInputPlugin::openFile(size_t name_index, size_t file_index)
         tsp->verbose(u"reading file %s", {name.empty() ? u"'stdin'" : name});
     }
 
-    // Preset artificial stuffing.
+    // Preset artificial stuffing and I/O mode.
     _files[file_index].setStuffing(_start_stuffing[name_index], _stop_stuffing[name_index]);
+    _files[file_index].setIOFlags(_io_flags);
 
     // Actually open the file.
-    return _files[file_index].openRead(name, _repeat_count, _start_offset, *tsp, _file_format);
+    const bool ok = _files[file_index].openRead(name, _repeat_count, _start_offset, *tsp, _file_format);
+    _mapped[file_index] = ok && _files[file_index].isMemoryMapped();
+    return ok;
+}
+
+
+//----------------------------------------------------------------------------
+// Read packets from one input file.
+//----------------------------------------------------------------------------
+
+size_t ts::FileInputPlugin::readFile(size_t file_index, TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+{
+    TSFile& file(_files[file_index]);
+
+    // With memory-mapped files containing plain TS packets, the packets are copied only once,
+    // from the mapped area into the tsp buffer. Otherwise, use the standard read method.
+    if (_mapped[file_index]) {
+        const TSPacket* packets = nullptr;
+        size_t count = max_packets;
+        if (file.mapPackets(packets, count, *tsp)) {
+            TSPacket::Copy(buffer, packets, count);
+            TSPacketMetadata::Reset(pkt_data, count);
+            return count;
+        }
+        // Direct access is not possible on this file, do not try again.
+        _mapped[file_index] = false;
+    }
+    return file.readPackets(buffer, pkt_data, max_packets, *tsp);
 }
 
 
@@ -222,6 +274,7 @@ bool ts::FileInputPlugin::start()
     // With --interleave, all files are simultaneously open.
     // Without it, only one file is open at a time.
     _files.resize(_interleave ? _filenames.size() : 1);
+    _mapped.assign(_files.size(), false);
 
     // Open files.
     bool ok = true;
@@ -304,7 +357,7 @@ size_t ts::FileInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data
         }
         else {
             // Read packets from the file.
-            count = _files[_current_file].readPackets(buffer + read_count, pkt_data + read_count, count, *tsp);
+            count = readFile(_current_file, buffer + read_count, pkt_data + read_count, count);
         }
 
         // Mark all read packets with a label.
@@ -70,15 +70,20 @@ namespace ts {
         uint64_t       _start_offset;
         size_t         _base_label;
         TSPacketFormat _file_format;
+        TSFile::OpenFlags _io_flags;        // I/O acceleration flags for input files.
         UStringVector  _filenames;
         std::vector<size_t>  _start_stuffing;
         std::vector<size_t>  _stop_stuffing;
         std::set<size_t>     _eof;          // Set of file indexes having reached end of file.
         std::vector<TSFile>  _files;        // Array of open files, only one without interleave.
+        std::vector<bool>    _mapped;       // Files in _files which are directly accessed using mapPackets().
 
         // Open one input file.
         bool openFile(size_t name_index, size_t file_index);
 
+        // Read packets from one input file.
+        size_t readFile(size_t file_index, TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets);
+
         // Close all files which are currently open.
         bool closeAllFiles();
     };
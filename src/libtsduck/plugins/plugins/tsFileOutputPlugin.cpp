@@ -77,6 +77,20 @@ ts::FileOutputPlugin::FileOutputPlugin(TSP* tsp_) :
     option(u"append", 'a');
     help(u"append", u"If the file already exists, append to the end of the file. By default, existing files are overwritten.");
 
+    option(u"direct-io");
+    help(u"direct-io",
+         u"Write the output file using direct I/O, bypassing the system cache. "
+         u"This avoids filling the system cache when recording very large files at high bitrates. "
+         u"This option is ignored with --append, on non-regular files such as pipes, on file systems which do not support "
+         u"direct I/O and on operating systems which do not provide direct I/O on files (macOS, Windows).");
+
+    option(u"io-uring");
+    help(u"io-uring",
+         u"Write the output file using asynchronous I/O with io_uring. "
+         u"Several write operations are kept in progress so that a slow disk does not stall the processing chain. "
+         u"This option is ignored with --direct-io or --append, on non-regular files such as pipes, on systems other than Linux "
+         u"and when io_uring is not available (old kernel, restricted container).");
+
     option(u"keep", 'k');
     help(u"keep", u"Keep existing file (abort if the specified file already exists). By default, existing files are overwritten.");
 
@@ -143,6 +157,12 @@ bool ts::FileOutputPlugin::getOptions()
     if (present(u"keep")) {
         _flags |= TSFile::KEEP;
     }
+    if (present(u"direct-io")) {
+        _flags |= TSFile::DIRECT;
+    }
+    if (present(u"io-uring")) {
+        _flags |= TSFile::ASYNC;
+    }
 
     if (_max_size > 0 && _max_duration > 0) {
         tsp->error(u"--max-duration and --max-size are mutually exclusive");
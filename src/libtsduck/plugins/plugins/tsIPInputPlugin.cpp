@@ -118,3 +118,20 @@ bool ts::IPInputPlugin::receiveDatagram(uint8_t* buffer, size_t buffer_size, siz
     IPv4SocketAddress destination;
     return _sock.receive(buffer, buffer_size, ret_size, sender, destination, tsp, *tsp, &timestamp);
 }
+
+
+//----------------------------------------------------------------------------
+// Batched datagram reception methods.
+//----------------------------------------------------------------------------
+
+size_t ts::IPInputPlugin::getDatagramBatchSize()
+{
+    // Receive up to 32 datagrams per system call.
+    return std::min<size_t>(32, UDPSocket::MAX_RECEIVE_MULTIPLE);
+}
+
+bool ts::IPInputPlugin::receiveDatagrams(UDPSocket::ReceiveBuffer* buffers, size_t& count)
+{
+    count = _sock.receiveMultiple(buffers, count, tsp, *tsp);
+    return count > 0;
+}
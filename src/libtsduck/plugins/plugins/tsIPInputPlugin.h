@@ -61,6 +61,8 @@ namespace ts {
     protected:
         // Implementation of AbstractDatagramInputPlugin.
         virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, MicroSecond& timestamp) override;
+        virtual size_t getDatagramBatchSize() override;
+        virtual bool receiveDatagrams(UDPSocket::ReceiveBuffer* buffers, size_t& count) override;
 
     private:
         UDPReceiver _sock; // Incoming socket with associated command line options.
@@ -169,10 +169,20 @@ bool ts::IPOutputPlugin::stop()
 
 
 //----------------------------------------------------------------------------
-// Implementation of AbstractDatagramOutputPlugin: send one datagram.
+// Implementation of AbstractDatagramOutputPlugin: send datagrams.
 //----------------------------------------------------------------------------
 
 bool ts::IPOutputPlugin::sendDatagram(const void* address, size_t size)
 {
     return _sock.send(address, size, *tsp);
 }
+
+size_t ts::IPOutputPlugin::getDatagramBatchSize()
+{
+    return UDPSocket::MAX_SEND_MULTIPLE;
+}
+
+bool ts::IPOutputPlugin::sendDatagrams(const void* const address[], const size_t size[], size_t count)
+{
+    return _sock.sendMultiple(address, size, count, *tsp);
+}
@@ -60,6 +60,8 @@ namespace ts {
     protected:
         // Implementation of AbstractDatagramOutputPlugin
         virtual bool sendDatagram(const void* address, size_t size) override;
+        virtual size_t getDatagramBatchSize() override;
+        virtual bool sendDatagrams(const void* const address[], const size_t size[], size_t count) override;
 
     private:
         IPv4SocketAddress _destination;     // Destination address/port.
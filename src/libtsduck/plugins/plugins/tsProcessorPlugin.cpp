@@ -73,6 +73,20 @@ size_t ts::ProcessorPlugin::getPacketWindowSize()
     return 0;
 }
 
+bool ts::ProcessorPlugin::usePacketWindowIndex() const
+{
+    return false;
+}
+
+bool ts::ProcessorPlugin::isStateless() const
+{
+    return false;
+}
+
+void ts::ProcessorPlugin::mergeStatistics(const ProcessorPlugin& clone)
+{
+}
+
 ts::ProcessorPlugin::Status ts::ProcessorPlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
 {
     return TSP_OK;
@@ -93,6 +93,13 @@ namespace ts {
     //! sizes is larger than the size of the global buffer, the stream processing can enter a deadlock and
     //! stops. The global @c tsp command shall be carefully tuned to avoid that.
     //!
+    //! Some plugins are pure packet transformations: the processing of a packet does not depend on
+    //! previous packets and does not modify any state in the plugin object. Such plugins may declare
+    //! themselves as @e stateless by overriding ProcessorPlugin::isStateless(). In that case, when
+    //! requested by the user, the application may create several clones of the plugin, with the same
+    //! command line options, and call ProcessorPlugin::processPacket() on distinct clones in parallel,
+    //! on distinct consecutive slices of the stream. The order of packets is preserved.
+    //!
     class TSDUCKDLL ProcessorPlugin : public Plugin
     {
         TS_NOBUILD_NOCOPY(ProcessorPlugin);
@@ -115,10 +122,22 @@ namespace ts {
         //!
         //! @return The preferred number of TS packets to be processed at once in processPacketWindow().
         //! If the returned value is zero, then TS packets are processed one by one using processPacket().
-        //! If this method is not overriden, the default implementation returns zero.
+        //! If this method is not overridden, the default implementation returns zero.
         //!
         virtual size_t getPacketWindowSize();
 
+        //!
+        //! Check if the plugin uses the PID and label index of the packet windows.
+        //!
+        //! This method is called by the application in packet window mode only. Building the PID
+        //! and label index of the packet windows has a cost and is performed only for the plugins
+        //! which request it. See TSPacketWindow::pids() and TSPacketWindow::labels().
+        //!
+        //! @return True if processPacketWindow() uses the PID and label index. If this method is
+        //! not overridden, the default implementation returns false.
+        //!
+        virtual bool usePacketWindowIndex() const;
+
         //!
         //! Simple packet processing interface.
         //!
@@ -153,6 +172,33 @@ namespace ts {
         //!
         virtual size_t processPacketWindow(TSPacketWindow& win);
 
+        //!
+        //! Check if the plugin is stateless, with the current options.
+        //!
+        //! This method is called by the application after start(). A stateless plugin processes each packet
+        //! independently, without any dependency on previous packets. Several clones of the plugin can then
+        //! process distinct packets in parallel. A stateless plugin shall use the "packet method" only.
+        //! It shall not rely on packet counters from the TSP object and shall not change the bitrate.
+        //! Most plugins can be stateless or not, depending on their options.
+        //!
+        //! @return True if the plugin is stateless. If this method is not overridden, the default
+        //! implementation returns false.
+        //!
+        virtual bool isStateless() const;
+
+        //!
+        //! Merge the statistics of a clone of this plugin.
+        //!
+        //! When a stateless plugin is executed by parallel clones, each clone counts only the packets
+        //! it has processed. Before stopping this plugin, the application calls this method once for
+        //! each clone, after stopping the clone, so that stop() can report the statistics of the complete
+        //! stream. The clones do not report anything in their own stop().
+        //!
+        //! @param [in] clone A stopped clone of this plugin, an instance of the same class with the same options.
+        //! If this method is not overridden, the default implementation does nothing.
+        //!
+        virtual void mergeStatistics(const ProcessorPlugin& clone);
+
         //!
         //! Get the content of the --only-label options.
         //! The value of the option is fetched each time this method is called.
@@ -35,6 +35,8 @@
 #include "tsTelnetConnection.h"
 #include "tsGuardMutex.h"
 #include "tsSysUtils.h"
+#include "tsjsonArray.h"
+#include "tsTextFormatter.h"
 
 
 //----------------------------------------------------------------------------
@@ -75,6 +77,7 @@ ts::tsp::ControlServer::ControlServer(TSProcessorArgs& options, Report& log, Mut
     _reference.setCommandLineHandler(this, &ControlServer::executeExit, u"exit");
     _reference.setCommandLineHandler(this, &ControlServer::executeSetLog, u"set-log");
     _reference.setCommandLineHandler(this, &ControlServer::executeList, u"list");
+    _reference.setCommandLineHandler(this, &ControlServer::executeStats, u"stats");
     _reference.setCommandLineHandler(this, &ControlServer::executeSuspend, u"suspend");
     _reference.setCommandLineHandler(this, &ControlServer::executeResume, u"resume");
     _reference.setCommandLineHandler(this, &ControlServer::executeRestart, u"restart");
@@ -269,6 +272,46 @@ void ts::tsp::ControlServer::listOnePlugin(size_t index, UChar type, PluginExecu
 }
 
 
+//----------------------------------------------------------------------------
+// Stats command.
+//----------------------------------------------------------------------------
+
+ts::CommandStatus ts::tsp::ControlServer::executeStats(const UString& command, Args& args)
+{
+    // Build a JSON array of plugin statistics.
+    json::Array root;
+    const bool all = !args.present(u"");
+    const size_t index = args.intValue<size_t>(u"");
+    if (all || index == 0) {
+        root.set(_input->getStatisticsJSON());
+    }
+    for (size_t i = 0; i < _plugins.size(); ++i) {
+        if (all || index == i + 1) {
+            root.set(_plugins[i]->getStatisticsJSON());
+        }
+    }
+    if (all || index == _plugins.size() + 1) {
+        root.set(_output->getStatisticsJSON());
+    }
+    if (root.size() == 0) {
+        args.error(u"invalid plugin index %d, specify 0 to %d", {index, _plugins.size() + 1});
+        return CommandStatus::ERROR;
+    }
+
+    // Format the JSON text.
+    TextFormatter text(args);
+    text.setString();
+    if (args.present(u"json-line")) {
+        text.setEndOfLineMode(TextFormatter::EndOfLineMode::SPACING);
+    }
+    root.print(text);
+    UString str;
+    text.getString(str);
+    args.info(str);
+    return CommandStatus::SUCCESS;
+}
+
+
 //----------------------------------------------------------------------------
 // Suspend/resume commands.
 //----------------------------------------------------------------------------
@@ -260,7 +260,9 @@ size_t ts::tsp::InputExecutor::receiveAndValidate(size_t index, size_t max_packe
     if (_use_watchdog) {
         _watchdog.restart();
     }
+    const Monotonic receive_start(true);
     size_t count = _input->receive(pkt, data, max_packets);
+    addProcessTime(receive_start);
     _plugin_completed = _plugin_completed || count == 0;
     if (_use_watchdog) {
         _watchdog.suspend();
@@ -275,34 +277,34 @@ size_t ts::tsp::InputExecutor::receiveAndValidate(size_t index, size_t max_packe
         }
     }
 
-    // Validate sync byte (0x47) at beginning of each packet
-    for (size_t n = 0; n < count; ++n) {
-        if (pkt[n].hasValidSync()) {
-            // Count good packets from plugin
-            addPluginPackets(1);
+    // Validate sync byte (0x47) at beginning of each packet, all packets at once.
+    const size_t valid = TSPacket::FindInvalidSync(pkt, count);
 
-            // Include packet in bitrate analysis.
-            _pcr_analyzer.feedPacket(pkt[n]);
-            _dts_analyzer.feedPacket(pkt[n]);
-        }
-        else {
-            // Report error
-            error(u"synchronization lost after %'d packets, got 0x%X instead of 0x%X", {pluginPackets(), pkt[n].b[0], SYNC_BYTE});
-            // In debug mode, partial dump of input
-            // (one packet before lost of sync and 3 packets starting at lost of sync).
-            if (maxSeverity() >= 1) {
-                if (n > 0) {
-                    debug(u"content of packet before loss of synchronization:\n%s",
-                          {UString::Dump(pkt[n-1].b, PKT_SIZE, UString::HEXA | UString::OFFSET | UString::ASCII | UString::BPL, 4, 16)});
-                }
-                const size_t dump_count = std::min<size_t>(3, count - n);
-                debug(u"data at loss of synchronization:\n%s",
-                      {UString::Dump(pkt[n].b, dump_count * PKT_SIZE, UString::HEXA | UString::OFFSET | UString::ASCII | UString::BPL, 4, 16)});
+    // Count good packets from plugin and include them in bitrate analysis.
+    addPluginPackets(valid);
+    for (size_t n = 0; n < valid; ++n) {
+        _pcr_analyzer.feedPacket(pkt[n]);
+        _dts_analyzer.feedPacket(pkt[n]);
+    }
+
+    if (valid < count) {
+        const size_t n = valid;
+        // Report error
+        error(u"synchronization lost after %'d packets, got 0x%X instead of 0x%X", {pluginPackets(), pkt[n].b[0], SYNC_BYTE});
+        // In debug mode, partial dump of input
+        // (one packet before lost of sync and 3 packets starting at lost of sync).
+        if (maxSeverity() >= 1) {
+            if (n > 0) {
+                debug(u"content of packet before loss of synchronization:\n%s",
+                      {UString::Dump(pkt[n-1].b, PKT_SIZE, UString::HEXA | UString::OFFSET | UString::ASCII | UString::BPL, 4, 16)});
             }
-            // Ignore subsequent packets
-            count = n;
-            _in_sync_lost = true;
+            const size_t dump_count = std::min<size_t>(3, count - n);
+            debug(u"data at loss of synchronization:\n%s",
+                  {UString::Dump(pkt[n].b, dump_count * PKT_SIZE, UString::HEXA | UString::OFFSET | UString::ASCII | UString::BPL, 4, 16)});
         }
+        // Ignore subsequent packets
+        count = n;
+        _in_sync_lost = true;
     }
 
     return count;
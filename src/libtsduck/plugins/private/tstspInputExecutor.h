@@ -86,6 +86,13 @@ namespace ts {
             //!
             bool initAllBuffers(PacketBuffer* buffer, PacketMetadataBuffer* metadata);
 
+            //!
+            //! Get the start time of the input executor.
+            //! This is the origin of the input time stamps which are generated by tsp.
+            //! @return A constant reference to the start time in a monotonic clock.
+            //!
+            const Monotonic& startTime() const { return _start_time; }
+
             // Overridden methods.
             virtual void setAbort() override;
             virtual size_t pluginIndex() const override;
@@ -28,6 +28,7 @@
 //----------------------------------------------------------------------------
 
 #include "tstspOutputExecutor.h"
+#include "tstspInputExecutor.h"
 
 
 //----------------------------------------------------------------------------
@@ -75,6 +76,9 @@ void ts::tsp::OutputExecutor::main()
 {
     debug(u"output thread started");
 
+    // Origin of the input time stamps, for latency statistics.
+    const Monotonic& input_start(ringNext<InputExecutor>()->startTime());
+
     PacketCounter output_packets = 0;
     bool aborted = false;
     bool restarted = false;
@@ -147,15 +151,21 @@ void ts::tsp::OutputExecutor::main()
                     // Don't output packet when the plugin is suspended.
                     addNonPluginPackets(out_subcnt);
                 }
-                else if (_output->send(pkt, data, out_subcnt)) {
-                    // Packet successfully sent.
-                    addPluginPackets(out_subcnt);
-                    output_packets += out_subcnt;
-                }
                 else {
-                    // Send error.
-                    aborted = true;
-                    break;
+                    const Monotonic send_start(true);
+                    const bool sent = _output->send(pkt, data, out_subcnt);
+                    addProcessTime(send_start);
+                    if (sent) {
+                        // Packet successfully sent.
+                        addPluginPackets(out_subcnt);
+                        addLatency(data, out_subcnt, input_start);
+                        output_packets += out_subcnt;
+                    }
+                    else {
+                        // Send error.
+                        aborted = true;
+                        break;
+                    }
                 }
                 pkt += out_subcnt;
                 data += out_subcnt;
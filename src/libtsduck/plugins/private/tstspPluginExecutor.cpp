@@ -31,6 +31,30 @@
 #include "tsPluginRepository.h"
 #include "tsGuardCondition.h"
 #include "tsGuardMutex.h"
+#include "tsjsonObject.h"
+
+// Adaptive spinning in lock-free handoff mode (number of polling iterations before parking).
+namespace {
+    constexpr size_t MIN_SPIN_LIMIT  =   16;
+    constexpr size_t MAX_SPIN_LIMIT  = 4096;
+    constexpr size_t INIT_SPIN_LIMIT =  256;
+}
+
+// Update a statistics counter. There is only one writer thread, the plugin one.
+namespace {
+    template <typename INT>
+    inline void StatAdd(std::atomic<INT>& counter, INT value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+    template <typename INT>
+    inline void StatMax(std::atomic<INT>& counter, INT value)
+    {
+        if (value > counter.load(std::memory_order_relaxed)) {
+            counter.store(value, std::memory_order_relaxed);
+        }
+    }
+}
 
 
 //----------------------------------------------------------------------------
@@ -57,8 +81,21 @@ ts::tsp::PluginExecutor::PluginExecutor(const TSProcessorArgs& options,
     _input_end(false),
     _bitrate(0),
     _br_confidence(BitRateConfidence::LOW),
+    _br_lock(false),
+    _park_mutex(),
+    _parked(false),
+    _spin_limit(INIT_SPIN_LIMIT),
     _restart(false),
-    _restart_data()
+    _restart_data(),
+    _stat_start(),
+    _stat_plugin_packets(0),
+    _stat_total_packets(0),
+    _stat_process_time(0),
+    _stat_wait_time(0),
+    _stat_max_buffered(0),
+    _stat_latency_count(0),
+    _stat_latency_total(0),
+    _stat_latency_max(0)
 {
     // Preset common default options.
     if (plugin() != nullptr) {
@@ -102,7 +139,7 @@ void ts::tsp::PluginExecutor::setAbort()
 {
     GuardMutex lock(_global_mutex);
     _tsp_aborting = true;
-    ringPrevious<PluginExecutor>()->_to_do.signal();
+    ringPrevious<PluginExecutor>()->wakeUp();
 }
 
 
@@ -135,13 +172,59 @@ void ts::tsp::PluginExecutor::initBuffer(PacketBuffer*         buffer,
     _buffer = buffer;
     _metadata = metadata;
     _pkt_first = pkt_first;
-    _pkt_cnt = pkt_cnt;
-    _input_end = input_end;
+    _pkt_cnt.store(pkt_cnt);
+    _input_end.store(input_end);
     _tsp_aborting = aborted;
     _bitrate = bitrate;
     _br_confidence = br_confidence;
     _tsp_bitrate = bitrate;
     _tsp_bitrate_confidence = br_confidence;
+    _stat_start.getSystemTime();
+}
+
+
+//----------------------------------------------------------------------------
+// Access the input bitrate, as propagated by the previous processor.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::getInputBitrate(BitRate& bitrate, BitRateConfidence& br_confidence)
+{
+    while (_br_lock.exchange(true, std::memory_order_acquire)) {
+    }
+    bitrate = _bitrate;
+    br_confidence = _br_confidence;
+    _br_lock.store(false, std::memory_order_release);
+}
+
+void ts::tsp::PluginExecutor::setInputBitrate(const BitRate& bitrate, BitRateConfidence br_confidence)
+{
+    while (_br_lock.exchange(true, std::memory_order_acquire)) {
+    }
+    _bitrate = bitrate;
+    _br_confidence = br_confidence;
+    _br_lock.store(false, std::memory_order_release);
+}
+
+
+//----------------------------------------------------------------------------
+// Wake up the thread of this processor.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::wakeUp()
+{
+    if (!_options.lockfree_handoff) {
+        // The caller holds the global mutex.
+        _to_do.signal();
+    }
+    else {
+        // The waiting thread sets _parked, then checks the packet area. We update the packet area,
+        // then check _parked. The full fences guarantee that at least one side sees the other.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_parked.load()) {
+            GuardMutex lock(_park_mutex);
+            _to_do.signal();
+        }
+    }
 }
 
 
@@ -155,6 +238,14 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
 
     log(10, u"passPackets(count = %'d, bitrate = %'d, input_end = %s, aborted = %s)", {count, bitrate, input_end, aborted});
 
+    // Update execution statistics. The packets have been counted by the caller.
+    _stat_plugin_packets.store(pluginPackets(), std::memory_order_relaxed);
+    _stat_total_packets.store(totalPacketsInThread(), std::memory_order_relaxed);
+
+    if (_options.lockfree_handoff) {
+        return passPacketsLockFree(count, bitrate, br_confidence, input_end, aborted);
+    }
+
     // We access data under the protection of the global mutex.
     GuardMutex lock(_global_mutex);
 
@@ -167,13 +258,12 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
     next->_pkt_cnt += count;
 
     // Propagate bitrate and end of input flag to next processor.
-    next->_bitrate = bitrate;
-    next->_br_confidence = br_confidence;
+    next->setInputBitrate(bitrate, br_confidence);
     next->_input_end = next->_input_end || input_end;
 
     // Wake the next processor when there is some new input data or end of input.
     if (count > 0 || input_end) {
-        next->_to_do.signal();
+        next->wakeUp();
     }
 
     // Force to abort our processor when the next one is aborting. Already done in waitWork() but force immediately.
@@ -185,7 +275,7 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
     // Wake the previous processor when we abort (propagate abort conditions backward).
     if (aborted) {
         _tsp_aborting = true; // volatile bool in TSP superclass
-        ringPrevious<PluginExecutor>()->_to_do.signal();
+        ringPrevious<PluginExecutor>()->wakeUp();
     }
 
     // Return false when the current processor shall stop.
@@ -193,6 +283,52 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
 }
 
 
+//----------------------------------------------------------------------------
+// Signal that packets have been processed, lock-free handoff mode.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::PluginExecutor::passPacketsLockFree(size_t count, const BitRate& bitrate, BitRateConfidence br_confidence, bool input_end, bool aborted)
+{
+    // Remove the first 'count' packets from our slice. Only this thread modifies _pkt_first.
+    _pkt_first = (_pkt_first + count) % _buffer->count();
+    _pkt_cnt.fetch_sub(count, std::memory_order_acq_rel);
+
+    // Publish the bitrate first, then the packets, then the end of input.
+    // The next processor reads them in reverse order (see waitWork).
+    PluginExecutor* next = ringNext<PluginExecutor>();
+    next->setInputBitrate(bitrate, br_confidence);
+    next->_pkt_cnt.fetch_add(count, std::memory_order_release);
+    if (input_end) {
+        next->_input_end.store(true, std::memory_order_release);
+    }
+
+    // Wake the next processor when there is some new input data or end of input.
+    if (count > 0 || input_end) {
+        next->wakeUp();
+    }
+
+    // Same abort propagation as with the global mutex.
+    if (plugin()->type() != PluginType::OUTPUT) {
+        aborted = aborted || next->_tsp_aborting;
+    }
+    if (aborted) {
+        _tsp_aborting = true;
+        ringPrevious<PluginExecutor>()->wakeUp();
+    }
+    return !input_end && !aborted;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if there is something to do, without the global mutex.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::PluginExecutor::hasWork(size_t min_pkt_cnt, const PluginExecutor* next) const
+{
+    return _pkt_cnt.load(std::memory_order_acquire) >= min_pkt_cnt || _input_end.load(std::memory_order_acquire) || next->_tsp_aborting;
+}
+
+
 //----------------------------------------------------------------------------
 // Wait for packets to process or some error condition.
 //----------------------------------------------------------------------------
@@ -209,21 +345,147 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
         min_pkt_cnt = _buffer->count();
     }
 
-    // We access data under the protection of the global mutex.
-    GuardCondition lock(_global_mutex, _to_do);
-
     PluginExecutor* next = ringNext<PluginExecutor>();
+    const Monotonic start(true);
     timeout = false;
 
-    // Loop until enough packets are available (or some error condition).
-    while (_pkt_cnt < min_pkt_cnt && !_input_end && !timeout && !next->_tsp_aborting) {
-        // If packet area for this processor is empty, wait for some packet.
-        // The mutex is implicitely released, we wait for the condition
-        // '_to_do' and, once we get it, implicitely relock the mutex.
-        // We loop on this until packets are actually available.
-        // If there is a timeout in the packet reception, call the plugin handler.
-        timeout = !lock.waitCondition(_tsp_timeout) && !plugin()->handlePacketTimeout();
+    if (_options.lockfree_handoff) {
+        // Spin then park, without the global mutex.
+        waitWorkLockFree(min_pkt_cnt, next, timeout);
+        returnWork(min_pkt_cnt, timeout, next, pkt_first, pkt_cnt, bitrate, br_confidence, input_end, aborted);
+    }
+    else {
+        // We access data under the protection of the global mutex.
+        GuardCondition lock(_global_mutex, _to_do);
+
+        // Loop until enough packets are available (or some error condition).
+        while (_pkt_cnt < min_pkt_cnt && !_input_end && !timeout && !next->_tsp_aborting) {
+            // If packet area for this processor is empty, wait for some packet.
+            // The mutex is implicitely released, we wait for the condition
+            // '_to_do' and, once we get it, implicitely relock the mutex.
+            // We loop on this until packets are actually available.
+            // If there is a timeout in the packet reception, call the plugin handler.
+            timeout = !lock.waitCondition(_tsp_timeout) && !plugin()->handlePacketTimeout();
+        }
+
+        returnWork(min_pkt_cnt, timeout, next, pkt_first, pkt_cnt, bitrate, br_confidence, input_end, aborted);
+    }
+
+    // Update execution statistics.
+    StatAdd<int64_t>(_stat_wait_time, Monotonic(true) - start);
+    StatMax<size_t>(_stat_max_buffered, pkt_cnt);
+
+    log(10, u"waitWork(min_pkt_cnt = %'d, pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %s, aborted = %s, timeout = %s)",
+        {min_pkt_cnt, pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout});
+}
+
+
+//----------------------------------------------------------------------------
+// Execution statistics.
+//----------------------------------------------------------------------------
+
+ts::tsp::PluginExecutor::Statistics::Statistics() :
+    plugin_packets(0),
+    total_packets(0),
+    elapsed(0),
+    process_time(0),
+    wait_time(0),
+    buffered_packets(0),
+    max_buffered_packets(0),
+    latency_packets(0),
+    latency_total(0),
+    latency_max(0)
+{
+}
+
+void ts::tsp::PluginExecutor::getStatistics(Statistics& stats) const
+{
+    stats.plugin_packets = _stat_plugin_packets.load(std::memory_order_relaxed);
+    stats.total_packets = _stat_total_packets.load(std::memory_order_relaxed);
+    stats.elapsed = Monotonic(true) - _stat_start;
+    stats.process_time = _stat_process_time.load(std::memory_order_relaxed);
+    stats.wait_time = _stat_wait_time.load(std::memory_order_relaxed);
+    stats.buffered_packets = _pkt_cnt.load(std::memory_order_relaxed);
+    stats.max_buffered_packets = _stat_max_buffered.load(std::memory_order_relaxed);
+    stats.latency_packets = _stat_latency_count.load(std::memory_order_relaxed);
+    stats.latency_total = _stat_latency_total.load(std::memory_order_relaxed);
+    stats.latency_max = _stat_latency_max.load(std::memory_order_relaxed);
+}
+
+ts::json::ValuePtr ts::tsp::PluginExecutor::getStatisticsJSON() const
+{
+    Statistics stats;
+    getStatistics(stats);
+
+    json::Object* obj = new json::Object;
+    json::ValuePtr result(obj);
+    obj->add(u"index", int64_t(pluginIndex()));
+    obj->add(u"name", pluginName());
+    obj->add(u"type", PluginTypeNames.name(plugin()->type()));
+    obj->add(u"suspended", json::Bool(getSuspended()));
+    obj->add(u"plugin-packets", int64_t(stats.plugin_packets));
+    obj->add(u"total-packets", int64_t(stats.total_packets));
+    obj->add(u"elapsed-us", stats.elapsed / NanoSecPerMicroSec);
+    obj->add(u"process-us", stats.process_time / NanoSecPerMicroSec);
+    obj->add(u"wait-us", stats.wait_time / NanoSecPerMicroSec);
+    obj->add(u"process-percent", stats.elapsed <= 0 ? 0 : (100 * stats.process_time) / stats.elapsed);
+    obj->add(u"wait-percent", stats.elapsed <= 0 ? 0 : (100 * stats.wait_time) / stats.elapsed);
+    obj->add(u"buffered-packets", int64_t(stats.buffered_packets));
+    obj->add(u"max-buffered-packets", int64_t(stats.max_buffered_packets));
+    if (stats.latency_packets > 0) {
+        obj->add(u"latency-packets", int64_t(stats.latency_packets));
+        obj->add(u"latency-average-us", stats.latency_total / NanoSecond(stats.latency_packets) / NanoSecPerMicroSec);
+        obj->add(u"latency-max-us", stats.latency_max / NanoSecPerMicroSec);
+    }
+    return result;
+}
+
+void ts::tsp::PluginExecutor::addProcessTime(const Monotonic& start)
+{
+    StatAdd<int64_t>(_stat_process_time, Monotonic(true) - start);
+}
+
+void ts::tsp::PluginExecutor::addLatency(const TSPacketMetadata* data, size_t count, const Monotonic& input_start)
+{
+    // Current time, in the same reference as input time stamps from the tsp clock (see InputExecutor).
+    TSPacketMetadata now;
+    now.setInputTimeStamp(Monotonic(true) - input_start, NanoSecPerSec, TimeSource::TSP);
+
+    uint64_t lat_count = 0;
+    uint64_t lat_total = 0;
+    uint64_t lat_max = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (data[i].getInputTimeSource() == TimeSource::TSP && data[i].hasInputTimeStamp()) {
+            const uint64_t lat = DiffPCR(data[i].getInputTimeStamp(), now.getInputTimeStamp());
+            if (lat != INVALID_PCR) {
+                lat_count++;
+                lat_total += lat;
+                lat_max = std::max(lat_max, lat);
+            }
+        }
+    }
+    if (lat_count > 0) {
+        // Time stamps are in PCR units.
+        StatAdd<uint64_t>(_stat_latency_count, lat_count);
+        StatAdd<int64_t>(_stat_latency_total, NanoSecond((lat_total * NanoSecPerMicroSec) / (SYSTEM_CLOCK_FREQ / MicroSecPerSec)));
+        StatMax<int64_t>(_stat_latency_max, NanoSecond((lat_max * NanoSecPerMicroSec) / (SYSTEM_CLOCK_FREQ / MicroSecPerSec)));
     }
+}
+
+
+//----------------------------------------------------------------------------
+// Build the returned values of waitWork().
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::returnWork(size_t min_pkt_cnt, bool timeout, const PluginExecutor* next,
+                                         size_t& pkt_first, size_t& pkt_cnt,
+                                         BitRate& bitrate, BitRateConfidence& br_confidence,
+                                         bool& input_end, bool& aborted)
+{
+    // Read the end of input before the packet count. In lock-free handoff mode,
+    // the previous processor publishes them in reverse order.
+    const bool end = _input_end.load(std::memory_order_acquire);
+    const size_t available = _pkt_cnt.load(std::memory_order_acquire);
 
     // The number of returned packets is limited up to the wrap-up point of the circular buffer,
     // if allowed by the requested minimum number of packets.
@@ -233,25 +495,60 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
     }
     else if (_pkt_first + min_pkt_cnt <= _buffer->count()) {
         // Return up to the wrap-up point. This will satisfy the requested minimum.
-        pkt_cnt = std::min(_pkt_cnt, _buffer->count() - _pkt_first);
+        pkt_cnt = std::min(available, _buffer->count() - _pkt_first);
     }
     else {
         // The requested minimum does not fit into a contiguous area.
-        pkt_cnt = _pkt_cnt;
+        pkt_cnt = available;
     }
 
     pkt_first = _pkt_first;
-    bitrate = _bitrate;
-    br_confidence = _br_confidence;
-    input_end = _input_end && pkt_cnt == _pkt_cnt;
+    getInputBitrate(bitrate, br_confidence);
+    input_end = end && pkt_cnt == available;
 
     // Force to abort our processor when the next one is aborting.
     // Don't do that if current is output and next is input because
     // there is no propagation of packets from output back to input.
     aborted = plugin()->type() != PluginType::OUTPUT && next->_tsp_aborting;
+}
 
-    log(10, u"waitWork(min_pkt_cnt = %'d, pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %s, aborted = %s, timeout = %s)",
-        {min_pkt_cnt, pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout});
+
+//----------------------------------------------------------------------------
+// Wait for packets to process, lock-free handoff mode.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::waitWorkLockFree(size_t min_pkt_cnt, PluginExecutor* next, bool& timeout)
+{
+    size_t spin = 0;
+    bool parked = false;
+
+    while (!timeout && !hasWork(min_pkt_cnt, next)) {
+        if (spin < _spin_limit) {
+            // Spin phase: the previous processor is likely to publish packets soon.
+            spin++;
+            Thread::SpinPause();
+        }
+        else {
+            // Park phase: declare that we are parked, then check again before waiting.
+            GuardCondition lock(_park_mutex, _to_do);
+            _parked.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!hasWork(min_pkt_cnt, next)) {
+                // If there is a timeout in the packet reception, call the plugin handler.
+                timeout = !lock.waitCondition(_tsp_timeout) && !plugin()->handlePacketTimeout();
+            }
+            _parked.store(false);
+            parked = true;
+        }
+    }
+
+    // Adapt the spin limit: spin longer when spinning was sufficient, shorter when we had to park.
+    if (parked) {
+        _spin_limit = std::max(MIN_SPIN_LIMIT, _spin_limit / 2);
+    }
+    else if (spin > 0) {
+        _spin_limit = std::min(MAX_SPIN_LIMIT, _spin_limit * 2);
+    }
 }
 
 
@@ -305,7 +602,7 @@ void ts::tsp::PluginExecutor::restart(const RestartDataPtr& rd)
         _restart = true;
 
         // Signal the plugin thread that there is something to do.
-        lock1.signal();
+        wakeUp();
     }
 
     // Now wait for the restart operation to complete.
@@ -331,6 +628,11 @@ bool ts::tsp::PluginExecutor::pendingRestart()
 // Process a pending restart operation if there is one.
 //----------------------------------------------------------------------------
 
+void ts::tsp::PluginExecutor::stopPlugin()
+{
+    plugin()->stop();
+}
+
 bool ts::tsp::PluginExecutor::processPendingRestart(bool& restarted)
 {
     // Run under the protection of the global mutex.
@@ -354,7 +656,7 @@ bool ts::tsp::PluginExecutor::processPendingRestart(bool& restarted)
     _restart_data->report.verbose(u"restarting plugin %s", {pluginName()});
 
     // First, stop the current execution.
-    plugin()->stop();
+    stopPlugin();
 
     // Inform the TSP layer to reset plugin session accounting.
     restartPluginSession();
@@ -42,6 +42,8 @@
 #include "tsCondition.h"
 #include "tsMutex.h"
 #include "tsThread.h"
+#include "tsMonotonic.h"
+#include "tsjsonValue.h"
 
 namespace ts {
     namespace tsp {
@@ -145,6 +147,41 @@ namespace ts {
             //!
             void restart(Report& report);
 
+            //!
+            //! Execution statistics of a plugin executor.
+            //! All durations are in nanoseconds.
+            //!
+            class Statistics
+            {
+            public:
+                Statistics();                       //!< Constructor.
+                PacketCounter plugin_packets;       //!< Number of packets which were passed to the plugin.
+                PacketCounter total_packets;        //!< Total number of packets in the thread, including suspended and dropped.
+                NanoSecond    elapsed;              //!< Elapsed time since the start of the packet processing.
+                NanoSecond    process_time;         //!< Time spent processing packets: receive(), processPacket() or processPacketWindow() loop, send().
+                NanoSecond    wait_time;            //!< Time spent blocked in waitWork(), waiting for packets or free buffers.
+                size_t        buffered_packets;     //!< Current number of packets in the buffer area of the plugin.
+                size_t        max_buffered_packets; //!< Maximum number of packets which were returned at once by waitWork().
+                PacketCounter latency_packets;      //!< Number of packets with a measured latency (output plugin only).
+                NanoSecond    latency_total;        //!< Cumulated latency of all measured packets, from input to output.
+                NanoSecond    latency_max;          //!< Maximum latency of a packet, from input to output.
+            };
+
+            //!
+            //! Get the execution statistics of the plugin.
+            //! This method can be called from any thread. The returned values are not atomically
+            //! consistent with each other but each of them is a valid value.
+            //! @param [out] stats Returned statistics.
+            //!
+            void getStatistics(Statistics& stats) const;
+
+            //!
+            //! Get the execution statistics of the plugin as a JSON object.
+            //! This method can be called from any thread.
+            //! @return A safe pointer to a JSON object describing the plugin and its statistics.
+            //!
+            json::ValuePtr getStatisticsJSON() const;
+
             // Implementation of TSP virtual methods.
             virtual size_t pluginCount() const override;
             virtual void signalPluginEvent(uint32_t event_code, Object* plugin_data = nullptr) const override;
@@ -217,6 +254,30 @@ namespace ts {
             //!
             bool processPendingRestart(bool& restarted);
 
+            //!
+            //! Stop the plugin, at the end of the processing or before a restart.
+            //! The default implementation calls the stop() method of the plugin.
+            //! Must be called from the plugin thread only.
+            //!
+            virtual void stopPlugin();
+
+            //!
+            //! Add time which was spent in the plugin, for execution statistics.
+            //! Must be called from the plugin thread only.
+            //! @param [in] start Monotonic time when the plugin was called.
+            //!
+            void addProcessTime(const Monotonic& start);
+
+            //!
+            //! Add the input-to-output latency of packets, for execution statistics.
+            //! Only packets with input time stamps from the tsp monotonic clock are used.
+            //! Must be called from the plugin thread only.
+            //! @param [in] data Metadata of the packets.
+            //! @param [in] count Number of packets.
+            //! @param [in] input_start Start time of the input plugin, origin of its time stamps.
+            //!
+            void addLatency(const TSPacketMetadata* data, size_t count, const Monotonic& input_start);
+
         private:
             // Registry of plugin event handlers.
             const PluginEventHandlerRegistry& _handlers;
@@ -228,14 +289,34 @@ namespace ts {
             // The following private data must be accessed exclusively under the protection of the global mutex.
             // Implementation details: see the file src/docs/developing-plugins.dox.
             // [*] After initialization, these fields are read/written only in passPackets() and waitWork().
-            Condition         _to_do;          // Notify processor to do something.
-            size_t            _pkt_first;      // Starting index of packets area [*]
-            size_t            _pkt_cnt;        // Size of packets area [*]
-            bool              _input_end;      // No more packet after current ones [*]
-            BitRate           _bitrate;        // Input bitrate (set by previous plugin) [*]
-            BitRateConfidence _br_confidence;  // Input bitrate confidence (set by previous plugin) [*]
-            bool              _restart;        // Restart the plugin asap using _restart_data
-            RestartDataPtr    _restart_data;   // How to restart the plugin
+            // In lock-free handoff mode, the [*] fields are not protected by the global mutex. The packet
+            // area is published through the atomic _pkt_cnt: increased by the previous processor (release),
+            // decreased by this processor. _pkt_first is only modified by this processor. The bitrate is
+            // protected by the _br_lock spin lock. A waiting thread first spins on _pkt_cnt, then parks
+            // on _to_do using _park_mutex instead of the global mutex.
+            Condition           _to_do;          // Notify processor to do something.
+            size_t              _pkt_first;      // Starting index of packets area [*]
+            std::atomic<size_t> _pkt_cnt;        // Size of packets area [*]
+            std::atomic<bool>   _input_end;      // No more packet after current ones [*]
+            BitRate             _bitrate;        // Input bitrate (set by previous plugin) [*]
+            BitRateConfidence   _br_confidence;  // Input bitrate confidence (set by previous plugin) [*]
+            std::atomic<bool>   _br_lock;        // Spin lock on _bitrate and _br_confidence.
+            Mutex               _park_mutex;     // Mutex for _to_do in lock-free handoff mode.
+            std::atomic<bool>   _parked;         // The thread is waiting on _to_do in lock-free handoff mode.
+            size_t              _spin_limit;     // Current adaptive number of spin iterations before parking.
+            bool                _restart;        // Restart the plugin asap using _restart_data
+            RestartDataPtr      _restart_data;   // How to restart the plugin
+
+            // Execution statistics. They are written by the plugin thread only and read from any thread.
+            Monotonic              _stat_start;          // Start time of statistics, set in initBuffer().
+            std::atomic<uint64_t>  _stat_plugin_packets; // Copy of pluginPackets(), updated in passPackets().
+            std::atomic<uint64_t>  _stat_total_packets;  // Copy of totalPacketsInThread(), updated in passPackets().
+            std::atomic<int64_t>   _stat_process_time;   // Time spent in the plugin.
+            std::atomic<int64_t>   _stat_wait_time;      // Time spent in waitWork().
+            std::atomic<size_t>    _stat_max_buffered;   // Max packets returned by waitWork().
+            std::atomic<uint64_t>  _stat_latency_count;  // Number of packets with a measured latency.
+            std::atomic<int64_t>   _stat_latency_total;  // Cumulated latency.
+            std::atomic<int64_t>   _stat_latency_max;    // Max latency.
 
             // Description of a restart operation.
             class RestartData
@@ -255,6 +336,26 @@ namespace ts {
 
             // Restart this plugin.
             void restart(const RestartDataPtr&);
+
+            // Lock-free handoff mode (--lock-free-handoff), see above.
+            bool passPacketsLockFree(size_t count, const BitRate& bitrate, BitRateConfidence br_confidence, bool input_end, bool aborted);
+            void waitWorkLockFree(size_t min_pkt_cnt, PluginExecutor* next, bool& timeout);
+
+            // Build the returned values of waitWork(), once waiting is over.
+            void returnWork(size_t min_pkt_cnt, bool timeout, const PluginExecutor* next,
+                            size_t& pkt_first, size_t& pkt_cnt,
+                            BitRate& bitrate, BitRateConfidence& br_confidence,
+                            bool& input_end, bool& aborted);
+
+            // Check if there is something to do for this processor, without the global mutex.
+            bool hasWork(size_t min_pkt_cnt, const PluginExecutor* next) const;
+
+            // Wake up the thread of this processor. In global mutex mode, the caller must hold the global mutex.
+            void wakeUp();
+
+            // Get/set the input bitrate, as propagated by the previous processor.
+            void getInputBitrate(BitRate& bitrate, BitRateConfidence& br_confidence);
+            void setInputBitrate(const BitRate& bitrate, BitRateConfidence br_confidence);
         };
     }
 }
@@ -28,6 +28,11 @@
 //----------------------------------------------------------------------------
 
 #include "tstspProcessorExecutor.h"
+#include "tsPluginRepository.h"
+#include "tsNullReport.h"
+
+// Minimum number of packets per slice of packet window in a parallel worker.
+#define MIN_SLICE_PACKETS 64
 
 
 //----------------------------------------------------------------------------
@@ -43,7 +48,9 @@ ts::tsp::ProcessorExecutor::ProcessorExecutor(const TSProcessorArgs& options,
 
     PluginExecutor(options, handlers, PluginType::PROCESSOR, options.plugins[plugin_index], attributes, global_mutex, report),
     _processor(dynamic_cast<ProcessorPlugin*>(PluginThread::plugin())),
-    _plugin_index(1 + plugin_index) // include first input plugin in the count
+    _plugin_index(1 + plugin_index), // include first input plugin in the count
+    _workers(),
+    _slice()
 {
     if (options.log_plugin_index) {
         // Make sure that plugins display their index.
@@ -54,6 +61,7 @@ ts::tsp::ProcessorExecutor::ProcessorExecutor(const TSProcessorArgs& options,
 ts::tsp::ProcessorExecutor::~ProcessorExecutor()
 {
     waitForTermination();
+    stopWorkers();
 }
 
 
@@ -89,8 +97,17 @@ void ts::tsp::ProcessorExecutor::main()
         window_size = _processor->getPacketWindowSize();
     }
 
-    // Perform the complete packet processing in individual-packet or packet-window mode.
+    // A stateless plugin in individual-packet mode can be executed by parallel workers.
     if (window_size == 0) {
+        startWorkers();
+    }
+
+    // Perform the complete packet processing in individual-packet or packet-window mode.
+    // With parallel workers, the packet windows use all available packets.
+    if (!_workers.empty()) {
+        processPacketWindows(1);
+    }
+    else if (window_size == 0) {
         processIndividualPackets();
     }
     else {
@@ -99,6 +116,13 @@ void ts::tsp::ProcessorExecutor::main()
 
     // Close the packet processor.
     debug(u"stopping the plugin");
+    stopPlugin();
+}
+
+void ts::tsp::ProcessorExecutor::stopPlugin()
+{
+    // The statistics of the clones are merged in the plugin before stopping it.
+    stopWorkers();
     _processor->stop();
 }
 
@@ -166,6 +190,7 @@ void ts::tsp::ProcessorExecutor::processIndividualPackets()
         // Now process the packets.
         size_t pkt_done = 0;
         size_t pkt_flush = 0;
+        const Monotonic process_start(true);
 
         while (pkt_done < pkt_cnt && !aborted) {
 
@@ -252,6 +277,7 @@ void ts::tsp::ProcessorExecutor::processIndividualPackets()
                 pkt_flush = 0;
             }
         }
+        addProcessTime(process_start);
 
     } while (!input_end && !aborted);
 
@@ -268,7 +294,10 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
 {
     debug(u"packet processing window size: %'d packets", {window_size});
 
+    // The PID and label index is built only when the plugin uses it. The slices
+    // which are processed by the parallel workers are never indexed.
     TSPacketMetadata::LabelSet only_labels(_processor->getOnlyLabelOption());
+    bool use_index = _workers.empty() && _processor->usePacketWindowIndex();
     PacketCounter passed_packets = 0;
     PacketCounter dropped_packets = 0;
     PacketCounter nullified_packets = 0;
@@ -314,7 +343,8 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
                 br_confidence = _tsp_bitrate_confidence;
             }
 
-            // Process restart requests.
+            // Process restart requests. The parallel workers are stopped with the plugin.
+            const bool parallel = !_workers.empty();
             if (!processPendingRestart(restarted)) {
                 timeout = true; // restart error
             }
@@ -323,6 +353,11 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
                 // Don't let window size be zero, we are in packet window mode.
                 only_labels = _processor->getOnlyLabelOption();
                 window_size = std::max<size_t>(1, _processor->getPacketWindowSize());
+                // The plugin clones shall be recreated with the new options, if the plugin is still stateless.
+                if (parallel) {
+                    startWorkers();
+                }
+                use_index = _workers.empty() && _processor->usePacketWindowIndex();
             }
 
             // If the plugin is suspended, simply pass the packets to the next plugin.
@@ -335,6 +370,7 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
             }
 
             // Inspect the packets we got from the buffer (pkt_first / pkt_count) and insert usable packets in the packet window.
+            win.setIndexed(use_index);
             for (size_t pkt_offset = 0; pkt_offset < allocated_packets; ++pkt_offset) {
 
                 // Take care that waitWork() may have returned a slice of the buffer which wraps up.
@@ -369,8 +405,20 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
             request_packets += window_size - win.size();
         }
 
-        // Let the plugin process the packet window.
-        const size_t processed_packets = _processor->processPacketWindow(win);
+        // Let the plugin process the packet window, possibly using parallel workers.
+        size_t processed_packets = 0;
+        size_t drop_count = 0;
+        size_t nullify_count = 0;
+        const Monotonic process_start(true);
+        if (_workers.empty()) {
+            processed_packets = _processor->processPacketWindow(win);
+            drop_count = win.dropCount();
+            nullify_count = win.nullifyCount();
+        }
+        else {
+            processed_packets = processParallelWindow(win, drop_count, nullify_count);
+        }
+        addProcessTime(process_start);
 
         // If not all packets from the window were processed, the plugin want to terminate the stream processing.
         if (processed_packets < win.size()) {
@@ -398,9 +446,9 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
         }
 
         // Count packets which were processed in the plugin.
-        passed_packets += processed_packets - win.dropCount();
-        dropped_packets += win.dropCount();
-        nullified_packets += win.nullifyCount();
+        passed_packets += processed_packets - drop_count;
+        dropped_packets += drop_count;
+        nullified_packets += nullify_count;
         addPluginPackets(processed_packets);
         addNonPluginPackets(allocated_packets - processed_packets);
 
@@ -432,3 +480,136 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
     debug(u"packet processing thread %s after %'d packets, %'d passed, %'d dropped, %'d nullified",
           {input_end ? u"terminated" : u"aborted", pluginPackets(), passed_packets, dropped_packets, nullified_packets});
 }
+
+
+//----------------------------------------------------------------------------
+// Start or stop the parallel workers of a stateless plugin.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::startWorkers()
+{
+    // Need at least two threads, including this one, and a stateless plugin.
+    if (!_workers.empty() || _options.parallel_workers <= 1 || !_processor->isStateless()) {
+        return;
+    }
+
+    // All clones are created from the same factory, with the current options of the plugin.
+    const PluginRepository::ProcessorPluginFactory allocator = PluginRepository::Instance()->getProcessor(pluginName(), *this);
+    if (allocator == nullptr) {
+        return;
+    }
+    UStringVector args;
+    _processor->getCommandArgs(args);
+
+    // The worker threads have the same attributes as this thread.
+    ThreadAttributes attr;
+    getAttributes(attr);
+
+    while (_workers.size() + 1 < _options.parallel_workers) {
+        ProcessorPlugin* clone = allocator(this);
+        if (clone == nullptr) {
+            break;
+        }
+        clone->setShell(_processor->getShell());
+        clone->setMaxSeverity(_processor->maxSeverity());
+        clone->resetContext(_options.duck_args);
+
+        // The command line was already successfully analyzed by the main instance of the plugin, don't report errors twice.
+        clone->setFlags(clone->getFlags() | Args::NO_HELP | Args::NO_EXIT_ON_ERROR);
+        Report* previous_report = clone->redirectReport(&NULLREP);
+        const bool analyzed = clone->analyze(pluginName(), args, false) && clone->getOptions();
+        clone->redirectReport(previous_report);
+
+        if (!analyzed || !clone->start()) {
+            delete clone;
+            break;
+        }
+        if (!clone->isStateless()) {
+            clone->stop();
+            delete clone;
+            break;
+        }
+
+        // The worker is now responsible for the clone.
+        ProcessorWorker* worker = new ProcessorWorker(clone, attr);
+        if (!worker->open()) {
+            delete worker;
+            break;
+        }
+        _workers.push_back(worker);
+    }
+
+    if (_workers.size() + 1 < _options.parallel_workers) {
+        warning(u"could only start %d parallel workers out of %d", {_workers.size() + 1, _options.parallel_workers});
+    }
+    debug(u"using %d parallel workers", {_workers.size() + 1});
+}
+
+void ts::tsp::ProcessorExecutor::stopWorkers()
+{
+    // The statistics of each clone are partial. They are merged in the main instance of the plugin,
+    // which reports them when stopped. Only errors and warnings from the clones are displayed.
+    const int severity = maxSeverity();
+    setMaxSeverity(std::min(severity, int(Severity::Warning)));
+    for (auto worker : _workers) {
+        worker->close();
+        _processor->mergeStatistics(*worker->plugin());
+        delete worker;
+    }
+    _workers.clear();
+    setMaxSeverity(severity);
+}
+
+
+//----------------------------------------------------------------------------
+// Process a packet window using the parallel workers.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Build a slice of a packet window.
+    void BuildSlice(ts::TSPacketWindow& slice, const ts::TSPacketWindow& win, size_t first, size_t count)
+    {
+        slice.clear();
+        ts::TSPacket* pkt = nullptr;
+        ts::TSPacketMetadata* mdata = nullptr;
+        for (size_t i = first; i < first + count && i < win.size(); ++i) {
+            if (win.get(i, pkt, mdata)) {
+                slice.addPacketsReference(pkt, mdata, 1);
+            }
+        }
+    }
+}
+
+size_t ts::tsp::ProcessorExecutor::processParallelWindow(TSPacketWindow& win, size_t& drop_count, size_t& nullify_count)
+{
+    // Split the window in contiguous slices, all of them large enough to be worth a thread switch.
+    // The first slice is processed in this thread. Each worker processes one of the other slices.
+    const size_t slice_count = std::max<size_t>(1, std::min(_workers.size() + 1, win.size() / MIN_SLICE_PACKETS));
+    const size_t slice_size = (win.size() + slice_count - 1) / slice_count;
+
+    BuildSlice(_slice, win, 0, slice_size);
+    for (size_t i = 1; i < slice_count; ++i) {
+        BuildSlice(_workers[i - 1]->window(), win, i * slice_size, slice_size);
+        _workers[i - 1]->startWindow();
+    }
+
+    // Process the first slice.
+    size_t processed_packets = ProcessorWorker::ProcessWindow(_processor, _slice);
+    bool terminated = processed_packets < _slice.size();
+    drop_count = _slice.dropCount();
+    nullify_count = _slice.nullifyCount();
+
+    // Wait for all workers and collect their results in stream order. When a slice
+    // terminates the processing, the packets in the next slices are ignored.
+    for (size_t i = 1; i < slice_count; ++i) {
+        ProcessorWorker* worker = _workers[i - 1];
+        const size_t count = worker->waitWindow();
+        if (!terminated) {
+            processed_packets += count;
+            drop_count += worker->window().dropCount();
+            nullify_count += worker->window().nullifyCount();
+            terminated = count < worker->window().size();
+        }
+    }
+    return processed_packets;
+}
@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tstspPluginExecutor.h"
+#include "tstspProcessorWorker.h"
 #include "tsProcessorPlugin.h"
 
 namespace ts {
@@ -72,15 +73,29 @@ namespace ts {
             virtual size_t pluginIndex() const override;
 
         private:
-            ProcessorPlugin* _processor;
-            const size_t     _plugin_index;
+            ProcessorPlugin*              _processor;
+            const size_t                  _plugin_index;
+            std::vector<ProcessorWorker*> _workers;  // Parallel workers with plugin clones (stateless plugins only).
+            TSPacketWindow                _slice;    // Slice of packet window which is processed in the executor thread.
 
             // Inherited from Thread
             virtual void main() override;
 
+            // Inherited from PluginExecutor: stop the parallel workers first, then the plugin.
+            virtual void stopPlugin() override;
+
             // Process packets one by one or using packet windows.
             void processIndividualPackets();
             void processPacketWindows(size_t window_size);
+
+            // Start or stop the parallel workers of a stateless plugin.
+            // Workers are started only if requested by the tsp options and the plugin is stateless.
+            void startWorkers();
+            void stopWorkers();
+
+            // Process a packet window using the parallel workers.
+            // Same returned value as ProcessorPlugin::processPacketWindow().
+            size_t processParallelWindow(TSPacketWindow& win, size_t& drop_count, size_t& nullify_count);
         };
     }
 }
@@ -0,0 +1,173 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tstspProcessorWorker.h"
+#include "tsGuardCondition.h"
+#include "tsGuardMutex.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::tsp::ProcessorWorker::ProcessorWorker(ProcessorPlugin* plugin, const ThreadAttributes& attributes) :
+    Thread(attributes),
+    _plugin(plugin),
+    _win(),
+    _closed(false),
+    _processed(0),
+    _busy(false),
+    _terminate(false),
+    _mutex(),
+    _work_to_do(),
+    _work_done()
+{
+}
+
+ts::tsp::ProcessorWorker::~ProcessorWorker()
+{
+    close();
+
+    // Deallocate the plugin clone.
+    if (_plugin != nullptr) {
+        delete _plugin;
+        _plugin = nullptr;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Start and stop the worker thread.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::ProcessorWorker::open()
+{
+    return _plugin != nullptr && start();
+}
+
+void ts::tsp::ProcessorWorker::close()
+{
+    if (!_closed) {
+        _closed = true;
+
+        // Terminate the worker thread.
+        {
+            GuardCondition lock(_mutex, _work_to_do);
+            _terminate = true;
+            lock.signal();
+        }
+        waitForTermination();
+
+        // Stop the plugin clone.
+        if (_plugin != nullptr) {
+            _plugin->stop();
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Start and wait for the processing of the packet window.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorWorker::startWindow()
+{
+    GuardCondition lock(_mutex, _work_to_do);
+    _processed = 0;
+    _busy = true;
+    lock.signal();
+}
+
+size_t ts::tsp::ProcessorWorker::waitWindow()
+{
+    GuardCondition lock(_mutex, _work_done);
+    while (_busy) {
+        lock.waitCondition();
+    }
+    return _processed;
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked in the context of the worker thread.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorWorker::main()
+{
+    for (;;) {
+        // Wait for a packet window to process.
+        {
+            GuardCondition lock(_mutex, _work_to_do);
+            while (!_busy && !_terminate) {
+                lock.waitCondition();
+            }
+            if (_terminate) {
+                break;
+            }
+        }
+
+        // Process the packet window outside the mutex.
+        const size_t processed = ProcessWindow(_plugin, _win);
+
+        // Notify the executor.
+        GuardCondition lock(_mutex, _work_done);
+        _processed = processed;
+        _busy = false;
+        lock.signal();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Process a window of packets using the individual packet processing method.
+//----------------------------------------------------------------------------
+
+size_t ts::tsp::ProcessorWorker::ProcessWindow(ProcessorPlugin* plugin, TSPacketWindow& win)
+{
+    TSPacket* pkt = nullptr;
+    TSPacketMetadata* mdata = nullptr;
+    size_t processed_packets = 0;
+
+    while (processed_packets < win.size()) {
+        if (win.get(processed_packets, pkt, mdata)) {
+            const ProcessorPlugin::Status status = plugin->processPacket(*pkt, *mdata);
+            if (status == ProcessorPlugin::TSP_NULL) {
+                win.nullify(processed_packets);
+            }
+            else if (status == ProcessorPlugin::TSP_DROP) {
+                win.drop(processed_packets);
+            }
+            else if (status == ProcessorPlugin::TSP_END) {
+                break;
+            }
+        }
+        processed_packets++;
+    }
+    return processed_packets;
+}
@@ -0,0 +1,135 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream processor: Parallel worker for stateless packet processors
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsProcessorPlugin.h"
+#include "tsTSPacketWindow.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+
+namespace ts {
+    namespace tsp {
+        //!
+        //! Transport stream processor: Parallel worker for stateless packet processors.
+        //! This class is internal to the TSDuck library and cannot be called by applications.
+        //!
+        //! When a packet processor plugin declares itself as stateless, its executor may split
+        //! each packet window in several slices and process them in parallel. Each worker owns
+        //! a clone of the plugin and processes one slice at a time in its own thread.
+        //!
+        //! @ingroup plugin
+        //!
+        class ProcessorWorker : private Thread
+        {
+            TS_NOBUILD_NOCOPY(ProcessorWorker);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] plugin A started clone of the plugin. The worker becomes the owner of
+            //! this object. The plugin is stopped and deleted with the worker.
+            //! @param [in] attributes Creation attributes for the worker thread.
+            //!
+            ProcessorWorker(ProcessorPlugin* plugin, const ThreadAttributes& attributes);
+
+            //!
+            //! Destructor.
+            //! The worker thread is terminated and the plugin clone is stopped and deleted.
+            //!
+            virtual ~ProcessorWorker() override;
+
+            //!
+            //! Start the worker thread.
+            //! @return True on success, false on error.
+            //!
+            bool open();
+
+            //!
+            //! Terminate the worker thread and stop the plugin clone.
+            //! The clone remains allocated until the worker is deleted, so that its statistics
+            //! can be merged in the main instance of the plugin.
+            //!
+            void close();
+
+            //!
+            //! Get the plugin clone of the worker.
+            //! @return A pointer to the plugin clone.
+            //!
+            ProcessorPlugin* plugin() const { return _plugin; }
+
+            //!
+            //! Get the packet window of the worker.
+            //! The executor shall fill it with the packets of the next slice before calling startWindow().
+            //! @return A reference to the packet window of the worker.
+            //!
+            TSPacketWindow& window() { return _win; }
+
+            //!
+            //! Asynchronously start the processing of the worker's packet window.
+            //!
+            void startWindow();
+
+            //!
+            //! Wait for the completion of the processing of the worker's packet window.
+            //! @return Number of processed packets in the window, same as ProcessorPlugin::processPacketWindow().
+            //!
+            size_t waitWindow();
+
+            //!
+            //! Process a window of packets using the individual packet processing method of a plugin.
+            //! Unlike the default implementation of ProcessorPlugin::processPacketWindow(), the packet
+            //! counters of the associated TSP object are not updated. This method can be safely called
+            //! on several clones of the same plugin in parallel.
+            //! @param [in,out] plugin The plugin to use.
+            //! @param [in,out] win The window of TS packets to process.
+            //! @return Number of processed packets in the window, same as ProcessorPlugin::processPacketWindow().
+            //!
+            static size_t ProcessWindow(ProcessorPlugin* plugin, TSPacketWindow& win);
+
+        private:
+            ProcessorPlugin* _plugin;
+            TSPacketWindow   _win;
+            bool             _closed;
+            size_t           _processed;
+            bool             _busy;       // Protected by _mutex.
+            bool             _terminate;  // Protected by _mutex.
+            Mutex            _mutex;
+            Condition        _work_to_do;
+            Condition        _work_done;
+
+            // Implementation of Thread.
+            virtual void main() override;
+        };
+    }
+}
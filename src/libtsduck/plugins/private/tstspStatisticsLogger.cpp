@@ -0,0 +1,130 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tstspStatisticsLogger.h"
+#include "tsGuardCondition.h"
+#include "tsGuardMutex.h"
+#include "tsTextFormatter.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::tsp::StatisticsLogger::StatisticsLogger(const TSProcessorArgs& options, Report& log, InputExecutor* input) :
+    _is_open(false),
+    _terminate(false),
+    _interval(options.stats_interval),
+    _log(log),
+    _input(input),
+    _mutex(),
+    _wake_up()
+{
+}
+
+ts::tsp::StatisticsLogger::~StatisticsLogger()
+{
+    close();
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Start/stop the periodic logging.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::StatisticsLogger::open()
+{
+    if (_interval <= 0 || _input == nullptr) {
+        // No periodic logging, do nothing.
+        return true;
+    }
+    else if (_is_open) {
+        _log.error(u"tsp statistics logger already started");
+        return false;
+    }
+    else {
+        _terminate = false;
+        _is_open = true;
+        return start();
+    }
+}
+
+void ts::tsp::StatisticsLogger::close()
+{
+    if (_is_open) {
+        {
+            GuardCondition lock(_mutex, _wake_up);
+            _terminate = true;
+            lock.signal();
+        }
+        waitForTermination();
+        _is_open = false;
+        // Final statistics.
+        logStatistics();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked in the context of the logger thread.
+//----------------------------------------------------------------------------
+
+void ts::tsp::StatisticsLogger::main()
+{
+    _log.debug(u"plugin statistics thread started");
+
+    GuardCondition lock(_mutex, _wake_up);
+    while (!_terminate) {
+        if (!lock.waitCondition(_interval) && !_terminate) {
+            logStatistics();
+        }
+    }
+
+    _log.debug(u"plugin statistics thread completed");
+}
+
+
+//----------------------------------------------------------------------------
+// Log the statistics of all plugins, one JSON line per plugin.
+//----------------------------------------------------------------------------
+
+void ts::tsp::StatisticsLogger::logStatistics()
+{
+    PluginExecutor* proc = _input;
+    do {
+        TextFormatter text(_log);
+        text.setString();
+        text.setEndOfLineMode(TextFormatter::EndOfLineMode::SPACING);
+        proc->getStatisticsJSON()->print(text);
+        UString line;
+        text.getString(line);
+        _log.info(u"plugin stats: %s", {line});
+    } while ((proc = proc->ringNext<PluginExecutor>()) != _input);
+}
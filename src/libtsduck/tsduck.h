@@ -88,6 +88,7 @@
 #include "tsAssociationTagDescriptor.h"
 #include "tsAsyncReport.h"
 #include "tsAsyncReportArgs.h"
+#include "tsAtomicMutex.h"
 #include "tsATSCAC3AudioStreamDescriptor.h"
 #include "tsATSCEAC3AudioDescriptor.h"
 #include "tsATSCEIT.h"
@@ -423,6 +424,7 @@
 #include "tsMultilingualComponentDescriptor.h"
 #include "tsMultilingualNetworkNameDescriptor.h"
 #include "tsMultilingualServiceNameDescriptor.h"
+#include "tsMultiPatternSearch.h"
 #include "tsMultiplexBufferDescriptor.h"
 #include "tsMultiplexBufferUtilizationDescriptor.h"
 #include "tsMutex.h"
@@ -517,6 +519,7 @@
 #include "tsReportFile.h"
 #include "tsReportWithPrefix.h"
 #include "tsResidentBuffer.h"
+#include "tsRingMessageQueue.h"
 #include "tsRingNode.h"
 #include "tsRIST.h"
 #include "tsRISTInputPlugin.h"
@@ -764,6 +767,7 @@
 
 #if defined(TS_LINUX)
 #include "tsDTVProperties.h"
+#include "tsIOUring.h"
 #include "tsSignalAllocator.h"
 #include "tsTunerDevice.h"
 #include "tsTunerDeviceInfo.h"
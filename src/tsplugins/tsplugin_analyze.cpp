@@ -37,6 +37,10 @@
 #include "tsTSSpeedMetrics.h"
 #include "tsFileNameGenerator.h"
 #include "tsFileUtils.h"
+#include "tsThread.h"
+#include "tsGuardCondition.h"
+
+#define REPORT_THREAD_STACK_SIZE (512 * 1024)
 
 
 //----------------------------------------------------------------------------
@@ -44,18 +48,32 @@
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class AnalyzePlugin: public ProcessorPlugin
+    class AnalyzePlugin: public ProcessorPlugin, private Thread
     {
         TS_NOBUILD_NOCOPY(AnalyzePlugin);
     public:
         // Implementation of plugin API
         AnalyzePlugin(TSP*);
+        virtual ~AnalyzePlugin() override;
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual bool stop() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
+        // One analysis context. With --interval, there are two of them. One is fed
+        // by the packet processing thread while the other one, containing the previous
+        // interval, is formatted and reset by the report thread. Each analysis has its
+        // own DuckContext because the analysis of tables accumulates standards in it.
+        class Analysis
+        {
+            TS_NOBUILD_NOCOPY(Analysis);
+        public:
+            Analysis(Report* report) : duck(report), analyzer(duck) {}
+            DuckContext      duck;
+            TSAnalyzerReport analyzer;
+        };
+
         // Command line options:
         UString           _output_name;
         NanoSecond        _output_interval;
@@ -67,12 +85,26 @@ namespace ts {
         std::ostream*     _output;
         TSSpeedMetrics    _metrics;
         NanoSecond        _next_report;
-        TSAnalyzerReport  _analyzer;
         FileNameGenerator _name_gen;
+        Analysis          _analysis1;
+        Analysis          _analysis2;
+        Analysis*         _current;         // Analysis being fed with packets, owned by the packet thread.
+        std::atomic<bool> _report_error;    // The report thread failed to produce a report.
+
+        // Handoff between the packet processing thread and the report thread, protected by the mutex.
+        Mutex             _mutex;
+        Condition         _condition;
+        Analysis*         _pending;         // Analysis to report, waiting for the report thread.
+        Analysis*         _free;            // Reported and reset analysis, available for the packet thread.
+        bool              _terminate;       // Terminate the report thread when no more pending analysis.
 
         bool openOutput();
         void closeOutput();
-        bool produceReport();
+        bool produceReport(Analysis&);
+        bool publishAnalysis();
+
+        // Invoked in the context of the report thread.
+        virtual void main() override;
     };
 }
 
@@ -85,6 +117,7 @@ TS_REGISTER_PROCESSOR_PLUGIN(u"analyze", ts::AnalyzePlugin);
 
 ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
     ProcessorPlugin(tsp_, u"Analyze the structure of a transport stream", u"[options]"),
+    Thread(ThreadAttributes().setStackSize(REPORT_THREAD_STACK_SIZE)),
     _output_name(),
     _output_interval(0),
     _multiple_output(false),
@@ -93,8 +126,16 @@ ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
     _output(nullptr),
     _metrics(),
     _next_report(0),
-    _analyzer(duck),
-    _name_gen()
+    _name_gen(),
+    _analysis1(tsp_),
+    _analysis2(tsp_),
+    _current(&_analysis1),
+    _report_error(false),
+    _mutex(),
+    _condition(),
+    _pending(nullptr),
+    _free(nullptr),
+    _terminate(false)
 {
     // Define all standard analysis options.
     duck.defineArgsForStandards(*this);
@@ -108,7 +149,9 @@ ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
          u"Produce a new output file at regular intervals. "
          u"The interval value is in seconds. "
          u"After outputting a file, the analysis context is reset, "
-         u"ie. each output file contains a fully independent analysis.");
+         u"ie. each output file contains a fully independent analysis. "
+         u"The reports are formatted and written in a separate thread, "
+         u"without interrupting the packet processing.");
 
     option(u"multiple-files", 'm');
     help(u"multiple-files",
@@ -124,6 +167,23 @@ ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
 }
 
 
+//----------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------
+
+ts::AnalyzePlugin::~AnalyzePlugin()
+{
+    // The report thread is still running when the plugin is deleted without
+    // stop(), for instance when a subsequent plugin failed to start.
+    {
+        GuardCondition lock(_mutex, _condition);
+        _terminate = true;
+        lock.signal();
+    }
+    Thread::waitForTermination();
+}
+
+
 //----------------------------------------------------------------------------
 // Get options method
 //----------------------------------------------------------------------------
@@ -146,9 +206,22 @@ bool ts::AnalyzePlugin::getOptions()
 bool ts::AnalyzePlugin::start()
 {
     _output = _output_name.empty() ? &std::cout : &_output_stream;
-    _analyzer.setAnalysisOptions(_analyzer_options);
     _name_gen.initDateTime(_output_name);
 
+    // Both analysis contexts use the same options.
+    DuckContext::SavedArgs args;
+    duck.saveArgs(args);
+    for (auto an : {&_analysis1, &_analysis2}) {
+        an->duck.restoreArgs(args);
+        an->analyzer.reset();
+        an->analyzer.setAnalysisOptions(_analyzer_options);
+    }
+    _current = &_analysis1;
+    _pending = nullptr;
+    _free = &_analysis2;
+    _terminate = false;
+    _report_error = false;
+
     // For production of multiple reports at regular intervals.
     _metrics.start();
     _next_report = _output_interval;
@@ -160,6 +233,11 @@ bool ts::AnalyzePlugin::start()
         return false;
     }
 
+    // With --interval, the periodic reports are produced by a separate thread.
+    if (_output_interval > 0 && !Thread::start()) {
+        tsp->error(u"cannot start report thread");
+        return false;
+    }
     return true;
 }
 
@@ -206,30 +284,101 @@ void ts::AnalyzePlugin::closeOutput()
 // Produce a report. Return true on success, false on error.
 //----------------------------------------------------------------------------
 
-bool ts::AnalyzePlugin::produceReport()
+bool ts::AnalyzePlugin::produceReport(Analysis& an)
 {
     if (!openOutput()) {
         return false;
     }
     else {
-        // Set last known input bitrate as hint
-        _analyzer.setBitrateHint(tsp->bitrate(), tsp->bitrateConfidence());
-
-        // Produce the report
-        _analyzer.report(*_output, _analyzer_options, *tsp);
+        // Produce the report. With --interval, this is executed in the report thread, the
+        // only one to use the output file and the analysis options after start().
+        an.analyzer.report(*_output, _analyzer_options, *tsp);
         closeOutput();
         return true;
     }
 }
 
 
+//----------------------------------------------------------------------------
+// Publish the current analysis to the report thread and continue with the
+// other one. Executed in the packet processing thread. Return false on error.
+//----------------------------------------------------------------------------
+
+bool ts::AnalyzePlugin::publishAnalysis()
+{
+    // Set last known input bitrate as hint
+    _current->analyzer.setBitrateHint(tsp->bitrate(), tsp->bitrateConfidence());
+
+    // Swap the analysis contexts. We need to wait only when the previous
+    // report is still being formatted after a complete interval.
+    GuardCondition lock(_mutex, _condition);
+    while (_free == nullptr) {
+        lock.waitCondition();
+    }
+    _pending = _current;
+    _current = _free;
+    _free = nullptr;
+    lock.signal();
+    return !_report_error;
+}
+
+
+//----------------------------------------------------------------------------
+// Report thread.
+//----------------------------------------------------------------------------
+
+void ts::AnalyzePlugin::main()
+{
+    for (;;) {
+        // Wait for an analysis to report or termination.
+        Analysis* an = nullptr;
+        {
+            GuardCondition lock(_mutex, _condition);
+            while (_pending == nullptr && !_terminate) {
+                lock.waitCondition();
+            }
+            if (_pending == nullptr) {
+                break;
+            }
+            an = _pending;
+            _pending = nullptr;
+        }
+
+        // Produce the report and reset the analysis context, without interrupting the packet processing.
+        if (!produceReport(*an)) {
+            _report_error = true;
+        }
+        an->analyzer.reset();
+
+        // Give back the analysis context to the packet processing thread.
+        GuardCondition lock(_mutex, _condition);
+        _free = an;
+        lock.signal();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Stop method
 //----------------------------------------------------------------------------
 
 bool ts::AnalyzePlugin::stop()
 {
-    produceReport();
+    if (_output_interval == 0) {
+        // Set last known input bitrate as hint and produce the final report.
+        _current->analyzer.setBitrateHint(tsp->bitrate(), tsp->bitrateConfidence());
+        produceReport(*_current);
+    }
+    else {
+        // Publish the last partial analysis and wait for the report thread to terminate.
+        publishAnalysis();
+        {
+            GuardCondition lock(_mutex, _condition);
+            _terminate = true;
+            lock.signal();
+        }
+        Thread::waitForTermination();
+    }
     return true;
 }
 
@@ -241,16 +390,14 @@ bool ts::AnalyzePlugin::stop()
 ts::ProcessorPlugin::Status ts::AnalyzePlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
 {
     // Feed the analyzer with one packet
-    _analyzer.feedPacket(pkt);
+    _current->analyzer.feedPacket(pkt);
 
     // With --interval, check if it is time to produce a report
     if (_output_interval > 0 && _metrics.processedPacket() && _metrics.sessionNanoSeconds() >= _next_report) {
-        // Time to produce a report.
-        if (!produceReport()) {
+        // Time to produce a report, in the report thread, and continue with a fresh analysis context.
+        if (!publishAnalysis()) {
             return TSP_END;
         }
-        // Reset analysis context.
-        _analyzer.reset();
         // Compute next report time.
         _next_report += _output_interval;
     }
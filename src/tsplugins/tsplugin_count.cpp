@@ -52,6 +52,9 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual size_t getPacketWindowSize() override;
+        virtual bool usePacketWindowIndex() const override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
 
     private:
         // This structure is used at each --interval.
@@ -74,6 +77,7 @@ namespace ts {
         bool           _report_summary;     // Report summary
         bool           _report_total;       // Report total of all PIDs
         PacketCounter  _report_interval;    // If non-zero, report time-stamp at this packet interval
+        size_t         _packet_window;      // Number of packets to count at once, zero means one by one
 
         // Working data:
         std::ofstream  _outfile;            // User-specified output file
@@ -82,6 +86,9 @@ namespace ts {
 
         // Report a line
         void report(const UChar* fmt, const std::initializer_list<ArgMixIn> args);
+
+        // Count one packet, packet_index is the index of the packet in the plugin.
+        void countPacket(PacketCounter packet_index, PID pid);
     };
 }
 
@@ -102,6 +109,7 @@ ts::CountPlugin::CountPlugin(TSP* tsp_) :
     _report_summary(false),
     _report_total(false),
     _report_interval(0),
+    _packet_window(0),
     _outfile(),
     _last_report(),
     _counters()
@@ -129,6 +137,12 @@ ts::CountPlugin::CountPlugin(TSP* tsp_) :
          u"Specify the output file for reporting packet counters. By default, report "
          u"on standard error using the tsp logging mechanism.");
 
+    option(u"packet-window", 0, POSITIVE);
+    help(u"packet-window", u"count",
+         u"Count packets by groups of up to the specified number of packets. "
+         u"The packets are counted using the PID index of the group, without accessing each packet. "
+         u"By default, packets are counted one by one.");
+
     option(u"pid", 'p', PIDVAL, 0, UNLIMITED_COUNT);
     help(u"pid", u"pid1[-pid2]",
          u"PID filter: select packets with these PID values. Several -p or --pid "
@@ -164,6 +178,7 @@ bool ts::CountPlugin::getOptions()
     _brief_report = present(u"brief");
     _negate = present(u"negate");
     getIntValue(_report_interval, u"interval");
+    getIntValue(_packet_window, u"packet-window", 0);
     getIntValues(_pids, u"pid");
     _tag = value(u"tag");
     if (!_tag.empty()) {
@@ -263,9 +278,53 @@ void ts::CountPlugin::report(const UChar* fmt, const std::initializer_list<ArgMi
 //----------------------------------------------------------------------------
 
 ts::ProcessorPlugin::Status ts::CountPlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
+{
+    countPacket(tsp->pluginPackets(), pkt.getPID());
+    return TSP_OK;
+}
+
+
+//----------------------------------------------------------------------------
+// Packet window processing method, when --packet-window is specified.
+//----------------------------------------------------------------------------
+
+size_t ts::CountPlugin::getPacketWindowSize()
+{
+    return _packet_window;
+}
+
+bool ts::CountPlugin::usePacketWindowIndex() const
+{
+    return true;
+}
+
+size_t ts::CountPlugin::processPacketWindow(TSPacketWindow& win)
+{
+    // Without PID index, count packets one by one.
+    const PID* const pids = win.pids();
+    if (pids == nullptr) {
+        return ProcessorPlugin::processPacketWindow(win);
+    }
+
+    // The packet counter of the plugin is updated after processing the window.
+    // Dropped packets have PID_MAX in the index.
+    const PacketCounter base = tsp->pluginPackets();
+    for (size_t i = 0; i < win.size(); ++i) {
+        if (pids[i] < PID_MAX) {
+            countPacket(base + i, pids[i]);
+        }
+    }
+    return win.size();
+}
+
+
+//----------------------------------------------------------------------------
+// Count one packet.
+//----------------------------------------------------------------------------
+
+void ts::CountPlugin::countPacket(PacketCounter packet_index, PID pid)
 {
     // Check if the packet must be counted
-    const PID pid = pkt.getPID();
     bool ok = _pids[pid];
     if (_negate) {
         ok = !ok;
@@ -273,18 +332,18 @@ ts::ProcessorPlugin::Status ts::CountPlugin::processPacket(TSPacket& pkt, TSPack
 
     // Process reporting intervals.
     if (_report_interval > 0) {
-        if (tsp->pluginPackets() == 0) {
+        if (packet_index == 0) {
             // Set initial interval
             _last_report.start = Time::CurrentUTC();
             _last_report.counted_packets = 0;
             _last_report.total_packets = 0;
         }
-        else if (tsp->pluginPackets() % _report_interval == 0) {
+        else if (packet_index % _report_interval == 0) {
             // It is time to produce a report.
             // Get current state.
             IntervalReport now;
             now.start = Time::CurrentUTC();
-            now.total_packets = tsp->pluginPackets();
+            now.total_packets = packet_index;
             now.counted_packets = 0;
             for (size_t p = 0; p < PID_MAX; p++) {
                 now.counted_packets += _counters[p];
@@ -310,14 +369,12 @@ ts::ProcessorPlugin::Status ts::CountPlugin::processPacket(TSPacket& pkt, TSPack
     if (ok) {
         if (_report_all) {
             if (_brief_report) {
-                report(u"%d %d", {tsp->pluginPackets(), pid});
+                report(u"%d %d", {packet_index, pid});
             }
             else {
-                report(u"%spacket: %10'd, PID: %4d (0x%04X)", {_tag, tsp->pluginPackets(), pid, pid});
+                report(u"%spacket: %10'd, PID: %4d (0x%04X)", {_tag, packet_index, pid, pid});
             }
         }
         _counters[pid]++;
     }
-
-    return TSP_OK;
 }
@@ -35,7 +35,7 @@
 #include "tsPluginRepository.h"
 #include "tsReportBuffer.h"
 #include "tsUDPReceiver.h"
-#include "tsMessageQueue.h"
+#include "tsRingMessageQueue.h"
 #include "tsThread.h"
 #include "tsAlgorithm.h"
 
@@ -61,7 +61,7 @@ namespace ts {
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
-        typedef MessageQueue<UString, Mutex> CommandQueue;
+        typedef RingMessageQueue<UString, Mutex> CommandQueue;
 
         // Plugin private fields.
         volatile bool _terminate;      // Force termination flag for thread.
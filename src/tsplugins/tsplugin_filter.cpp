@@ -36,7 +36,7 @@
 #include "tsSignalizationDemux.h"
 #include "tsPESPacket.h"
 #include "tsAlgorithm.h"
-#include "tsMemory.h"
+#include "tsMultiPatternSearch.h"
 
 
 //----------------------------------------------------------------------------
@@ -53,7 +53,12 @@ namespace ts {
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual bool stop() override;
+        virtual bool isStateless() const override;
+        virtual void mergeStatistics(const ProcessorPlugin&) override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual size_t getPacketWindowSize() override;
+        virtual bool usePacketWindowIndex() const override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
 
     private:
         // Packet intervals and list of them.
@@ -92,7 +97,7 @@ namespace ts {
         PacketCounter   _every_packets;      // Filter 1 out of this number of packets
         CodecType       _codec;              // Filter on codec type
         PIDSet          _explicit_pid;       // Explicit PID values to filter
-        ByteBlock       _pattern;            // Byte pattern to search.
+        MultiPatternSearch _patterns;        // Byte patterns to search.
         bool            _search_payload;     // Search pattern in payload only
         bool            _use_search_offset;  // Search at specified offset only
         size_t          _search_offset;      // Offset where to search.
@@ -105,6 +110,8 @@ namespace ts {
         TSPacketMetadata::LabelSet _reset_labels;      // Labels to reset on filtered packets
         TSPacketMetadata::LabelSet _set_perm_labels;   // Labels to set on all packets after getting one packet
         TSPacketMetadata::LabelSet _reset_perm_labels; // Labels to reset on all packets after getting one packet
+        size_t          _packet_window;      // Number of packets to filter at once, zero means one by one.
+        bool            _index_only;         // Packets are selected on PID and labels only.
 
         // Working data:
         PacketCounter      _filtered_packets;  // Number of filtered packets
@@ -157,7 +164,7 @@ ts::FilterPlugin::FilterPlugin(TSP* tsp_) :
     _every_packets(0),
     _codec(CodecType::UNDEFINED),
     _explicit_pid(),
-    _pattern(),
+    _patterns(),
     _search_payload(false),
     _use_search_offset(false),
     _search_offset(0),
@@ -170,6 +177,8 @@ ts::FilterPlugin::FilterPlugin(TSP* tsp_) :
     _reset_labels(),
     _set_perm_labels(),
     _reset_perm_labels(),
+    _packet_window(0),
+    _index_only(false),
     _filtered_packets(0),
     _stream_id_pid(),
     _all_service_ids(),
@@ -282,10 +291,12 @@ ts::FilterPlugin::FilterPlugin(TSP* tsp_) :
          u"Select packets which were explicitly turned into null packets by some previous "
          u"plugin in the chain (typically using a --stuffing option).");
 
-    option(u"pattern", 0, HEXADATA);
+    option(u"pattern", 0, HEXADATA, 0, UNLIMITED_COUNT);
     help(u"pattern",
          u"Select packets containing the specified pattern bytes. "
          u"The value must be a string of hexadecimal digits specifying any number of bytes. "
+         u"Several --pattern options may be specified. A packet is selected when it contains any of them. "
+         u"All patterns are searched at once, the search time does not significantly depend on the number of patterns. "
          u"By default, the packet is selected when the value is anywhere inside the packet. "
          u"With option --search-payload, only search the pattern in the payload of the packet. "
          u"With option --search-offset, the packet is selected only if the pattern "
@@ -293,6 +304,13 @@ ts::FilterPlugin::FilterPlugin(TSP* tsp_) :
          u"When --search-payload and --search-offset are both specified, the packet "
          u"is selected only if the pattern is at the specified offset in the payload.");
 
+    option(u"packet-window", 0, POSITIVE);
+    help(u"packet-window", u"count",
+         u"Filter packets by groups of up to the specified number of packets. "
+         u"The packets are selected using the PID and label index of the group, without accessing each packet. "
+         u"This option can be used only when the packets are selected with --pid and --label. "
+         u"By default, packets are filtered one by one.");
+
     option(u"payload");
     help(u"payload", u"Select packets with a payload.");
 
@@ -426,10 +444,15 @@ bool ts::FilterPlugin::getOptions()
     getIntValues(_reset_labels, u"reset-label");
     getIntValues(_set_perm_labels, u"set-permanent-label");
     getIntValues(_reset_perm_labels, u"reset-permanent-label");
+    getIntValue(_packet_window, u"packet-window", 0);
     _search_payload = present(u"search-payload");
     _use_search_offset = present(u"search-offset");
     getIntValue(_search_offset, u"search-offset");
-    getHexaValue(_pattern, u"pattern");
+    ByteBlockVector patterns(count(u"pattern"));
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        getHexaValue(patterns[i], u"pattern", ByteBlock(), i);
+    }
+    _patterns.setPatterns(patterns);
 
     // Decode all index ranges.
     _ranges.clear();
@@ -454,7 +477,7 @@ bool ts::FilterPlugin::getOptions()
     }
 
     // Check that the pattern to search is not larger than the packet.
-    if (_pattern.size() > PKT_SIZE || (_use_search_offset && _search_offset + _pattern.size() > PKT_SIZE)) {
+    if (_patterns.maxPatternSize() > PKT_SIZE || (_use_search_offset && _search_offset + _patterns.maxPatternSize() > PKT_SIZE)) {
         tsp->error(u"search pattern too large for TS packets");
         return false;
     }
@@ -496,6 +519,19 @@ bool ts::FilterPlugin::getOptions()
     // If we look for service names, we also need to be notified of changes in service list.
     _demux.setHandler(_service_names.empty() ? nullptr : this);
 
+    // Check if the packets are selected on PID and labels only, without accessing the packets.
+    _index_only =
+        !_need_demux && _scrambling_ctrl < 0 && !_with_payload && !_with_af && !_with_pes && !_with_pcr &&
+        !_with_splice && !_unit_start && !_nullified && !_input_stuffing && !_valid &&
+        _min_payload < 0 && _max_payload < 0 && _min_af < 0 && _max_af < 0 &&
+        _splice < -128 && _min_splice < -128 && _max_splice < -128 &&
+        _after_packets == 0 && _every_packets == 0 && _stream_ids.empty() && _patterns.empty() && _ranges.empty() &&
+        _set_perm_labels.none() && _reset_perm_labels.none();
+    if (_packet_window > 0 && !_index_only) {
+        tsp->error(u"--packet-window can be used only with --pid and --label selection criteria");
+        return false;
+    }
+
     return true;
 }
 
@@ -525,6 +561,27 @@ bool ts::FilterPlugin::stop()
 }
 
 
+//----------------------------------------------------------------------------
+// The filter is stateless when packets are selected on their own content only,
+// without signalization, PES stream id or position in the stream. Packets
+// which were filtered by parallel clones are counted in the main instance.
+//----------------------------------------------------------------------------
+
+bool ts::FilterPlugin::isStateless() const
+{
+    return !_need_demux && _stream_ids.empty() && _after_packets == 0 && _every_packets == 0 &&
+        _ranges.empty() && _set_perm_labels.none() && _reset_perm_labels.none();
+}
+
+void ts::FilterPlugin::mergeStatistics(const ProcessorPlugin& clone)
+{
+    const FilterPlugin* other = dynamic_cast<const FilterPlugin*>(&clone);
+    if (other != nullptr) {
+        _filtered_packets += other->_filtered_packets;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
@@ -586,14 +643,14 @@ ts::ProcessorPlugin::Status ts::FilterPlugin::processPacket(TSPacket& pkt, TSPac
         (_with_pes && pkt.startPES());
 
     // Search binary patterns in packets.
-    if (!ok && !_pattern.empty()) {
-        const size_t start = _search_payload ? pkt.getHeaderSize() : 0;
-        if (start + _search_offset + _pattern.size() <= PKT_SIZE) {
+    if (!ok && !_patterns.empty()) {
+        const size_t start = (_search_payload ? pkt.getHeaderSize() : 0) + _search_offset;
+        if (start < PKT_SIZE) {
             if (_use_search_offset) {
-                ok = ::memcmp(pkt.b + start + _search_offset, _pattern.data(), _pattern.size()) == 0;
+                ok = _patterns.startsWith(pkt.b + start, PKT_SIZE - start);
             }
             else {
-                ok = LocatePattern(pkt.b + start, PKT_SIZE - start, _pattern.data(), _pattern.size()) != nullptr;
+                ok = _patterns.search(pkt.b + start, PKT_SIZE - start);
             }
         }
     }
@@ -625,6 +682,59 @@ ts::ProcessorPlugin::Status ts::FilterPlugin::processPacket(TSPacket& pkt, TSPac
 }
 
 
+//----------------------------------------------------------------------------
+// Packet window processing method, when --packet-window is specified.
+//----------------------------------------------------------------------------
+
+size_t ts::FilterPlugin::getPacketWindowSize()
+{
+    return _packet_window;
+}
+
+bool ts::FilterPlugin::usePacketWindowIndex() const
+{
+    return _index_only;
+}
+
+size_t ts::FilterPlugin::processPacketWindow(TSPacketWindow& win)
+{
+    // Without PID and label index or with other criteria, filter packets one by one.
+    const PID* const pids = win.pids();
+    const uint32_t* const labels = win.labels();
+    if (!_index_only || pids == nullptr || labels == nullptr) {
+        return ProcessorPlugin::processPacketWindow(win);
+    }
+
+    // Select packets using the index only. Dropped packets have PID_MAX in the index.
+    const uint32_t label_mask = uint32_t(_labels.to_ulong());
+    const bool update_labels = _set_labels.any() || _reset_labels.any();
+    for (size_t i = 0; i < win.size(); ++i) {
+        const PID pid = pids[i];
+        if (pid < PID_MAX) {
+            bool ok = _explicit_pid[pid] || (labels[i] & label_mask) != 0;
+            if (_negate) {
+                ok = !ok;
+            }
+            if (ok) {
+                _filtered_packets++;
+                if (update_labels) {
+                    TSPacketMetadata* const mdata = win.metadata(i);
+                    mdata->setLabels(_set_labels);
+                    mdata->clearLabels(_reset_labels);
+                }
+            }
+            else if (_drop_status == TSP_DROP) {
+                win.drop(i);
+            }
+            else if (_drop_status == TSP_NULL) {
+                win.nullify(i);
+            }
+        }
+    }
+    return win.size();
+}
+
+
 //----------------------------------------------------------------------------
 // Handle potential changes in the service list.
 //----------------------------------------------------------------------------
@@ -36,7 +36,7 @@
 #include "tsUDPReceiver.h"
 #include "tsMPEPacket.h"
 #include "tsPacketizer.h"
-#include "tsMessageQueue.h"
+#include "tsRingMessageQueue.h"
 #include "tsThread.h"
 
 #define MAX_IP_SIZE                 65536
@@ -70,7 +70,9 @@ namespace ts {
 
         // Each receiver thread builds DSM-CC sections from the received UDP datagrams.
         // Sections from all receivers are multiplexed into one single thread-safe queue.
-        typedef MessageQueue<Section, Mutex> SectionQueue;
+        // There are several producers (the receivers) and one consumer (the plugin thread),
+        // a lock-free ring is used to avoid one lock and one allocation per datagram.
+        typedef RingMessageQueue<Section, AtomicMutex> SectionQueue;
 
         // Command line options.
         PID        _mpe_pid;        // PID into insert the MPE datagrams.
@@ -369,8 +371,8 @@ void ts::MPEInjectPlugin::provideSection(SectionCounter counter, SectionPtr& sec
     SectionQueue::MessagePtr ptr;
     if (_section_queue.dequeue(ptr, 0) && !ptr.isNull() && ptr->isValid()) {
         // Got a valid section. Transfer the section pointer ownership.
-        // We need an ownership transfer because SectionQueue::MessagePtr uses
-        // a real Mutex while SectionPtr uses a NullMutex (unsynchronized).
+        // We need an ownership transfer because SectionQueue::MessagePtr is
+        // thread-safe while SectionPtr uses a NullMutex (unsynchronized).
         section = ptr.changeMutex<NullMutex>();
     }
     else {
@@ -407,6 +407,11 @@ bool ts::PESPlugin::start()
     _demux.setPIDFilter(_pids);
     _demux.setDefaultCodec(_default_h26x);
 
+    // When only audio/video attributes are displayed, complete PES packets are not needed.
+    // Use the streaming mode of the demux, without reassembly of the PES packets.
+    _demux.setStreamingMode(!_trace_packets && !_dump_start_code && !_dump_nal_units && !_dump_avc_sei &&
+                            !_intra_images && _pes_filename.empty() && _es_filename.empty());
+
     // Create output files.
     bool ok = openOutput(_out_filename, &_out_file, &_out, false);
     if (_multiple_files) {
@@ -57,6 +57,7 @@ namespace ts {
         RemapPlugin(TSP*);
         virtual bool getOptions() override;
         virtual bool start() override;
+        virtual bool isStateless() const override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
@@ -252,6 +253,16 @@ void ts::RemapPlugin::handleTable(SectionDemux& demux, const BinaryTable& table)
 }
 
 
+//----------------------------------------------------------------------------
+// Without PSI update, each packet is remapped independently.
+//----------------------------------------------------------------------------
+
+bool ts::RemapPlugin::isStateless() const
+{
+    return !_update_psi;
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
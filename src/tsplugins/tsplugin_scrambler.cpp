@@ -102,6 +102,8 @@ namespace ts {
         virtual bool getOptions() override;
         virtual bool start() override;
         virtual bool stop() override;
+        virtual bool isStateless() const override;
+        virtual void mergeStatistics(const ProcessorPlugin&) override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
@@ -499,6 +501,28 @@ bool ts::ScramblerPlugin::stop()
 }
 
 
+//----------------------------------------------------------------------------
+// With one fixed control word on an explicit list of PID's, each packet is
+// scrambled independently and the plugin can run in parallel instances.
+// Packets which were scrambled by parallel clones are counted in the main instance.
+//----------------------------------------------------------------------------
+
+bool ts::ScramblerPlugin::isStateless() const
+{
+    return !_use_service && !_need_cp && !_need_ecm && _partial_scrambling <= 1;
+}
+
+void ts::ScramblerPlugin::mergeStatistics(const ProcessorPlugin& clone)
+{
+    const ScramblerPlugin* other = dynamic_cast<const ScramblerPlugin*>(&clone);
+    if (other != nullptr) {
+        _packet_count += other->_packet_count;
+        _scrambled_count += other->_scrambled_count;
+        _input_pids |= other->_input_pids;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 //  This method processes the PMT of the service.
 //----------------------------------------------------------------------------
@@ -57,6 +57,9 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual size_t getPacketWindowSize() override;
+        virtual bool usePacketWindowIndex() const override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
 
     private:
         // Each category of packets (PID or lable) is described by a structure like this.
@@ -76,6 +79,7 @@ namespace ts {
         NanoSecond _output_interval;   // Recreate output at this time interval.
         PIDSet     _pids;              // List of PID's to track.
         TSPacketMetadata::LabelSet _labels;  // List of labels to track.
+        size_t     _packet_window;     // Number of packets to analyze at once, zero means one by one.
 
         // Working data.
         std::ofstream     _output_stream;  // Output file stream.
@@ -88,6 +92,10 @@ namespace ts {
         // Get or create the description of a tracked PID or label.
         ContextPtr getContext(size_t index);
 
+        // Analyze one packet, packet_index is the index of the packet in the plugin.
+        // Return false on report error.
+        bool analyzePacket(PacketCounter packet_index, PID pid, const TSPacketMetadata::LabelSet& labels);
+
         // Open, close and create statistics report.
         bool openOutput();
         void closeOutput();
@@ -105,7 +113,7 @@ namespace ts {
             Context();
 
             // Add packet data to the context.
-            void addPacketData(PacketCounter, const TSPacket&);
+            void addPacketData(PacketCounter);
         };
     };
 }
@@ -129,6 +137,7 @@ ts::StatsPlugin::StatsPlugin(TSP* tsp_) :
     _output_interval(0),
     _pids(),
     _labels(),
+    _packet_window(0),
     _output_stream(),
     _output(nullptr),
     _ctx_map(),
@@ -176,6 +185,12 @@ ts::StatsPlugin::StatsPlugin(TSP* tsp_) :
          u"Specify the output text file for the analysis result. "
          u"By default, use the standard output.");
 
+    option(u"packet-window", 0, POSITIVE);
+    help(u"packet-window", u"count",
+         u"Analyze packets by groups of up to the specified number of packets. "
+         u"The packets are analyzed using the PID and label index of the group, without accessing each packet. "
+         u"By default, packets are analyzed one by one.");
+
     option(u"pid", 'p', PIDVAL, 0, UNLIMITED_COUNT);
     help(u"pid", u"pid1[-pid2]",
          u"Analyze the specified PID or range of PID's. "
@@ -203,6 +218,7 @@ bool ts::StatsPlugin::getOptions()
     getValue(_output_name, u"output-file");
     getIntValues(_pids, u"pid");
     getIntValues(_labels, u"label");
+    getIntValue(_packet_window, u"packet-window", 0);
 
     if (_pids.any() && _labels.any()) {
         tsp->error(u"options --pid and --label are mutually exclusive");
@@ -366,20 +382,63 @@ bool ts::StatsPlugin::stop()
 
 ts::ProcessorPlugin::Status ts::StatsPlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
 {
-    const PID pid = pkt.getPID();
+    return analyzePacket(tsp->pluginPackets(), pkt.getPID(), pkt_data.getLabels()) ? TSP_OK : TSP_END;
+}
+
+
+//----------------------------------------------------------------------------
+// Packet window processing method, when --packet-window is specified.
+//----------------------------------------------------------------------------
+
+size_t ts::StatsPlugin::getPacketWindowSize()
+{
+    return _packet_window;
+}
+
+bool ts::StatsPlugin::usePacketWindowIndex() const
+{
+    return true;
+}
 
+size_t ts::StatsPlugin::processPacketWindow(TSPacketWindow& win)
+{
+    // Without PID and label index, analyze packets one by one.
+    const PID* const pids = win.pids();
+    const uint32_t* const labels = win.labels();
+    if (pids == nullptr || labels == nullptr) {
+        return ProcessorPlugin::processPacketWindow(win);
+    }
+
+    // The packet counter of the plugin is updated after processing the window.
+    // Dropped packets have PID_MAX in the index.
+    const PacketCounter base = tsp->pluginPackets();
+    for (size_t i = 0; i < win.size(); ++i) {
+        if (pids[i] < PID_MAX && !analyzePacket(base + i, pids[i], TSPacketMetadata::LabelSet(labels[i]))) {
+            return i;
+        }
+    }
+    return win.size();
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze one packet.
+//----------------------------------------------------------------------------
+
+bool ts::StatsPlugin::analyzePacket(PacketCounter packet_index, PID pid, const TSPacketMetadata::LabelSet& labels)
+{
     // Check tracked pids.
     if (_pids.test(pid)) {
         const ContextPtr ctx(getContext(pid));
-        ctx->addPacketData(tsp->pluginPackets(), pkt);
+        ctx->addPacketData(packet_index);
     }
 
     // Check tracked labels.
     if (!_track_pids) {
         for (size_t label = 0; label < _labels.size(); ++label) {
-            if (pkt_data.hasLabel(label)) {
+            if (labels.test(label)) {
                 const ContextPtr ctx(getContext(label));
-                ctx->addPacketData(tsp->pluginPackets(), pkt);
+                ctx->addPacketData(packet_index);
             }
         }
     }
@@ -388,7 +447,7 @@ ts::ProcessorPlugin::Status ts::StatsPlugin::processPacket(TSPacket& pkt, TSPack
     if (_output_interval > 0 && _metrics.processedPacket() && _metrics.sessionNanoSeconds() >= _next_report) {
         // Time to produce a report.
         if (!produceReport()) {
-            return TSP_END;
+            return false;
         }
         // Reset analysis context.
         _ctx_map.clear();
@@ -396,7 +455,7 @@ ts::ProcessorPlugin::Status ts::StatsPlugin::processPacket(TSPacket& pkt, TSPack
         _next_report += _output_interval;
     }
 
-    return TSP_OK;
+    return true;
 }
 
 
@@ -435,7 +494,7 @@ ts::StatsPlugin::Context::Context() :
 // Add packet data to the context.
 //----------------------------------------------------------------------------
 
-void ts::StatsPlugin::Context::addPacketData(PacketCounter ts_index, const TSPacket& pkt)
+void ts::StatsPlugin::Context::addPacketData(PacketCounter ts_index)
 {
     // Accumulate inter-packet statistics, starting at the second packet.
     if (total_pkt > 0) {
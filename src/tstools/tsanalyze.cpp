@@ -35,8 +35,11 @@
 #include "tsTSAnalyzerReport.h"
 #include "tsTSAnalyzerOptions.h"
 #include "tsTSFile.h"
+#include "tsFileUtils.h"
 #include "tsPagerArgs.h"
 #include "tsDuckContext.h"
+#include "tsReportFile.h"
+#include "tsThread.h"
 TS_MAIN(MainCode);
 
 
@@ -53,6 +56,8 @@ namespace {
 
         ts::DuckContext       duck;      // TSDuck execution context.
         ts::BitRate           bitrate;   // Expected bitrate (188-byte packets)
+        bool                  mmap;      // Map the input file in memory.
+        size_t                threads;   // Number of analysis threads.
         ts::UString           infile;    // Input file name
         ts::TSPacketFormat    format;    // Input file format.
         ts::TSAnalyzerOptions analysis;  // Analysis options.
@@ -64,6 +69,8 @@ Options::Options(int argc, char *argv[]) :
     ts::Args(u"Analyze the structure of a transport stream", u"[options] [filename]"),
     duck(this),
     bitrate(0),
+    mmap(false),
+    threads(1),
     infile(),
     format(ts::TSPacketFormat::AUTODETECT),
     analysis(),
@@ -87,6 +94,25 @@ Options::Options(int argc, char *argv[]) :
          u"(based on 188-byte packets). By default, the bitrate is "
          u"evaluated using the PCR in the transport stream.");
 
+    option(u"mmap");
+    help(u"mmap",
+         u"Map the input file in memory and directly analyze the packets in the mapped area. "
+         u"This is faster on very large files. "
+         u"This option is ignored on Windows and when the input is not a regular file.");
+
+    option(u"threads", 0, INTEGER, 0, 1, 1, 64);
+    help(u"threads", u"count",
+         u"Analyze the input file using the specified number of parallel threads. "
+         u"The file is split into contiguous parts which are analyzed in parallel and "
+         u"the results are merged into one single report. "
+         u"The continuity counters and the table repetition rates are checked across the "
+         u"boundaries of the parts. Each part, except the first one, starts with a "
+         u"resynchronization window which overlaps the end of the previous part. "
+         u"The packets in this window are not counted twice, they are only used to "
+         u"collect the PAT and PMT's and the sections or PES packets which span the boundary. "
+         u"This option is ignored when the input is not a regular file. "
+         u"By default, the file is analyzed sequentially in one thread.");
+
     analyze(argc, argv);
 
     // Define all standard analysis options.
@@ -96,12 +122,198 @@ Options::Options(int argc, char *argv[]) :
 
     getValue(infile, u"");
     getValue(bitrate, u"bitrate");
+    mmap = present(u"mmap");
+    getIntValue(threads, u"threads", 1);
     format = ts::LoadTSPacketFormatInputOption(*this);
 
     exitOnError();
 }
 
 
+//----------------------------------------------------------------------------
+//  Analyze the packets from an open file.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Analyze at most max_packets packets.
+    void AnalyzePackets(ts::TSAnalyzer& analyzer, ts::TSFile& file, uint64_t max_packets, ts::Report& report)
+    {
+        // When possible, directly analyze the packets in the mapped file.
+        const size_t map_chunk = 10000;
+        const ts::TSPacket* pkts = nullptr;
+        size_t count = size_t(std::min<uint64_t>(map_chunk, max_packets));
+        if (file.mapPackets(pkts, count, report)) {
+            while (count > 0) {
+                for (size_t i = 0; i < count; ++i) {
+                    analyzer.feedPacket(pkts[i]);
+                }
+                max_packets -= count;
+                count = size_t(std::min<uint64_t>(map_chunk, max_packets));
+                if (count > 0) {
+                    file.mapPackets(pkts, count, report);
+                }
+            }
+        }
+        else {
+            ts::TSPacket pkt;
+            while (max_packets > 0 && file.readPackets(&pkt, nullptr, 1, report) > 0) {
+                analyzer.feedPacket(pkt);
+                max_packets--;
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Analysis of one part of the input file in a separate thread.
+//----------------------------------------------------------------------------
+
+namespace {
+    class PartAnalyzer: public ts::Thread
+    {
+        TS_NOBUILD_NOCOPY(PartAnalyzer);
+    public:
+        // Constructor: analyze packet_count packets, starting at byte offset start_offset.
+        // The first resync_packets packets overlap the previous part and are not counted.
+        PartAnalyzer(const Options& opt, ts::TSPacketFormat format, uint64_t start_offset, uint64_t packet_count, uint64_t resync_packets, ts::Report& report);
+
+        // Destructor.
+        virtual ~PartAnalyzer() override;
+
+        ts::DuckContext duck;      // Each analyzer needs its own context, tables analysis updates it.
+        ts::TSAnalyzer  analyzer;  // Analysis of this part.
+        bool            success;   // The file part was successfully read.
+
+    private:
+        const Options&     _opt;
+        ts::TSPacketFormat _format;
+        uint64_t           _start_offset;
+        uint64_t           _packet_count;
+        ts::Report&        _report;
+
+        // Implementation of Thread.
+        virtual void main() override;
+    };
+}
+
+PartAnalyzer::PartAnalyzer(const Options& opt, ts::TSPacketFormat format, uint64_t start_offset, uint64_t packet_count, uint64_t resync_packets, ts::Report& report) :
+    duck(&report),
+    analyzer(duck, opt.bitrate, ts::BitRateConfidence::OVERRIDE),
+    success(false),
+    _opt(opt),
+    _format(format),
+    _start_offset(start_offset),
+    _packet_count(packet_count),
+    _report(report)
+{
+    ts::DuckContext::SavedArgs args;
+    _opt.duck.saveArgs(args);
+    duck.restoreArgs(args);
+    analyzer.setMinErrorCountBeforeSuspect(_opt.analysis.suspect_min_error_count);
+    analyzer.setMaxConsecutiveSuspectCount(_opt.analysis.suspect_max_consecutive);
+    analyzer.setResyncWindow(resync_packets);
+}
+
+PartAnalyzer::~PartAnalyzer()
+{
+    waitForTermination();
+}
+
+void PartAnalyzer::main()
+{
+    ts::TSFile file;
+    file.setIOFlags(_opt.mmap ? ts::TSFile::MMAP : ts::TSFile::NONE);
+    success = file.openRead(_opt.infile, 1, _start_offset, _report, _format);
+    if (success) {
+        AnalyzePackets(analyzer, file, _packet_count, _report);
+        file.close(_report);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+//  Analyze the input file in several parts in parallel.
+//  Set done to false if the file cannot be split and must be analyzed
+//  sequentially. Return false on error.
+//----------------------------------------------------------------------------
+
+namespace {
+    bool AnalyzeParallel(ts::TSAnalyzer& analyzer, Options& opt, bool& done)
+    {
+        done = false;
+
+        // Minimum size of a file part in packets. Smaller files use less threads.
+        const uint64_t min_part_packets = 100000;
+
+        // Number of packets at the end of a part which are read again at the beginning of the next
+        // part to resynchronize the demux (PAT, PMT, sections and PES packets across the boundary).
+        const uint64_t resync_packets = 50000;
+
+        // Only regular files, with a known size, can be split.
+        const int64_t file_size = opt.infile.empty() || opt.infile == u"-" ? -1 : ts::GetFileSize(opt.infile);
+        if (file_size <= 0) {
+            opt.verbose(u"input is not a regular file, analyzing in one single thread");
+            return true;
+        }
+
+        // Read the first packet to get the actual file format.
+        ts::TSFile file;
+        ts::TSPacket pkt;
+        if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
+            return false;
+        }
+        const bool empty = file.readPackets(&pkt, nullptr, 1, opt) == 0;
+        const ts::TSPacketFormat format = file.packetFormat();
+        const uint64_t packet_size = file.packetHeaderSize() + ts::PKT_SIZE + file.packetTrailerSize();
+        file.close(opt);
+        if (empty) {
+            return true;
+        }
+
+        // Split the file in contiguous parts of packets. All parts are aligned on the packet size
+        // from the beginning of the file, exactly as the packets would be read in one single pass.
+        const uint64_t total_packets = uint64_t(file_size) / packet_size;
+        const size_t part_count = size_t(std::max<uint64_t>(1, std::min<uint64_t>(opt.threads, total_packets / min_part_packets)));
+        if (part_count < 2) {
+            opt.verbose(u"input file is too small, analyzing in one single thread");
+            return true;
+        }
+        opt.verbose(u"analyzing %'d packets in %d parallel threads, format %s", {total_packets, part_count, ts::TSPacketFormatEnum.name(format)});
+
+        // Messages from the analysis threads are serialized.
+        ts::ReportFile<ts::Mutex> report(std::cerr, opt.maxSeverity());
+
+        // Start one thread per part. The last part ends at end of file, including
+        // any truncated packet, as in a sequential analysis. All parts except the
+        // first one start with a resynchronization window in the previous part.
+        std::vector<ts::SafePtr<PartAnalyzer>> parts(part_count);
+        const uint64_t part_packets = total_packets / part_count;
+        const uint64_t overlap = std::min(resync_packets, part_packets / 2);
+        for (size_t i = 0; i < part_count; ++i) {
+            const uint64_t resync = i == 0 ? 0 : overlap;
+            const uint64_t count = i + 1 < part_count ? resync + part_packets : std::numeric_limits<uint64_t>::max();
+            parts[i] = new PartAnalyzer(opt, format, (i * part_packets - resync) * packet_size, count, resync, report);
+            if (!parts[i]->start()) {
+                opt.error(u"cannot start analysis thread");
+                return false;
+            }
+        }
+
+        // Wait for all threads and merge their analysis in sequence.
+        // The resynchronization windows are dropped by the merge.
+        done = true;
+        bool success = true;
+        for (size_t i = 0; i < part_count; ++i) {
+            parts[i]->waitForTermination();
+            success = success && parts[i]->success;
+            analyzer.merge(parts[i]->analyzer);
+        }
+        return success;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 //  Program entry point
 //----------------------------------------------------------------------------
@@ -115,18 +327,20 @@ int MainCode(int argc, char *argv[])
     ts::TSAnalyzerReport analyzer(opt.duck, opt.bitrate, ts::BitRateConfidence::OVERRIDE);
     analyzer.setAnalysisOptions(opt.analysis);
 
-    // Open the TS file.
-    ts::TSFile file;
-    if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
+    // Analyze the input file, in parallel when possible, otherwise sequentially.
+    bool done = false;
+    if (opt.threads > 1 && !AnalyzeParallel(analyzer, opt, done)) {
         return EXIT_FAILURE;
     }
-
-    // Analyze all packets in the file.
-    ts::TSPacket pkt;
-    while (file.readPackets(&pkt, nullptr, 1, opt) > 0) {
-        analyzer.feedPacket(pkt);
+    if (!done) {
+        ts::TSFile file;
+        file.setIOFlags(opt.mmap ? ts::TSFile::MMAP : ts::TSFile::NONE);
+        if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
+            return EXIT_FAILURE;
+        }
+        AnalyzePackets(analyzer, file, std::numeric_limits<uint64_t>::max(), opt);
+        file.close(opt);
     }
-    file.close(opt);
 
     // Display analysis results.
     analyzer.report(opt.pager.output(opt), opt.analysis, opt);
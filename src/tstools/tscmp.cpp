@@ -38,6 +38,8 @@
 #include "tsTSFile.h"
 #include "tsTextFormatter.h"
 #include "tsFileUtils.h"
+#include "tsReportFile.h"
+#include "tsThread.h"
 #include "tsjsonObject.h"
 #include "tsjsonString.h"
 #include "tsjsonNumber.h"
@@ -45,6 +47,8 @@ TS_MAIN(MainCode);
 
 #define DEFAULT_BUFFERED_PACKETS 10000
 #define DEFAULT_MIN_REORDER          7
+#define MIN_PART_PACKETS        100000  // Minimum size of file parts with --threads.
+#define PART_CHUNK_PACKETS       10000  // Number of packets to compare at a time in a file part.
 
 
 //----------------------------------------------------------------------------
@@ -77,6 +81,9 @@ namespace ts {
         bool             pid_ignore;
         bool             cc_ignore;
         bool             continue_all;
+        bool             mmap;
+        size_t           threads;
+        PIDSet           pid_mask;
         json::OutputArgs json;
     };
 }
@@ -103,6 +110,9 @@ ts::TSCompareOptions::TSCompareOptions(int argc, char *argv[]) :
     pid_ignore(false),
     cc_ignore(false),
     continue_all(false),
+    mmap(false),
+    threads(1),
+    pid_mask(),
     json()
 {
     ts::DefineTSPacketFormatInputOption(*this, 'f');
@@ -134,6 +144,12 @@ ts::TSCompareOptions::TSCompareOptions(int argc, char *argv[]) :
          u"With --search-reorder, this is the minimum number of consecutive packets to consider in reordered sequences of packets. "
          u"The default is " + UString::Decimal(DEFAULT_MIN_REORDER) + u" TS packets.");
 
+    option(u"mmap");
+    help(u"mmap",
+         u"Map the input files in memory and directly compare the packets in the mapped areas. "
+         u"This is faster on very large files. "
+         u"This option is ignored on Windows and when the input files are not regular files.");
+
     option(u"normalized", 'n');
     help(u"normalized", u"Report in a normalized output format (useful for automatic analysis).");
 
@@ -149,6 +165,13 @@ ts::TSCompareOptions::TSCompareOptions(int argc, char *argv[]) :
     option(u"pid-ignore", 0);
     help(u"pid-ignore", u"Ignore PID value when comparing packets. Useful if one file has gone through a remapping process.");
 
+    option(u"pid-mask", 0, PIDVAL, 0, UNLIMITED_COUNT);
+    help(u"pid-mask", u"pid1[-pid2]",
+         u"With --cc-ignore, --pcr-ignore or --pid-ignore, ignore the corresponding fields only in the packets "
+         u"with these PID values in the first file. The other packets are entirely compared. "
+         u"Several --pid-mask options may be specified. "
+         u"By default, the fields are ignored in all packets.");
+
     option(u"quiet", 'q');
     help(u"quiet",
          u"Do not output any message. The process simply terminates with a success "
@@ -163,6 +186,15 @@ ts::TSCompareOptions::TSCompareOptions(int argc, char *argv[]) :
     option(u"subset");
     help(u"subset", u"Legacy option, same as --search-reorder");
 
+    option(u"threads", 0, INTEGER, 0, 1, 1, 64);
+    help(u"threads", u"count",
+         u"Compare the files using the specified number of parallel threads. "
+         u"The files are split into contiguous parts which are compared in parallel. "
+         u"The differences are reported in the same order as in a sequential comparison. "
+         u"This option is ignored when the input files are not regular files. "
+         u"It cannot be used with --search-reorder. "
+         u"By default, the files are compared sequentially in one thread.");
+
     option(u"threshold-diff", 't', INTEGER, 0, 1, 0, PKT_SIZE);
     help(u"threshold-diff", u"count",
          u"When used with --search-reorder, this value specifies the maximum number of "
@@ -188,6 +220,9 @@ ts::TSCompareOptions::TSCompareOptions(int argc, char *argv[]) :
     pid_ignore = present(u"pid-ignore");
     cc_ignore = present(u"cc-ignore");
     continue_all = present(u"continue");
+    mmap = present(u"mmap");
+    getIntValue(threads, u"threads", 1);
+    getIntValues(pid_mask, u"pid-mask", true);
     quiet = present(u"quiet");
     normalized = !quiet && present(u"normalized");
     dump = !quiet && present(u"dump");
@@ -199,6 +234,9 @@ ts::TSCompareOptions::TSCompareOptions(int argc, char *argv[]) :
     if (json.useFile() && normalized) {
         error(u"options --json and --normalized are mutually exclusive");
     }
+    if (threads > 1 && search_reorder) {
+        error(u"options --threads and --search-reorder are mutually exclusive");
+    }
     if (quiet) {
         setMaxSeverity(Severity::Info);
     }
@@ -266,7 +304,7 @@ ts::PacketComparator::PacketComparator(const TSPacket& pkt1, const TSPacket& pkt
         // Compare payload only
         compare(pkt1.getPayload(), pkt1.getPayloadSize(), pkt2.getPayload(), pkt2.getPayloadSize());
     }
-    else if (!opt.pcr_ignore && !opt.pid_ignore && !opt.cc_ignore) {
+    else if ((!opt.pcr_ignore && !opt.pid_ignore && !opt.cc_ignore) || !opt.pid_mask.test(pkt1.getPID())) {
         // Compare full original packets
         compare(pkt1.b, PKT_SIZE, pkt2.b, PKT_SIZE);
     }
@@ -304,17 +342,8 @@ ts::PacketComparator::PacketComparator(const TSPacket& pkt1, const TSPacket& pkt
 // Compare two memory regions.
 void ts::PacketComparator::compare(const uint8_t* mem1, size_t size1, const uint8_t* mem2, size_t size2)
 {
-    diff_count = 0;
-    first_diff = end_diff = compared_size = std::min(size1, size2);
-    for (size_t i = 0; i < compared_size; i++) {
-        if (mem1[i] != mem2[i]) {
-            diff_count++;
-            end_diff = i + 1;
-            if (first_diff == compared_size) {
-                first_diff = i;
-            }
-        }
-    }
+    compared_size = std::min(size1, size2);
+    diff_count = TSPacket::CompareBytes(mem1, mem2, compared_size, first_diff, end_diff);
     equal = (_opt.search_reorder ? (diff_count <= _opt.threshold_diff) : (diff_count == 0)) && size1 == size2;
 }
 
@@ -335,6 +364,10 @@ namespace ts {
         UString fileName() const { return _file.getDisplayFileName(); }
         PacketCounter readPacketsCount() const { return _file.readPacketsCount(); }
 
+        // Get the detected packet format of the file and the corresponding packet size.
+        TSPacketFormat packetFormat() const { return _file.packetFormat(); }
+        size_t packetSize() const { return _file.packetHeaderSize() + PKT_SIZE + _file.packetTrailerSize(); }
+
         // Check if current packet is after end of file.
         bool eof() const { return _end_of_file && _packet_count == 0; }
 
@@ -415,8 +448,10 @@ ts::FileToCompare::FileToCompare(TSCompareOptions& opt, const UString& filename)
     _missing_start(NONE),
     _missing_packets(0),
     _missing_chunks(0),
-    _end_of_file(!_file.openRead(filename, 1, _opt.byte_offset, _opt, _opt.format))
+    _end_of_file(true)
 {
+    _file.setIOFlags(_opt.mmap ? TSFile::MMAP : TSFile::NONE);
+    _end_of_file = !_file.openRead(filename, 1, _opt.byte_offset, _opt, _opt.format);
     fillBuffer();
 }
 
@@ -547,6 +582,161 @@ void ts::FileToCompare::ignore(PacketCounter index, PacketCounter count)
 }
 
 
+//----------------------------------------------------------------------------
+// Comparison of one part of the files in a separate thread.
+//----------------------------------------------------------------------------
+
+namespace ts {
+    class PartComparator: public Thread
+    {
+        TS_NOBUILD_NOCOPY(PartComparator);
+    public:
+        // Constructor: compare packet_count packets, starting at packet index first_packet.
+        // The thread stops when a difference is found in a preceding part, as indicated by stop_part.
+        PartComparator(TSCompareOptions& opt,
+                       const TSPacketFormat format[2],
+                       const size_t packet_size[2],
+                       size_t part_index,
+                       PacketCounter first_packet,
+                       PacketCounter packet_count,
+                       std::atomic<size_t>& stop_part,
+                       Report& report);
+
+        // Destructor.
+        virtual ~PartComparator() override;
+
+        // Description of a difference between two packets.
+        struct Difference {
+            PacketCounter index;            // Index of the packets in the files.
+            TSPacket      pkt[2];           // Packets from the two files.
+            PacketCounter index_in_pid[2];  // Index of the packets in their PID, from the beginning of the part.
+        };
+
+        bool                       success;      // The two parts were successfully read.
+        std::vector<Difference>    differences;  // All differences in this part, in order.
+        std::vector<PacketCounter> pid_count0;   // Number of packets per PID in this part of the first file.
+        std::vector<PacketCounter> pid_count1;   // Number of packets per PID in this part of the second file.
+
+    private:
+        TSCompareOptions&    _opt;
+        TSPacketFormat       _format[2];
+        size_t               _packet_size[2];
+        size_t               _part_index;
+        PacketCounter        _first_packet;
+        PacketCounter        _packet_count;
+        std::atomic<size_t>& _stop_part;
+        Report&              _report;
+
+        // Get the next packets of a file, directly in the mapped file when possible.
+        size_t nextPackets(TSFile& file, TSPacketVector& buffer, const TSPacket*& packets, size_t count);
+
+        // Record that a difference was found in this part.
+        void stopFollowingParts();
+
+        // Implementation of Thread.
+        virtual void main() override;
+    };
+}
+
+ts::PartComparator::PartComparator(TSCompareOptions& opt,
+                                   const TSPacketFormat format[2],
+                                   const size_t packet_size[2],
+                                   size_t part_index,
+                                   PacketCounter first_packet,
+                                   PacketCounter packet_count,
+                                   std::atomic<size_t>& stop_part,
+                                   Report& report) :
+    success(false),
+    differences(),
+    pid_count0(PID_MAX, 0),
+    pid_count1(PID_MAX, 0),
+    _opt(opt),
+    _format{format[0], format[1]},
+    _packet_size{packet_size[0], packet_size[1]},
+    _part_index(part_index),
+    _first_packet(first_packet),
+    _packet_count(packet_count),
+    _stop_part(stop_part),
+    _report(report)
+{
+}
+
+ts::PartComparator::~PartComparator()
+{
+    waitForTermination();
+}
+
+// Get the next packets of a file.
+size_t ts::PartComparator::nextPackets(TSFile& file, TSPacketVector& buffer, const TSPacket*& packets, size_t count)
+{
+    size_t mapped = count;
+    if (file.mapPackets(packets, mapped, _report)) {
+        return mapped;
+    }
+    buffer.resize(count);
+    packets = buffer.data();
+    return file.readPackets(buffer.data(), nullptr, count, _report);
+}
+
+// Record that a difference was found in this part.
+void ts::PartComparator::stopFollowingParts()
+{
+    size_t current = _stop_part.load();
+    while (_part_index < current && !_stop_part.compare_exchange_weak(current, _part_index)) {
+    }
+}
+
+// Thread main code.
+void ts::PartComparator::main()
+{
+    const bool stop_at_first = _opt.quiet || !_opt.continue_all;
+    TSFile file0;
+    TSFile file1;
+    file0.setIOFlags(_opt.mmap ? TSFile::MMAP : TSFile::NONE);
+    file1.setIOFlags(_opt.mmap ? TSFile::MMAP : TSFile::NONE);
+    success =
+        file0.openRead(_opt.filename0, 1, _opt.byte_offset + _first_packet * _packet_size[0], _report, _format[0]) &&
+        file1.openRead(_opt.filename1, 1, _opt.byte_offset + _first_packet * _packet_size[1], _report, _format[1]);
+
+    TSPacketVector buffer0;
+    TSPacketVector buffer1;
+    PacketCounter done = 0;
+    while (success && done < _packet_count && _stop_part.load() > _part_index) {
+        const TSPacket* pkts0 = nullptr;
+        const TSPacket* pkts1 = nullptr;
+        const size_t max_count = size_t(std::min<PacketCounter>(PART_CHUNK_PACKETS, _packet_count - done));
+        const size_t count = std::min(nextPackets(file0, buffer0, pkts0, max_count), nextPackets(file1, buffer1, pkts1, max_count));
+        if (count < max_count) {
+            _report.error(u"error reading packets %'d to %'d", {_first_packet + done, _first_packet + done + max_count - 1});
+            success = false;
+        }
+        size_t i = 0;
+        while (i < count) {
+            // Skip identical packets, which are the general case, just count them in their PID.
+            for (const size_t end = i + TSPacket::FindDifferentPacket(pkts0 + i, pkts1 + i, count - i); i < end; ++i) {
+                pid_count0[pkts0[i].getPID()]++;
+                pid_count1[pkts1[i].getPID()]++;
+            }
+            if (i < count) {
+                // The packets are binary different, check if they are different according to the options.
+                const PacketComparator comp(pkts0[i], pkts1[i], _opt);
+                if (!comp.equal) {
+                    differences.push_back({_first_packet + done + i, {pkts0[i], pkts1[i]}, {pid_count0[pkts0[i].getPID()], pid_count1[pkts1[i].getPID()]}});
+                    if (stop_at_first) {
+                        stopFollowingParts();
+                        return;
+                    }
+                }
+                pid_count0[pkts0[i].getPID()]++;
+                pid_count1[pkts1[i].getPID()]++;
+                ++i;
+            }
+        }
+        done += count;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // File comparator class
 //----------------------------------------------------------------------------
@@ -569,10 +759,16 @@ namespace ts {
         json::Object      _jroot;
         PacketCounter     _diff_count;
 
+        // Compare the files sequentially or in parallel. Return false if parallel comparison is not possible.
+        void compareSequential();
+        bool compareParallel();
+
         void displayHeader();
-        void displayFinal();
-        void displayOneDifference(const PacketComparator& comp, PacketCounter index0, PacketCounter index1);
-        void displayTruncated(size_t file_index, const FileToCompare& file);
+        void displayFinal(PacketCounter packets0, PacketCounter packets1);
+        void displayOneDifference(const PacketComparator& comp, PacketCounter index,
+                                  const TSPacket& pkt0, PacketCounter index_in_pid0,
+                                  const TSPacket& pkt1, PacketCounter index_in_pid1);
+        void displayTruncated(size_t file_index, const FileToCompare& file, PacketCounter packets);
         void displayMissingChunk(size_t ref_file_index, FileToCompare& ref_file,
                                  size_t miss_file_index, FileToCompare& miss_file);
         void displayReorder(size_t file0_index, const FileToCompare& file0, PacketCounter packet_index0,
@@ -598,6 +794,18 @@ ts::FileComparator::FileComparator(TSCompareOptions& opt) :
 
     displayHeader();
 
+    // Read errors in parallel threads are not reported in _opt.
+    success = true;
+    if (_opt.threads < 2 || !compareParallel()) {
+        compareSequential();
+    }
+    success = success && _diff_count == 0 && _opt.valid() && !_opt.gotErrors();
+}
+
+
+// Compare the files sequentially, with optional search of reordered packets.
+void ts::FileComparator::compareSequential()
+{
     // Read and compare all packets in the files.
     // Stop at first difference in quiet mode (only report if equal) or not --continue.
     while (!_file0.eof() && !_file1.eof() && (_diff_count == 0 || (!_opt.quiet && _opt.continue_all))) {
@@ -659,7 +867,9 @@ ts::FileComparator::FileComparator(TSCompareOptions& opt) :
         }
         else {
             // Simply report a difference between packets.
-            displayOneDifference(comp, _file0.packetIndex(), _file1.packetIndex());
+            displayOneDifference(comp, _file0.packetIndex(),
+                                 _file0.packet(), _file0.countInPID(_file0.packetIndex()),
+                                 _file1.packet(), _file1.countInPID(_file1.packetIndex()));
             _file0.moveNext();
             _file1.moveNext();
         }
@@ -668,14 +878,89 @@ ts::FileComparator::FileComparator(TSCompareOptions& opt) :
     displayMissingChunk(0, _file0, 1, _file1);
     displayMissingChunk(1, _file1, 0, _file0);
     if (_file0.eof() && !_file1.eof()) {
-        displayTruncated(0, _file0);
+        displayTruncated(0, _file0, _file0.readPacketsCount());
     }
     else if (!_file0.eof() && _file1.eof()) {
-        displayTruncated(1, _file1);
+        displayTruncated(1, _file1, _file1.readPacketsCount());
     }
-    displayFinal();
+    displayFinal(_file0.readPacketsCount(), _file1.readPacketsCount());
+}
+
 
-    success = _diff_count == 0 && _opt.valid() && !_opt.gotErrors();
+// Compare the files in several parts in parallel.
+bool ts::FileComparator::compareParallel()
+{
+    // Only regular files, with a known size, can be split.
+    const int64_t file_size0 = _opt.filename0.empty() || _opt.filename0 == u"-" ? -1 : GetFileSize(_opt.filename0);
+    const int64_t file_size1 = _opt.filename1.empty() || _opt.filename1 == u"-" ? -1 : GetFileSize(_opt.filename1);
+    if (file_size0 <= 0 || file_size1 <= 0) {
+        _opt.verbose(u"input files are not regular files, comparing in one single thread");
+        return false;
+    }
+
+    // The packet format of the files was detected when the initial buffers were filled.
+    const TSPacketFormat format[2] = {_file0.packetFormat(), _file1.packetFormat()};
+    const size_t packet_size[2] = {_file0.packetSize(), _file1.packetSize()};
+    const PacketCounter packets0 = uint64_t(file_size0) <= _opt.byte_offset ? 0 : (uint64_t(file_size0) - _opt.byte_offset) / packet_size[0];
+    const PacketCounter packets1 = uint64_t(file_size1) <= _opt.byte_offset ? 0 : (uint64_t(file_size1) - _opt.byte_offset) / packet_size[1];
+
+    // Split the common range of packets in contiguous parts.
+    const PacketCounter total_packets = std::min(packets0, packets1);
+    const size_t part_count = size_t(std::max<PacketCounter>(1, std::min<PacketCounter>(_opt.threads, total_packets / MIN_PART_PACKETS)));
+    if (part_count < 2) {
+        _opt.verbose(u"input files are too small, comparing in one single thread");
+        return false;
+    }
+    _opt.verbose(u"comparing %'d packets in %d parallel threads", {total_packets, part_count});
+
+    // Messages from the comparison threads are serialized.
+    ReportFile<Mutex> report(std::cerr, _opt.maxSeverity());
+
+    // Start one thread per part. When stopping on the first difference, all parts after
+    // the first part with a difference are useless and are interrupted.
+    const bool stop_at_first = _opt.quiet || !_opt.continue_all;
+    std::atomic<size_t> stop_part(part_count);
+    std::vector<SafePtr<PartComparator>> parts(part_count);
+    const PacketCounter part_packets = total_packets / part_count;
+    for (size_t i = 0; i < part_count; ++i) {
+        const PacketCounter count = i + 1 < part_count ? part_packets : total_packets - i * part_packets;
+        parts[i] = new PartComparator(_opt, format, packet_size, i, i * part_packets, count, stop_part, report);
+        parts[i]->start();
+    }
+
+    // Report the differences in sequence. The index of packets in their PID are
+    // computed from the number of packets per PID in the preceding parts.
+    std::vector<PacketCounter> pid_base0(PID_MAX, 0);
+    std::vector<PacketCounter> pid_base1(PID_MAX, 0);
+    bool at_end = true;
+    for (size_t i = 0; i < part_count && (_diff_count == 0 || !stop_at_first); ++i) {
+        const PartComparator& part(*parts[i]);
+        parts[i]->waitForTermination();
+        success = success && part.success;
+        for (auto it = part.differences.begin(); it != part.differences.end() && (_diff_count == 0 || !stop_at_first); ++it) {
+            const PID pid0 = it->pkt[0].getPID();
+            const PID pid1 = it->pkt[1].getPID();
+            const PacketComparator comp(it->pkt[0], it->pkt[1], _opt);
+            displayOneDifference(comp, it->index,
+                                 it->pkt[0], pid_base0[pid0] + it->index_in_pid[0],
+                                 it->pkt[1], pid_base1[pid1] + it->index_in_pid[1]);
+            at_end = !stop_at_first || it->index + 1 == total_packets;
+        }
+        for (PID pid = 0; pid < PID_MAX; ++pid) {
+            pid_base0[pid] += part.pid_count0[pid];
+            pid_base1[pid] += part.pid_count1[pid];
+        }
+    }
+
+    // Report a truncated file when the comparison reached the end of the shortest file.
+    if (at_end && packets0 < packets1) {
+        displayTruncated(0, _file0, packets0);
+    }
+    else if (at_end && packets0 > packets1) {
+        displayTruncated(1, _file1, packets1);
+    }
+    displayFinal(packets0, packets1);
+    return true;
 }
 
 
@@ -693,27 +978,27 @@ void ts::FileComparator::displayHeader()
 
 
 // Display final report.
-void ts::FileComparator::displayFinal()
+void ts::FileComparator::displayFinal(PacketCounter packets0, PacketCounter packets1)
 {
     if (_opt.json.useJSON()) {
         json::Value& jv0(_jroot.query(u"files[0]"));
-        jv0.add(u"packets", _file0.readPacketsCount());
+        jv0.add(u"packets", packets0);
         jv0.add(u"missing", _file0.missingPackets());
         jv0.add(u"holes", _file0.missingChunks());
         json::Value& jv1(_jroot.query(u"files[1]"));
-        jv1.add(u"packets", _file1.readPacketsCount());
+        jv1.add(u"packets", packets1);
         jv1.add(u"missing", _file1.missingPackets());
         jv1.add(u"holes", _file1.missingChunks());
         _jroot.query(u"summary", true).add(u"differences", _diff_count);
     }
     if (_opt.normalized) {
         std::cout << "file:file=1:filename=" << _file0.fileName()
-                  << ":packets=" << _file0.readPacketsCount()
+                  << ":packets=" << packets0
                   << ":missing=" << _file0.missingPackets()
                   << ":holes=" << _file0.missingChunks()
                   << ":" << std::endl;
         std::cout << "file:file=2:filename=" << _file1.fileName()
-                  << ":packets=" << _file1.readPacketsCount()
+                  << ":packets=" << packets1
                   << ":missing=" << _file1.missingPackets()
                   << ":holes=" << _file1.missingChunks()
                   << ":" << std::endl;
@@ -723,12 +1008,12 @@ void ts::FileComparator::displayFinal()
     else if (_opt.verbose() && !_opt.json.useFile()) {
         std::cout << "* Found " << UString::Decimal(_diff_count) << " differences" << std::endl;
         if (_file0.missingPackets() > 0) {
-            std::cout << "* " << _file0.fileName() << ", " << UString::Decimal(_file0.readPacketsCount()) << " packets, missing "
+            std::cout << "* " << _file0.fileName() << ", " << UString::Decimal(packets0) << " packets, missing "
                       << UString::Decimal(_file0.missingPackets()) << " packets in " << UString::Decimal(_file0.missingChunks()) << " holes"
                       << std::endl;
         }
         if (_file1.missingPackets() > 0) {
-            std::cout << "* " << _file1.fileName() << ", " << UString::Decimal(_file1.readPacketsCount()) << " packets, missing "
+            std::cout << "* " << _file1.fileName() << ", " << UString::Decimal(packets1) << " packets, missing "
                       << UString::Decimal(_file1.missingPackets()) << " packets in " << UString::Decimal(_file1.missingChunks()) << " holes"
                       << std::endl;
         }
@@ -740,21 +1025,19 @@ void ts::FileComparator::displayFinal()
 
 
 // Report a difference in a packet.
-void ts::FileComparator::displayOneDifference(const PacketComparator& comp, PacketCounter index0, PacketCounter index1)
+void ts::FileComparator::displayOneDifference(const PacketComparator& comp, PacketCounter index,
+                                              const TSPacket& pkt0, PacketCounter index_in_pid0,
+                                              const TSPacket& pkt1, PacketCounter index_in_pid1)
 {
     _diff_count++;
 
-    const TSPacket& pkt0(_file0.packet(index0));
-    const TSPacket& pkt1(_file1.packet(index1));
     const PID pid0 = pkt0.getPID();
     const PID pid1 = pkt1.getPID();
-    const PacketCounter index_in_pid0 = _file0.countInPID(index0);
-    const PacketCounter index_in_pid1 = _file1.countInPID(index1);
 
     if (_opt.json.useJSON()) {
         json::Value& jv(_jroot.query(u"events[]", true));
         jv.add(u"type", u"difference");
-        jv.add(u"packet", index0);
+        jv.add(u"packet", index);
         jv.add(u"payload-only", json::Bool(_opt.payload_only));
         jv.add(u"offset", comp.first_diff);
         jv.add(u"end-offset", comp.end_diff);
@@ -768,7 +1051,7 @@ void ts::FileComparator::displayOneDifference(const PacketComparator& comp, Pack
         jv.add(u"same-index", json::Bool(index_in_pid0 == index_in_pid1));
     }
     if (_opt.normalized) {
-        std::cout << "diff:packet=" << index0
+        std::cout << "diff:packet=" << index
                   << (_opt.payload_only ? ":payload" : "")
                   << ":offset=" << comp.first_diff
                   << ":endoffset=" << comp.end_diff
@@ -783,7 +1066,7 @@ void ts::FileComparator::displayOneDifference(const PacketComparator& comp, Pack
                   << ":" << std::endl;
     }
     else if (!_opt.quiet && !_opt.json.useFile()) {
-        std::cout << "* Packet " << UString::Decimal(index0) << " differ at offset " << comp.first_diff;
+        std::cout << "* Packet " << UString::Decimal(index) << " differ at offset " << comp.first_diff;
         if (_opt.payload_only) {
             std::cout << " in payload";
         }
@@ -815,19 +1098,19 @@ void ts::FileComparator::displayOneDifference(const PacketComparator& comp, Pack
 
 
 // Report a truncated file.
-void ts::FileComparator::displayTruncated(size_t file_index, const FileToCompare& file)
+void ts::FileComparator::displayTruncated(size_t file_index, const FileToCompare& file, PacketCounter packets)
 {
     if (_opt.json.useJSON()) {
         json::Value& jv(_jroot.query(u"events[]", true));
         jv.add(u"type", u"truncated");
-        jv.add(u"packet", file.readPacketsCount());
+        jv.add(u"packet", packets);
         jv.add(u"file-index", file_index);
     }
     if (_opt.normalized) {
-        std::cout << "truncated:file=" << file_index << ":packet=" << file.readPacketsCount() << ":filename=" << file.fileName() << ":" << std::endl;
+        std::cout << "truncated:file=" << file_index << ":packet=" << packets << ":filename=" << file.fileName() << ":" << std::endl;
     }
     else if (!_opt.quiet && !_opt.json.useFile()) {
-        std::cout << "* Packet " << UString::Decimal(file.readPacketsCount()) << ": file " << file.fileName() << " is truncated" << std::endl;
+        std::cout << "* Packet " << UString::Decimal(packets) << ": file " << file.fileName() << " is truncated" << std::endl;
     }
     _diff_count++;
 }
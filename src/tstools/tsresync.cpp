@@ -36,7 +36,7 @@
 #include "tsOutputRedirector.h"
 #include "tsByteBlock.h"
 #include "tsFatal.h"
-#include "tsTS.h"
+#include "tsTSPacket.h"
 TS_MAIN(MainCode);
 
 #define MIN_SYNC_SIZE       (1024)              // 1 kB
@@ -159,11 +159,12 @@ public:
     }
 
     // Look for MPEG packets in a buffer, according to an assumed packet size.
-    // If the complete buffer matches the packet size, set input and output packet
-    // sizes and return true. Return false otherwise.
-    bool checkSync(const uint8_t* buf, size_t buf_size, size_t pkt_size, size_t header_size);
+    // Search the first index in the buffer where search_size bytes match the packet size.
+    // If found before 'limit', set input and output packet sizes, set 'limit' to the
+    // found index and return true. Return false otherwise.
+    bool findSync(const uint8_t* buf, size_t buf_size, size_t search_size, size_t pkt_size, size_t header_size, size_t& limit);
 
-    // Get packet sizes, as determined by checkSync(). Size is zero if no valid packet size found.
+    // Get packet sizes, as determined by findSync(). Size is zero if no valid packet size found.
     size_t inputPacketSize() const {return _in_pkt_size;}
     size_t inputHeaderSize() const {return _in_header_size;}
     size_t outputPacketSize() const {return _out_pkt_size;}
@@ -254,20 +255,21 @@ bool Resynchronizer::writePacket(const uint8_t* input_packet)
 //  Look for MPEG packets in a buffer, according to an assumed packet size.
 //----------------------------------------------------------------------------
 
-bool Resynchronizer::checkSync(const uint8_t* buf, size_t buf_size, size_t pkt_size, size_t header_size)
+bool Resynchronizer::findSync(const uint8_t* buf, size_t buf_size, size_t search_size, size_t pkt_size, size_t header_size, size_t& limit)
 {
     assert(pkt_size >= header_size + ts::PKT_SIZE);
-    const uint8_t* end = buf + buf_size - pkt_size + 1;
-
-    // Check if the buffer contains packets with the appropriate size
-    while (buf < end) {
-        if (buf[header_size] != ts::SYNC_BYTE) {
-            return false; // not found
-        }
-        buf += pkt_size;
+    assert(search_size <= buf_size);
+
+    // All packets which start in the search area must have a sync byte. The search area may start
+    // at any index up to buf_size - search_size. All candidate indexes are checked in one pass.
+    const size_t count = search_size / pkt_size;
+    const size_t index = count == 0 ? 0 : ts::TSPacket::FindSync(buf, buf_size - search_size + count * pkt_size, count, pkt_size, header_size);
+    if (index == ts::NPOS || index >= limit) {
+        return false; // not found or not better than a previous packet size
     }
 
-    // Packets found all along the buffer
+    // Packets found all along the search area
+    limit = index;
     _in_pkt_size = pkt_size;
     _in_header_size = header_size;
     _out_pkt_size = _keep_packet_size ? pkt_size : ts::PKT_SIZE;
@@ -313,37 +315,27 @@ int MainCode(int argc, char *argv[])
 
         // Look for a range of packets for at least --min-contiguous bytes
         size_t const search_size = std::min(opt.contig_size, sync_size);
-        uint8_t* const end_search = sync_end - search_size + 1;
-
-        // Search a range of valid packets. Try all expected packet sizes.
-        const uint8_t* start;
-        for (start = sync_buf; start < end_search; start++) {
-            if (opt.packet_size > 0) {
-                if (resync.checkSync(start, search_size, opt.packet_size, opt.header_size)) {
-                    // Found user-specified encapsulation of TS packets
-                    break;
-                }
-            }
-            else {
-                if (resync.checkSync(start, search_size, ts::PKT_SIZE, 0)) {
-                    // Found standard TS packets
-                    break;
-                }
-                if (resync.checkSync(start, search_size, ts::PKT_RS_SIZE, 0)) {
-                    // Found TS packets with trailing Reed-Solomon outer FEC
-                    break;
-                }
-                if (resync.checkSync(start, search_size, ts::PKT_M2TS_SIZE, ts::M2TS_HEADER_SIZE)) {
-                    // Found TS packets with leading 4-byte timestamp (M2TS format, blu-ray discs)
-                    break;
-                }
-            }
+
+        // Search the first range of valid packets. Try all expected packet sizes.
+        size_t sync_index = ts::NPOS;
+        if (opt.packet_size > 0) {
+            // User-specified encapsulation of TS packets
+            resync.findSync(sync_buf, sync_size, search_size, opt.packet_size, opt.header_size, sync_index);
+        }
+        else {
+            // Standard TS packets
+            resync.findSync(sync_buf, sync_size, search_size, ts::PKT_SIZE, 0, sync_index);
+            // TS packets with trailing Reed-Solomon outer FEC
+            resync.findSync(sync_buf, sync_size, search_size, ts::PKT_RS_SIZE, 0, sync_index);
+            // TS packets with leading 4-byte timestamp (M2TS format, blu-ray discs)
+            resync.findSync(sync_buf, sync_size, search_size, ts::PKT_M2TS_SIZE, ts::M2TS_HEADER_SIZE, sync_index);
         }
         if (resync.inputPacketSize() == 0) {
             std::cerr << "* Cannot find MPEG TS packets after " << ts::UString::Decimal(search_size) << " bytes" << std::endl;
             resync.setStatus (RS_ERROR);
             break;
         }
+        const uint8_t* start = sync_buf + sync_index;
         if (opt.verbose()) {
             std::cerr << "* Found synchronization after " << ts::UString::Decimal(start - sync_buf) << " bytes" << std::endl
                       << "* Packet size is " << resync.inputPacketSize() << " bytes";
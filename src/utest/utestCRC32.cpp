@@ -0,0 +1,209 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for CRC32 class.
+//
+//----------------------------------------------------------------------------
+
+#include "tsCRC32.h"
+#include "tsByteBlock.h"
+#include "tsMonotonic.h"
+#include "tsSysUtils.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class CRC32Test: public tsunit::Test
+{
+public:
+    CRC32Test();
+
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testReference();
+    void testEngines();
+    void testIncremental();
+    void testBenchmark();
+
+    TSUNIT_TEST_BEGIN(CRC32Test);
+    TSUNIT_TEST(testReference);
+    TSUNIT_TEST(testEngines);
+    TSUNIT_TEST(testIncremental);
+    TSUNIT_TEST(testBenchmark);
+    TSUNIT_TEST_END();
+private:
+    ts::ByteBlock _data;
+};
+
+TSUNIT_REGISTER(CRC32Test);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+CRC32Test::CRC32Test() :
+    _data()
+{
+}
+
+// Test suite initialization method.
+void CRC32Test::beforeTest()
+{
+    // Deterministic pseudo-random data, larger than the largest PSI section.
+    _data.resize(64 * 1024 + 37);
+    uint32_t seed = 0x12345678;
+    for (size_t i = 0; i < _data.size(); ++i) {
+        seed = seed * 1103515245 + 12345;
+        _data[i] = uint8_t(seed >> 16);
+    }
+}
+
+// Test suite cleanup method.
+void CRC32Test::afterTest()
+{
+}
+
+namespace {
+    const ts::CRC32::Engine allEngines[] = {
+        ts::CRC32::Engine::DEFAULT,
+        ts::CRC32::Engine::BYTEWISE,
+        ts::CRC32::Engine::SLICING,
+        ts::CRC32::Engine::FOLDING,
+    };
+
+    const char* engineName(ts::CRC32::Engine engine)
+    {
+        switch (engine) {
+            case ts::CRC32::Engine::DEFAULT: return "default";
+            case ts::CRC32::Engine::BYTEWISE: return "bytewise";
+            case ts::CRC32::Engine::SLICING: return "slicing-by-8";
+            case ts::CRC32::Engine::FOLDING: return "folding";
+            default: return "?";
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void CRC32Test::testReference()
+{
+    // Standard check value of CRC-32/MPEG-2.
+    static const char check[] = "123456789";
+    TSUNIT_EQUAL(0x0376E6E7, ts::CRC32(check, 9).value());
+    TSUNIT_EQUAL(0xFFFFFFFF, ts::CRC32(check, 0).value());
+
+    // A data area followed by its CRC32 (as in a section) has a zero CRC32.
+    ts::ByteBlock sec(_data.data(), 1000);
+    sec.appendUInt32(ts::CRC32(sec.data(), sec.size()).value());
+    TSUNIT_EQUAL(0, ts::CRC32(sec.data(), sec.size()).value());
+}
+
+void CRC32Test::testEngines()
+{
+    TSUNIT_ASSERT(ts::CRC32::IsSupported(ts::CRC32::Engine::DEFAULT));
+    TSUNIT_ASSERT(ts::CRC32::IsSupported(ts::CRC32::Engine::BYTEWISE));
+    TSUNIT_ASSERT(ts::CRC32::IsSupported(ts::CRC32::Engine::SLICING));
+    debug() << "CRC32Test: folding engine supported: " << ts::UString::YesNo(ts::CRC32::IsSupported(ts::CRC32::Engine::FOLDING)) << std::endl;
+
+    // All engines on all sizes up to a few blocks and all alignments.
+    for (size_t offset = 0; offset < 16; ++offset) {
+        for (size_t size = 0; size <= 300; ++size) {
+            ts::CRC32 ref;
+            ref.add(&_data[offset], size, ts::CRC32::Engine::BYTEWISE);
+            for (auto engine : allEngines) {
+                ts::CRC32 crc;
+                crc.add(&_data[offset], size, engine);
+                TSUNIT_EQUAL(ref.value(), crc.value());
+            }
+        }
+    }
+
+    // All engines on a large area.
+    ts::CRC32 ref;
+    ref.add(_data.data(), _data.size(), ts::CRC32::Engine::BYTEWISE);
+    for (auto engine : allEngines) {
+        ts::CRC32 crc;
+        crc.add(_data.data(), _data.size(), engine);
+        TSUNIT_EQUAL(ref.value(), crc.value());
+    }
+}
+
+void CRC32Test::testIncremental()
+{
+    const ts::CRC32 ref(_data.data(), _data.size());
+
+    // Split the data area at various points, mixing engines.
+    for (size_t split = 0; split < 1000; split += 7) {
+        for (auto engine : allEngines) {
+            ts::CRC32 crc;
+            crc.add(_data.data(), split, engine);
+            crc.add(_data.data() + split, _data.size() - split);
+            TSUNIT_EQUAL(ref.value(), crc.value());
+        }
+    }
+}
+
+void CRC32Test::testBenchmark()
+{
+    if (!ts::EnvironmentExists(u"UTEST_BENCHMARK_ALLOWED")) {
+        debug() << "CRC32Test: benchmark skipped, define UTEST_BENCHMARK_ALLOWED to run it" << std::endl;
+        return;
+    }
+
+    // Typical section sizes: short PSI, EIT, max long section.
+    static const size_t sizes[] = {64, 1024, 4096};
+    const size_t total = 16 * 1024 * 1024;
+
+    for (auto size : sizes) {
+        for (auto engine : allEngines) {
+            if (ts::CRC32::IsSupported(engine)) {
+                ts::CRC32 crc;
+                ts::Monotonic start(true);
+                for (size_t done = 0; done < total; done += size) {
+                    crc.reset();
+                    crc.add(_data.data(), size, engine);
+                }
+                const ts::NanoSecond duration = ts::Monotonic(true) - start;
+                std::cerr << "CRC32Test: " << engineName(engine) << ", " << size << "-byte areas, "
+                          << (duration <= 0 ? 0 : (total * ts::NanoSecPerSec) / (size_t(duration) * 1024 * 1024)) << " MB/s"
+                          << std::endl;
+            }
+        }
+    }
+}
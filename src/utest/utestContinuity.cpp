@@ -33,6 +33,8 @@
 
 #include "tsContinuityAnalyzer.h"
 #include "tsReportBuffer.h"
+#include "tsMonotonic.h"
+#include "tsSysUtils.h"
 #include "tsunit.h"
 
 
@@ -48,10 +50,14 @@ public:
 
     void testAnalyze();
     void testFix();
+    void testPIDState();
+    void testBenchmark();
 
     TSUNIT_TEST_BEGIN(ContinuityTest);
     TSUNIT_TEST(testAnalyze);
     TSUNIT_TEST(testFix);
+    TSUNIT_TEST(testPIDState);
+    TSUNIT_TEST(testBenchmark);
     TSUNIT_TEST_END();
 };
 
@@ -235,3 +241,90 @@ void ContinuityTest::testFix()
     TSUNIT_EQUAL(2, fixer.errorCount());
     TSUNIT_EQUAL(5, fixer.fixCount());
 }
+
+void ContinuityTest::testPIDState()
+{
+    ts::ContinuityAnalyzer fixer(ts::AllPIDs);
+
+    TSUNIT_EQUAL(ts::INVALID_CC, fixer.firstCC(100));
+    TSUNIT_EQUAL(ts::INVALID_CC, fixer.lastCC(100));
+    TSUNIT_EQUAL(ts::NPOS, fixer.dupCount(100));
+    TSUNIT_ASSERT(fixer.lastPacket(100) == ts::NullPacket);
+
+    ts::TSPacket pkt(ts::NullPacket);
+    pkt.setPID(100); pkt.setCC(7); pkt.b[10] = 0x10;
+    TSUNIT_ASSERT(fixer.feedPacket(pkt));
+    pkt.setPID(200); pkt.setCC(2); pkt.b[10] = 0x20;
+    TSUNIT_ASSERT(fixer.feedPacket(pkt));
+    pkt.setPID(100); pkt.setCC(8); pkt.b[10] = 0x11;
+    TSUNIT_ASSERT(fixer.feedPacket(pkt));
+    pkt.setPID(100); pkt.setCC(8); pkt.b[10] = 0x11;
+    TSUNIT_ASSERT(fixer.feedPacket(pkt));
+
+    TSUNIT_EQUAL(7, fixer.firstCC(100));
+    TSUNIT_EQUAL(8, fixer.lastCC(100));
+    TSUNIT_EQUAL(1, fixer.dupCount(100));
+    TSUNIT_EQUAL(0x11, fixer.lastPacket(100).b[10]);
+    TSUNIT_EQUAL(2, fixer.firstCC(200));
+    TSUNIT_EQUAL(2, fixer.lastCC(200));
+    TSUNIT_EQUAL(0, fixer.dupCount(200));
+    TSUNIT_EQUAL(0x20, fixer.lastPacket(200).b[10]);
+    TSUNIT_EQUAL(ts::INVALID_CC, fixer.firstCC(300));
+
+    // Same CC and different content is not a duplicate.
+    pkt.setPID(200); pkt.setCC(2); pkt.b[10] = 0x21;
+    TSUNIT_ASSERT(!fixer.feedPacket(pkt));
+    TSUNIT_EQUAL(0, fixer.dupCount(200));
+
+    // A removed PID forgets its state, including when it comes back.
+    fixer.removePID(100);
+    TSUNIT_EQUAL(ts::INVALID_CC, fixer.firstCC(100));
+    TSUNIT_EQUAL(ts::NPOS, fixer.dupCount(100));
+    TSUNIT_ASSERT(fixer.lastPacket(100) == ts::NullPacket);
+    TSUNIT_EQUAL(2, fixer.firstCC(200));
+
+    fixer.addPID(100);
+    pkt.setPID(100); pkt.setCC(3); pkt.b[10] = 0x12;
+    TSUNIT_ASSERT(fixer.feedPacket(pkt));
+    TSUNIT_EQUAL(3, fixer.firstCC(100));
+    TSUNIT_EQUAL(0x12, fixer.lastPacket(100).b[10]);
+
+    // Reset forgets all PID's.
+    fixer.reset();
+    TSUNIT_EQUAL(ts::INVALID_CC, fixer.firstCC(100));
+    TSUNIT_EQUAL(ts::INVALID_CC, fixer.firstCC(200));
+    TSUNIT_EQUAL(0, fixer.totalPackets());
+}
+
+void ContinuityTest::testBenchmark()
+{
+    if (!ts::EnvironmentExists(u"UTEST_BENCHMARK_ALLOWED")) {
+        debug() << "ContinuityTest: benchmark skipped, define UTEST_BENCHMARK_ALLOWED to run it" << std::endl;
+        return;
+    }
+
+    // Ten seconds of a 100 Mb/s stream (66,489 packets/s), all PID's active in turn.
+    const size_t count = 664893;
+    const size_t pid_count = 1000;
+
+    ts::TSPacket pkt(ts::NullPacket);
+    ts::ContinuityAnalyzer fixer(ts::AllPIDs);
+    fixer.setFix(true);
+    uint8_t cc[pid_count];
+    TS_ZERO(cc);
+
+    ts::Monotonic start(true);
+    for (size_t i = 0; i < count; ++i) {
+        const size_t index = (i * 7) % pid_count;
+        pkt.setPID(ts::PID(32 + index));
+        pkt.setCC(cc[index]++ & ts::CC_MASK);
+        fixer.feedPacket(pkt);
+    }
+    const ts::NanoSecond duration = std::max<ts::NanoSecond>(1, ts::Monotonic(true) - start);
+
+    TSUNIT_EQUAL(count, fixer.processedPackets());
+    TSUNIT_EQUAL(0, fixer.errorCount());
+    std::cerr << "ContinuityTest: " << count << " packets, " << pid_count << " PID's, "
+              << (uint64_t(count) * ts::NanoSecPerSec / uint64_t(duration)) << " packets/s"
+              << std::endl;
+}
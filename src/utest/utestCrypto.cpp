@@ -85,6 +85,8 @@ public:
     void testAES_CTS3();
     void testAES_CTS4();
     void testAES_DVS042();
+    void testAES_Blocks();
+    void testAES_Batches();
     void testDES();
     void testTDES();
     void testTDES_CBC();
@@ -107,6 +109,8 @@ public:
     TSUNIT_TEST(testAES_CTS3);
     TSUNIT_TEST(testAES_CTS4);
     TSUNIT_TEST(testAES_DVS042);
+    TSUNIT_TEST(testAES_Blocks);
+    TSUNIT_TEST(testAES_Batches);
     TSUNIT_TEST(testDES);
     TSUNIT_TEST(testTDES);
     TSUNIT_TEST(testTDES_CBC);
@@ -412,6 +416,121 @@ void CryptoTest::testAES_DVS042()
     testChainingSizes(dvs042_aes, 16, 17, 23, 31, 32, 33, 45, 64, 67, 184, 12345, 0);
 }
 
+void CryptoTest::testAES_Blocks()
+{
+    debug() << "CryptoTest: AES accelerated instructions: " << ts::UString::YesNo(ts::AES::IsAccelerated()) << std::endl;
+
+    // Multi-block encryption of the same test vector in all blocks, all counts around the internal batches.
+    ts::AES aes;
+    const size_t tv_count = sizeof(tv_aes) / sizeof(TV_AES);
+    for (size_t tvi = 0; tvi < tv_count; ++tvi) {
+        const TV_AES* tv = tv_aes + tvi;
+        TSUNIT_ASSERT(aes.setKey(tv->key, tv->key_size));
+        for (size_t count = 0; count <= 20; ++count) {
+            ts::ByteBlock plain, cipher, buf1, buf2(count * ts::AES::BLOCK_SIZE);
+            for (size_t i = 0; i < count; ++i) {
+                plain.append(tv->plain, sizeof(tv->plain));
+                cipher.append(tv->cipher, sizeof(tv->cipher));
+            }
+            // Separate buffers.
+            TSUNIT_ASSERT(aes.encryptBlocks(plain.data(), buf2.data(), count));
+            TSUNIT_ASSERT(buf2 == cipher);
+            TSUNIT_ASSERT(aes.decryptBlocks(cipher.data(), buf2.data(), count));
+            TSUNIT_ASSERT(buf2 == plain);
+            // In place.
+            buf1 = plain;
+            TSUNIT_ASSERT(aes.encryptBlocks(buf1.data(), buf1.data(), count));
+            TSUNIT_ASSERT(buf1 == cipher);
+            TSUNIT_ASSERT(aes.decryptBlocks(buf1.data(), buf1.data(), count));
+            TSUNIT_ASSERT(buf1 == plain);
+        }
+    }
+
+    // Default implementation in other block ciphers.
+    ts::DES des;
+    const TV_DES* tv = tv_des;
+    TSUNIT_ASSERT(des.setKey(tv->key, sizeof(tv->key)));
+    ts::ByteBlock plain, cipher, buf;
+    for (size_t i = 0; i < 5; ++i) {
+        plain.append(tv->plain, sizeof(tv->plain));
+        cipher.append(tv->cipher, sizeof(tv->cipher));
+    }
+    buf = plain;
+    TSUNIT_ASSERT(des.encryptBlocks(buf.data(), buf.data(), 5));
+    TSUNIT_ASSERT(buf == cipher);
+    TSUNIT_ASSERT(des.decryptBlocks(buf.data(), buf.data(), 5));
+    TSUNIT_ASSERT(buf == plain);
+
+    // Each block counts as one use of the key.
+    TSUNIT_EQUAL(5, des.encryptionCount());
+    TSUNIT_EQUAL(5, des.decryptionCount());
+    des.setEncryptionMax(8);
+    TSUNIT_ASSERT(!des.encryptBlocks(buf.data(), buf.data(), 5));
+    TSUNIT_ASSERT(buf == plain);
+    TSUNIT_EQUAL(5, des.encryptionCount());
+    TSUNIT_ASSERT(des.encryptBlocks(buf.data(), buf.data(), 3));
+    TSUNIT_EQUAL(8, des.encryptionCount());
+    TSUNIT_ASSERT(!des.encryptBlocks(buf.data(), buf.data(), 1));
+    TSUNIT_EQUAL(8, des.encryptionCount());
+}
+
+void CryptoTest::testAES_Batches()
+{
+    // Chaining modes which process blocks by batches, on sizes around the batch size.
+    ts::CBC<ts::AES> cbc_aes;
+    testChainingSizes(cbc_aes, 16, 32, 176, 256, 272, 512, 4096, 0);
+    ts::CTR<ts::AES> ctr_aes;
+    testChainingSizes(ctr_aes, 1, 16, 17, 184, 255, 256, 257, 12345, 0);
+    ts::DVS042<ts::AES> dvs042_aes;
+    testChainingSizes(dvs042_aes, 255, 256, 257, 4100, 0);
+
+    // Reference data.
+    ts::SystemRandomGenerator prng;
+    uint8_t key[16], iv[16];
+    ts::ByteBlock plain(1000);
+    TSUNIT_ASSERT(prng.read(key, sizeof(key)));
+    TSUNIT_ASSERT(prng.read(iv, sizeof(iv)));
+    TSUNIT_ASSERT(prng.read(plain.data(), plain.size()));
+    iv[8] = iv[9] = iv[10] = iv[11] = 0xFF; // force a carry in the counter part
+
+    // Reference CTR encryption, block per block, with a 64-bit counter.
+    ts::AES aes;
+    TSUNIT_ASSERT(aes.setKey(key, sizeof(key)));
+    ts::ByteBlock ref(plain.size());
+    uint8_t counter[16], mask[16];
+    ::memcpy(counter, iv, sizeof(counter));
+    for (size_t i = 0; i < plain.size(); i += 16) {
+        TSUNIT_ASSERT(aes.encrypt(counter, 16, mask, 16));
+        for (size_t j = 0; j < 16 && i + j < plain.size(); ++j) {
+            ref[i + j] = plain[i + j] ^ mask[j];
+        }
+        ts::PutUInt64(counter + 8, ts::GetUInt64(counter + 8) + 1);
+    }
+    ts::ByteBlock buf(plain.size());
+    TSUNIT_ASSERT(ctr_aes.setKey(key, sizeof(key)));
+    TSUNIT_ASSERT(ctr_aes.setIV(iv, sizeof(iv)));
+    TSUNIT_ASSERT(ctr_aes.encrypt(plain.data(), plain.size(), buf.data(), buf.size()));
+    TSUNIT_ASSERT(buf == ref);
+
+    // Reference CBC decryption, block per block, compared with in-place batched decryption.
+    plain.resize(992);
+    ref.resize(plain.size());
+    const uint8_t* previous = iv;
+    for (size_t i = 0; i < plain.size(); i += 16) {
+        TSUNIT_ASSERT(aes.decrypt(&plain[i], 16, &ref[i], 16));
+        for (size_t j = 0; j < 16; ++j) {
+            ref[i + j] ^= previous[j];
+        }
+        previous = &plain[i];
+    }
+    TSUNIT_ASSERT(cbc_aes.setKey(key, sizeof(key)));
+    TSUNIT_ASSERT(cbc_aes.setIV(iv, sizeof(iv)));
+    buf = plain;
+    TSUNIT_ASSERT(cbc_aes.decrypt(buf.data(), buf.size(), buf.data(), buf.size()));
+    TSUNIT_ASSERT(buf == ref);
+}
+
+
 void CryptoTest::testDES()
 {
     ts::DES des;
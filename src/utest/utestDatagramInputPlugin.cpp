@@ -0,0 +1,301 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::AbstractDatagramInputPlugin
+//
+//----------------------------------------------------------------------------
+
+#include "tsAbstractDatagramInputPlugin.h"
+#include "tsPluginRepository.h"
+#include "tsPluginEventHandlerInterface.h"
+#include "tsPluginEventData.h"
+#include "tsTSProcessor.h"
+#include "tsIPProtocols.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class DatagramInputPluginTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testBatchDirect();
+    void testBatchSplit();
+    void testBatchSmallBuffer();
+
+    TSUNIT_TEST_BEGIN(DatagramInputPluginTest);
+    TSUNIT_TEST(testBatchDirect);
+    TSUNIT_TEST(testBatchSplit);
+    TSUNIT_TEST(testBatchSmallBuffer);
+    TSUNIT_TEST_END();
+
+private:
+    // Receive the test datagrams and check the output packets.
+    void receive(size_t max_input_packets);
+};
+
+TSUNIT_REGISTER(DatagramInputPluginTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void DatagramInputPluginTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void DatagramInputPluginTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Test datagrams and expected packets.
+//----------------------------------------------------------------------------
+
+namespace {
+    class TestData
+    {
+    public:
+        std::vector<ts::ByteBlock> datagrams;
+        ts::TSPacketVector packets;
+
+        TestData();
+
+    private:
+        // Add a datagram: header bytes, packets, trailing bytes.
+        void add(size_t header_size, size_t packet_count, size_t trailer_size);
+    };
+
+    TestData::TestData() :
+        datagrams(),
+        packets()
+    {
+        add(0, 7, 0);     // standard datagram, directly received in the tsp buffer
+        add(12, 7, 0);    // RTP header, the last packet is in the second segment
+        add(0, 14, 0);    // larger than 7 packets, reassembled from the two segments
+        add(0, 7, 100);   // partial trailing packet, spans the two segments
+        add(0, 3, 50);    // short datagram with partial trailing packet
+        add(0, 0, 60);    // no TS packet at all
+        add(12, 20, 0);   // RTP header, larger than 7 packets
+        add(0, 1, 0);     // one single packet
+        add(0, 7, 0);     // standard datagram
+    }
+
+    void TestData::add(size_t header_size, size_t packet_count, size_t trailer_size)
+    {
+        ts::ByteBlock dgram(header_size, 0x00);
+        if (header_size >= 12) {
+            dgram[0] = 0x80;    // RTP version 2
+            dgram[1] = 33;      // RTP payload type for MPEG-2 TS
+        }
+        for (size_t i = 0; i < packet_count; ++i) {
+            // Each packet is unique: the payload contains the packet index.
+            ts::TSPacket pkt;
+            pkt.init(100, uint8_t(packets.size() & 0x0F));
+            ts::PutUInt32(pkt.getPayload(), uint32_t(packets.size()));
+            packets.push_back(pkt);
+            dgram.append(pkt.b, ts::PKT_SIZE);
+        }
+        // Trailing bytes without sync byte.
+        dgram.append(ts::ByteBlock(trailer_size, 0xA5));
+        datagrams.push_back(dgram);
+    }
+
+    const TestData& Data()
+    {
+        static const TestData data;
+        return data;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// A test input plugin which receives the test datagrams in batches.
+//----------------------------------------------------------------------------
+
+namespace {
+    class TestInputPlugin : public ts::AbstractDatagramInputPlugin
+    {
+        TS_NOBUILD_NOCOPY(TestInputPlugin);
+    public:
+        TestInputPlugin(ts::TSP*);
+        virtual bool start() override;
+        static ts::InputPlugin* CreateInstance(ts::TSP*);
+
+        // Max number of datagrams per batch.
+        static constexpr size_t BATCH_SIZE = 4;
+
+    protected:
+        virtual size_t getDatagramBatchSize() override;
+        virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, ts::MicroSecond& timestamp) override;
+        virtual bool receiveDatagrams(ts::UDPSocket::ReceiveBuffer* buffers, size_t& count) override;
+
+    private:
+        size_t _next;  // Index of next datagram to receive.
+    };
+}
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t TestInputPlugin::BATCH_SIZE;
+#endif
+
+TestInputPlugin::TestInputPlugin(ts::TSP* t) :
+    ts::AbstractDatagramInputPlugin(t, ts::IP_MAX_PACKET_SIZE, u"Test datagram input", u"", u"", u"", false),
+    _next(0)
+{
+}
+
+ts::InputPlugin* TestInputPlugin::CreateInstance(ts::TSP* t)
+{
+    return new TestInputPlugin(t);
+}
+
+bool TestInputPlugin::start()
+{
+    _next = 0;
+    return ts::AbstractDatagramInputPlugin::start();
+}
+
+size_t TestInputPlugin::getDatagramBatchSize()
+{
+    return BATCH_SIZE;
+}
+
+bool TestInputPlugin::receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, ts::MicroSecond& timestamp)
+{
+    // Not used in batched mode.
+    return false;
+}
+
+bool TestInputPlugin::receiveDatagrams(ts::UDPSocket::ReceiveBuffer* buffers, size_t& count)
+{
+    // Return as many datagrams as requested, scattered in the two segments of each buffer.
+    const std::vector<ts::ByteBlock>& datagrams(Data().datagrams);
+    count = std::min(count, datagrams.size() - _next);
+    for (size_t i = 0; i < count; ++i) {
+        const ts::ByteBlock& dgram(datagrams[_next++]);
+        ts::UDPSocket::ReceiveBuffer& rb(buffers[i]);
+        const size_t size1 = std::min(dgram.size(), rb.size1);
+        const size_t size2 = std::min(dgram.size() - size1, rb.size2);
+        ::memcpy(rb.data1, dgram.data(), size1);
+        if (size2 > 0) {
+            ::memcpy(rb.data2, dgram.data() + size1, size2);
+        }
+        rb.ret_size = size1 + size2;
+        rb.timestamp = -1;
+    }
+    // End of input after the last datagram.
+    return count > 0;
+}
+
+
+//----------------------------------------------------------------------------
+// An event handler for memory output plugin: fill a vector of packets.
+//----------------------------------------------------------------------------
+
+namespace {
+    class Output : public ts::PluginEventHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(Output);
+    public:
+        Output(ts::TSPacketVector& output) : _output(output) {}
+        virtual void handlePluginEvent(const ts::PluginEventContext& context) override;
+    private:
+        ts::TSPacketVector& _output;
+    };
+
+    void Output::handlePluginEvent(const ts::PluginEventContext& context)
+    {
+        ts::PluginEventData* data = dynamic_cast<ts::PluginEventData*>(context.pluginData());
+        if (data != nullptr) {
+            const size_t count = data->size() / ts::PKT_SIZE;
+            const size_t index = _output.size();
+            _output.resize(index + count);
+            ts::TSPacket::Copy(&_output[index], data->data(), count);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void DatagramInputPluginTest::receive(size_t max_input_packets)
+{
+    ts::PluginRepository::Instance()->registerInput(u"testdgram", TestInputPlugin::CreateInstance);
+
+    ts::TSPacketVector output;
+    Output handler(output);
+
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"DatagramInputPluginTest";
+    opt.max_input_pkt = max_input_packets;
+    opt.input = {u"testdgram", {}};
+    opt.output = {u"memory", {}};
+
+    ts::TSProcessor tsproc(CERR);
+    tsproc.registerEventHandler(&handler, ts::PluginType::OUTPUT);
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+
+    const ts::TSPacketVector& expected(Data().packets);
+    debug() << "DatagramInputPluginTest: max input packets: " << max_input_packets << ", expected: " << expected.size() << ", received: " << output.size() << std::endl;
+    TSUNIT_EQUAL(expected.size(), output.size());
+    for (size_t i = 0; i < expected.size() && i < output.size(); ++i) {
+        TSUNIT_ASSERT(output[i] == expected[i]);
+    }
+}
+
+void DatagramInputPluginTest::testBatchDirect()
+{
+    // Several datagrams per batch, directly received in the tsp buffer, then compacted.
+    receive(0);
+}
+
+void DatagramInputPluginTest::testBatchSplit()
+{
+    // One datagram per batch, large datagrams are split over several calls to receive().
+    receive(10);
+}
+
+void DatagramInputPluginTest::testBatchSmallBuffer()
+{
+    // Less than 7 packets in the tsp buffer, datagrams are received in the internal buffer.
+    receive(5);
+}
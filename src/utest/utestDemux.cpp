@@ -45,6 +45,8 @@
 #include "tsTOT.h"
 #include "tsTDT.h"
 #include "tsNames.h"
+#include "tsMonotonic.h"
+#include "tsSysUtils.h"
 #include "tsunit.h"
 
 #include "tables/psi_bat_cplus_packets.h"
@@ -92,6 +94,9 @@ public:
     void testTDT();
     void testTOT();
     void testHEVC();
+    void testManyTables();
+    void testBenchmark();
+    void testSectionRecycling();
 
     TSUNIT_TEST_BEGIN(DemuxTest);
     TSUNIT_TEST(testPAT);
@@ -105,6 +110,9 @@ public:
     TSUNIT_TEST(testTDT);
     TSUNIT_TEST(testTOT);
     TSUNIT_TEST(testHEVC);
+    TSUNIT_TEST(testManyTables);
+    TSUNIT_TEST(testBenchmark);
+    TSUNIT_TEST(testSectionRecycling);
     TSUNIT_TEST_END();
 
 private:
@@ -114,6 +122,9 @@ private:
     // Compare a vector of packets with the list of reference packets
     bool checkPackets(const char* test_name, const char* table_name, const ts::TSPacketVector& packets, const uint8_t* ref_packets, size_t ref_packets_size);
 
+    // Build a stream with many PSI PID's, EIT, ECM and DSM-CC like, return the number of tables.
+    size_t buildManyTables(ts::TSPacketVector& packets, uint8_t last_section, bool complete);
+
     // Unitary test for one table.
     void testTable(const char* name, const uint8_t* ref_packets, size_t ref_packets_size, const uint8_t* ref_sections, size_t ref_sections_size);
 };
@@ -489,3 +500,212 @@ void DemuxTest::testHEVC()
 {
     TEST_TABLE("PMT with HEVC descriptor", pmt_hevc);
 }
+
+namespace {
+    // A table handler which collects the PID's and ETID's of all tables.
+    class TableCollector: public ts::TableHandlerInterface
+    {
+    public:
+        std::vector<ts::PID> pids;
+        std::vector<ts::ETID> etids;
+        TableCollector() : pids(), etids() {}
+        virtual void handleTable(ts::SectionDemux&, const ts::BinaryTable& table) override
+        {
+            pids.push_back(table.sourcePID());
+            etids.push_back(table.isShortSection() ? ts::ETID(table.tableId()) : ts::ETID(table.tableId(), table.tableIdExtension()));
+        }
+    };
+
+    // A section handler which counts sections and keeps some of them, shared or copied.
+    class SectionCollector: public ts::SectionHandlerInterface
+    {
+    public:
+        size_t count;
+        size_t keep_interval;
+        ts::ShareMode keep_mode;
+        ts::SectionPtrVector kept;
+        SectionCollector(size_t interval, ts::ShareMode mode) : count(0), keep_interval(interval), keep_mode(mode), kept() {}
+        virtual void handleSection(ts::SectionDemux&, const ts::Section& section) override
+        {
+            if (keep_interval > 0 && count % keep_interval == 0) {
+                kept.push_back(new ts::Section(section, keep_mode));
+            }
+            count++;
+        }
+    };
+}
+
+size_t DemuxTest::buildManyTables(ts::TSPacketVector& packets, uint8_t last_section, bool complete)
+{
+    ts::DuckContext duck;
+    std::vector<ts::TSPacketVector> pids;
+    const ts::ByteBlock payload(1000, 0xA5);
+    const uint8_t end_section = complete ? last_section : last_section - 1;
+    size_t table_count = 0;
+
+    // EIT schedule like: one PID, 8 table ids, 64 services.
+    {
+        ts::OneShotPacketizer pzer(duck, ts::PID_EIT);
+        for (ts::TID tid = ts::TID_EIT_S_ACT_MIN + 7; tid >= ts::TID_EIT_S_ACT_MIN; --tid) {
+            for (uint16_t srv = 0; srv < 64; ++srv) {
+                for (uint8_t sec = 0; sec <= end_section; ++sec) {
+                    pzer.addSection(new ts::Section(tid, true, uint16_t(srv * 37), 1, true, sec, last_section, payload.data(), 150));
+                }
+                table_count++;
+            }
+        }
+        pids.resize(pids.size() + 1);
+        pzer.getPackets(pids.back());
+    }
+
+    // ECM like: 40 PID's, alternating short sections 0x80 and 0x81.
+    for (ts::PID pid = 0x0100; pid < 0x0128; ++pid) {
+        ts::OneShotPacketizer pzer(duck, pid);
+        pzer.addSection(new ts::Section(ts::TID_ECM_80, true, payload.data(), 100));
+        pzer.addSection(new ts::Section(ts::TID_ECM_81, true, payload.data(), 100));
+        table_count += 2;
+        pids.resize(pids.size() + 1);
+        pzer.getPackets(pids.back());
+    }
+
+    // DSM-CC carousel like: 8 PID's, 64 modules each.
+    for (ts::PID pid = 0x0200; pid < 0x0208; ++pid) {
+        ts::OneShotPacketizer pzer(duck, pid);
+        for (uint16_t module = 64; module-- > 0; ) {
+            for (uint8_t sec = 0; sec <= end_section; ++sec) {
+                pzer.addSection(new ts::Section(ts::TID_DSMCC_DDM, true, module, 2, true, sec, last_section, payload.data(), payload.size()));
+            }
+            table_count++;
+        }
+        pids.resize(pids.size() + 1);
+        pzer.getPackets(pids.back());
+    }
+
+    // Interleave all PID's.
+    packets.clear();
+    for (size_t index = 0, remain = pids.size(); remain > 0; ++index) {
+        remain = 0;
+        for (const auto& pkts : pids) {
+            if (index < pkts.size()) {
+                packets.push_back(pkts[index]);
+                remain++;
+            }
+        }
+    }
+    return table_count;
+}
+
+void DemuxTest::testManyTables()
+{
+    ts::DuckContext duck;
+    ts::TSPacketVector packets;
+    TableCollector handler;
+    ts::SectionDemux demux(duck, &handler, nullptr, ts::AllPIDs);
+
+    // All tables complete.
+    const size_t count = buildManyTables(packets, 1, true);
+    for (const auto& pkt : packets) {
+        demux.feedPacket(pkt);
+    }
+    TSUNIT_EQUAL(count, handler.etids.size());
+    TSUNIT_ASSERT(!demux.hasErrors());
+
+    // Same tables, same versions, no new notification, except short sections.
+    demux.resetPID(ts::PID_EIT);
+    handler.etids.clear();
+    for (const auto& pkt : packets) {
+        demux.feedPacket(pkt);
+    }
+    TSUNIT_EQUAL(512 + 80, handler.etids.size());
+
+    // Incomplete tables, notified in increasing order of PID and ETID on flush.
+    demux.reset();
+    handler.pids.clear();
+    handler.etids.clear();
+    TSUNIT_EQUAL(count, buildManyTables(packets, 1, false));
+    for (const auto& pkt : packets) {
+        demux.feedPacket(pkt);
+    }
+    TSUNIT_EQUAL(80, handler.etids.size());
+    demux.packAndFlushSections();
+    TSUNIT_EQUAL(count, handler.etids.size());
+    for (size_t i = 81; i < handler.etids.size(); ++i) {
+        TSUNIT_ASSERT(handler.pids[i - 1] < handler.pids[i] || (handler.pids[i - 1] == handler.pids[i] && handler.etids[i - 1] < handler.etids[i]));
+    }
+}
+
+void DemuxTest::testBenchmark()
+{
+    if (!ts::EnvironmentExists(u"UTEST_BENCHMARK_ALLOWED")) {
+        debug() << "DemuxTest: benchmark skipped, define UTEST_BENCHMARK_ALLOWED to run it" << std::endl;
+        return;
+    }
+
+    ts::DuckContext duck;
+    ts::TSPacketVector packets;
+    TableCollector handler;
+    ts::SectionDemux demux(duck, &handler, nullptr, ts::AllPIDs);
+
+    const size_t count = buildManyTables(packets, 3, true);
+    const size_t passes = 20;
+
+    ts::Monotonic start(true);
+    for (size_t pass = 0; pass < passes; ++pass) {
+        demux.reset();
+        for (const auto& pkt : packets) {
+            demux.feedPacket(pkt);
+        }
+    }
+    const ts::NanoSecond duration = ts::Monotonic(true) - start;
+
+    TSUNIT_EQUAL(passes * count, handler.etids.size());
+    std::cerr << "DemuxTest::testBenchmark: " << packets.size() << " packets, " << count << " tables, "
+              << (duration <= 0 ? 0 : (passes * packets.size() * ts::NanoSecPerSec) / size_t(duration)) << " packets/s"
+              << std::endl;
+
+    // Same stream with a section handler only.
+    SectionCollector shandler(0, ts::ShareMode::SHARE);
+    ts::SectionDemux sdemux(duck, nullptr, &shandler, ts::AllPIDs);
+    ts::Monotonic sstart(true);
+    for (size_t pass = 0; pass < passes; ++pass) {
+        sdemux.reset();
+        for (const auto& pkt : packets) {
+            sdemux.feedPacket(pkt);
+        }
+    }
+    const ts::NanoSecond sduration = ts::Monotonic(true) - sstart;
+    std::cerr << "DemuxTest::testBenchmark: " << shandler.count << " sections, "
+              << (sduration <= 0 ? 0 : (shandler.count * ts::NanoSecPerSec) / size_t(sduration)) << " sections/s"
+              << std::endl;
+}
+
+void DemuxTest::testSectionRecycling()
+{
+    ts::DuckContext duck;
+    ts::TSPacketVector packets;
+    buildManyTables(packets, 1, true);
+
+    // Keep a shared copy of one section out of three, the demux shall not overwrite them.
+    SectionCollector handler(3, ts::ShareMode::SHARE);
+    ts::SectionDemux demux(duck, nullptr, &handler, ts::AllPIDs);
+    for (const auto& pkt : packets) {
+        demux.feedPacket(pkt);
+    }
+    TSUNIT_EQUAL(512 * 2 + 80 + 512 * 2, handler.count);
+    TSUNIT_EQUAL((handler.count + 2) / 3, handler.kept.size());
+
+    // Reference: deep copies of all sections, from another demux.
+    SectionCollector ref(1, ts::ShareMode::COPY);
+    ts::SectionDemux rdemux(duck, nullptr, &ref, ts::AllPIDs);
+    for (const auto& pkt : packets) {
+        rdemux.feedPacket(pkt);
+    }
+    TSUNIT_EQUAL(handler.count, ref.count);
+    TSUNIT_EQUAL(ref.count, ref.kept.size());
+
+    // The kept sections must be identical to the sections of same rank in the reference.
+    for (size_t i = 0; i < handler.kept.size(); ++i) {
+        TSUNIT_ASSERT(handler.kept[i]->isValid());
+        TSUNIT_ASSERT(*handler.kept[i] == *ref.kept[3 * i]);
+    }
+}
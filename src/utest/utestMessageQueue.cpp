@@ -33,6 +33,8 @@
 
 #include "tsMessageQueue.h"
 #include "tsMessagePriorityQueue.h"
+#include "tsRingMessageQueue.h"
+#include "tsAtomicMutex.h"
 #include "tsMonotonic.h"
 #include "tsSysUtils.h"
 #include "tsunit.h"
@@ -54,11 +56,19 @@ public:
     void testConstructor();
     void testQueue();
     void testPriorityQueue();
+    void testRingQueue();
+    void testRingQueueContent();
+    void testRingQueueProducers();
+    void testBenchmark();
 
     TSUNIT_TEST_BEGIN(MessageQueueTest);
     TSUNIT_TEST(testConstructor);
     TSUNIT_TEST(testQueue);
     TSUNIT_TEST(testPriorityQueue);
+    TSUNIT_TEST(testRingQueue);
+    TSUNIT_TEST(testRingQueueContent);
+    TSUNIT_TEST(testRingQueueProducers);
+    TSUNIT_TEST(testBenchmark);
     TSUNIT_TEST_END();
 private:
     ts::NanoSecond  _nsPrecision;
@@ -112,6 +122,11 @@ void MessageQueueTest::testConstructor()
 
     queue1.setMaxMessages(27);
     TSUNIT_ASSERT(queue1.getMaxMessages() == 27);
+
+    ts::RingMessageQueue<int> queue3;
+    ts::RingMessageQueue<int> queue4(10);
+    TSUNIT_EQUAL(ts::RingMessageQueue<int>::DEFAULT_MAX_MESSAGES, queue3.getMaxMessages());
+    TSUNIT_EQUAL(10, queue4.getMaxMessages());
 }
 
 // Thread for testQueue()
@@ -271,3 +286,237 @@ void MessageQueueTest::testPriorityQueue()
 
     TSUNIT_ASSERT(!queue.dequeue(msg, 0));
 }
+
+// Consumer thread for testRingQueue()
+namespace {
+    typedef ts::RingMessageQueue<int> TestRingQueue;
+
+    class RingQueueTestThread: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(RingQueueTestThread);
+    private:
+        TestRingQueue& _queue;
+    public:
+        explicit RingQueueTestThread(TestRingQueue& queue) :
+            utest::TSUnitThread(),
+            _queue(queue)
+        {
+        }
+
+        virtual ~RingQueueTestThread() override
+        {
+            waitForTermination();
+        }
+
+        virtual void test() override
+        {
+            // Initial suspend of 500 ms, then expect consecutive values until negative value.
+            ts::SleepThread(500);
+            int expected = 0;
+            TestRingQueue::MessagePtr message;
+            do {
+                TSUNIT_ASSERT(_queue.dequeue(message, 10000));
+                TSUNIT_ASSERT(!message.isNull());
+                if (*message >= 0) {
+                    TSUNIT_EQUAL(expected, *message);
+                    expected++;
+                }
+                ts::Thread::Yield();
+            } while (*message >= 0);
+            TSUNIT_EQUAL(11, expected);
+        }
+    };
+}
+
+void MessageQueueTest::testRingQueue()
+{
+    TestRingQueue queue(10);
+    RingQueueTestThread thread(queue);
+    int message = 0;
+
+    // Enqueue 10 messages, with and without timeout, should not fail.
+    TSUNIT_ASSERT(queue.enqueue(new int(message++)));
+    while (message < 10) {
+        TSUNIT_ASSERT(queue.enqueue(new int(message++), 100));
+    }
+
+    // Start the consumer thread. The queue is full until it wakes up.
+    const ts::Time start(ts::Time::CurrentUTC());
+    TSUNIT_ASSERT(thread.start());
+    TSUNIT_ASSERT(!queue.enqueue(new int(message), 50));
+
+    // Enqueue message, should wait for the consumer, at least 500 ms.
+    const bool enqueued = queue.enqueue(new int(message++), 10000);
+    const ts::MilliSecond duration = ts::Time::CurrentUTC() - start;
+    debug() << "MessageQueueTest: ring queue: enqueue = " << ts::UString::TrueFalse(enqueued) << ", duration = " << ts::UString::Decimal(duration) << " ms" << std::endl;
+    TSUNIT_ASSERT(enqueued);
+    TSUNIT_ASSUME(duration >= 500 - 20 * _msPrecision);
+
+    // Enqueue exit request.
+    queue.forceEnqueue(new int(-1));
+}
+
+void MessageQueueTest::testRingQueueContent()
+{
+    typedef ts::RingMessageQueue<int> RingQueue;
+    RingQueue queue(4);
+    RingQueue::MessagePtr msg;
+
+    TSUNIT_ASSERT(queue.peek().isNull());
+    TSUNIT_ASSERT(!queue.dequeue(msg, 0));
+    TSUNIT_ASSERT(!queue.dequeue(msg, 20));
+
+    // Fill the queue, then overflow with forced messages.
+    for (int i = 0; i < 4; ++i) {
+        TSUNIT_ASSERT(queue.enqueue(new int(i), 0));
+    }
+    TSUNIT_ASSERT(!queue.enqueue(new int(100), 0));
+    msg = new int(4);
+    RingQueue::MessagePtr copy(msg);
+    TSUNIT_ASSERT(!queue.enqueue(msg, 20));
+    TSUNIT_ASSERT(!msg.isNull());
+    queue.forceEnqueue(msg);
+    TSUNIT_ASSERT(msg.isNull());
+    TSUNIT_ASSERT(copy.isNull());
+    queue.forceEnqueue(new int(5));
+
+    // A peeked message remains valid after being dequeued.
+    RingQueue::MessagePtr first(queue.peek());
+    TSUNIT_ASSERT(!first.isNull());
+    TSUNIT_EQUAL(0, *first);
+
+    // A dequeued message shared by the caller is not affected by the next dequeue.
+    TSUNIT_ASSERT(queue.dequeue(msg, 0));
+    TSUNIT_EQUAL(0, *msg);
+    TSUNIT_EQUAL(0, *first);
+    const RingQueue::MessagePtr kept(msg);
+    TSUNIT_ASSERT(queue.dequeue(msg, 0));
+    TSUNIT_EQUAL(1, *msg);
+    TSUNIT_EQUAL(0, *kept);
+
+    // Still full: 4 messages remain, including forced ones.
+    TSUNIT_ASSERT(!queue.enqueue(new int(100), 0));
+
+    // Change the queue size, messages are preserved.
+    queue.setMaxMessages(100);
+    TSUNIT_EQUAL(100, queue.getMaxMessages());
+    TSUNIT_ASSERT(queue.enqueue(new int(6), 0));
+    for (int i = 2; i <= 6; ++i) {
+        TSUNIT_ASSERT(queue.dequeue(msg, 0));
+        TSUNIT_ASSERT(!msg.isNull());
+        TSUNIT_EQUAL(i, *msg);
+    }
+    TSUNIT_ASSERT(!queue.dequeue(msg, 0));
+
+    // Wrap around the ring several times, with 3 messages in the queue.
+    for (int i = 0; i < 1000; ++i) {
+        TSUNIT_ASSERT(queue.enqueue(new int(i), 0));
+        if (i >= 3) {
+            TSUNIT_ASSERT(queue.dequeue(msg, 0));
+            TSUNIT_EQUAL(i - 3, *msg);
+        }
+    }
+    queue.clear();
+    TSUNIT_ASSERT(queue.peek().isNull());
+    TSUNIT_ASSERT(!queue.dequeue(msg, 0));
+}
+
+// Producer thread for multi-producer tests and benchmarks.
+namespace {
+    template <class QUEUE>
+    class ProducerThread: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(ProducerThread);
+    private:
+        QUEUE& _queue;
+        int    _id;
+        int    _count;
+    public:
+        ProducerThread(QUEUE& queue, int id, int count) :
+            utest::TSUnitThread(),
+            _queue(queue),
+            _id(id),
+            _count(count)
+        {
+        }
+        virtual ~ProducerThread() override
+        {
+            waitForTermination();
+        }
+        virtual void test() override
+        {
+            // Message value: producer id in high-order part, sequence in low-order part.
+            for (int i = 0; i < _count; ++i) {
+                TSUNIT_ASSERT(_queue.enqueue(new int(_id * 1000000 + i), 10000));
+            }
+        }
+    };
+
+    // Run several producers and one consumer (the calling thread).
+    // Check that all messages are received in order for each producer.
+    // Return the duration in nanoseconds.
+    template <class QUEUE>
+    ts::NanoSecond RunProducers(size_t maxMessages, int producers, int count)
+    {
+        QUEUE queue(maxMessages);
+        std::vector<int> next(producers, 0);
+        typename QUEUE::MessagePtr msg;
+
+        ts::Monotonic start(true);
+        {
+            std::vector<ts::SafePtr<ProducerThread<QUEUE>>> threads;
+            for (int id = 0; id < producers; ++id) {
+                threads.push_back(new ProducerThread<QUEUE>(queue, id, count));
+                threads.back()->start();
+            }
+            for (int received = 0; received < producers * count; ++received) {
+                TSUNIT_ASSERT(queue.dequeue(msg, 10000));
+                TSUNIT_ASSERT(!msg.isNull());
+                const int id = *msg / 1000000;
+                TSUNIT_ASSERT(id >= 0 && id < producers);
+                TSUNIT_EQUAL(next[id], *msg % 1000000);
+                next[id]++;
+            }
+        }
+        const ts::NanoSecond duration = ts::Monotonic(true) - start;
+
+        TSUNIT_ASSERT(!queue.dequeue(msg, 0));
+        for (int id = 0; id < producers; ++id) {
+            TSUNIT_EQUAL(count, next[id]);
+        }
+        return duration;
+    }
+
+    // Throughput in messages per second.
+    ts::NanoSecond MessageRate(int count, ts::NanoSecond duration)
+    {
+        return duration <= 0 ? 0 : (count * ts::NanoSecPerSec) / duration;
+    }
+}
+
+void MessageQueueTest::testRingQueueProducers()
+{
+    RunProducers<ts::RingMessageQueue<int>>(16, 1, 20000);
+    RunProducers<ts::RingMessageQueue<int>>(16, 4, 20000);
+    RunProducers<ts::RingMessageQueue<int, ts::AtomicMutex>>(3, 4, 20000);
+}
+
+void MessageQueueTest::testBenchmark()
+{
+    if (!ts::EnvironmentExists(u"UTEST_BENCHMARK_ALLOWED")) {
+        debug() << "MessageQueueTest: benchmark skipped, define UTEST_BENCHMARK_ALLOWED to run it" << std::endl;
+        return;
+    }
+
+    static const int producers[] = {1, 4};
+    const int total = 400000;
+
+    for (auto count : producers) {
+        ts::NanoSecond duration = RunProducers<ts::MessageQueue<int>>(256, count, total / count);
+        std::cerr << "MessageQueueTest: MessageQueue<Mutex>, " << count << " producers: " << MessageRate(total, duration) << " messages/s" << std::endl;
+        duration = RunProducers<ts::RingMessageQueue<int>>(256, count, total / count);
+        std::cerr << "MessageQueueTest: RingMessageQueue<Mutex>, " << count << " producers: " << MessageRate(total, duration) << " messages/s" << std::endl;
+        duration = RunProducers<ts::RingMessageQueue<int, ts::AtomicMutex>>(256, count, total / count);
+        std::cerr << "MessageQueueTest: RingMessageQueue<AtomicMutex>, " << count << " producers: " << MessageRate(total, duration) << " messages/s" << std::endl;
+    }
+}
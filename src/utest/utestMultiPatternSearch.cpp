@@ -0,0 +1,173 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::MultiPatternSearch
+//
+//----------------------------------------------------------------------------
+
+#include "tsMultiPatternSearch.h"
+#include "tsMemory.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class MultiPatternSearchTest: public tsunit::Test
+{
+public:
+    MultiPatternSearchTest();
+
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testEmpty();
+    void testSearch();
+    void testStartsWith();
+    void testReference();
+
+    TSUNIT_TEST_BEGIN(MultiPatternSearchTest);
+    TSUNIT_TEST(testEmpty);
+    TSUNIT_TEST(testSearch);
+    TSUNIT_TEST(testStartsWith);
+    TSUNIT_TEST(testReference);
+    TSUNIT_TEST_END();
+private:
+    ts::ByteBlock _data;
+};
+
+TSUNIT_REGISTER(MultiPatternSearchTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+MultiPatternSearchTest::MultiPatternSearchTest() :
+    _data()
+{
+}
+
+// Test suite initialization method.
+void MultiPatternSearchTest::beforeTest()
+{
+    // Deterministic pseudo-random data, with a reduced alphabet to get partial matches.
+    _data.resize(64 * 1024);
+    uint32_t seed = 0x12345678;
+    for (size_t i = 0; i < _data.size(); ++i) {
+        seed = seed * 1103515245 + 12345;
+        _data[i] = uint8_t((seed >> 16) % 6);
+    }
+}
+
+// Test suite cleanup method.
+void MultiPatternSearchTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void MultiPatternSearchTest::testEmpty()
+{
+    ts::MultiPatternSearch mps;
+    TSUNIT_ASSERT(mps.empty());
+    TSUNIT_EQUAL(0, mps.patternCount());
+    TSUNIT_EQUAL(0, mps.maxPatternSize());
+    TSUNIT_ASSERT(!mps.search(_data.data(), _data.size()));
+    TSUNIT_ASSERT(!mps.startsWith(_data.data(), _data.size()));
+
+    mps.setPatterns({ts::ByteBlock()});
+    TSUNIT_ASSERT(mps.empty());
+    TSUNIT_ASSERT(!mps.search(_data.data(), _data.size()));
+}
+
+void MultiPatternSearchTest::testSearch()
+{
+    static const uint8_t area[] = {0x10, 0x20, 0x30, 0x40, 0x47, 0x01, 0x02, 0x03, 0xAB, 0xCD, 0xEF, 0x01, 0x02, 0x04,
+                                   0x00, 0x00, 0x01, 0xE0, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99};
+
+    ts::MultiPatternSearch mps({ts::ByteBlock({0x01, 0x02, 0x05}), ts::ByteBlock({0x02, 0x03, 0xAB})});
+    TSUNIT_EQUAL(2, mps.patternCount());
+    TSUNIT_EQUAL(3, mps.maxPatternSize());
+    TSUNIT_ASSERT(mps.search(area, sizeof(area)));
+    TSUNIT_ASSERT(!mps.search(area, 8));
+    TSUNIT_ASSERT(mps.search(area, 9));
+    TSUNIT_ASSERT(!mps.search(area + 7, sizeof(area) - 7));
+
+    // Overlapping patterns, one is a suffix of the other.
+    mps.setPatterns({ts::ByteBlock({0x00, 0x00, 0x01, 0xE1}), ts::ByteBlock({0x00, 0x01, 0xE0})});
+    TSUNIT_ASSERT(mps.search(area, sizeof(area)));
+    TSUNIT_ASSERT(!mps.search(area, 17));
+    TSUNIT_ASSERT(mps.search(area + 15, 3));
+
+    // Many distinct first bytes (no SIMD prefilter).
+    mps.setPatterns({ts::ByteBlock({0xA0}), ts::ByteBlock({0xA1}), ts::ByteBlock({0xA2}), ts::ByteBlock({0xA3}), ts::ByteBlock({0x99})});
+    TSUNIT_ASSERT(mps.search(area, sizeof(area)));
+    TSUNIT_ASSERT(!mps.search(area, sizeof(area) - 1));
+}
+
+void MultiPatternSearchTest::testStartsWith()
+{
+    static const uint8_t area[] = {0x47, 0x01, 0x02, 0x03};
+
+    ts::MultiPatternSearch mps({ts::ByteBlock({0x01, 0x02}), ts::ByteBlock({0x47, 0x01, 0x02, 0x03, 0x04})});
+    TSUNIT_ASSERT(!mps.startsWith(area, sizeof(area)));
+    TSUNIT_ASSERT(mps.startsWith(area + 1, 3));
+    TSUNIT_ASSERT(!mps.startsWith(area + 1, 1));
+
+    mps.setPatterns({ts::ByteBlock({0x47, 0x01})});
+    TSUNIT_ASSERT(mps.startsWith(area, sizeof(area)));
+}
+
+void MultiPatternSearchTest::testReference()
+{
+    // Compare with LocatePattern() on all TS-packet-sized areas, using various sets of patterns.
+    for (size_t count = 1; count <= 8; ++count) {
+        for (size_t size = 1; size <= 5; ++size) {
+            ts::ByteBlockVector patterns;
+            for (size_t i = 0; i < count; ++i) {
+                patterns.push_back(ts::ByteBlock(&_data[1000 * i + 17 * size], size));
+            }
+            const ts::MultiPatternSearch mps(patterns);
+            for (size_t offset = 0; offset + 188 <= _data.size(); offset += 188) {
+                bool expected = false;
+                for (size_t i = 0; !expected && i < count; ++i) {
+                    expected = ts::LocatePattern(&_data[offset], 188, patterns[i].data(), patterns[i].size()) != nullptr;
+                }
+                TSUNIT_EQUAL(expected, mps.search(&_data[offset], 188));
+            }
+        }
+    }
+}
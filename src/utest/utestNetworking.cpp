@@ -70,6 +70,8 @@ public:
     void testIPv6SocketAddress();
     void testTCPSocket();
     void testUDPSocket();
+    void testUDPReceiveMultiple();
+    void testUDPSendMultiple();
     void testIPHeader();
     void testIPProtocol();
     void testTCPPacket();
@@ -86,6 +88,8 @@ public:
     TSUNIT_TEST(testIPv6SocketAddress);
     TSUNIT_TEST(testTCPSocket);
     TSUNIT_TEST(testUDPSocket);
+    TSUNIT_TEST(testUDPReceiveMultiple);
+    TSUNIT_TEST(testUDPSendMultiple);
     TSUNIT_TEST(testIPHeader);
     TSUNIT_TEST(testIPProtocol);
     TSUNIT_TEST(testTCPPacket);
@@ -746,6 +750,107 @@ void NetworkingTest::testUDPSocket()
     CERR.debug(u"UDPSocketTest: main thread: reply sent");
 }
 
+void NetworkingTest::testUDPReceiveMultiple()
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    const uint16_t portNumber = 12346;
+    const size_t msgCount = 5;
+    const size_t msgSize[msgCount] = {100, 7 * 188, 7 * 188 + 50, 1, 3000};
+
+    // Create receiver and sender sockets.
+    ts::UDPSocket receiver(true);
+    TSUNIT_ASSERT(receiver.isOpen());
+    TSUNIT_ASSERT(receiver.reusePort(true, CERR));
+    TSUNIT_ASSERT(receiver.bind(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, portNumber), CERR));
+
+    ts::UDPSocket sender(true);
+    TSUNIT_ASSERT(sender.isOpen());
+    TSUNIT_ASSERT(sender.bind(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, ts::IPv4SocketAddress::AnyPort), CERR));
+    TSUNIT_ASSERT(sender.setDefaultDestination(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, portNumber), CERR));
+
+    // Send all messages. On the loopback interface, they are immediately available in the receiver.
+    uint8_t data[msgCount][4096];
+    for (size_t i = 0; i < msgCount; ++i) {
+        for (size_t j = 0; j < msgSize[i]; ++j) {
+            data[i][j] = uint8_t(i * 16 + j);
+        }
+        TSUNIT_ASSERT(sender.send(data[i], msgSize[i], CERR));
+    }
+
+    // Receive all messages in two segments.
+    uint8_t first[msgCount][7 * 188];
+    uint8_t second[msgCount][4096];
+    ts::UDPSocket::ReceiveBuffer buffers[msgCount];
+    size_t received = 0;
+    while (received < msgCount) {
+        const size_t count = msgCount - received;
+        for (size_t i = 0; i < count; ++i) {
+            buffers[i].data1 = first[i];
+            buffers[i].size1 = sizeof(first[i]);
+            buffers[i].data2 = second[i];
+            buffers[i].size2 = sizeof(second[i]);
+        }
+        const size_t used = receiver.receiveMultiple(buffers, count, nullptr, CERR);
+        CERR.debug(u"UDPSocketTest: received %d messages", {used});
+        TSUNIT_ASSERT(used > 0);
+        TSUNIT_ASSERT(used <= count);
+        for (size_t i = 0; i < used; ++i) {
+            const size_t index = received + i;
+            const size_t size = msgSize[index];
+            TSUNIT_EQUAL(size, buffers[i].ret_size);
+            TSUNIT_ASSERT(ts::IPv4Address(buffers[i].sender) == ts::IPv4Address::LocalHost);
+            const size_t size1 = std::min(size, sizeof(first[i]));
+            TSUNIT_EQUAL(0, ::memcmp(data[index], first[i], size1));
+            TSUNIT_EQUAL(0, ::memcmp(data[index] + size1, second[i], size - size1));
+        }
+        received += used;
+    }
+}
+
+void NetworkingTest::testUDPSendMultiple()
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    const uint16_t portNumber = 12347;
+    const size_t msgCount = 9;
+    const size_t msgSize[msgCount] = {1316, 1316, 1316, 1316, 1316, 100, 1316, 1316, 20};
+
+    // Create receiver and sender sockets.
+    ts::UDPSocket receiver(true);
+    TSUNIT_ASSERT(receiver.isOpen());
+    TSUNIT_ASSERT(receiver.reusePort(true, CERR));
+    TSUNIT_ASSERT(receiver.setReceiveBufferSize(256 * 1024, CERR));
+    TSUNIT_ASSERT(receiver.bind(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, portNumber), CERR));
+
+    ts::UDPSocket sender(true);
+    TSUNIT_ASSERT(sender.isOpen());
+    TSUNIT_ASSERT(sender.bind(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, ts::IPv4SocketAddress::AnyPort), CERR));
+    TSUNIT_ASSERT(sender.setDefaultDestination(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, portNumber), CERR));
+
+    // Send all messages at once. Consecutive messages of identical sizes may be segmented by the kernel.
+    uint8_t data[msgCount][2000];
+    const void* address[msgCount];
+    for (size_t i = 0; i < msgCount; ++i) {
+        for (size_t j = 0; j < msgSize[i]; ++j) {
+            data[i][j] = uint8_t(i * 16 + j);
+        }
+        address[i] = data[i];
+    }
+    TSUNIT_ASSERT(sender.sendMultiple(address, msgSize, msgCount, CERR));
+
+    // Receive all messages one by one, check that the message boundaries are preserved.
+    for (size_t i = 0; i < msgCount; ++i) {
+        ts::IPv4SocketAddress from;
+        ts::IPv4SocketAddress destination;
+        uint8_t buffer[2000];
+        size_t size = 0;
+        TSUNIT_ASSERT(receiver.receive(buffer, sizeof(buffer), size, from, destination, nullptr, CERR));
+        TSUNIT_EQUAL(msgSize[i], size);
+        TSUNIT_EQUAL(0, ::memcmp(data[i], buffer, size));
+    }
+}
+
 void NetworkingTest::testIPHeader()
 {
     static const uint8_t reference_header[] = {
@@ -0,0 +1,393 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for PESDemux class.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPESDemux.h"
+#include "tsPESOneShotPacketizer.h"
+#include "tsDuckContext.h"
+#include "tsTSPacket.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PESDemuxTest: public tsunit::Test, private ts::PESHandlerInterface
+{
+public:
+    PESDemuxTest();
+
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testStreamingPayload();
+    void testStreamingAttributes();
+
+    TSUNIT_TEST_BEGIN(PESDemuxTest);
+    TSUNIT_TEST(testStreamingPayload);
+    TSUNIT_TEST(testStreamingAttributes);
+    TSUNIT_TEST_END();
+
+private:
+    typedef std::pair<ts::PID, ts::ByteBlock> PIDPayload;
+
+    ts::TSPacketVector          _packets;     // Test stream
+    std::vector<PIDPayload>     _payloads;    // PES payloads, in order of reception
+    std::map<ts::PID, size_t>   _current;     // Streaming mode: index in _payloads of current PES packet
+    ts::UStringList             _events;      // Reported attributes
+
+    // Build the test stream.
+    void buildStream();
+
+    // Demux the test stream in one mode.
+    void demux(bool streaming);
+
+    // Implementation of PESHandlerInterface.
+    virtual void handlePESPacket(ts::PESDemux&, const ts::PESPacket&) override;
+    virtual void handlePESPayload(ts::PESDemux&, const ts::PESPacket&, const uint8_t*, size_t, size_t) override;
+    virtual void handleNewMPEG2VideoAttributes(ts::PESDemux&, const ts::PESPacket&, const ts::MPEG2VideoAttributes&) override;
+    virtual void handleNewAVCAttributes(ts::PESDemux&, const ts::PESPacket&, const ts::AVCAttributes&) override;
+    virtual void handleNewMPEG2AudioAttributes(ts::PESDemux&, const ts::PESPacket&, const ts::MPEG2AudioAttributes&) override;
+    virtual void handleNewAC3Attributes(ts::PESDemux&, const ts::PESPacket&, const ts::AC3Attributes&) override;
+    void addEvent(const ts::PESPacket&, const ts::AbstractAudioVideoAttributes&);
+};
+
+TSUNIT_REGISTER(PESDemuxTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+PESDemuxTest::PESDemuxTest() :
+    _packets(),
+    _payloads(),
+    _current(),
+    _events()
+{
+}
+
+// Test suite initialization method.
+void PESDemuxTest::beforeTest()
+{
+    buildStream();
+}
+
+// Test suite cleanup method.
+void PESDemuxTest::afterTest()
+{
+    _packets.clear();
+}
+
+// PID's in the test stream.
+namespace {
+    constexpr ts::PID PID_MPEG2 = 100;
+    constexpr ts::PID PID_AVC   = 101;
+    constexpr ts::PID PID_AUDIO = 102;
+    constexpr ts::PID PID_AC3   = 103;
+}
+
+
+//----------------------------------------------------------------------------
+// Build the test stream.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Append a PES header with a 3-byte optional header. Zero size means unbounded.
+    void AddHeader(ts::ByteBlock& pes, uint8_t stream_id)
+    {
+        pes.appendUInt24(0x000001);
+        pes.appendUInt8(stream_id);
+        pes.appendUInt16(0);
+        pes.appendUInt24(0x800000);
+    }
+
+    // Update the PES_packet_length of a bounded PES packet.
+    void SetSize(ts::ByteBlock& pes)
+    {
+        ts::PutUInt16(pes.data() + 4, uint16_t(pes.size() - 6));
+    }
+
+    // Append video data without start code (never two consecutive zeroes).
+    void AddVideoData(ts::ByteBlock& pes, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i) {
+            pes.appendUInt8(uint8_t(i % 251 + 1));
+        }
+    }
+
+    // Append MPEG-2 sequence header and sequence extension.
+    void AddSequenceHeader(ts::ByteBlock& pes, uint16_t vsize)
+    {
+        pes.appendUInt32(0x000001B3);
+        pes.appendUInt24(0x2D0000 | vsize);       // 720 x vsize
+        pes.appendUInt8(0x33);                    // 4:3, 25 fps
+        pes.appendUInt32(0x0BB820A4);             // bitrate, VBV size, etc.
+        pes.appendUInt32(0x000001B5);
+        pes.appendUInt32(0x14820001);             // sequence extension
+        pes.appendUInt16(0x0000);
+    }
+
+    // Append AVC sequence parameter set NALunit.
+    void AddSPS(ts::ByteBlock& pes)
+    {
+        static const uint8_t sps[] = {
+            0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0xC0, 0x1F, 0xDA, 0x01, 0x40, 0x16, 0xE8, 0x40, 0x00, 0x00,
+            0x03, 0x00, 0x40, 0x00, 0x00, 0x0C, 0x83, 0xC6, 0x0C, 0xA8,
+        };
+        pes.append(sps, sizeof(sps));
+    }
+}
+
+void PESDemuxTest::buildStream()
+{
+    ts::DuckContext duck;
+    std::vector<ts::ByteBlock> mpeg2, avc, audio, ac3;
+    ts::ByteBlock pes;
+
+    // MPEG-2 video, unbounded PES packets. The PES header and the start of the payload use
+    // 9 + 175 bytes in the first TS packet. Place sequence headers across TS packets.
+    AddHeader(pes, 0xE0);
+    AddSequenceHeader(pes, 576);
+    pes.appendUInt32(0x000001B8);
+    AddVideoData(pes, 4);
+    pes.appendUInt32(0x00000100);
+    AddVideoData(pes, 4);
+    pes.appendUInt32(0x00000101);
+    AddVideoData(pes, 1000);
+    mpeg2.push_back(pes);
+
+    pes.clear();
+    AddHeader(pes, 0xE0);
+    pes.appendUInt32(0x00000101);
+    AddVideoData(pes, 166);
+    AddSequenceHeader(pes, 576);
+    pes.appendUInt32(0x00000101);
+    AddVideoData(pes, 300);
+    mpeg2.push_back(pes);
+
+    pes.clear();
+    AddHeader(pes, 0xE0);
+    pes.appendUInt32(0x00000101);
+    AddVideoData(pes, 173);
+    AddSequenceHeader(pes, 480);
+    pes.appendUInt32(0x00000101);
+    AddVideoData(pes, 500);
+    mpeg2.push_back(pes);
+    mpeg2.push_back(mpeg2.front());
+
+    // AVC video, bounded PES packets.
+    pes.clear();
+    AddHeader(pes, 0xE0);
+    pes.appendUInt24(0x000000);
+    pes.appendUInt24(0x010910);
+    AddSPS(pes);
+    pes.appendUInt32(0x00000001);
+    pes.appendUInt32(0x68CE3880);
+    pes.appendUInt32(0x00000165);
+    AddVideoData(pes, 700);
+    SetSize(pes);
+    avc.push_back(pes);
+
+    pes.clear();
+    AddHeader(pes, 0xE0);
+    pes.appendUInt32(0x00000001);
+    pes.appendUInt16(0x0910);
+    pes.appendUInt32(0x00000141);
+    AddVideoData(pes, 153);
+    AddSPS(pes);
+    pes.appendUInt32(0x00000165);
+    AddVideoData(pes, 400);
+    SetSize(pes);
+    avc.push_back(pes);
+
+    // MPEG audio and AC-3, bounded PES packets.
+    for (size_t i = 0; i < 3; ++i) {
+        pes.clear();
+        AddHeader(pes, 0xC0);
+        pes.appendUInt32(i < 2 ? 0xFFFD8004 : 0xFFFDA004);
+        AddVideoData(pes, 400 + i);
+        SetSize(pes);
+        audio.push_back(pes);
+
+        pes.clear();
+        AddHeader(pes, 0xBD);
+        pes.appendUInt32(0x0B771234);
+        pes.appendUInt24(i < 2 ? 0x144000 : 0x1440E0);
+        AddVideoData(pes, 600 + i);
+        SetSize(pes);
+        ac3.push_back(pes);
+    }
+
+    // Packetize all PES packets, one PID after the other.
+    _packets.clear();
+    const std::vector<std::pair<ts::PID, const std::vector<ts::ByteBlock>*>> streams {
+        {PID_MPEG2, &mpeg2}, {PID_AVC, &avc}, {PID_AUDIO, &audio}, {PID_AC3, &ac3}
+    };
+    for (const auto& st : streams) {
+        ts::PESOneShotPacketizer zer(duck, st.first);
+        for (const auto& bb : *st.second) {
+            zer.addPES(ts::PESPacket(bb, st.first), ts::ShareMode::COPY);
+        }
+        ts::TSPacketVector packets;
+        zer.getPackets(packets);
+        _packets.insert(_packets.end(), packets.begin(), packets.end());
+    }
+
+    // Terminate the last unbounded PES packets.
+    ts::TSPacket pkt;
+    pkt.init(PID_MPEG2, 3);
+    pkt.setPUSI();
+    _packets.push_back(pkt);
+}
+
+
+//----------------------------------------------------------------------------
+// Demux the test stream.
+//----------------------------------------------------------------------------
+
+void PESDemuxTest::demux(bool streaming)
+{
+    _payloads.clear();
+    _current.clear();
+    _events.clear();
+
+    ts::DuckContext duck;
+    ts::PESDemux demux(duck, this);
+    demux.setDefaultCodec(PID_AVC, ts::CodecType::AVC);
+    demux.setStreamingMode(streaming);
+    TSUNIT_EQUAL(streaming, demux.streamingMode());
+
+    for (const auto& pkt : _packets) {
+        demux.feedPacket(pkt);
+    }
+
+    // In streaming mode, unbounded PES packets are analyzed before the next unit start.
+    // Only the order of events in each PID is significant.
+    std::stable_sort(_payloads.begin(), _payloads.end(), [](const PIDPayload& p1, const PIDPayload& p2) { return p1.first < p2.first; });
+    _events.sort();
+
+    TSUNIT_ASSERT(!demux.allAC3(PID_AUDIO));
+    TSUNIT_ASSERT(demux.allAC3(PID_AC3));
+    ts::AVCAttributes avc;
+    demux.getAVCAttributes(PID_AVC, avc);
+    TSUNIT_ASSERT(avc.isValid());
+}
+
+
+//----------------------------------------------------------------------------
+// Handlers.
+//----------------------------------------------------------------------------
+
+void PESDemuxTest::handlePESPacket(ts::PESDemux& demux, const ts::PESPacket& pes)
+{
+    TSUNIT_ASSERT(!demux.streamingMode());
+    _payloads.push_back(std::make_pair(pes.sourcePID(), ts::ByteBlock(pes.payload(), pes.payloadSize())));
+}
+
+void PESDemuxTest::handlePESPayload(ts::PESDemux& demux, const ts::PESPacket& pes, const uint8_t* data, size_t size, size_t offset)
+{
+    TSUNIT_ASSERT(demux.streamingMode());
+    TSUNIT_ASSERT(pes.isValid());
+    TSUNIT_ASSERT(size > 0);
+    if (offset == 0) {
+        _current[pes.sourcePID()] = _payloads.size();
+        _payloads.push_back(std::make_pair(pes.sourcePID(), ts::ByteBlock()));
+    }
+    TSUNIT_ASSERT(_current.find(pes.sourcePID()) != _current.end());
+    ts::ByteBlock& payload(_payloads[_current[pes.sourcePID()]].second);
+    TSUNIT_EQUAL(payload.size(), offset);
+    payload.append(data, size);
+}
+
+void PESDemuxTest::handleNewMPEG2VideoAttributes(ts::PESDemux&, const ts::PESPacket& pes, const ts::MPEG2VideoAttributes& attr)
+{
+    addEvent(pes, attr);
+}
+
+void PESDemuxTest::handleNewAVCAttributes(ts::PESDemux&, const ts::PESPacket& pes, const ts::AVCAttributes& attr)
+{
+    addEvent(pes, attr);
+}
+
+void PESDemuxTest::handleNewMPEG2AudioAttributes(ts::PESDemux&, const ts::PESPacket& pes, const ts::MPEG2AudioAttributes& attr)
+{
+    addEvent(pes, attr);
+}
+
+void PESDemuxTest::handleNewAC3Attributes(ts::PESDemux&, const ts::PESPacket& pes, const ts::AC3Attributes& attr)
+{
+    addEvent(pes, attr);
+}
+
+void PESDemuxTest::addEvent(const ts::PESPacket& pes, const ts::AbstractAudioVideoAttributes& attr)
+{
+    TSUNIT_ASSERT(attr.isValid());
+    _events.push_back(ts::UString::Format(u"PID %d, first packet %3d, stream id 0x%X: %s", {pes.sourcePID(), pes.firstTSPacketIndex(), pes.getStreamId(), attr}));
+    debug() << "PESDemuxTest: " << _events.back() << std::endl;
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void PESDemuxTest::testStreamingPayload()
+{
+    demux(false);
+    const std::vector<PIDPayload> ref(_payloads);
+    TSUNIT_EQUAL(12, ref.size());
+
+    demux(true);
+    TSUNIT_EQUAL(ref.size(), _payloads.size());
+    for (size_t i = 0; i < ref.size() && i < _payloads.size(); ++i) {
+        TSUNIT_EQUAL(ref[i].first, _payloads[i].first);
+        TSUNIT_ASSERT(ref[i].second == _payloads[i].second);
+    }
+}
+
+void PESDemuxTest::testStreamingAttributes()
+{
+    demux(false);
+    const ts::UStringList ref(_events);
+    // MPEG-2 video: 576, 480 and 576 lines, AVC: one SPS, audio and AC-3: two versions.
+    TSUNIT_EQUAL(8, ref.size());
+
+    demux(true);
+    TSUNIT_EQUAL(ref.size(), _events.size());
+    auto it2 = _events.begin();
+    for (auto it1 = ref.begin(); it1 != ref.end() && it2 != _events.end(); ++it1, ++it2) {
+        TSUNIT_EQUAL(*it1, *it2);
+    }
+}
@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsResidentBuffer.h"
+#include "tsSysInfo.h"
 #include "tsunit.h"
 
 
@@ -46,9 +47,11 @@ public:
     virtual void afterTest() override;
 
     void testResidentBuffer();
+    void testHugePages();
 
     TSUNIT_TEST_BEGIN(ResidentBufferTest);
     TSUNIT_TEST(testResidentBuffer);
+    TSUNIT_TEST(testHugePages);
     TSUNIT_TEST_END();
 };
 
@@ -85,4 +88,33 @@ void ResidentBufferTest::testResidentBuffer()
 
     TSUNIT_ASSERT(buf.isLocked());
     TSUNIT_ASSERT(buf.count() >= buf_size);
+    TSUNIT_EQUAL(int(ts::PageMode::STANDARD), int(buf.pageMode()));
+}
+
+void ResidentBufferTest::testHugePages()
+{
+    const size_t buf_size = 3 * 1024 * 1024;
+    const size_t huge_size = ts::SysInfo::Instance()->hugePageSize();
+
+    debug() << "ResidentBufferTest: huge page size: " << huge_size << std::endl;
+
+    for (auto mode : {ts::PageMode::TRANSPARENT_HUGE, ts::PageMode::EXPLICIT_HUGE}) {
+        ts::ResidentBuffer<uint8_t> buf(buf_size, mode);
+        const ts::PageMode actual = buf.pageMode();
+
+        debug() << "ResidentBufferTest: requested " << ts::PageModeEnum.name(int(mode))
+                << " pages, got " << ts::PageModeEnum.name(int(actual))
+                << ", isLocked() = " << buf.isLocked() << ", count() = " << buf.count() << std::endl;
+
+        // Huge pages may be unavailable but the fallback must always be a usable buffer.
+        TSUNIT_ASSERT(buf.count() >= buf_size);
+        TSUNIT_ASSERT(buf.base() != nullptr);
+        TSUNIT_ASSERT(actual == ts::PageMode::STANDARD || actual == mode || actual == ts::PageMode::TRANSPARENT_HUGE);
+        if (actual != ts::PageMode::STANDARD) {
+            TSUNIT_ASSERT(huge_size > 0);
+            TSUNIT_EQUAL(0, size_t(buf.base()) % huge_size);
+        }
+        buf.base()[0] = 0x47;
+        buf.base()[buf.count() - 1] = 0x47;
+    }
 }
@@ -33,6 +33,10 @@
 
 #include "tsSafePtr.h"
 #include "tsMutex.h"
+#include "tsAtomicMutex.h"
+#include "tsMonotonic.h"
+#include "utestTSUnitThread.h"
+#include "tsSysUtils.h"
 #include "tsunit.h"
 
 
@@ -50,12 +54,18 @@ public:
     void testDowncast();
     void testUpcast();
     void testChangeMutex();
+    void testAtomic();
+    void testAtomicThreads();
+    void testBenchmark();
 
     TSUNIT_TEST_BEGIN(SafePtrTest);
     TSUNIT_TEST(testSafePtr);
     TSUNIT_TEST(testDowncast);
     TSUNIT_TEST(testUpcast);
     TSUNIT_TEST(testChangeMutex);
+    TSUNIT_TEST(testAtomic);
+    TSUNIT_TEST(testAtomicThreads);
+    TSUNIT_TEST(testBenchmark);
     TSUNIT_TEST_END();
 };
 
@@ -386,3 +396,155 @@ void SafePtrTest::testChangeMutex()
     pt.clear();
     TSUNIT_ASSERT(TestData::InstanceCount() == 0);
 }
+
+// Test case: same semantics with lock-free atomic reference counting
+void SafePtrTest::testAtomic()
+{
+    typedef ts::SafePtr<TestData,ts::AtomicMutex> AtomicPtr;
+
+    TSUNIT_ASSERT(TestData::InstanceCount() == 0);
+    AtomicPtr p1;
+    TSUNIT_ASSERT(p1.isNull());
+    TSUNIT_EQUAL(1, p1.count());
+
+    p1.reset(new TestData(12));
+    TSUNIT_ASSERT(!p1.isNull());
+    TSUNIT_EQUAL(12, p1->value());
+    TSUNIT_EQUAL(1, TestData::InstanceCount());
+
+    {
+        AtomicPtr p2(p1);
+        AtomicPtr p3;
+        p3 = p2;
+        TSUNIT_EQUAL(3, p1.count());
+        TSUNIT_ASSERT(p1 == p3);
+        p3.reset(new TestData(27));
+        TSUNIT_EQUAL(1, TestData::InstanceCount());
+        TSUNIT_EQUAL(27, p1->value());
+        AtomicPtr p4(std::move(p3));
+        TSUNIT_EQUAL(3, p1.count());
+    }
+    TSUNIT_EQUAL(1, p1.count());
+    TSUNIT_EQUAL(1, TestData::InstanceCount());
+
+    TestData* px = p1.release();
+    TSUNIT_ASSERT(p1.isNull());
+    TSUNIT_EQUAL(27, px->value());
+    delete px;
+    TSUNIT_EQUAL(0, TestData::InstanceCount());
+
+    // Casts and mutex changes.
+    AtomicPtr p(new SubTestData2(666));
+    TSUNIT_ASSERT(p.downcast<SubTestData1>().isNull());
+    TSUNIT_ASSERT(!p.isNull());
+    ts::SafePtr<SubTestData2,ts::AtomicMutex> ps(p.downcast<SubTestData2>());
+    TSUNIT_ASSERT(p.isNull());
+    TSUNIT_EQUAL(666, ps->value());
+    AtomicPtr pu(ps.upcast<TestData>());
+    TSUNIT_ASSERT(ps.isNull());
+    ts::SafePtr<TestData,ts::Mutex> pm(pu.changeMutex<ts::Mutex>());
+    TSUNIT_ASSERT(pu.isNull());
+    TSUNIT_EQUAL(666, pm->value());
+    TSUNIT_EQUAL(1, TestData::InstanceCount());
+
+    pm.clear();
+    TSUNIT_EQUAL(0, TestData::InstanceCount());
+}
+
+// A thread which repeatedly copies and releases a shared safe pointer.
+namespace {
+    template <class MUTEX>
+    class CopyThread: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(CopyThread);
+    private:
+        const ts::SafePtr<TestData,MUTEX>& _ptr;
+        size_t _count;
+    public:
+        CopyThread(const ts::SafePtr<TestData,MUTEX>& ptr, size_t count) :
+            utest::TSUnitThread(),
+            _ptr(ptr),
+            _count(count)
+        {
+        }
+        virtual ~CopyThread() override
+        {
+            waitForTermination();
+        }
+        virtual void test() override
+        {
+            for (size_t i = 0; i < _count; ++i) {
+                ts::SafePtr<TestData,MUTEX> copy(_ptr);
+                TSUNIT_ASSERT(copy->value() == 1234);
+            }
+        }
+    };
+
+    // Run copies of a safe pointer in several concurrent threads, return duration in nanoseconds.
+    template <class MUTEX>
+    ts::NanoSecond CopyInThreads(size_t thread_count, size_t copy_count)
+    {
+        const ts::SafePtr<TestData,MUTEX> ptr(new TestData(1234));
+        ts::Monotonic start(true);
+        {
+            std::vector<ts::SafePtr<CopyThread<MUTEX>>> threads;
+            for (size_t i = 0; i < thread_count; ++i) {
+                threads.push_back(new CopyThread<MUTEX>(ptr, copy_count));
+                threads.back()->start();
+            }
+        }
+        const ts::NanoSecond duration = ts::Monotonic(true) - start;
+        TSUNIT_EQUAL(1, ptr.count());
+        TSUNIT_EQUAL(1234, ptr->value());
+        return duration;
+    }
+}
+
+// Test case: concurrent copies of an atomic safe pointer
+void SafePtrTest::testAtomicThreads()
+{
+    CopyInThreads<ts::AtomicMutex>(4, 100000);
+    TSUNIT_EQUAL(0, TestData::InstanceCount());
+}
+
+// Test case: performance of reference counting with various synchronizations
+namespace {
+    // Throughput in millions of copies per second.
+    ts::NanoSecond CopyRate(size_t count, ts::NanoSecond duration)
+    {
+        return duration <= 0 ? 0 : (ts::NanoSecond(count) * 1000) / duration;
+    }
+
+    // Measure copy/delete throughput in one thread and, when the safe pointer is thread-safe, in several threads.
+    template <class MUTEX>
+    void CopyBenchmark(std::ostream& out, const char* name, bool thread_safe)
+    {
+        const size_t count = 2000000;
+        const ts::SafePtr<TestData,MUTEX> ptr(new TestData(1234));
+        ts::Monotonic start(true);
+        for (size_t i = 0; i < count; ++i) {
+            ts::SafePtr<TestData,MUTEX> copy(ptr);
+        }
+        ts::NanoSecond duration = ts::Monotonic(true) - start;
+        out << "SafePtrTest: " << name << ", 1 thread: " << CopyRate(count, duration) << " M copies/s" << std::endl;
+
+        if (thread_safe) {
+            const size_t threads = 4;
+            duration = CopyInThreads<MUTEX>(threads, count / threads);
+            out << "SafePtrTest: " << name << ", " << threads << " threads: " << CopyRate(count, duration) << " M copies/s" << std::endl;
+        }
+    }
+}
+
+void SafePtrTest::testBenchmark()
+{
+    if (!ts::EnvironmentExists(u"UTEST_BENCHMARK_ALLOWED")) {
+        debug() << "SafePtrTest: benchmark skipped, define UTEST_BENCHMARK_ALLOWED to run it" << std::endl;
+        return;
+    }
+
+    CopyBenchmark<ts::NullMutex>(std::cerr, "NullMutex", false);
+    CopyBenchmark<ts::Mutex>(std::cerr, "Mutex", true);
+    CopyBenchmark<ts::AtomicMutex>(std::cerr, "AtomicMutex", true);
+    TSUNIT_EQUAL(0, TestData::InstanceCount());
+}
@@ -32,7 +32,16 @@
 //----------------------------------------------------------------------------
 
 #include "tsDVBCSA2.h"
+#include "tsTSScrambling.h"
 #include "tsTSPacket.h"
+#include "tsTSProcessor.h"
+#include "tsPluginEventHandlerInterface.h"
+#include "tsPluginEventData.h"
+#include "tsOneShotPacketizer.h"
+#include "tsDuckProtocol.h"
+#include "tsCADescriptor.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
 #include "tsNames.h"
 #include "tsunit.h"
 
@@ -48,9 +57,17 @@ public:
     virtual void afterTest() override;
 
     void testScrambling();
+    void testBatch();
+    void testBatchPackets();
+    void testBatchFailure();
+    void testDescramblerWindowFailure();
 
     TSUNIT_TEST_BEGIN(ScramblingTest);
     TSUNIT_TEST(testScrambling);
+    TSUNIT_TEST(testBatch);
+    TSUNIT_TEST(testBatchPackets);
+    TSUNIT_TEST(testBatchFailure);
+    TSUNIT_TEST(testDescramblerWindowFailure);
     TSUNIT_TEST_END();
 };
 
@@ -210,3 +227,324 @@ void ScramblingTest::testScrambling()
         TSUNIT_ASSERT(::memcmp(pkt.b + header_size, vec->cipher.b + header_size, payload_size) == 0);
     }
 }
+
+namespace {
+    // Deterministic pseudo-random data, reproducible from one run to another.
+    class PseudoRandom
+    {
+    public:
+        PseudoRandom() : _state(0x0123456789ABCDEF) {}
+        uint32_t next()
+        {
+            _state ^= _state << 13;
+            _state ^= _state >> 7;
+            _state ^= _state << 17;
+            return uint32_t(_state >> 16);
+        }
+        void fill(uint8_t* data, size_t size)
+        {
+            for (size_t i = 0; i < size; ++i) {
+                data[i] = uint8_t(next());
+            }
+        }
+    private:
+        uint64_t _state;
+    };
+}
+
+void ScramblingTest::testBatch()
+{
+    // Compare batch decryption with packet-per-packet decryption on random data.
+    // Include short packets, residues and incomplete bitsliced batches.
+    PseudoRandom prng;
+    uint8_t cw[ts::DVBCSA2::KEY_SIZE];
+    prng.fill(cw, sizeof(cw));
+
+    ts::DVBCSA2 single;
+    ts::DVBCSA2 batch;
+    TSUNIT_ASSERT(single.setKey(cw, sizeof(cw)));
+    TSUNIT_ASSERT(batch.setKey(cw, sizeof(cw)));
+
+    static const size_t counts[] = {0, 1, 7, ts::DVBCSA2::BatchSize() - 1, ts::DVBCSA2::BatchSize(), 3 * ts::DVBCSA2::BatchSize() + 25, 1000};
+    for (auto count : counts) {
+        std::vector<ts::ByteBlock> ref(count);
+        std::vector<ts::ByteBlock> data(count);
+        std::vector<void*> addr(count);
+        std::vector<size_t> sizes(count);
+        for (size_t i = 0; i < count; ++i) {
+            const size_t size = i % 3 == 0 ? 1 + prng.next() % 184 : 184;
+            ref[i].resize(size);
+            prng.fill(ref[i].data(), size);
+            data[i] = ref[i];
+            addr[i] = data[i].data();
+            sizes[i] = size;
+            TSUNIT_ASSERT(single.decryptInPlace(ref[i].data(), size));
+        }
+        size_t decrypted = 0;
+        TSUNIT_ASSERT(batch.decryptInPlaceBatch(count, addr.data(), sizes.data(), &decrypted));
+        TSUNIT_EQUAL(count, decrypted);
+        for (size_t i = 0; i < count; ++i) {
+            TSUNIT_ASSERT(ref[i] == data[i]);
+        }
+    }
+
+    // When the usage limit of the control word is reached, only the leading data blocks are decrypted.
+    const size_t count = 100;
+    const size_t limit = 70;
+    std::vector<ts::ByteBlock> ref(count);
+    std::vector<ts::ByteBlock> data(count);
+    std::vector<void*> addr(count);
+    std::vector<size_t> sizes(count, 184);
+    TSUNIT_ASSERT(batch.setKey(cw, sizeof(cw)));
+    batch.setDecryptionMax(limit);
+    for (size_t i = 0; i < count; ++i) {
+        ref[i].resize(184);
+        prng.fill(ref[i].data(), ref[i].size());
+        data[i] = ref[i];
+        addr[i] = data[i].data();
+        if (i < limit) {
+            TSUNIT_ASSERT(single.decryptInPlace(ref[i].data(), ref[i].size()));
+        }
+    }
+    size_t decrypted = 0;
+    TSUNIT_ASSERT(!batch.decryptInPlaceBatch(count, addr.data(), sizes.data(), &decrypted));
+    TSUNIT_EQUAL(limit, decrypted);
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_ASSERT(ref[i] == data[i]);
+    }
+}
+
+void ScramblingTest::testBatchPackets()
+{
+    // Decrypt long sequences of test vectors with TSScrambling, by runs of same parity.
+    ts::TSScrambling scrambling;
+    const ScramblingTestVector* vec = scrambling_test_vectors;
+    const size_t vec_count = sizeof(scrambling_test_vectors) / sizeof(ScramblingTestVector);
+    TSUNIT_ASSERT(scrambling.setCW(ts::ByteBlock(vec->cw_even, sizeof(vec->cw_even)), ts::SC_EVEN_KEY));
+    TSUNIT_ASSERT(scrambling.setCW(ts::ByteBlock(vec->cw_odd, sizeof(vec->cw_odd)), ts::SC_ODD_KEY));
+
+    const size_t count = 500;
+    std::vector<ts::TSPacket> packets(count);
+    std::vector<ts::TSPacket*> addr(count);
+    for (size_t i = 0; i < count; ++i) {
+        packets[i] = i % 37 == 0 ? vec[0].plain : vec[(i / 50) % vec_count].cipher;
+        addr[i] = &packets[i];
+    }
+    TSUNIT_ASSERT(scrambling.decrypt(addr.data(), count));
+    for (size_t i = 0; i < count; ++i) {
+        const ts::TSPacket& plain(i % 37 == 0 ? vec[0].plain : vec[(i / 50) % vec_count].plain);
+        TSUNIT_ASSERT(packets[i] == plain);
+    }
+}
+
+namespace {
+    // Build a scrambled packet with a pseudo-random payload. Also return the clear packet.
+    void MakeScrambledPacket(PseudoRandom& prng, ts::TSScrambling& scrambling, ts::PID pid, uint8_t scv, ts::TSPacket& plain, ts::TSPacket& cipher)
+    {
+        plain.init(pid);
+        prng.fill(plain.getPayload(), plain.getPayloadSize());
+        cipher = plain;
+        TSUNIT_ASSERT(scrambling.setEncryptParity(scv));
+        TSUNIT_ASSERT(scrambling.encrypt(cipher));
+        TSUNIT_EQUAL(scv, cipher.getScrambling());
+    }
+}
+
+void ScramblingTest::testBatchFailure()
+{
+    // The odd control word is unknown to the descrambler, the batch fails on the first odd packet.
+    PseudoRandom prng;
+    ts::ByteBlock cw_even(ts::DVBCSA2::KEY_SIZE);
+    ts::ByteBlock cw_odd(ts::DVBCSA2::KEY_SIZE);
+    prng.fill(cw_even.data(), cw_even.size());
+    prng.fill(cw_odd.data(), cw_odd.size());
+
+    ts::TSScrambling encrypt;
+    TSUNIT_ASSERT(encrypt.setCW(cw_even, ts::SC_EVEN_KEY));
+    TSUNIT_ASSERT(encrypt.setCW(cw_odd, ts::SC_ODD_KEY));
+
+    static const uint8_t scvs[] = {ts::SC_EVEN_KEY, ts::SC_EVEN_KEY, ts::SC_CLEAR, ts::SC_EVEN_KEY, ts::SC_CLEAR, ts::SC_ODD_KEY, ts::SC_EVEN_KEY, ts::SC_ODD_KEY};
+    const size_t count = sizeof(scvs);
+    const size_t failing = 5;
+    std::vector<ts::TSPacket> plain(count);
+    std::vector<ts::TSPacket> cipher(count);
+    std::vector<ts::TSPacket*> addr(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (scvs[i] == ts::SC_CLEAR) {
+            plain[i].init(100);
+            cipher[i] = plain[i];
+        }
+        else {
+            MakeScrambledPacket(prng, encrypt, 100, scvs[i], plain[i], cipher[i]);
+        }
+    }
+
+    ts::TSScrambling decrypt;
+    TSUNIT_ASSERT(decrypt.setCW(cw_even, ts::SC_EVEN_KEY));
+
+    std::vector<ts::TSPacket> packets(cipher);
+    for (size_t i = 0; i < count; ++i) {
+        addr[i] = &packets[i];
+    }
+    size_t processed = 0;
+    TSUNIT_ASSERT(!decrypt.decrypt(addr.data(), count, &processed));
+    TSUNIT_EQUAL(failing, processed);
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_ASSERT(packets[i] == (i < failing ? plain[i] : cipher[i]));
+    }
+
+    // Same thing without the failing packets.
+    packets = cipher;
+    TSUNIT_ASSERT(decrypt.decrypt(addr.data(), failing, &processed));
+    TSUNIT_EQUAL(failing, processed);
+}
+
+
+//----------------------------------------------------------------------------
+// Descrambler plugin with packet windows, using clear ECM's.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Memory input plugin handler: send packets one by one.
+    class Input : public ts::PluginEventHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(Input);
+    public:
+        Input(const ts::TSPacketVector& packets) : _packets(packets), _next(0) {}
+        virtual void handlePluginEvent(const ts::PluginEventContext& context) override
+        {
+            ts::PluginEventData* data = dynamic_cast<ts::PluginEventData*>(context.pluginData());
+            if (data != nullptr && _next < _packets.size()) {
+                data->append(&_packets[_next++], ts::PKT_SIZE);
+            }
+        }
+    private:
+        const ts::TSPacketVector& _packets;
+        size_t _next;
+    };
+
+    // Memory output plugin handler: fill a vector of packets.
+    class Output : public ts::PluginEventHandlerInterface
+    {
+        TS_NOBUILD_NOCOPY(Output);
+    public:
+        Output(ts::TSPacketVector& packets) : _packets(packets) {}
+        virtual void handlePluginEvent(const ts::PluginEventContext& context) override
+        {
+            ts::PluginEventData* data = dynamic_cast<ts::PluginEventData*>(context.pluginData());
+            if (data != nullptr) {
+                const size_t count = data->size() / ts::PKT_SIZE;
+                const size_t index = _packets.size();
+                _packets.resize(index + count);
+                ts::TSPacket::Copy(&_packets[index], data->data(), count);
+            }
+        }
+    private:
+        ts::TSPacketVector& _packets;
+    };
+
+    // Run the descrambler plugin on a list of packets.
+    void Descramble(const ts::TSPacketVector& input, ts::TSPacketVector& output, const ts::UStringVector& args)
+    {
+        Input in(input);
+        Output out(output);
+        ts::TSProcessorArgs opt;
+        opt.input = {u"memory", {}};
+        opt.plugins = {{u"descrambler", args}};
+        opt.output = {u"memory", {}};
+        ts::TSProcessor tsproc(NULLREP);
+        tsproc.registerEventHandler(&in, ts::PluginType::INPUT);
+        tsproc.registerEventHandler(&out, ts::PluginType::OUTPUT);
+        TSUNIT_ASSERT(tsproc.start(opt));
+        tsproc.waitForTermination();
+    }
+
+    // Packetize a clear ECM.
+    void AddECM(ts::DuckContext& duck, ts::TSPacketVector& packets, ts::PID pid, ts::TID tid, const ts::ByteBlock& cw_even, const ts::ByteBlock& cw_odd)
+    {
+        ts::duck::ClearECM ecm;
+        ecm.cw_even = cw_even;
+        ecm.cw_odd = cw_odd;
+        ts::ByteBlockPtr bin(new ts::ByteBlock);
+        ts::tlv::Serializer zer(bin);
+        ecm.serialize(zer);
+        ts::OneShotPacketizer pzer(duck, pid);
+        pzer.addSection(ts::SectionPtr(new ts::Section(tid, true, bin->data(), bin->size())));
+        ts::TSPacketVector ecm_packets;
+        pzer.getPackets(ecm_packets);
+        packets.insert(packets.end(), ecm_packets.begin(), ecm_packets.end());
+    }
+}
+
+void ScramblingTest::testDescramblerWindowFailure()
+{
+    constexpr ts::PID pmt_pid = 200;
+    constexpr ts::PID es_pid = 201;
+    constexpr ts::PID ecm_pid = 202;
+
+    PseudoRandom prng;
+    ts::DuckContext duck;
+    ts::TSPacketVector input;
+    ts::TSPacketVector expected;
+
+    // PAT and PMT of service 1, with ECM's.
+    ts::PAT pat(0, true, 1);
+    pat.pmts[1] = pmt_pid;
+    ts::PMT pmt(0, true, 1, es_pid);
+    pmt.descs.add(duck, ts::CADescriptor(0x1234, ecm_pid));
+    pmt.streams[es_pid].stream_type = ts::ST_MPEG2_VIDEO;
+    ts::OneShotPacketizer pzer(duck, ts::PID_PAT);
+    pzer.addTable(duck, pat);
+    pzer.getPackets(input);
+    pzer.setPID(pmt_pid);
+    pzer.addTable(duck, pmt);
+    ts::TSPacketVector pmt_packets;
+    pzer.getPackets(pmt_packets);
+    input.insert(input.end(), pmt_packets.begin(), pmt_packets.end());
+
+    // Control words. The odd one in the ECM's is invalid, odd packets cannot be descrambled.
+    ts::ByteBlock cw_even1(ts::DVBCSA2::KEY_SIZE);
+    ts::ByteBlock cw_even2(ts::DVBCSA2::KEY_SIZE);
+    ts::ByteBlock cw_odd(ts::DVBCSA2::KEY_SIZE);
+    const ts::ByteBlock bad_cw(3, 0xFF);
+    prng.fill(cw_even1.data(), cw_even1.size());
+    prng.fill(cw_even2.data(), cw_even2.size());
+    prng.fill(cw_odd.data(), cw_odd.size());
+    ts::TSScrambling scrambling;
+    TSUNIT_ASSERT(scrambling.setCW(cw_even1, ts::SC_EVEN_KEY));
+    TSUNIT_ASSERT(scrambling.setCW(cw_odd, ts::SC_ODD_KEY));
+
+    // First crypto-period: 3 even packets, one undecipherable odd packet, 2 even packets.
+    AddECM(duck, input, ecm_pid, ts::TID_ECM_80, cw_even1, bad_cw);
+    expected = input;
+    ts::TSPacket plain, cipher;
+    for (size_t i = 0; i < 3; ++i) {
+        MakeScrambledPacket(prng, scrambling, es_pid, ts::SC_EVEN_KEY, plain, cipher);
+        input.push_back(cipher);
+        expected.push_back(plain);
+    }
+    for (size_t i = 0; i < 3; ++i) {
+        MakeScrambledPacket(prng, scrambling, es_pid, i == 0 ? ts::SC_ODD_KEY : ts::SC_EVEN_KEY, plain, cipher);
+        input.push_back(cipher);
+    }
+
+    // New even control word. The first even packet flushes the pending packets from the window.
+    AddECM(duck, input, ecm_pid, ts::TID_ECM_81, cw_even2, bad_cw);
+    TSUNIT_ASSERT(scrambling.setCW(cw_even2, ts::SC_EVEN_KEY));
+    for (size_t i = 0; i < 3; ++i) {
+        MakeScrambledPacket(prng, scrambling, es_pid, ts::SC_EVEN_KEY, plain, cipher);
+        input.push_back(cipher);
+    }
+
+    // Packet per packet: terminate on the odd packet.
+    ts::TSPacketVector output;
+    Descramble(input, output, {u"1"});
+    TSUNIT_EQUAL(expected.size(), output.size());
+    TSUNIT_ASSERT(output == expected);
+
+    // Packet window: same result, the failing packet is in the middle of the window.
+    output.clear();
+    Descramble(input, output, {u"1", u"--packet-window", u"1000"});
+    TSUNIT_EQUAL(expected.size(), output.size());
+    TSUNIT_ASSERT(output == expected);
+}
@@ -0,0 +1,463 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2022, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for TSAnalyzer class.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSAnalyzer.h"
+#include "tsOneShotPacketizer.h"
+#include "tsDuckContext.h"
+#include "tsBinaryTable.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsMonotonic.h"
+#include "tsSysUtils.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSAnalyzerTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testServices();
+    void testContinuity();
+    void testReset();
+    void testMerge();
+    void testMergeOverlap();
+    void testBenchmark();
+
+    TSUNIT_TEST_BEGIN(TSAnalyzerTest);
+    TSUNIT_TEST(testServices);
+    TSUNIT_TEST(testContinuity);
+    TSUNIT_TEST(testReset);
+    TSUNIT_TEST(testMerge);
+    TSUNIT_TEST(testMergeOverlap);
+    TSUNIT_TEST(testBenchmark);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(TSAnalyzerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TSAnalyzerTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void TSAnalyzerTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Synthetic multi-service transport stream at 100 Mb/s.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // Characteristics of the synthetic stream.
+    const size_t   SERVICE_COUNT = 10;
+    const uint64_t TS_BITRATE = 100000000;
+
+    // Each sequence of 100 packets contains, for each of the 10 services,
+    // 8 video packets (PCR in the first one), 1 audio packet and one spare
+    // slot. The spare slot of the last service carries PAT and PMT's in
+    // sequence, the others are null packets.
+    class StreamGenerator
+    {
+        TS_NOCOPY(StreamGenerator);
+    public:
+        static uint16_t ServiceId(size_t srv) { return uint16_t(srv + 1); }
+        static ts::PID PMTPID(size_t srv) { return ts::PID(0x0100 + srv); }
+        static ts::PID VideoPID(size_t srv) { return ts::PID(0x1000 + 16 * srv); }
+        static ts::PID AudioPID(size_t srv) { return ts::PID(0x1001 + 16 * srv); }
+
+        StreamGenerator();
+        void next(ts::TSPacket& pkt);
+        void skipPacket(ts::PID pid) { _cc[pid] = (_cc[pid] + 1) & ts::CC_MASK; }
+        uint64_t packetCount() const { return _count; }
+
+    private:
+        ts::TSPacketVector _psi;
+        size_t   _psi_next;
+        uint64_t _count;
+        uint8_t  _cc[ts::PID_MAX];
+
+        static void startPES(ts::TSPacket& pkt, uint8_t stream_id);
+    };
+
+    StreamGenerator::StreamGenerator() :
+        _psi(),
+        _psi_next(0),
+        _count(0),
+        _cc()
+    {
+        ts::DuckContext duck;
+        ts::PAT pat(0, true, 1);
+        for (size_t srv = 0; srv < SERVICE_COUNT; ++srv) {
+            pat.pmts[ServiceId(srv)] = PMTPID(srv);
+        }
+        ts::BinaryTable bin;
+        pat.serialize(duck, bin);
+        ts::OneShotPacketizer pzer(duck, ts::PID_PAT);
+        pzer.addTable(bin);
+        pzer.getPackets(_psi);
+
+        for (size_t srv = 0; srv < SERVICE_COUNT; ++srv) {
+            ts::PMT pmt(0, true, ServiceId(srv), VideoPID(srv));
+            pmt.streams[VideoPID(srv)].stream_type = ts::ST_MPEG2_VIDEO;
+            pmt.streams[AudioPID(srv)].stream_type = ts::ST_MPEG2_AUDIO;
+            pmt.serialize(duck, bin);
+            ts::TSPacketVector pkts;
+            ts::OneShotPacketizer pzer2(duck, PMTPID(srv));
+            pzer2.addTable(bin);
+            pzer2.getPackets(pkts);
+            _psi.insert(_psi.end(), pkts.begin(), pkts.end());
+        }
+    }
+
+    void StreamGenerator::startPES(ts::TSPacket& pkt, uint8_t stream_id)
+    {
+        // PES header with unbounded size.
+        pkt.setPUSI();
+        pkt.b[4] = 0x00;
+        pkt.b[5] = 0x00;
+        pkt.b[6] = 0x01;
+        pkt.b[7] = stream_id;
+    }
+
+    void StreamGenerator::next(ts::TSPacket& pkt)
+    {
+        const size_t slot = size_t(_count % 100);
+        const size_t srv = slot / 10;
+        const size_t index = slot % 10;
+
+        if (index == 9 && srv + 1 < SERVICE_COUNT) {
+            pkt = ts::NullPacket;
+        }
+        else {
+            if (index == 9) {
+                pkt = _psi[_psi_next];
+                _psi_next = (_psi_next + 1) % _psi.size();
+            }
+            else if (index < 8) {
+                pkt.init(VideoPID(srv), 0, 0x00);
+                if (index == 0) {
+                    startPES(pkt, 0xE0);
+                    pkt.setPCR((_count * ts::PKT_SIZE_BITS * ts::SYSTEM_CLOCK_FREQ) / TS_BITRATE, true);
+                }
+            }
+            else {
+                pkt.init(AudioPID(srv), 0, 0x00);
+                startPES(pkt, 0xC0);
+            }
+            const ts::PID pid = pkt.getPID();
+            pkt.setCC(_cc[pid]);
+            _cc[pid] = (_cc[pid] + 1) & ts::CC_MASK;
+        }
+        _count++;
+    }
+
+    // Give access to the protected PID contexts and global statistics.
+    class Analyzer: public ts::TSAnalyzer
+    {
+        TS_NOBUILD_NOCOPY(Analyzer);
+    public:
+        explicit Analyzer(ts::DuckContext& duck) : ts::TSAnalyzer(duck) {}
+        using ts::TSAnalyzer::pidExists;
+        const PIDContext& pid(ts::PID p) { recomputeStatistics(); return *getPID(p); }
+        ts::BitRate pcrBitrate() { recomputeStatistics(); return _ts_pcr_bitrate_188; }
+        size_t pidCount() { recomputeStatistics(); return _pid_cnt; }
+    };
+
+    void FeedAnalyzer(ts::TSAnalyzer& analyzer, StreamGenerator& gen, size_t count)
+    {
+        ts::TSPacket pkt;
+        for (size_t i = 0; i < count; ++i) {
+            gen.next(pkt);
+            analyzer.feedPacket(pkt);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Test cases
+//----------------------------------------------------------------------------
+
+void TSAnalyzerTest::testServices()
+{
+    ts::DuckContext duck;
+    Analyzer analyzer(duck);
+    StreamGenerator gen;
+    FeedAnalyzer(analyzer, gen, 20000);
+
+    std::vector<uint16_t> services;
+    analyzer.getServiceIds(services);
+    TSUNIT_EQUAL(SERVICE_COUNT, services.size());
+
+    for (size_t srv = 0; srv < SERVICE_COUNT; ++srv) {
+        std::vector<ts::PID> pids;
+        analyzer.getPIDsOfService(pids, StreamGenerator::ServiceId(srv));
+        TSUNIT_EQUAL(3, pids.size());
+        TSUNIT_EQUAL(StreamGenerator::PMTPID(srv), pids[0]);
+        TSUNIT_EQUAL(StreamGenerator::VideoPID(srv), pids[1]);
+        TSUNIT_EQUAL(StreamGenerator::AudioPID(srv), pids[2]);
+
+        TSUNIT_ASSERT(analyzer.pidExists(StreamGenerator::VideoPID(srv)));
+        const auto& video(analyzer.pid(StreamGenerator::VideoPID(srv)));
+        TSUNIT_EQUAL(1600, video.ts_pkt_cnt);
+        TSUNIT_EQUAL(200, video.pcr_cnt);
+        TSUNIT_EQUAL(200, video.pl_start_cnt);
+        TSUNIT_EQUAL(0, video.unexp_discont);
+        TSUNIT_ASSERT(video.carry_video);
+        TSUNIT_ASSERT(video.is_pcr_pid);
+
+        const auto& audio(analyzer.pid(StreamGenerator::AudioPID(srv)));
+        TSUNIT_EQUAL(200, audio.ts_pkt_cnt);
+        TSUNIT_EQUAL(0, audio.pcr_cnt);
+        TSUNIT_ASSERT(audio.carry_audio);
+    }
+
+    // PAT, PMT's, video and audio PID's, null PID.
+    TSUNIT_EQUAL(2 + 3 * SERVICE_COUNT, analyzer.pidCount());
+
+    // The bitrate is exactly computed from the PCR's.
+    TSUNIT_EQUAL(TS_BITRATE, uint64_t(analyzer.pcrBitrate().toInt()));
+}
+
+void TSAnalyzerTest::testContinuity()
+{
+    ts::DuckContext duck;
+    Analyzer analyzer(duck);
+    StreamGenerator gen;
+    const ts::PID video = StreamGenerator::VideoPID(3);
+    const ts::PID audio = StreamGenerator::AudioPID(5);
+
+    FeedAnalyzer(analyzer, gen, 5000);
+    gen.skipPacket(video);
+    FeedAnalyzer(analyzer, gen, 5000);
+    gen.skipPacket(video);
+    gen.skipPacket(audio);
+    FeedAnalyzer(analyzer, gen, 5000);
+
+    TSUNIT_EQUAL(2, analyzer.pid(video).unexp_discont);
+    TSUNIT_EQUAL(1, analyzer.pid(audio).unexp_discont);
+    TSUNIT_EQUAL(0, analyzer.pid(StreamGenerator::VideoPID(4)).unexp_discont);
+    TSUNIT_EQUAL(0, analyzer.pid(StreamGenerator::AudioPID(4)).unexp_discont);
+}
+
+void TSAnalyzerTest::testReset()
+{
+    ts::DuckContext duck;
+    Analyzer analyzer(duck);
+    StreamGenerator gen;
+
+    FeedAnalyzer(analyzer, gen, 10000);
+    TSUNIT_ASSERT(analyzer.pidExists(StreamGenerator::VideoPID(0)));
+    TSUNIT_ASSERT(!analyzer.pidExists(0x1FF0));
+
+    analyzer.reset();
+    TSUNIT_ASSERT(!analyzer.pidExists(StreamGenerator::VideoPID(0)));
+
+    // After reset, all PID contexts are recreated from scratch.
+    FeedAnalyzer(analyzer, gen, 10000);
+    TSUNIT_ASSERT(analyzer.pidExists(StreamGenerator::VideoPID(0)));
+    TSUNIT_EQUAL(800, analyzer.pid(StreamGenerator::VideoPID(0)).ts_pkt_cnt);
+    TSUNIT_EQUAL(100, analyzer.pid(StreamGenerator::AudioPID(9)).ts_pkt_cnt);
+    TSUNIT_EQUAL(0, analyzer.pid(StreamGenerator::AudioPID(9)).unexp_discont);
+}
+
+void TSAnalyzerTest::testMerge()
+{
+    // Analyze the same stream in one pass and in three parts.
+    ts::DuckContext duck;
+    Analyzer ref(duck);
+    ts::DuckContext duck1;
+    Analyzer part1(duck1);
+    ts::DuckContext duck2;
+    Analyzer part2(duck2);
+    ts::DuckContext duck3;
+    Analyzer part3(duck3);
+
+    const ts::PID video = StreamGenerator::VideoPID(2);
+    const ts::PID audio = StreamGenerator::AudioPID(7);
+
+    StreamGenerator gen;
+    ts::TSPacket pkt;
+    for (size_t i = 0; i < 30000; ++i) {
+        // Discontinuities inside the parts and exactly at their boundaries.
+        if (i == 5000 || i == 10000) {
+            gen.skipPacket(video);
+        }
+        if (i == 20000 || i == 25000) {
+            gen.skipPacket(audio);
+        }
+        gen.next(pkt);
+        ref.feedPacket(pkt);
+        // The second boundary is not aligned on the structure of the stream.
+        (i < 10000 ? part1 : (i < 20037 ? part2 : part3)).feedPacket(pkt);
+    }
+
+    part1.merge(part2);
+    part1.merge(part3);
+
+    std::vector<uint16_t> services;
+    part1.getServiceIds(services);
+    TSUNIT_EQUAL(SERVICE_COUNT, services.size());
+    TSUNIT_EQUAL(ref.pidCount(), part1.pidCount());
+
+    std::vector<ts::PID> pids;
+    ref.getPIDs(pids);
+    for (auto pid : pids) {
+        const auto& rpc(ref.pid(pid));
+        const auto& mpc(part1.pid(pid));
+        TSUNIT_EQUAL(rpc.ts_pkt_cnt, mpc.ts_pkt_cnt);
+        TSUNIT_EQUAL(rpc.unexp_discont, mpc.unexp_discont);
+        TSUNIT_EQUAL(rpc.duplicated, mpc.duplicated);
+        TSUNIT_EQUAL(rpc.pcr_cnt, mpc.pcr_cnt);
+        TSUNIT_EQUAL(rpc.pl_start_cnt, mpc.pl_start_cnt);
+        TSUNIT_EQUAL(rpc.carry_audio, mpc.carry_audio);
+        TSUNIT_EQUAL(rpc.carry_video, mpc.carry_video);
+        TSUNIT_ASSERT(rpc.services == mpc.services);
+    }
+    TSUNIT_EQUAL(2, part1.pid(video).unexp_discont);
+    TSUNIT_EQUAL(2, part1.pid(audio).unexp_discont);
+    TSUNIT_EQUAL(TS_BITRATE, uint64_t(part1.pcrBitrate().toInt()));
+}
+
+void TSAnalyzerTest::testMergeOverlap()
+{
+    // Analyze the same stream in one pass and in three overlapping parts.
+    ts::DuckContext duck;
+    Analyzer ref(duck);
+    ts::DuckContext duck1;
+    Analyzer part1(duck1);
+    ts::DuckContext duck2;
+    Analyzer part2(duck2);
+    ts::DuckContext duck3;
+    Analyzer part3(duck3);
+
+    // The resynchronization window contains at least one PAT and all PMT's.
+    const size_t window = 2000;
+    part2.setResyncWindow(window);
+    part3.setResyncWindow(window);
+
+    const ts::PID video = StreamGenerator::VideoPID(2);
+    StreamGenerator gen;
+    ts::TSPacket pkt;
+    for (size_t i = 0; i < 30000; ++i) {
+        if (i == 10000) {
+            gen.skipPacket(video);
+        }
+        gen.next(pkt);
+        ref.feedPacket(pkt);
+        if (i < 10000) {
+            part1.feedPacket(pkt);
+        }
+        if (i >= 10000 - window && i < 20037) {
+            part2.feedPacket(pkt);
+        }
+        if (i >= 20037 - window) {
+            part3.feedPacket(pkt);
+        }
+    }
+
+    part1.merge(part2);
+    part1.merge(part3);
+    TSUNIT_EQUAL(ref.pidCount(), part1.pidCount());
+
+    std::vector<ts::PID> pids;
+    ref.getPIDs(pids);
+    for (auto pid : pids) {
+        const auto& rpc(ref.pid(pid));
+        const auto& mpc(part1.pid(pid));
+        TSUNIT_EQUAL(rpc.ts_pkt_cnt, mpc.ts_pkt_cnt);
+        TSUNIT_EQUAL(rpc.unexp_discont, mpc.unexp_discont);
+        TSUNIT_EQUAL(rpc.duplicated, mpc.duplicated);
+        TSUNIT_EQUAL(rpc.pmt_cnt, mpc.pmt_cnt);
+        TSUNIT_EQUAL(rpc.sections.size(), mpc.sections.size());
+        for (const auto& it : rpc.sections) {
+            const auto mit = mpc.sections.find(it.first);
+            TSUNIT_ASSERT(mit != mpc.sections.end());
+            TSUNIT_EQUAL(it.second->section_count, mit->second->section_count);
+            TSUNIT_EQUAL(it.second->table_count, mit->second->table_count);
+        }
+    }
+    TSUNIT_EQUAL(1, part1.pid(video).unexp_discont);
+    TSUNIT_EQUAL(TS_BITRATE, uint64_t(part1.pcrBitrate().toInt()));
+}
+
+void TSAnalyzerTest::testBenchmark()
+{
+    if (!ts::EnvironmentExists(u"UTEST_BENCHMARK_ALLOWED")) {
+        debug() << "TSAnalyzerTest: benchmark skipped, define UTEST_BENCHMARK_ALLOWED to run it" << std::endl;
+        return;
+    }
+
+    // Ten seconds of a 100 Mb/s stream.
+    const size_t count = size_t((10 * TS_BITRATE) / ts::PKT_SIZE_BITS);
+
+    // Reference time: generation of the stream only.
+    ts::TSPacket pkt;
+    StreamGenerator gen1;
+    ts::Monotonic start(true);
+    for (size_t i = 0; i < count; ++i) {
+        gen1.next(pkt);
+    }
+    const ts::NanoSecond gen_duration = ts::Monotonic(true) - start;
+
+    ts::DuckContext duck;
+    Analyzer analyzer(duck);
+    StreamGenerator gen2;
+    start.getSystemTime();
+    FeedAnalyzer(analyzer, gen2, count);
+    const ts::NanoSecond duration = std::max<ts::NanoSecond>(1, ts::Monotonic(true) - start - gen_duration);
+
+    TSUNIT_EQUAL(count, gen2.packetCount());
+    TSUNIT_EQUAL(0, analyzer.pid(StreamGenerator::VideoPID(0)).unexp_discont);
+    std::cerr << "TSAnalyzerTest: " << count << " packets, " << SERVICE_COUNT << " services, "
+              << (uint64_t(count) * ts::NanoSecPerSec / uint64_t(duration)) << " packets/s, "
+              << (uint64_t(count) * ts::PKT_SIZE_BITS * ts::NanoSecPerSec / (uint64_t(duration) * 1000000)) << " Mb/s"
+              << std::endl;
+}
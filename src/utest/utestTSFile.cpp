@@ -37,6 +37,8 @@
 #include "tsCerrReport.h"
 #include "tsNullReport.h"
 #include "tsFileUtils.h"
+#include "tsMonotonic.h"
+#include "tsSysUtils.h"
 #include "tsunit.h"
 
 
@@ -57,6 +59,10 @@ public:
     void testDuck();
     void testStuffingRead();
     void testStuffingWrite();
+    void testDirectWrite();
+    void testMemoryMap();
+    void testAsyncIO();
+    void testInterleaveBenchmark();
 
     TSUNIT_TEST_BEGIN(TSFileTest);
     TSUNIT_TEST(testTS);
@@ -64,6 +70,10 @@ public:
     TSUNIT_TEST(testDuck);
     TSUNIT_TEST(testStuffingRead);
     TSUNIT_TEST(testStuffingWrite);
+    TSUNIT_TEST(testDirectWrite);
+    TSUNIT_TEST(testMemoryMap);
+    TSUNIT_TEST(testAsyncIO);
+    TSUNIT_TEST(testInterleaveBenchmark);
     TSUNIT_TEST_END();
 
 private:
@@ -395,3 +405,233 @@ void TSFileTest::testStuffingWrite()
     TSUNIT_EQUAL(184, packets[5].getPayloadSize());
     TSUNIT_EQUAL(0xFF, packets[5].getPayload()[0]);
 }
+
+void TSFileTest::testDirectWrite()
+{
+    // Write more than the direct I/O buffer size, not a multiple of the alignment.
+    ts::TSFile file;
+    ts::TSPacketVector packets(7001);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i].init(ts::PID(i % 8000), uint8_t(i), uint8_t(i >> 4));
+    }
+
+    file.setStuffing(1, 2);
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE | ts::TSFile::DIRECT, CERR));
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, 5000, CERR));
+    TSUNIT_ASSERT(file.writePackets(&packets[5000], nullptr, packets.size() - 5000, CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(packets.size() + 3, file.writePacketsCount());
+    TSUNIT_EQUAL((packets.size() + 3) * ts::PKT_SIZE, ts::GetFileSize(_tempFileName));
+
+    // Read it back.
+    ts::TSPacketVector inpackets(packets.size() + 10);
+    file.setStuffing(0, 0);
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::READ, CERR));
+    TSUNIT_EQUAL(packets.size() + 3, file.readPackets(inpackets.data(), nullptr, inpackets.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(ts::PID_NULL, inpackets[0].getPID());
+    TSUNIT_EQUAL(0, ::memcmp(packets.data(), &inpackets[1], packets.size() * ts::PKT_SIZE));
+    TSUNIT_EQUAL(ts::PID_NULL, inpackets[packets.size() + 1].getPID());
+    TSUNIT_EQUAL(ts::PID_NULL, inpackets[packets.size() + 2].getPID());
+
+    // Seek back while data are pending in the direct I/O buffer, then overwrite the first packets.
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE | ts::TSFile::DIRECT, CERR));
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, 5000, CERR));
+    TSUNIT_ASSERT(file.rewind(CERR));
+    TSUNIT_ASSERT(file.writePackets(&packets[5000], nullptr, 10, CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(5000 * ts::PKT_SIZE, ts::GetFileSize(_tempFileName));
+
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::READ, CERR));
+    TSUNIT_EQUAL(5000, file.readPackets(inpackets.data(), nullptr, inpackets.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(0, ::memcmp(&packets[5000], inpackets.data(), 10 * ts::PKT_SIZE));
+    TSUNIT_EQUAL(0, ::memcmp(&packets[10], &inpackets[10], 4990 * ts::PKT_SIZE));
+}
+
+void TSFileTest::testMemoryMap()
+{
+    ts::TSFile file;
+    ts::TSPacketVector packets(1000);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i].init(ts::PID(i), uint8_t(i), uint8_t(i >> 4));
+    }
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR));
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, packets.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+
+    // Read through the mapped area, with start offset and repetition.
+    file.setIOFlags(ts::TSFile::MMAP);
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 2, 10 * ts::PKT_SIZE, CERR));
+    debug() << "TSFileTest::testMemoryMap: memory-mapped: " << ts::UString::YesNo(file.isMemoryMapped()) << std::endl;
+    ts::TSPacketVector inpackets(3000);
+    TSUNIT_EQUAL(1980, file.readPackets(inpackets.data(), nullptr, inpackets.size(), CERR));
+    TSUNIT_EQUAL(0, ::memcmp(&packets[10], &inpackets[0], 990 * ts::PKT_SIZE));
+    TSUNIT_EQUAL(0, ::memcmp(&packets[10], &inpackets[990], 990 * ts::PKT_SIZE));
+    TSUNIT_EQUAL(0, file.readPackets(inpackets.data(), nullptr, inpackets.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+
+    // Direct access to packets in the mapped area.
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 2, 0, CERR));
+    const ts::TSPacket* pkts = nullptr;
+    size_t total = 0;
+    size_t count = 300;
+    if (file.mapPackets(pkts, count, CERR)) {
+        TSUNIT_ASSERT(file.isMemoryMapped());
+        while (count > 0) {
+            TSUNIT_ASSERT(pkts != nullptr);
+            TSUNIT_ASSERT(count <= 300);
+            for (size_t i = 0; i < count; ++i) {
+                TSUNIT_EQUAL(packets[(total + i) % packets.size()].getPID(), pkts[i].getPID());
+            }
+            total += count;
+            count = 300;
+            TSUNIT_ASSERT(file.mapPackets(pkts, count, CERR));
+        }
+        TSUNIT_EQUAL(2000, total);
+        TSUNIT_EQUAL(2000, file.readPacketsCount());
+        TSUNIT_EQUAL(ts::TSPacketFormat::TS, file.packetFormat());
+    }
+    else {
+        TSUNIT_ASSERT(!file.isMemoryMapped());
+    }
+    TSUNIT_ASSERT(file.close(CERR));
+
+    // Files with artificial stuffing cannot be directly accessed.
+    file.setStuffing(1, 0);
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 1, 0, CERR));
+    count = 10;
+    TSUNIT_ASSERT(!file.mapPackets(pkts, count, CERR));
+    TSUNIT_EQUAL(0, count);
+    TSUNIT_EQUAL(1001, file.readPackets(inpackets.data(), nullptr, inpackets.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+}
+
+void TSFileTest::testAsyncIO()
+{
+    // Write several I/O buffers, not a multiple of the buffer size.
+    ts::TSFile file;
+    ts::TSPacketVector packets(10001);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i].init(ts::PID(i % 8000), uint8_t(i), uint8_t(i >> 4));
+    }
+
+    file.setIOFlags(ts::TSFile::ASYNC);
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR));
+    debug() << "TSFileTest::testAsyncIO: asynchronous write: " << ts::UString::YesNo(file.isAsynchronous()) << std::endl;
+    for (size_t i = 0; i < packets.size(); i += 1000) {
+        TSUNIT_ASSERT(file.writePackets(&packets[i], nullptr, std::min<size_t>(1000, packets.size() - i), CERR));
+    }
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_ASSERT(!file.isAsynchronous());
+    TSUNIT_EQUAL(packets.size(), file.writePacketsCount());
+    TSUNIT_EQUAL(packets.size() * ts::PKT_SIZE, ts::GetFileSize(_tempFileName));
+
+    // Read it back twice, with start offset, in odd chunks.
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 2, 5 * ts::PKT_SIZE, CERR));
+    debug() << "TSFileTest::testAsyncIO: asynchronous read: " << ts::UString::YesNo(file.isAsynchronous()) << std::endl;
+    ts::TSPacketVector inpackets(2 * packets.size());
+    size_t count = 0;
+    size_t size = 0;
+    do {
+        size = file.readPackets(&inpackets[count], nullptr, std::min<size_t>(777, inpackets.size() - count), CERR);
+        count += size;
+    } while (size > 0 && count < inpackets.size());
+    TSUNIT_EQUAL(0, file.readPackets(&inpackets[0], nullptr, 1, CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL(2 * (packets.size() - 5), count);
+    TSUNIT_EQUAL(0, ::memcmp(&packets[5], &inpackets[0], (packets.size() - 5) * ts::PKT_SIZE));
+    TSUNIT_EQUAL(0, ::memcmp(&packets[5], &inpackets[packets.size() - 5], (packets.size() - 5) * ts::PKT_SIZE));
+
+    // Seek in rewindable mode.
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 0, CERR));
+    TSUNIT_EQUAL(10, file.readPackets(inpackets.data(), nullptr, 10, CERR));
+    TSUNIT_ASSERT(file.seek(9000, CERR));
+    TSUNIT_EQUAL(1001, file.readPackets(inpackets.data(), nullptr, inpackets.size(), CERR));
+    TSUNIT_EQUAL(0, ::memcmp(&packets[9000], &inpackets[0], 1001 * ts::PKT_SIZE));
+    TSUNIT_ASSERT(file.rewind(CERR));
+    TSUNIT_EQUAL(3, file.readPackets(inpackets.data(), nullptr, 3, CERR));
+    TSUNIT_EQUAL(0, ::memcmp(&packets[0], &inpackets[0], 3 * ts::PKT_SIZE));
+    TSUNIT_ASSERT(file.close(CERR));
+
+    // Asynchronous I/O is not used in append mode.
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::APPEND, CERR));
+    TSUNIT_ASSERT(!file.isAsynchronous());
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, 10, CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_EQUAL((packets.size() + 10) * ts::PKT_SIZE, ts::GetFileSize(_tempFileName));
+    file.setIOFlags(ts::TSFile::NONE);
+}
+
+void TSFileTest::testInterleaveBenchmark()
+{
+    if (!ts::EnvironmentExists(u"UTEST_BENCHMARK_ALLOWED")) {
+        debug() << "TSFileTest: benchmark skipped, define UTEST_BENCHMARK_ALLOWED to run it" << std::endl;
+        return;
+    }
+
+    // Read several files simultaneously, in small chunks, as with option --interleave in plugin "file".
+    const size_t file_count = 4;
+    const size_t packet_count = 20000;
+    const size_t chunk = 100;
+
+    // Create the input files.
+    ts::UStringVector names;
+    ts::TSPacketVector packets(packet_count);
+    for (size_t i = 0; i < packet_count; ++i) {
+        packets[i].init(ts::PID(i % 8000), uint8_t(i), uint8_t(i >> 4));
+    }
+    for (size_t fi = 0; fi < file_count; ++fi) {
+        names.push_back(ts::TempFile(u".ts"));
+        ts::TSFile file;
+        TSUNIT_ASSERT(file.open(names.back(), ts::TSFile::WRITE, CERR));
+        TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, packets.size(), CERR));
+        TSUNIT_ASSERT(file.close(CERR));
+    }
+
+    static const struct {
+        ts::TSFile::OpenFlags flags;
+        const char* name;
+    } modes[] = {
+        {ts::TSFile::NONE,  "standard I/O"},
+        {ts::TSFile::ASYNC, "io_uring"},
+        {ts::TSFile::MMAP,  "memory-mapped"},
+    };
+
+    for (const auto& mode : modes) {
+        std::vector<ts::TSFile> files(file_count);
+        bool async = false;
+        for (size_t fi = 0; fi < file_count; ++fi) {
+            files[fi].setIOFlags(mode.flags);
+            TSUNIT_ASSERT(files[fi].openRead(names[fi], 1, 0, CERR));
+            async = async || files[fi].isAsynchronous();
+        }
+        ts::TSPacketVector buffer(chunk);
+        size_t total = 0;
+        size_t active = file_count;
+        ts::Monotonic start(true);
+        while (active > 0) {
+            active = 0;
+            for (auto& file : files) {
+                const size_t count = file.readPackets(buffer.data(), nullptr, buffer.size(), CERR);
+                if (count > 0) {
+                    total += count;
+                    active++;
+                }
+            }
+        }
+        const ts::NanoSecond duration = ts::Monotonic(true) - start;
+        for (auto& file : files) {
+            TSUNIT_ASSERT(file.close(CERR));
+        }
+        TSUNIT_EQUAL(file_count * packet_count, total);
+        std::cerr << "TSFileTest: interleaved read, " << file_count << " files, " << mode.name
+                  << (mode.flags == ts::TSFile::ASYNC && !async ? " (not supported)" : "") << ", "
+                  << (duration <= 0 ? 0 : (total * ts::PKT_SIZE * ts::NanoSecPerSec) / (size_t(duration) * 1024 * 1024)) << " MB/s"
+                  << std::endl;
+    }
+
+    for (const auto& name : names) {
+        ts::DeleteFile(name, NULLREP);
+    }
+}
@@ -55,6 +55,11 @@ public:
     void testSetPayloadSize();
     void testFlags();
     void testPrivateData();
+    void testFindInvalidSync();
+    void testFindSync();
+    void testLocate();
+    void testFindDifferentPacket();
+    void testCompareBytes();
 
     TSUNIT_TEST_BEGIN(TSPacketTest);
     TSUNIT_TEST(testPacket);
@@ -65,6 +70,11 @@ public:
     TSUNIT_TEST(testSetPayloadSize);
     TSUNIT_TEST(testFlags);
     TSUNIT_TEST(testPrivateData);
+    TSUNIT_TEST(testFindInvalidSync);
+    TSUNIT_TEST(testFindSync);
+    TSUNIT_TEST(testLocate);
+    TSUNIT_TEST(testFindDifferentPacket);
+    TSUNIT_TEST(testCompareBytes);
     TSUNIT_TEST_END();
 };
 
@@ -542,3 +552,165 @@ void TSPacketTest::testPrivateData()
     pkt.getPrivateData(data);
     TSUNIT_ASSERT(data.empty());
 }
+
+namespace {
+    // Pseudo-random data with frequent 0x47 bytes, to be used as corrupted data.
+    void FillNoise(ts::ByteBlock& data, uint32_t seed)
+    {
+        for (size_t i = 0; i < data.size(); ++i) {
+            seed = seed * 1103515245 + 12345;
+            data[i] = (seed >> 24) < 32 ? ts::SYNC_BYTE : uint8_t(seed >> 16);
+        }
+    }
+
+    // Reference implementation of TSPacket::FindSync(), one byte at a time.
+    size_t RefFindSync(const uint8_t* buffer, size_t buffer_size, size_t count, size_t pkt_size, size_t header_size)
+    {
+        for (size_t i = 0; i + count * pkt_size <= buffer_size; ++i) {
+            size_t n = 0;
+            while (n < count && buffer[i + header_size + n * pkt_size] == ts::SYNC_BYTE) {
+                ++n;
+            }
+            if (n == count) {
+                return i;
+            }
+        }
+        return ts::NPOS;
+    }
+}
+
+void TSPacketTest::testFindInvalidSync()
+{
+    ts::TSPacket pkts[40];
+    for (size_t i = 0; i < 40; ++i) {
+        pkts[i].init(ts::PID(i));
+    }
+    TSUNIT_EQUAL(0, ts::TSPacket::FindInvalidSync(pkts, 0));
+    TSUNIT_EQUAL(40, ts::TSPacket::FindInvalidSync(pkts, 40));
+    for (size_t bad = 0; bad < 40; ++bad) {
+        pkts[bad].b[0] = 0x48;
+        TSUNIT_EQUAL(bad, ts::TSPacket::FindInvalidSync(pkts, 40));
+        TSUNIT_EQUAL(std::min<size_t>(bad, 13), ts::TSPacket::FindInvalidSync(pkts, 13));
+        pkts[bad].b[0] = ts::SYNC_BYTE;
+    }
+}
+
+void TSPacketTest::testFindSync()
+{
+    ts::ByteBlock data(20 * ts::PKT_M2TS_SIZE);
+    static const size_t sizes[][2] = {{ts::PKT_SIZE, 0}, {ts::PKT_RS_SIZE, 0}, {ts::PKT_M2TS_SIZE, ts::M2TS_HEADER_SIZE}};
+
+    TSUNIT_EQUAL(ts::NPOS, ts::TSPacket::FindSync(nullptr, 1000, 1));
+    TSUNIT_EQUAL(ts::NPOS, ts::TSPacket::FindSync(data.data(), data.size(), 0));
+    TSUNIT_EQUAL(ts::NPOS, ts::TSPacket::FindSync(data.data(), 100, 1));
+
+    for (uint32_t seed = 1; seed < 40; ++seed) {
+        FillNoise(data, seed);
+        const size_t start = (seed * 37) % 500;
+        for (const auto& sz : sizes) {
+            // Insert a sequence of 8 valid sync bytes after the noise.
+            ts::ByteBlock buf(data);
+            for (size_t i = 0; i < 8; ++i) {
+                buf[start + sz[1] + i * sz[0]] = ts::SYNC_BYTE;
+            }
+            for (size_t count = 1; count <= 10; ++count) {
+                for (size_t size = buf.size() - 200; size <= buf.size(); size += 67) {
+                    TSUNIT_EQUAL(RefFindSync(buf.data(), size, count, sz[0], sz[1]), ts::TSPacket::FindSync(buf.data(), size, count, sz[0], sz[1]));
+                }
+            }
+            TSUNIT_ASSERT(ts::TSPacket::FindSync(buf.data(), buf.size(), 8, sz[0], sz[1]) <= start);
+        }
+    }
+}
+
+void TSPacketTest::testLocate()
+{
+    ts::ByteBlock dgram(7 * ts::PKT_SIZE + 12);
+    size_t start = 0;
+    size_t count = 0;
+
+    // RTP-like header followed by 7 packets.
+    FillNoise(dgram, 27);
+    for (size_t i = 0; i < 7; ++i) {
+        dgram[12 + i * ts::PKT_SIZE] = ts::SYNC_BYTE;
+    }
+    TSUNIT_ASSERT(ts::TSPacket::Locate(dgram.data(), dgram.size(), start, count));
+    TSUNIT_EQUAL(12, start);
+    TSUNIT_EQUAL(7, count);
+
+    // Header, 6 packets and a truncated packet.
+    FillNoise(dgram, 28);
+    dgram[dgram.size() - ts::PKT_SIZE] = 0x00;
+    for (size_t i = 0; i < 6; ++i) {
+        dgram[20 + i * ts::PKT_SIZE] = ts::SYNC_BYTE;
+    }
+    TSUNIT_ASSERT(ts::TSPacket::Locate(dgram.data(), dgram.size(), start, count));
+    TSUNIT_EQUAL(20, start);
+    TSUNIT_EQUAL(6, count);
+
+    // No packet.
+    TSUNIT_ASSERT(!ts::TSPacket::Locate(dgram.data(), 100, start, count));
+    TSUNIT_EQUAL(0, count);
+}
+
+void TSPacketTest::testFindDifferentPacket()
+{
+    ts::TSPacket pkts1[150];
+    ts::TSPacket pkts2[150];
+    for (size_t i = 0; i < 150; ++i) {
+        pkts1[i].init(ts::PID(i), uint8_t(i & 0x0F), uint8_t(i));
+        pkts2[i] = pkts1[i];
+    }
+    TSUNIT_EQUAL(0, ts::TSPacket::FindDifferentPacket(pkts1, pkts2, 0));
+    TSUNIT_EQUAL(150, ts::TSPacket::FindDifferentPacket(pkts1, pkts2, 150));
+    for (size_t bad = 0; bad < 150; bad += 7) {
+        pkts2[bad].b[bad + 1] ^= 0x01;
+        TSUNIT_EQUAL(bad, ts::TSPacket::FindDifferentPacket(pkts1, pkts2, 150));
+        TSUNIT_EQUAL(std::min<size_t>(bad, 70), ts::TSPacket::FindDifferentPacket(pkts1, pkts2, 70));
+        TSUNIT_EQUAL(0, ts::TSPacket::FindDifferentPacket(pkts1 + bad + 1, pkts2 + bad + 1, 0));
+        TSUNIT_EQUAL(150 - bad - 1, ts::TSPacket::FindDifferentPacket(pkts1 + bad + 1, pkts2 + bad + 1, 150 - bad - 1));
+        pkts2[bad].b[bad + 1] ^= 0x01;
+    }
+}
+
+void TSPacketTest::testCompareBytes()
+{
+    ts::ByteBlock data1(300);
+    ts::ByteBlock data2(300);
+    FillNoise(data1, 12);
+    size_t first = 0;
+    size_t end = 0;
+
+    // Most sizes are not multiple of 16, to exercise the remaining bytes.
+    for (size_t size = 0; size <= 300; size += 13) {
+        data2 = data1;
+        TSUNIT_EQUAL(0, ts::TSPacket::CompareBytes(data1.data(), data2.data(), size, first, end));
+        TSUNIT_EQUAL(size, first);
+        TSUNIT_EQUAL(size, end);
+
+        // Differences at each end of the compared area and in the middle.
+        if (size > 0) {
+            data2[0] ^= 0x80;
+            TSUNIT_EQUAL(1, ts::TSPacket::CompareBytes(data1.data(), data2.data(), size, first, end));
+            TSUNIT_EQUAL(0, first);
+            TSUNIT_EQUAL(1, end);
+            data2[size - 1] ^= 0x01;
+            data2[size / 2] ^= 0x10;
+            TSUNIT_EQUAL(3, ts::TSPacket::CompareBytes(data1.data(), data2.data(), size, first, end));
+            TSUNIT_EQUAL(0, first);
+            TSUNIT_EQUAL(size, end);
+            data2[0] ^= 0x80;
+            TSUNIT_EQUAL(2, ts::TSPacket::CompareBytes(data1.data(), data2.data(), size, first, end));
+            TSUNIT_EQUAL(size / 2, first);
+            TSUNIT_EQUAL(size, end);
+        }
+    }
+
+    // Difference outside the compared area.
+    data2 = data1;
+    data2[200] = ~data2[200];
+    TSUNIT_EQUAL(0, ts::TSPacket::CompareBytes(data1.data(), data2.data(), 200, first, end));
+    TSUNIT_EQUAL(1, ts::TSPacket::CompareBytes(data1.data(), data2.data(), 201, first, end));
+    TSUNIT_EQUAL(200, first);
+    TSUNIT_EQUAL(201, end);
+}
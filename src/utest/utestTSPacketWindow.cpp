@@ -46,9 +46,11 @@ public:
     virtual void afterTest() override;
 
     void testAll();
+    void testIndex();
 
     TSUNIT_TEST_BEGIN(TSPacketWindowTest);
     TSUNIT_TEST(testAll);
+    TSUNIT_TEST(testIndex);
     TSUNIT_TEST_END();
 };
 
@@ -171,3 +173,75 @@ void TSPacketWindowTest::testAll()
     TSUNIT_EQUAL(map[7], win.packetIndexInBuffer(7, packets, 10));
     TSUNIT_EQUAL(ts::NPOS, win.packetIndexInBuffer(11, packets, 10));
 }
+
+void TSPacketWindowTest::testIndex()
+{
+    // Physical buffer of 10 packets, PID 200 to 204, twice.
+    ts::TSPacket packets[10];
+    ts::TSPacketMetadata mdata[10];
+    for (size_t i = 0; i < 10; ++i) {
+        packets[i].init(ts::PID(200 + i % 5));
+        mdata[i].setLabel(i % 5);
+    }
+    packets[3].b[0] = 0; // dropped before the window is built
+
+    // Without index, the searches access the packets.
+    ts::TSPacketWindow win;
+    TSUNIT_ASSERT(!win.isIndexed());
+    win.addPacketsReference(packets + 5, mdata + 5, 5);
+    win.addPacketsReference(packets, mdata, 5);
+    TSUNIT_ASSERT(win.pids() == nullptr);
+    TSUNIT_ASSERT(win.labels() == nullptr);
+    TSUNIT_EQUAL(2, win.countPID(201));
+    TSUNIT_EQUAL(6, win.findPID(201, 2));
+    TSUNIT_EQUAL(1, win.countPID(203));
+
+    // Two segments of contiguous packets, with index.
+    win.clear();
+    win.setIndexed(true);
+    win.addPacketsReference(packets + 5, mdata + 5, 5);
+    win.addPacketsReference(packets, mdata, 5);
+    TSUNIT_ASSERT(win.isIndexed());
+    TSUNIT_EQUAL(10, win.size());
+    TSUNIT_EQUAL(2, win.segmentCount());
+
+    TSUNIT_ASSERT(win.pids() != nullptr);
+    TSUNIT_ASSERT(win.labels() != nullptr);
+    TSUNIT_EQUAL(200, win.pids()[0]);
+    TSUNIT_EQUAL(204, win.pids()[4]);
+    TSUNIT_EQUAL(202, win.pids()[7]);
+    TSUNIT_EQUAL(ts::PID_MAX, win.pids()[8]);
+    TSUNIT_EQUAL(0x00000001, win.labels()[0]);
+    TSUNIT_EQUAL(0x00000010, win.labels()[9]);
+
+    TSUNIT_EQUAL(2, win.countPID(201));
+    TSUNIT_EQUAL(1, win.countPID(203));
+    TSUNIT_EQUAL(0, win.countPID(ts::PID_NULL));
+    TSUNIT_EQUAL(1, win.findPID(201));
+    TSUNIT_EQUAL(6, win.findPID(201, 2));
+    TSUNIT_EQUAL(ts::NPOS, win.findPID(201, 7));
+    TSUNIT_EQUAL(ts::NPOS, win.findPID(300));
+
+    ts::TSPacketMetadata::LabelSet mask;
+    mask.set(2);
+    mask.set(3);
+    TSUNIT_EQUAL(2, win.findAnyLabel(mask));
+    TSUNIT_EQUAL(3, win.findAnyLabel(mask, 3));
+    TSUNIT_EQUAL(7, win.findAnyLabel(mask, 4));
+    TSUNIT_EQUAL(ts::NPOS, win.findAnyLabel(ts::TSPacketMetadata::NoLabel));
+
+    // The index follows nullify() and drop().
+    win.nullify(1);
+    TSUNIT_EQUAL(ts::PID_NULL, win.pids()[1]);
+    TSUNIT_EQUAL(1, win.countPID(201));
+    TSUNIT_EQUAL(1, win.countPID(ts::PID_NULL));
+    win.drop(6);
+    TSUNIT_EQUAL(ts::PID_MAX, win.pids()[6]);
+    TSUNIT_EQUAL(0, win.countPID(201));
+
+    // Clearing the window clears the index.
+    win.clear();
+    TSUNIT_EQUAL(0, win.size());
+    TSUNIT_EQUAL(0, win.countPID(201));
+    TSUNIT_EQUAL(ts::NPOS, win.findPID(200));
+}
@@ -34,6 +34,8 @@
 #include "tsTSProcessor.h"
 #include "tsPluginRepository.h"
 #include "tsCerrReport.h"
+#include "tsReportBuffer.h"
+#include "tsjsonValue.h"
 #include "tsunit.h"
 
 
@@ -48,9 +50,15 @@ public:
     virtual void afterTest() override;
 
     void testProcessing();
+    void testLockFreeHandoff();
+    void testPluginStatistics();
+    void testParallelWorkers();
 
     TSUNIT_TEST_BEGIN(TSProcessorTest);
     TSUNIT_TEST(testProcessing);
+    TSUNIT_TEST(testLockFreeHandoff);
+    TSUNIT_TEST(testPluginStatistics);
+    TSUNIT_TEST(testParallelWorkers);
     TSUNIT_TEST_END();
 };
 
@@ -324,3 +332,319 @@ void TSProcessorTest::testProcessing()
     TSUNIT_EQUAL(3,          handler2.logs[0].count);
     TSUNIT_EQUAL(26,         handler2.logs[0].packets);
 }
+
+
+//----------------------------------------------------------------------------
+// Internal packet processing plugin class which stamps or checks a sequence
+// number in each packet. The stop method signals an event with the number of
+// out-of-sequence packets.
+//----------------------------------------------------------------------------
+
+namespace {
+    class SequencePlugin : ts::ProcessorPlugin
+    {
+    public:
+        // Constructor.
+        SequencePlugin(ts::TSP*);
+
+        // Implementation of plugin API.
+        virtual bool getOptions() override;
+        virtual bool start() override;
+        virtual bool stop() override;
+        virtual Status processPacket(ts::TSPacket&, ts::TSPacketMetadata&) override;
+
+        // A factory static method which creates an instance of that class.
+        static ts::ProcessorPlugin* CreateInstance(ts::TSP*);
+
+        // Plugin-specific event code.
+        static constexpr uint32_t EVENT_ERRORS = 0xBEEF0004;
+
+    private:
+        bool     _stamp;   // Command line option: stamp instead of check.
+        uint64_t _next;    // Next expected sequence number.
+        int      _errors;  // Number of out-of-sequence packets.
+    };
+}
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr uint32_t SequencePlugin::EVENT_ERRORS;
+#endif
+
+// Factory method.
+ts::ProcessorPlugin* SequencePlugin::CreateInstance(ts::TSP* t)
+{
+    return new SequencePlugin(t);
+}
+
+// Constructor.
+SequencePlugin::SequencePlugin(ts::TSP* t) :
+    ts::ProcessorPlugin(t, u"Sequence test plugin", u"[options]"),
+    _stamp(false),
+    _next(0),
+    _errors(0)
+{
+    option(u"stamp");
+    help(u"stamp", u"Stamp a sequence number in packets instead of checking it.");
+}
+
+bool SequencePlugin::getOptions()
+{
+    _stamp = present(u"stamp");
+    return true;
+}
+
+bool SequencePlugin::start()
+{
+    _next = 0;
+    _errors = 0;
+    return true;
+}
+
+bool SequencePlugin::stop()
+{
+    TestPluginData data(_errors);
+    tsp->signalPluginEvent(EVENT_ERRORS, &data);
+    return true;
+}
+
+SequencePlugin::Status SequencePlugin::processPacket(ts::TSPacket& pkt, ts::TSPacketMetadata& metadata)
+{
+    if (_stamp) {
+        ts::PutUInt64(pkt.b + 4, _next);
+    }
+    else if (ts::GetUInt64(pkt.b + 4) != _next) {
+        _errors++;
+    }
+    _next++;
+    return TSP_OK;
+}
+
+
+//----------------------------------------------------------------------------
+// Internal stateless packet processing plugin class which counts packets.
+// The statistics of parallel clones are merged in the main instance.
+// The stop method signals an event with the number of counted packets.
+//----------------------------------------------------------------------------
+
+namespace {
+    class CountPlugin : public ts::ProcessorPlugin
+    {
+    public:
+        // Constructor.
+        CountPlugin(ts::TSP*);
+
+        // Implementation of plugin API.
+        virtual bool start() override;
+        virtual bool stop() override;
+        virtual bool isStateless() const override;
+        virtual void mergeStatistics(const ts::ProcessorPlugin&) override;
+        virtual Status processPacket(ts::TSPacket&, ts::TSPacketMetadata&) override;
+
+        // A factory static method which creates an instance of that class.
+        static ts::ProcessorPlugin* CreateInstance(ts::TSP*);
+
+        // Plugin-specific event code.
+        static constexpr uint32_t EVENT_COUNT = 0xBEEF0005;
+
+    private:
+        int _count;  // Number of counted packets.
+    };
+}
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr uint32_t CountPlugin::EVENT_COUNT;
+#endif
+
+// Factory method.
+ts::ProcessorPlugin* CountPlugin::CreateInstance(ts::TSP* t)
+{
+    return new CountPlugin(t);
+}
+
+// Constructor.
+CountPlugin::CountPlugin(ts::TSP* t) :
+    ts::ProcessorPlugin(t, u"Count test plugin", u"[options]"),
+    _count(0)
+{
+}
+
+bool CountPlugin::start()
+{
+    _count = 0;
+    return true;
+}
+
+bool CountPlugin::stop()
+{
+    TestPluginData data(_count);
+    tsp->signalPluginEvent(EVENT_COUNT, &data);
+    return true;
+}
+
+bool CountPlugin::isStateless() const
+{
+    return true;
+}
+
+void CountPlugin::mergeStatistics(const ts::ProcessorPlugin& clone)
+{
+    const CountPlugin* other = dynamic_cast<const CountPlugin*>(&clone);
+    if (other != nullptr) {
+        _count += other->_count;
+    }
+}
+
+CountPlugin::Status CountPlugin::processPacket(ts::TSPacket&, ts::TSPacketMetadata&)
+{
+    _count++;
+    return TSP_OK;
+}
+
+
+//----------------------------------------------------------------------------
+// Lock-free handoff between plugin threads.
+//----------------------------------------------------------------------------
+
+void TSProcessorTest::testLockFreeHandoff()
+{
+    ts::PluginRepository::Instance()->registerProcessor(u"sequence", SequencePlugin::CreateInstance);
+
+    // Use a small buffer and small flush size to force many handoffs between the threads.
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testLockFreeHandoff";
+    opt.lockfree_handoff = true;
+    opt.ts_buffer_size = ts::TSProcessorArgs::MIN_BUFFER_SIZE;
+    opt.max_flush_pkt = 7;
+    opt.max_input_pkt = 11;
+    opt.input = {u"null", {u"100000"}};
+    opt.plugins = {
+        {u"sequence", {u"--stamp"}},
+        {u"sequence", {}},
+        {u"sequence", {}},
+        {u"sequence", {}},
+    };
+    opt.output = {u"drop"};
+
+    ts::TSProcessor tsproc(CERR);
+    TestEventHandler handler;
+    ts::TSProcessor::Criteria crit;
+    crit.event_code = SequencePlugin::EVENT_ERRORS;
+    tsproc.registerEventHandler(&handler, crit);
+
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+
+    // All plugins have seen all packets in order.
+    TSUNIT_EQUAL(4, handler.logs.size());
+    for (const auto& log : handler.logs) {
+        TSUNIT_EQUAL(0, log.data);
+        TSUNIT_EQUAL(100000, log.packets);
+    }
+}
+
+void TSProcessorTest::testPluginStatistics()
+{
+    ts::PluginRepository::Instance()->registerProcessor(u"sequence", SequencePlugin::CreateInstance);
+
+    // With a long logging interval, the statistics are logged only once, at the end of the processing.
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testPluginStatistics";
+    opt.stats_interval = 3600 * ts::MilliSecPerSec;
+    opt.input = {u"null", {u"1000"}};
+    opt.plugins = {
+        {u"sequence", {u"--stamp"}},
+    };
+    opt.output = {u"drop"};
+
+    ts::ReportBuffer<ts::Mutex> log;
+    ts::TSProcessor tsproc(log);
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+    debug() << "TSProcessorTest::testPluginStatistics: " << log.getMessages() << std::endl;
+
+    // Collect the JSON description of each plugin.
+    const ts::UString prefix(u"plugin stats: ");
+    ts::UStringVector lines;
+    log.getMessages().split(lines, u'\n', true, true);
+    std::vector<ts::json::ValuePtr> stats;
+    for (const auto& line : lines) {
+        const size_t pos = line.find(prefix);
+        if (pos != ts::NPOS) {
+            ts::json::ValuePtr value;
+            TSUNIT_ASSERT(ts::json::Parse(value, line.substr(pos + prefix.size()), CERR));
+            TSUNIT_ASSERT(!value.isNull());
+            TSUNIT_ASSERT(value->isObject());
+            stats.push_back(value);
+        }
+    }
+
+    // One line per plugin, in processing order, all packets passed to all plugins.
+    static const ts::UChar* const names[] = {u"null", u"sequence", u"drop"};
+    TSUNIT_EQUAL(3, stats.size());
+    for (size_t i = 0; i < stats.size(); ++i) {
+        const ts::json::Value& st(*stats[i]);
+        TSUNIT_EQUAL(int64_t(i), st.value(u"index").toInteger(-1));
+        TSUNIT_EQUAL(ts::UString(names[i]), st.value(u"name").toString());
+        TSUNIT_EQUAL(1000, st.value(u"plugin-packets").toInteger());
+        TSUNIT_ASSERT(st.value(u"elapsed-us").toInteger(-1) >= 0);
+        TSUNIT_ASSERT(st.value(u"process-us").toInteger(-1) >= 0);
+        TSUNIT_ASSERT(st.value(u"wait-us").toInteger(-1) >= 0);
+        TSUNIT_ASSERT(st.value(u"max-buffered-packets").toInteger() > 0);
+    }
+
+    // Input time stamps are set by tsp, the latency of all packets is measured in the output plugin.
+    TSUNIT_EQUAL(1000, stats[2]->value(u"latency-packets").toInteger());
+    TSUNIT_ASSERT(stats[2]->value(u"latency-max-us").toInteger(-1) >= 0);
+    TSUNIT_ASSERT(stats[0]->value(u"latency-packets").isNull());
+}
+
+void TSProcessorTest::testParallelWorkers()
+{
+    ts::PluginRepository::Instance()->registerProcessor(u"sequence", SequencePlugin::CreateInstance);
+    ts::PluginRepository::Instance()->registerProcessor(u"count", CountPlugin::CreateInstance);
+
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testParallelWorkers";
+    opt.parallel_workers = 4;
+    opt.input = {u"null", {u"50000"}};
+    opt.plugins = {
+        {u"sequence", {u"--stamp"}},
+        {u"count", {}},
+        {u"sequence", {}},
+    };
+    opt.output = {u"drop"};
+
+    ts::TSProcessor tsproc(CERR);
+    TestEventHandler handler;
+    tsproc.registerEventHandler(&handler);
+
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+
+    // Expected events: one per clone of "count" with its own count, one for the main instance
+    // with the merged count of all packets (last one), one for each "sequence".
+    int clones = 0;
+    int clones_count = 0;
+    int main_count = -1;
+    int sequences = 0;
+    for (const auto& log : handler.logs) {
+        if (log.code == CountPlugin::EVENT_COUNT) {
+            TSUNIT_EQUAL(2, log.index);
+            if (main_count >= 0) {
+                clones++;
+                clones_count += main_count;
+            }
+            main_count = log.data;
+        }
+        else if (log.code == SequencePlugin::EVENT_ERRORS) {
+            // Packet order is preserved by the parallel workers.
+            TSUNIT_EQUAL(0, log.data);
+            TSUNIT_EQUAL(50000, log.packets);
+            sequences++;
+        }
+    }
+    debug() << "TSProcessorTest::testParallelWorkers: " << clones << " clones, " << clones_count << " packets in clones" << std::endl;
+    TSUNIT_EQUAL(2, sequences);
+    TSUNIT_EQUAL(3, clones);
+    TSUNIT_EQUAL(50000, main_count);
+}
@@ -44,6 +44,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsThreadAttributes.h"
+#include "tsThread.h"
 #include "tsunit.h"
 
 
@@ -60,11 +61,15 @@ public:
     void testStackSize();
     void testDeleteWhenTerminated();
     void testPriority();
+    void testCPUList();
+    void testCPUAffinity();
 
     TSUNIT_TEST_BEGIN(ThreadAttributesTest);
     TSUNIT_TEST(testStackSize);
     TSUNIT_TEST(testDeleteWhenTerminated);
     TSUNIT_TEST(testPriority);
+    TSUNIT_TEST(testCPUList);
+    TSUNIT_TEST(testCPUAffinity);
     TSUNIT_TEST_END();
 };
 
@@ -133,3 +138,47 @@ void ThreadAttributesTest::testPriority()
     attr.setPriority (ts::ThreadAttributes::GetNormalPriority());
     TSUNIT_ASSERT(attr.getPriority() == ts::ThreadAttributes::GetNormalPriority());
 }
+
+void ThreadAttributesTest::testCPUList()
+{
+    ts::ThreadAttributes attr;
+    TSUNIT_ASSERT(attr.getCPUAffinity().empty()); // default value
+
+    std::set<size_t> cpus;
+    TSUNIT_ASSERT(ts::ThreadAttributes::DecodeCPUList(u"0-3,8, 10-11", cpus));
+    TSUNIT_EQUAL(7, cpus.size());
+    TSUNIT_ASSERT(cpus.count(0) == 1 && cpus.count(3) == 1 && cpus.count(4) == 0 && cpus.count(8) == 1 && cpus.count(11) == 1);
+    TSUNIT_EQUAL(u"0-3,8,10-11", ts::ThreadAttributes::EncodeCPUList(cpus));
+    TSUNIT_EQUAL(7, attr.setCPUAffinity(cpus).getCPUAffinity().size());
+
+    TSUNIT_ASSERT(ts::ThreadAttributes::DecodeCPUList(u"5", cpus));
+    TSUNIT_EQUAL(u"5", ts::ThreadAttributes::EncodeCPUList(cpus));
+    TSUNIT_ASSERT(ts::ThreadAttributes::DecodeCPUList(u"", cpus));
+    TSUNIT_ASSERT(cpus.empty());
+    TSUNIT_EQUAL(u"", ts::ThreadAttributes::EncodeCPUList(cpus));
+
+    TSUNIT_ASSERT(!ts::ThreadAttributes::DecodeCPUList(u"3-1", cpus));
+    TSUNIT_ASSERT(!ts::ThreadAttributes::DecodeCPUList(u"1,x", cpus));
+    TSUNIT_ASSERT(!ts::ThreadAttributes::DecodeCPUList(u"0-", cpus));
+}
+
+void ThreadAttributesTest::testCPUAffinity()
+{
+    std::set<size_t> initial;
+    if (!ts::Thread::GetCurrentCPUAffinity(initial)) {
+        debug() << "ThreadAttributesTest: CPU affinity not supported" << std::endl;
+        return;
+    }
+    debug() << "ThreadAttributesTest: initial CPU affinity: " << ts::ThreadAttributes::EncodeCPUList(initial) << std::endl;
+    TSUNIT_ASSERT(!initial.empty());
+
+    // Restrict to the first allowed CPU, then restore.
+    const std::set<size_t> first({*initial.begin()});
+    std::set<size_t> cpus;
+    TSUNIT_ASSERT(ts::Thread::SetCurrentCPUAffinity(first));
+    TSUNIT_ASSERT(ts::Thread::GetCurrentCPUAffinity(cpus));
+    TSUNIT_ASSERT(cpus == first);
+    TSUNIT_ASSERT(ts::Thread::SetCurrentCPUAffinity(initial));
+    TSUNIT_ASSERT(ts::Thread::GetCurrentCPUAffinity(cpus));
+    TSUNIT_ASSERT(cpus == initial);
+}
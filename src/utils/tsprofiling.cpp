@@ -37,6 +37,14 @@
 //  is completely inappropriate for production and should be reserved to
 //  plugin profiling or debugging.
 //
+//  It is also a benchmark harness. The execution time of each plugin is
+//  reported, in nanoseconds per packet, as well as CPU cycles and instructions
+//  per packet when hardware counters are available (Linux perf events).
+//  Reproducible synthetic workloads can be used instead of an input plugin.
+//  The same plugin chain can be run again using the multi-threaded tsp
+//  engine for comparison. The results can be saved in JSON format for
+//  regression tracking between TSDuck versions.
+//
 //  Limitations:
 //  - Awful performances.
 //  - No support for joint termination.
@@ -49,9 +57,151 @@
 #include "tsDuckContext.h"
 #include "tsPCRAnalyzer.h"
 #include "tsPluginRepository.h"
+#include "tsTSProcessor.h"
+#include "tsAsyncReport.h"
+#include "tsCyclingPacketizer.h"
+#include "tsTSScrambling.h"
+#include "tsTSFile.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsSDT.h"
+#include "tsEIT.h"
+#include "tsShortEventDescriptor.h"
+#include "tsjsonObject.h"
+#include "tsjsonArray.h"
+#include "tsjsonOutputArgs.h"
+#include "tsFileUtils.h"
+#include "tsMonotonic.h"
+#include "tsVersionInfo.h"
+
+#if defined(TS_LINUX)
+    #include "tsBeforeStandardHeaders.h"
+    #include <linux/perf_event.h>
+    #include <sys/syscall.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
 TS_MAIN(MainCode);
 
 
+//----------------------------------------------------------------------------
+// Synthetic workloads.
+//----------------------------------------------------------------------------
+
+namespace {
+    enum class Workload {
+        NONE,       // No synthetic workload, use the input plugin.
+        PSI,        // Only PSI/SI sections.
+        SCRAMBLED,  // DVB-CSA2 scrambled PES PID's.
+        MANY_PIDS,  // Packets spread over many PID's.
+        VIDEO,      // High bitrate video PID.
+    };
+
+    const ts::Enumeration WorkloadNames({
+        {u"psi",       int(Workload::PSI)},
+        {u"scrambled", int(Workload::SCRAMBLED)},
+        {u"many-pids", int(Workload::MANY_PIDS)},
+        {u"video",     int(Workload::VIDEO)},
+    });
+
+    // Parameters of the workloads.
+    constexpr size_t   WL_SERVICES = 64;                 // Number of services in PSI workload.
+    constexpr size_t   WL_SCRAMBLED_PIDS = 4;            // Number of PID's in scrambled workload.
+    constexpr size_t   WL_MANY_PIDS = 8000;              // Number of PID's in many-pids workload.
+    constexpr ts::PID  WL_MANY_PIDS_BASE = 0x0020;       // First PID in many-pids workload.
+    constexpr uint64_t WL_VIDEO_BITRATE = 80000000;      // Bitrate of the video workload.
+    constexpr size_t   WL_VIDEO_FRAME_PACKETS = 10000;   // Packets per video frame (50 frames/s at 80 Mb/s).
+    constexpr size_t   WL_VIDEO_PSI_INTERVAL = 4000;     // Packets between PAT/PMT in the video workload.
+    constexpr ts::PID  WL_BASE_PID = 0x0100;             // First PID of generated elementary streams.
+    const uint8_t      WL_CW[8] = {0x11, 0x22, 0x33, 0x66, 0x44, 0x55, 0x66, 0xFF};  // Fixed DVB-CSA2 control word.
+}
+
+
+//----------------------------------------------------------------------------
+// CPU hardware counters (Linux perf events), for the current thread.
+//----------------------------------------------------------------------------
+
+namespace {
+    class PerfCounters
+    {
+        TS_NOCOPY(PerfCounters);
+    public:
+        PerfCounters() : _fd_cycles(-1), _fd_instructions(-1) {}
+        ~PerfCounters() { close(); }
+
+        // Open the counters. Return false when not supported.
+        bool open(ts::Report& report);
+        void close();
+        bool isOpen() const { return _fd_cycles >= 0; }
+
+        // Get current values of the counters. Always zero when not open.
+        void get(uint64_t& cycles, uint64_t& instructions) const;
+
+    private:
+        int _fd_cycles;        // Group leader.
+        int _fd_instructions;  // Member of the group.
+    };
+}
+
+bool PerfCounters::open(ts::Report& report)
+{
+#if defined(TS_LINUX)
+    close();
+
+    ::perf_event_attr attr;
+    TS_ZERO(attr);
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    // Count in the current thread, on any CPU.
+    _fd_cycles = int(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    if (_fd_cycles >= 0) {
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        _fd_instructions = int(::syscall(__NR_perf_event_open, &attr, 0, -1, _fd_cycles, 0));
+    }
+    if (_fd_cycles < 0 || _fd_instructions < 0) {
+        report.verbose(u"CPU hardware counters not available: %s", {ts::SysErrorCodeMessage()});
+        close();
+        return false;
+    }
+    return true;
+#else
+    report.verbose(u"CPU hardware counters not supported on this system");
+    return false;
+#endif
+}
+
+void PerfCounters::close()
+{
+#if defined(TS_LINUX)
+    if (_fd_instructions >= 0) {
+        ::close(_fd_instructions);
+    }
+    if (_fd_cycles >= 0) {
+        ::close(_fd_cycles);
+    }
+#endif
+    _fd_cycles = _fd_instructions = -1;
+}
+
+void PerfCounters::get(uint64_t& cycles, uint64_t& instructions) const
+{
+    cycles = instructions = 0;
+#if defined(TS_LINUX)
+    // Format of data with PERF_FORMAT_GROUP: number of counters, followed by counters.
+    uint64_t data[3];
+    if (_fd_cycles >= 0 && ::read(_fd_cycles, data, sizeof(data)) == ssize_t(sizeof(data)) && data[0] == 2) {
+        cycles = data[1];
+        instructions = data[2];
+    }
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Command line options
 //----------------------------------------------------------------------------
@@ -69,6 +219,13 @@ namespace {
         ts::PluginOptions       input;
         ts::PluginOptionsVector plugins;
         ts::PluginOptions       output;
+        Workload                workload;
+        ts::PacketCounter       workload_packets;
+        ts::UString             workload_file;
+        bool                    compare_tsp;
+        bool                    hw_counters;
+        ts::json::OutputArgs    json;
+        PerfCounters            perf;
     };
 }
 
@@ -79,7 +236,14 @@ Options::Options(int argc, char *argv[]) :
     fixed_bitrate(0),
     input(),
     plugins(),
-    output()
+    output(),
+    workload(Workload::NONE),
+    workload_packets(0),
+    workload_file(),
+    compare_tsp(false),
+    hw_counters(false),
+    json(),
+    perf()
 {
     duck.defineArgsForCAS(*this);
     duck.defineArgsForCharset(*this);
@@ -91,9 +255,41 @@ Options::Options(int argc, char *argv[]) :
     option<ts::BitRate>(u"bitrate", 'b');
     help(u"bitrate", u"Specify the input bitrate.");
 
+    option(u"compare-tsp", 'c');
+    help(u"compare-tsp",
+         u"After the mono-thread execution, run the same chain of plugins again using the multi-threaded "
+         u"tsp engine and report the throughput of both executions. "
+         u"The input must be readable twice, a synthetic workload or a regular file for instance.");
+
+    json.defineArgs(*this, true, u"Report the benchmark results in JSON format. Useful for regression tracking between TSDuck versions.");
+
+    option(u"no-hardware-counters");
+    help(u"no-hardware-counters",
+         u"Do not use CPU hardware counters. "
+         u"By default, on Linux, the numbers of CPU cycles and instructions per packet are reported for each plugin, "
+         u"when allowed by the system (see /proc/sys/kernel/perf_event_paranoid).");
+
     option(u"packet-buffer", 'p', POSITIVE);
     help(u"packet-buffer", u"Specify the maximum number of TS packets in the buffer. The default is 1000.");
 
+    option(u"workload", 'w', WorkloadNames);
+    help(u"workload",
+         u"Generate a reproducible synthetic transport stream and use it as input instead of the input plugin. "
+         u"The workload 'psi' contains only PSI/SI sections: PAT, " + ts::UString::Decimal(WL_SERVICES) + u" PMT's, SDT and EIT p/f. "
+         u"The workload 'scrambled' contains " + ts::UString::Decimal(WL_SCRAMBLED_PIDS) + u" PES PID's, starting at 0x0100, "
+         u"scrambled with DVB-CSA2 using the fixed even control word 11223366445566FF. "
+         u"The workload 'many-pids' contains packets spread over " + ts::UString::Decimal(WL_MANY_PIDS) + u" PID's, starting at 0x0020. "
+         u"The workload 'video' contains one high bitrate video PID with PCR's and PES headers at " +
+         ts::UString::Decimal(WL_VIDEO_BITRATE) + u" b/s.");
+
+    option(u"workload-file", 0, FILENAME);
+    help(u"workload-file",
+         u"Save the synthetic workload in the specified file. "
+         u"By default, the synthetic workload is written in a temporary file which is deleted on exit.");
+
+    option(u"workload-packets", 0, POSITIVE);
+    help(u"workload-packets", u"Number of packets in the synthetic workload. The default is 200,000 packets.");
+
     // Analyze the command.
     analyze(argc, argv);
 
@@ -104,12 +300,251 @@ Options::Options(int argc, char *argv[]) :
     getPlugin(input, ts::PluginType::INPUT, u"file");
     getPlugin(output, ts::PluginType::OUTPUT, u"drop");
     getPlugins(plugins, ts::PluginType::PROCESSOR);
+    workload = intValue<Workload>(u"workload", Workload::NONE);
+    getIntValue(workload_packets, u"workload-packets", 200000);
+    getValue(workload_file, u"workload-file");
+    compare_tsp = present(u"compare-tsp");
+    hw_counters = !present(u"no-hardware-counters");
+    json.loadArgs(duck, *this);
+
+    // A synthetic workload replaces the input plugin.
+    if (workload != Workload::NONE) {
+        if (workload_file.empty()) {
+            workload_file = ts::TempFile(u".ts");
+        }
+        input.set(u"file", ts::UStringVector({workload_file}));
+    }
 
     // Final checking
     exitOnError();
 }
 
 
+//----------------------------------------------------------------------------
+// Synthetic workload generator.
+//----------------------------------------------------------------------------
+
+namespace {
+    class WorkloadGenerator
+    {
+        TS_NOBUILD_NOCOPY(WorkloadGenerator);
+    public:
+        // Constructor.
+        WorkloadGenerator(ts::DuckContext& duck, Workload type);
+
+        // Generate the workload file.
+        bool generate(const ts::UString& filename, ts::PacketCounter count);
+
+    private:
+        typedef ts::SafePtr<ts::CyclingPacketizer, ts::NullMutex> CyclingPacketizerPtr;
+
+        ts::DuckContext&                  _duck;
+        Workload                          _type;
+        uint32_t                          _seed;         // Pseudo-random generator, for reproducible payloads.
+        ts::PacketCounter                 _index;        // Index of next packet.
+        std::vector<uint8_t>              _cc;           // Continuity counters, indexed by PID.
+        std::vector<CyclingPacketizerPtr> _packetizers;  // PSI/SI packetizers.
+        size_t                            _next_pzer;    // Next packetizer to use.
+        ts::TSScrambling                  _scrambling;   // DVB-CSA2 scrambling.
+
+        // Build the PSI/SI packetizers.
+        void addPSI(bool with_si);
+
+        // Build a packet with pseudo-random payload.
+        void randomPacket(ts::TSPacket& pkt, ts::PID pid);
+
+        // Add a PES header in a packet.
+        void addPESHeader(ts::TSPacket& pkt, uint64_t pts);
+
+        // Generate the next packet.
+        void nextPacket(ts::TSPacket& pkt);
+    };
+}
+
+// Constructor.
+WorkloadGenerator::WorkloadGenerator(ts::DuckContext& duck, Workload type) :
+    _duck(duck),
+    _type(type),
+    _seed(0x12345678),
+    _index(0),
+    _cc(ts::PID_MAX, 0),
+    _packetizers(),
+    _next_pzer(0),
+    _scrambling(duck.report())
+{
+    switch (_type) {
+        case Workload::PSI:
+            addPSI(true);
+            break;
+        case Workload::SCRAMBLED:
+            _scrambling.setCW(ts::ByteBlock(WL_CW, sizeof(WL_CW)), 0);
+            _scrambling.start();
+            break;
+        case Workload::VIDEO:
+            addPSI(false);
+            break;
+        case Workload::MANY_PIDS:
+        case Workload::NONE:
+        default:
+            break;
+    }
+}
+
+// Build the PSI/SI packetizers.
+void WorkloadGenerator::addPSI(bool with_si)
+{
+    const size_t service_count = with_si ? WL_SERVICES : 1;
+    const uint16_t ts_id = 1;
+    const uint16_t onetw_id = 1;
+
+    ts::PAT pat(0, true, ts_id);
+    ts::SDT sdt(true, 0, true, ts_id, onetw_id);
+    CyclingPacketizerPtr pat_pzer(new ts::CyclingPacketizer(_duck, ts::PID_PAT, ts::CyclingPacketizer::StuffingPolicy::NEVER));
+    CyclingPacketizerPtr sdt_pzer(new ts::CyclingPacketizer(_duck, ts::PID_SDT, ts::CyclingPacketizer::StuffingPolicy::NEVER));
+    CyclingPacketizerPtr eit_pzer(new ts::CyclingPacketizer(_duck, ts::PID_EIT, ts::CyclingPacketizer::StuffingPolicy::NEVER));
+    _packetizers.push_back(pat_pzer);
+
+    for (size_t i = 0; i < service_count; ++i) {
+        const uint16_t service_id = uint16_t(i + 1);
+        const ts::PID pmt_pid = ts::PID(0x1000 + i);
+        const ts::PID es_pid = ts::PID(WL_BASE_PID + 2 * i);
+
+        // One PMT per service, with one video and one audio stream.
+        pat.pmts[service_id] = pmt_pid;
+        ts::PMT pmt(0, true, service_id, es_pid);
+        pmt.streams[es_pid].stream_type = ts::ST_AVC_VIDEO;
+        pmt.streams[es_pid + 1].stream_type = ts::ST_MPEG2_AUDIO;
+        CyclingPacketizerPtr pmt_pzer(new ts::CyclingPacketizer(_duck, pmt_pid, ts::CyclingPacketizer::StuffingPolicy::NEVER));
+        pmt_pzer->addTable(_duck, pmt);
+        _packetizers.push_back(pmt_pzer);
+
+        if (with_si) {
+            // Service description.
+            ts::SDT::ServiceEntry& srv(sdt.services[service_id]);
+            srv.EITpf_present = true;
+            srv.running_status = 4; // running
+            srv.setName(_duck, ts::UString::Format(u"Service %d", {service_id}));
+            srv.setProvider(_duck, u"TSDuck");
+
+            // EIT present/following.
+            ts::EIT eit(true, true, 0, 0, true, service_id, ts_id, onetw_id);
+            for (uint16_t ev = 0; ev < 2; ++ev) {
+                ts::EIT::Event& event(eit.events.newEntry());
+                event.event_id = uint16_t(service_id * 2 + ev);
+                event.start_time = ts::Time(2022, 1, 1, 12 + ev, 0, 0);
+                event.duration = 3600;
+                event.running_status = ev == 0 ? 4 : 1;
+                event.descs.add(_duck, ts::ShortEventDescriptor(u"eng", ts::UString::Format(u"Event %d", {event.event_id}), u"Synthetic workload event, some text to fill the section"));
+            }
+            eit_pzer->addTable(_duck, eit);
+        }
+    }
+
+    pat_pzer->addTable(_duck, pat);
+    if (with_si) {
+        sdt_pzer->addTable(_duck, sdt);
+        _packetizers.push_back(sdt_pzer);
+        _packetizers.push_back(eit_pzer);
+    }
+}
+
+// Build a packet with pseudo-random payload.
+void WorkloadGenerator::randomPacket(ts::TSPacket& pkt, ts::PID pid)
+{
+    pkt.init(pid, _cc[pid]);
+    _cc[pid] = (_cc[pid] + 1) & ts::CC_MASK;
+    for (size_t i = 4; i < ts::PKT_SIZE; ++i) {
+        _seed = _seed * 1103515245 + 12345;
+        pkt.b[i] = uint8_t(_seed >> 16);
+    }
+}
+
+// Add a PES header in a packet with a payload-only packet.
+void WorkloadGenerator::addPESHeader(ts::TSPacket& pkt, uint64_t pts)
+{
+    uint8_t* pl = pkt.getPayload();
+    pkt.setPUSI();
+    pl[0] = 0x00; pl[1] = 0x00; pl[2] = 0x01; pl[3] = 0xE0; // start code, video stream id
+    pl[4] = 0x00; pl[5] = 0x00;                             // unbounded video PES packet
+    pl[6] = 0x80; pl[7] = 0x80; pl[8] = 0x05;               // PTS only, 5-byte header data
+    pl[9] = uint8_t(0x21 | ((pts >> 29) & 0x0E));
+    pl[10] = uint8_t(pts >> 22);
+    pl[11] = uint8_t(((pts >> 14) & 0xFE) | 0x01);
+    pl[12] = uint8_t(pts >> 7);
+    pl[13] = uint8_t(((pts << 1) & 0xFE) | 0x01);
+}
+
+// Generate the next packet.
+void WorkloadGenerator::nextPacket(ts::TSPacket& pkt)
+{
+    switch (_type) {
+        case Workload::PSI: {
+            // Round-robin on all PSI/SI PID's.
+            _packetizers[_next_pzer]->getNextPacket(pkt);
+            _next_pzer = (_next_pzer + 1) % _packetizers.size();
+            break;
+        }
+        case Workload::SCRAMBLED: {
+            // Round-robin on all PID's, a new PES packet every 100 packets on each PID.
+            const ts::PID pid = ts::PID(WL_BASE_PID + _index % WL_SCRAMBLED_PIDS);
+            randomPacket(pkt, pid);
+            if ((_index / WL_SCRAMBLED_PIDS) % 100 == 0) {
+                addPESHeader(pkt, _index);
+            }
+            _scrambling.encrypt(pkt);
+            break;
+        }
+        case Workload::MANY_PIDS: {
+            randomPacket(pkt, ts::PID(WL_MANY_PIDS_BASE + _index % WL_MANY_PIDS));
+            break;
+        }
+        case Workload::VIDEO: {
+            if (_index % WL_VIDEO_PSI_INTERVAL < _packetizers.size()) {
+                // PAT and PMT.
+                _packetizers[_index % WL_VIDEO_PSI_INTERVAL]->getNextPacket(pkt);
+            }
+            else {
+                randomPacket(pkt, WL_BASE_PID);
+                if (_index % WL_VIDEO_FRAME_PACKETS == _packetizers.size()) {
+                    // Start of a new video frame, with PCR and PTS.
+                    const uint64_t pcr = (_index * ts::PKT_SIZE_BITS * ts::SYSTEM_CLOCK_FREQ) / WL_VIDEO_BITRATE;
+                    addPESHeader(pkt, (pcr / ts::SYSTEM_CLOCK_SUBFACTOR + 9000) & ts::PTS_DTS_MASK);
+                    pkt.setPCR(pcr % ts::PCR_SCALE, true);
+                }
+            }
+            break;
+        }
+        case Workload::NONE:
+        default: {
+            pkt = ts::NullPacket;
+            break;
+        }
+    }
+    _index++;
+}
+
+// Generate the workload file.
+bool WorkloadGenerator::generate(const ts::UString& filename, ts::PacketCounter count)
+{
+    ts::TSFile file;
+    if (!file.open(filename, ts::TSFile::WRITE, _duck.report())) {
+        return false;
+    }
+
+    ts::TSPacketVector buffer(1000);
+    bool success = true;
+    while (success && count > 0) {
+        const size_t size = size_t(std::min<ts::PacketCounter>(count, buffer.size()));
+        for (size_t i = 0; i < size; ++i) {
+            nextPacket(buffer[i]);
+        }
+        success = file.writePackets(buffer.data(), nullptr, size, _duck.report());
+        count -= size;
+    }
+    return file.close(_duck.report()) && success;
+}
+
+
 //----------------------------------------------------------------------------
 // Plugin executor class.
 //----------------------------------------------------------------------------
@@ -134,10 +569,21 @@ namespace {
         virtual bool useJointTermination() const override { return false; }
         virtual bool thisJointTerminated() const override { return false; }
 
+        // Build a JSON description of the execution statistics of the plugin.
+        ts::json::ValuePtr results() const;
+
+        // Execution statistics.
+        ts::PacketCounter measuredPackets() const { return _meas_packets; }
+        ts::NanoSecond measuredTime() const { return _meas_time; }
+
     protected:
         Options& _opt;          // Application options.
         bool     _own_bitrate;  // This plugin manages its own bitrate (ie. does not get it from previous plugin).
 
+        // Measure the execution time of the plugin, around calls to the plugin.
+        void startMeasure();
+        void stopMeasure(size_t packets);
+
         // Inherited from Report (via TSP)
         virtual void writeLog(int severity, const ts::UString& msg) override;
 
@@ -150,6 +596,15 @@ namespace {
         ts::UString     _name;         // Plugin name.
         ts::Plugin*     _shlib;        // Plugin instance.
         PluginExecutor* _previous;     // Previous plugin executor.
+
+        // Execution statistics.
+        ts::Monotonic     _meas_start;         // Start time of current measure.
+        uint64_t          _meas_start_cycles;  // CPU cycles at start of current measure.
+        uint64_t          _meas_start_instr;   // CPU instructions at start of current measure.
+        ts::PacketCounter _meas_packets;       // Number of packets passed to the plugin.
+        ts::NanoSecond    _meas_time;          // Cumulated execution time of the plugin.
+        uint64_t          _meas_cycles;        // Cumulated CPU cycles in the plugin.
+        uint64_t          _meas_instr;         // Cumulated CPU instructions in the plugin.
     };
 }
 
@@ -161,7 +616,14 @@ PluginExecutor::PluginExecutor(Options& opt, size_t index, PluginExecutor* previ
     _index(index),
     _name(),
     _shlib(nullptr),
-    _previous(previous)
+    _previous(previous),
+    _meas_start(),
+    _meas_start_cycles(0),
+    _meas_start_instr(0),
+    _meas_packets(0),
+    _meas_time(0),
+    _meas_cycles(0),
+    _meas_instr(0)
 {
     const ts::UStringVector* args = nullptr;
     const ts::UChar* shell_opt = nullptr;
@@ -234,6 +696,46 @@ void PluginExecutor::writeLog(int severity, const ts::UString& msg)
     _opt.log(severity, _name + u": " + msg);
 }
 
+// Start measuring the execution time of the plugin.
+void PluginExecutor::startMeasure()
+{
+    _opt.perf.get(_meas_start_cycles, _meas_start_instr);
+    _meas_start.getSystemTime();
+}
+
+// Stop measuring the execution time of the plugin.
+void PluginExecutor::stopMeasure(size_t packets)
+{
+    _meas_time += ts::Monotonic(true) - _meas_start;
+    uint64_t cycles = 0;
+    uint64_t instr = 0;
+    _opt.perf.get(cycles, instr);
+    _meas_cycles += cycles - _meas_start_cycles;
+    _meas_instr += instr - _meas_start_instr;
+    _meas_packets += packets;
+}
+
+// Build a JSON description of the execution statistics of the plugin.
+ts::json::ValuePtr PluginExecutor::results() const
+{
+    ts::json::Object* obj = new ts::json::Object;
+    ts::json::ValuePtr result(obj);
+    obj->add(u"index", int64_t(_index));
+    obj->add(u"name", _name);
+    obj->add(u"type", ts::PluginTypeNames.name(_shlib->type()));
+    obj->add(u"packets", int64_t(_meas_packets));
+    obj->add(u"time-us", _meas_time / ts::NanoSecPerMicroSec);
+    if (_meas_packets > 0) {
+        // Keep some precision in integer JSON values.
+        obj->add(u"ps-per-packet", int64_t((1000 * _meas_time) / _meas_packets));
+        if (_opt.perf.isOpen()) {
+            obj->add(u"cycles-per-1000-packets", int64_t((1000 * _meas_cycles) / _meas_packets));
+            obj->add(u"instructions-per-1000-packets", int64_t((1000 * _meas_instr) / _meas_packets));
+        }
+    }
+    return result;
+}
+
 // Update bitrate from previous plugin executor.
 void PluginExecutor::updateBitrateFromPrevious()
 {
@@ -293,7 +795,12 @@ InputPluginExecutor::InputPluginExecutor(Options& opt) :
 size_t InputPluginExecutor::receive(ts::TSPacket* packets, ts::TSPacketMetadata* metadata, size_t max_packets)
 {
     // Receive packets from the plugin. End of stream after loss of synchronization.
-    size_t count = _sync_lost ? 0 : plugin()->receive(packets, metadata, max_packets);
+    size_t count = 0;
+    if (!_sync_lost) {
+        startMeasure();
+        count = plugin()->receive(packets, metadata, max_packets);
+        stopMeasure(count);
+    }
     if (count == 0) {
         return 0;
     }
@@ -364,16 +871,21 @@ bool ProcessorPluginExecutor::process(ts::TSPacket* packets, ts::TSPacketMetadat
     updateBitrateFromPrevious();
 
     // Loop on packets.
-    for (size_t i = 0; i < count; ++i) {
+    bool success = true;
+    size_t processed = 0;
+    startMeasure();
+    for (size_t i = 0; success && i < count; ++i) {
         if (packets[i].b[0] == 0) {
             // The packet has already been dropped by a previous packet processor.
             addNonPluginPackets(1);
         }
         else {
+            processed++;
             metadata[i].setBitrateChanged(false);
             switch (plugin()->processPacket(packets[i], metadata[i])) {
                 case ts::ProcessorPlugin::TSP_END:
-                    return false;
+                    success = false;
+                    break;
                 case ts::ProcessorPlugin::TSP_DROP:
                     packets[i].b[0] = 0;
                     addNonPluginPackets(1);
@@ -393,7 +905,8 @@ bool ProcessorPluginExecutor::process(ts::TSPacket* packets, ts::TSPacketMetadat
             }
         }
     }
-    return true;
+    stopMeasure(processed);
+    return success;
 }
 
 
@@ -441,8 +954,13 @@ bool OutputPluginExecutor::send(ts::TSPacket* packets, ts::TSPacketMetadata* met
             chunk_end++;
         }
         // Output chunk of packets.
-        if (chunk_end > chunk_start && !plugin()->send(packets + chunk_start, metadata + chunk_start, chunk_end - chunk_start)) {
-            return false;
+        if (chunk_end > chunk_start) {
+            startMeasure();
+            const bool sent = plugin()->send(packets + chunk_start, metadata + chunk_start, chunk_end - chunk_start);
+            stopMeasure(chunk_end - chunk_start);
+            if (!sent) {
+                return false;
+            }
         }
         chunk_start = chunk_end;
     }
@@ -452,59 +970,208 @@ bool OutputPluginExecutor::send(ts::TSPacket* packets, ts::TSPacketMetadata* met
 
 
 //----------------------------------------------------------------------------
-// Program main code.
+// Run the same chain of plugins using the multi-threaded tsp engine.
 //----------------------------------------------------------------------------
 
-int MainCode(int argc, char *argv[])
-{
-    // Get command line options.
-    Options opt(argc, argv);
-    CERR.setMaxSeverity(opt.maxSeverity());
+namespace {
+    bool RunTSProcessor(Options& opt, ts::NanoSecond& duration)
+    {
+        ts::TSProcessorArgs args;
+        args.app_name = opt.appName();
+        args.fixed_bitrate = opt.fixed_bitrate;
+        args.input = opt.input;
+        args.plugins = opt.plugins;
+        args.output = opt.output;
+        opt.duck.saveArgs(args.duck_args);
+
+        // Same logging as tsp, asynchronous.
+        ts::AsyncReport report(opt.maxSeverity());
+        ts::TSProcessor tsproc(report);
+
+        const ts::Monotonic start(true);
+        if (!tsproc.start(args)) {
+            return false;
+        }
+        tsproc.waitForTermination();
+        duration = ts::Monotonic(true) - start;
+        return true;
+    }
 
-    // Prevent from being killed when writing on broken pipes.
-    ts::IgnorePipeSignal();
+    // Build a JSON description of an execution.
+    ts::json::ValuePtr Throughput(ts::PacketCounter packets, ts::NanoSecond duration)
+    {
+        ts::json::Object* obj = new ts::json::Object;
+        ts::json::ValuePtr result(obj);
+        obj->add(u"packets", int64_t(packets));
+        obj->add(u"time-us", duration / ts::NanoSecPerMicroSec);
+        obj->add(u"packets-per-second", duration <= 0 ? 0 : int64_t((packets * ts::NanoSecPerSec) / ts::PacketCounter(duration)));
+        return result;
+    }
 
-    // Allocate and start all plugins.
-    InputPluginExecutor* input = new InputPluginExecutor(opt);
-    PluginExecutor* previous = input;
-    std::vector<ProcessorPluginExecutor*> procs;
-    for (size_t i = 0; i < opt.plugins.size(); ++i) {
-        ProcessorPluginExecutor* plugin = new ProcessorPluginExecutor(opt, i + 1, previous);
-        procs.push_back(plugin);
-        previous = plugin;
+    // Format a value in 1/1000 units with 3 decimal digits.
+    ts::UString Milli(const ts::json::Value& value)
+    {
+        const int64_t i = value.toInteger();
+        return ts::UString::Format(u"%'d.%03d", {i / 1000, i % 1000});
     }
-    OutputPluginExecutor* output = new OutputPluginExecutor(opt, previous);
 
-    // Exit on error when initializing the plugins.
-    if (opt.gotErrors()) {
-        return EXIT_FAILURE;
+    // Display the execution statistics of one plugin.
+    void DisplayPlugin(std::ostream& out, const PluginExecutor* plugin, const ts::json::Value& res)
+    {
+        out << ts::UString::Format(u"%-3d %-20s %12'd %12'd", {plugin->pluginIndex(), plugin->pluginName(), res.value(u"packets").toInteger(), res.value(u"time-us").toInteger() / 1000});
+        if (res.value(u"ps-per-packet").isNumber()) {
+            out << ts::UString::Format(u" %12s", {Milli(res.value(u"ps-per-packet"))});
+        }
+        if (res.value(u"cycles-per-1000-packets").isNumber()) {
+            out << ts::UString::Format(u" %14s %14s", {Milli(res.value(u"cycles-per-1000-packets")), Milli(res.value(u"instructions-per-1000-packets"))});
+        }
+        out << std::endl;
     }
+}
 
-    // Packet buffers.
-    ts::TSPacketVector packets(opt.buffer_size);
-    ts::TSPacketMetadataVector metadata(opt.buffer_size);
 
-    bool success = true;
-    size_t received = 0;
+//----------------------------------------------------------------------------
+// Program main code.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Run the profiling session, return the process exit status.
+    int RunProfiling(Options& opt)
+    {
+        // Generate the synthetic workload.
+        if (opt.workload != Workload::NONE) {
+            opt.verbose(u"generating workload %s, %'d packets in %s", {WorkloadNames.name(int(opt.workload)), opt.workload_packets, opt.workload_file});
+            WorkloadGenerator gen(opt.duck, opt.workload);
+            if (!gen.generate(opt.workload_file, opt.workload_packets)) {
+                return EXIT_FAILURE;
+            }
+        }
+
+        // Use CPU hardware counters in this thread.
+        if (opt.hw_counters) {
+            opt.perf.open(opt);
+        }
+
+        // Allocate and start all plugins.
+        InputPluginExecutor* input = new InputPluginExecutor(opt);
+        PluginExecutor* previous = input;
+        std::vector<ProcessorPluginExecutor*> procs;
+        for (size_t i = 0; i < opt.plugins.size(); ++i) {
+            ProcessorPluginExecutor* plugin = new ProcessorPluginExecutor(opt, i + 1, previous);
+            procs.push_back(plugin);
+            previous = plugin;
+        }
+        OutputPluginExecutor* output = new OutputPluginExecutor(opt, previous);
 
-    // Now loop on plugins, sequentially.
-    while (success && (received = input->receive(packets.data(), metadata.data(), packets.size())) != 0) {
-        // Received a chunk of packets, loop on plugins.
-        for (size_t pli = 0; success && pli < procs.size(); ++pli) {
-            success = procs[pli]->process(packets.data(), metadata.data(), received);
+        // Exit on error when initializing the plugins.
+        if (opt.gotErrors()) {
+            delete input;
+            for (size_t i = 0; i < procs.size(); ++i) {
+                delete procs[i];
+            }
+            delete output;
+            opt.perf.close();
+            return EXIT_FAILURE;
+        }
+
+        // Packet buffers.
+        ts::TSPacketVector packets(opt.buffer_size);
+        ts::TSPacketMetadataVector metadata(opt.buffer_size);
+
+        bool success = true;
+        size_t received = 0;
+        ts::PacketCounter total_packets = 0;
+        const ts::Monotonic start(true);
+
+        // Now loop on plugins, sequentially.
+        while (success && (received = input->receive(packets.data(), metadata.data(), packets.size())) != 0) {
+            // Received a chunk of packets, loop on plugins.
+            total_packets += received;
+            for (size_t pli = 0; success && pli < procs.size(); ++pli) {
+                success = procs[pli]->process(packets.data(), metadata.data(), received);
+            }
+            success = success && output->send(packets.data(), metadata.data(), received);
+            ts::TSPacketMetadata::Reset(metadata.data(), received);
+        }
+        const ts::NanoSecond duration = ts::Monotonic(true) - start;
+
+        // Build the results.
+        ts::json::Object root;
+        ts::json::Array* plugins = new ts::json::Array;
+        root.add(u"tsduck", ts::VersionInfo::GetVersion());
+        root.add(u"date", ts::Time::CurrentLocalTime().format(ts::Time::DATETIME));
+        root.add(u"workload", opt.workload == Workload::NONE ? opt.input.toString(ts::PluginType::INPUT) : WorkloadNames.name(int(opt.workload)));
+        root.add(u"packet-buffer", int64_t(opt.buffer_size));
+        root.add(u"hardware-counters", ts::json::Bool(opt.perf.isOpen()));
+        root.add(u"mono-thread", Throughput(total_packets, duration));
+        root.add(u"plugins", ts::json::ValuePtr(plugins));
+        plugins->set(input->results());
+        for (size_t i = 0; i < procs.size(); ++i) {
+            plugins->set(procs[i]->results());
         }
-        success = success && output->send(packets.data(), metadata.data(), received);
-        ts::TSPacketMetadata::Reset(metadata.data(), received);
+        plugins->set(output->results());
+
+        // Close and deallocate all plugins.
+        input->plugin()->stop();
+        for (size_t i = 0; i < opt.plugins.size(); ++i) {
+            procs[i]->plugin()->stop();
+        }
+        output->plugin()->stop();
+
+        // Run the same chain of plugins using tsp.
+        ts::NanoSecond tsp_duration = 0;
+        if (opt.compare_tsp && RunTSProcessor(opt, tsp_duration)) {
+            root.add(u"tsp", Throughput(total_packets, tsp_duration));
+        }
+
+        // Report the results.
+        if (opt.json.useJSON()) {
+            opt.json.report(root, std::cout, opt);
+        }
+        else {
+            std::cout << ts::UString::Format(u"Mono-thread: %'d packets, %'d ms, %'d packets/s", {total_packets, duration / ts::NanoSecPerMilliSec, root.value(u"mono-thread").value(u"packets-per-second").toInteger()}) << std::endl;
+            if (root.value(u"tsp").isObject()) {
+                std::cout << ts::UString::Format(u"Threaded tsp: %'d packets, %'d ms, %'d packets/s", {total_packets, tsp_duration / ts::NanoSecPerMilliSec, root.value(u"tsp").value(u"packets-per-second").toInteger()}) << std::endl;
+            }
+            std::cout << std::endl
+                      << ts::UString::Format(u"%-3s %-20s %12s %12s %12s", {u"#", u"Plugin", u"Packets", u"ms", u"ns/packet"});
+            if (opt.perf.isOpen()) {
+                std::cout << ts::UString::Format(u" %14s %14s", {u"cycles/packet", u"instr/packet"});
+            }
+            std::cout << std::endl;
+            DisplayPlugin(std::cout, input, plugins->at(0));
+            for (size_t i = 0; i < procs.size(); ++i) {
+                DisplayPlugin(std::cout, procs[i], plugins->at(i + 1));
+            }
+            DisplayPlugin(std::cout, output, plugins->at(procs.size() + 1));
+        }
+
+        // Deallocate all plugins. The hardware counters are used in the report, close them last.
+        delete input;
+        for (size_t i = 0; i < procs.size(); ++i) {
+            delete procs[i];
+        }
+        delete output;
+        opt.perf.close();
+        return EXIT_SUCCESS;
     }
+}
+
+int MainCode(int argc, char *argv[])
+{
+    // Get command line options.
+    Options opt(argc, argv);
+    CERR.setMaxSeverity(opt.maxSeverity());
+
+    // Prevent from being killed when writing on broken pipes.
+    ts::IgnorePipeSignal();
+
+    // Run the profiling session.
+    const int status = RunProfiling(opt);
 
-    // Close and deallocate all plugins.
-    input->plugin()->stop();
-    delete input;
-    for (size_t i = 0; i < opt.plugins.size(); ++i) {
-        procs[i]->plugin()->stop();
-        delete procs[i];
+    // Delete the temporary workload file, even after errors.
+    if (opt.workload != Workload::NONE && !opt.present(u"workload-file") && ts::FileExists(opt.workload_file)) {
+        ts::DeleteFile(opt.workload_file, opt);
     }
-    output->plugin()->stop();
-    delete output;
-    return EXIT_SUCCESS;
+    return status;
 }